@@ -23,6 +23,7 @@
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
+#include "system/checkpoint_data.hh"
 
 #include <petscmat.h>
 #include "mesh/mesh.h"
@@ -703,6 +704,33 @@ void Balance::calculate_instant(unsigned int quantity_idx, const Vec& solution)
 
 
 
+void Balance::save_state(CheckpointData &data) const
+{
+	CheckpointData::Scope scope(data, "balance");
+	data.save("initial_mass", initial_mass_);
+	data.save("integrated_sources", integrated_sources_);
+	data.save("integrated_fluxes", integrated_fluxes_);
+	data.save("increment_sources", increment_sources_);
+	data.save("increment_fluxes", increment_fluxes_);
+	data.save("last_time", last_time_);
+	data.save("initial", initial_);
+}
+
+
+void Balance::restore_state(CheckpointData &data)
+{
+	CheckpointData::Scope scope(data, "balance");
+	data.load("initial_mass", initial_mass_);
+	data.load("integrated_sources", integrated_sources_);
+	data.load("integrated_fluxes", integrated_fluxes_);
+	data.load("increment_sources", increment_sources_);
+	data.load("increment_fluxes", increment_fluxes_);
+	data.load("last_time", last_time_);
+	data.load("initial", initial_);
+}
+
+
+
 void Balance::output()
 {
     ASSERT_DBG(allocation_done_);
@@ -37,6 +37,7 @@ class TimeGovernor;
 class DOFHandlerMultiDim;
 class DHCellSide;
 class DHCellAccessor;
+class CheckpointData;
 namespace Input {
 	namespace Type {
 		class Record;
@@ -386,6 +387,12 @@ public:
 	/// Perform output to file for given time instant.
 	void output();
 
+	/// Save time integrated quantities to the checkpoint.
+	void save_state(CheckpointData &data) const;
+
+	/// Restore time integrated quantities saved by @p save_state.
+	void restore_state(CheckpointData &data);
+
 private:
 	/// Size of column in output (used if delimiter is space)
 	static const unsigned int output_column_width = 20;
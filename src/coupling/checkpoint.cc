@@ -0,0 +1,213 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint.cc
+ * @brief   Periodic checkpoints of coupled simulations and restart from the latest one.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <mpi.h>
+
+#include "coupling/checkpoint.hh"
+#include "system/checkpoint_data.hh"
+#include "system/file_path.hh"
+#include "system/logger.hh"
+#include "system/sys_profiler.hh"
+#include "input/input_type.hh"
+#include "io/output_time_set.hh"
+#include "tools/time_governor.hh"
+
+
+namespace IT = Input::Type;
+
+const std::string Checkpoint::index_file_name = "checkpoint.yaml";
+
+
+const IT::Record & Checkpoint::get_input_type() {
+	return IT::Record("Checkpoint", "Periodic saving of the simulation state and restart from the latest saved state.")
+		.declare_key("directory", IT::String(), IT::Default("\"checkpoint\""),
+				"Directory of checkpoint files, relative to the output directory.")
+		.declare_key("times", OutputTimeSet::get_input_type(), IT::Default::optional(),
+				"Simulation times of checkpoints. Checkpoint is written after all equations pass the time.")
+		.declare_key("wall_time_interval", IT::Double(0.0), IT::Default("0"),
+				"Minimal wall clock time in seconds between two checkpoints. Zero means no checkpoints given by wall time.")
+		.declare_key("keep", IT::Integer(1), IT::Default("2"),
+				"Number of kept checkpoints, older checkpoints are deleted.")
+		.declare_key("restart", IT::Bool(), IT::Default("false"),
+				"Start the simulation from the latest checkpoint in the checkpoint directory. "
+				"Restart requires the same input and the same number of processes as the checkpointed simulation.")
+		.close();
+}
+
+
+Checkpoint::Checkpoint(const Input::Record &in_rec, const TimeGovernor &tg)
+: directory_(in_rec.val<std::string>("directory")),
+  wall_time_interval_(in_rec.val<double>("wall_time_interval")),
+  last_wall_time_(std::chrono::steady_clock::now()),
+  n_keep_(in_rec.val<unsigned int>("keep")),
+  restart_(in_rec.val<bool>("restart")),
+  last_index_(0)
+{
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+	MPI_Comm_size(MPI_COMM_WORLD, &n_proc_);
+
+	// same grids as output times, but no time marks are added, equations need not to stop at checkpoint times
+	Input::Array times_array;
+	if (in_rec.opt_val("times", times_array)) {
+		for (auto it = times_array.begin<Input::Record>(); it != times_array.end(); ++it) {
+			double t_begin = tg.read_time(it->find<Input::Tuple>("begin"), tg.init_time());
+			double t_end = tg.read_time(it->find<Input::Tuple>("end"), tg.end_time());
+			Input::Tuple step;
+			if (! it->opt_val("step", step) ) {
+				times_.insert(t_begin);
+				continue;
+			}
+			double t_step = tg.read_time(it->find<Input::Tuple>("step"));
+			if (t_step < 2*std::numeric_limits<double>::epsilon() || t_begin > t_end || t_end >= TimeGovernor::inf_time) {
+				WarningOut().fmt("Ignoring checkpoint time grid. {}", it->address_string());
+				continue;
+			}
+			unsigned int n_steps = (t_end - t_begin) / t_step + TimeGovernor::time_step_precision;
+			for (unsigned int i = 0; i <= n_steps; i++) times_.insert(t_begin + i * t_step);
+		}
+	}
+}
+
+
+std::string Checkpoint::file_path(const std::string &file_name) const
+{
+	FilePath path(std::vector<std::string>({directory_, file_name}), FilePath::output_file);
+	path.create_output_dir();
+	return std::string(path);
+}
+
+
+std::string Checkpoint::data_file_name(unsigned int index, int rank)
+{
+	return "checkpoint_" + std::to_string(index) + "_" + std::to_string(rank) + ".bin";
+}
+
+
+bool Checkpoint::is_needed(double time)
+{
+	int needed = 0;
+	while ( !times_.empty() && *times_.begin() <= time + TimeGovernor::time_step_precision ) {
+		times_.erase(times_.begin());
+		needed = 1;
+	}
+	if (wall_time_interval_ > 0.0) {
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - last_wall_time_;
+		if (elapsed.count() >= wall_time_interval_) needed = 1;
+	}
+
+	// wall clock differs on processes
+	int needed_all;
+	MPI_Allreduce(&needed, &needed_all, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+	return (needed_all > 0);
+}
+
+
+void Checkpoint::write(CheckpointData &data, double time)
+{
+	START_TIMER("Checkpoint write");
+	unsigned int index = last_index_ + 1;
+	{
+		CheckpointData::Scope scope(data, "checkpoint");
+		data.save("rank", rank_);
+		data.save("n_processes", n_proc_);
+		data.save("time", time);
+	}
+
+	int error = 0;
+	try {
+		data.write( file_path(data_file_name(index, rank_)) );
+	} catch (std::exception &e) {
+		WarningOut() << e.what();
+		error = 1;
+	}
+	int error_all;
+	MPI_Allreduce(&error, &error_all, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+	if (error_all) {
+		WarningOut().fmt("Checkpoint at time {} was not written, the previous checkpoint is kept.\n", time);
+		return;
+	}
+
+	// all data files are complete, replace the index file
+	int index_replaced = 1;
+	if (rank_ == 0) {
+		std::string index_path = file_path(index_file_name);
+		std::string tmp_path = index_path + ".tmp";
+		{
+			std::ofstream index_file(tmp_path);
+			index_file.precision(17);
+			index_file << "index: " << index << "\n"
+			           << "time: " << time << "\n"
+			           << "n_processes: " << n_proc_ << "\n";
+		}
+		if ( std::rename(tmp_path.c_str(), index_path.c_str()) != 0 ) {
+			WarningOut().fmt("Can not replace checkpoint index file '{}'.\n", index_path);
+			index_replaced = 0;
+		}
+	}
+	// the index file still refers to the previous checkpoint if not replaced, its data files have to be kept
+	MPI_Bcast(&index_replaced, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (! index_replaced) {
+		WarningOut().fmt("Checkpoint at time {} was not written, the previous checkpoint is kept.\n", time);
+		return;
+	}
+
+	if (index > n_keep_) std::remove( file_path(data_file_name(index - n_keep_, rank_)).c_str() );
+	last_index_ = index;
+	last_wall_time_ = std::chrono::steady_clock::now();
+	MessageOut().fmt("Checkpoint {} written at time {}.\n", index, time);
+}
+
+
+double Checkpoint::read(CheckpointData &data)
+{
+	START_TIMER("Checkpoint read");
+	std::string index_path = file_path(index_file_name);
+	std::ifstream index_file(index_path);
+	unsigned int index = 0;
+	double time = 0.0;
+	int n_proc = -1;
+	std::string key;
+	while (index_file >> key) {
+		if (key == "index:") index_file >> index;
+		else if (key == "time:") index_file >> time;
+		else if (key == "n_processes:") index_file >> n_proc;
+	}
+	if (index == 0 || n_proc < 0) THROW( ExcNoCheckpoint() << EI_FileName(index_path) );
+	if (n_proc != n_proc_)
+		THROW( ExcProcessMismatch() << EI_FileName(index_path) << EI_NProcCheckpoint(n_proc) << EI_NProc(n_proc_) );
+
+	std::string data_path = file_path(data_file_name(index, rank_));
+	data.read(data_path);
+	int rank, n_proc_data;
+	{
+		CheckpointData::Scope scope(data, "checkpoint");
+		data.load("rank", rank);
+		data.load("n_processes", n_proc_data);
+	}
+	if (rank != rank_ || n_proc_data != n_proc_)
+		THROW( ExcProcessMismatch() << EI_FileName(data_path) << EI_NProcCheckpoint(n_proc_data) << EI_NProc(n_proc_) );
+
+	// checkpoints before the restart time are already written
+	while ( !times_.empty() && *times_.begin() <= time + TimeGovernor::time_step_precision )
+		times_.erase(times_.begin());
+	last_index_ = index;
+	last_wall_time_ = std::chrono::steady_clock::now();
+	MessageOut().fmt("Restart from checkpoint {} at time {}.\n", index, time);
+	return time;
+}
@@ -0,0 +1,122 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint.hh
+ * @brief   Periodic checkpoints of coupled simulations and restart from the latest one.
+ */
+
+#ifndef CHECKPOINT_HH_
+#define CHECKPOINT_HH_
+
+#include <chrono>
+#include <set>
+#include <string>
+#include "input/input_type_forward.hh"
+#include "input/accessors.hh"
+#include "system/exceptions.hh"
+
+class CheckpointData;
+class TimeGovernor;
+
+
+/**
+ * @brief Controller of checkpoints of the simulation state.
+ *
+ * Checkpoint is written when the simulation reaches one of the given times or when the given
+ * wall clock interval elapses since the last checkpoint. Every process writes its own binary file
+ * 'checkpoint_<index>_<rank>.bin' (see CheckpointData) into the checkpoint directory, after all
+ * processes succeed the process 0 replaces the index file 'checkpoint.yaml' referencing the latest
+ * complete checkpoint. So a crash during writing never damages the previous checkpoint.
+ *
+ * Restart reads the checkpoint referenced by the index file. Local data depend on the partitioning,
+ * so the restart has to run on the same number of processes with the same mesh and input.
+ */
+class Checkpoint {
+public:
+	TYPEDEF_ERR_INFO(EI_FileName, std::string);
+	TYPEDEF_ERR_INFO(EI_NProc, int);
+	TYPEDEF_ERR_INFO(EI_NProcCheckpoint, int);
+	DECLARE_EXCEPTION(ExcNoCheckpoint,
+			<< "Can not restart the simulation, checkpoint index file " << EI_FileName::qval
+			<< " is missing or invalid.\n");
+	DECLARE_EXCEPTION(ExcProcessMismatch,
+			<< "Checkpoint " << EI_FileName::qval << " was written by " << EI_NProcCheckpoint::val
+			<< " processes, restart runs on " << EI_NProc::val << " processes.\n"
+			<< "Restart requires the same partitioning as the checkpointed simulation.\n");
+	DECLARE_EXCEPTION(ExcPartitioning,
+			<< "Distribution of mesh elements differs from the checkpointed simulation.\n"
+			<< "Restart requires the same mesh and the same partitioning as the checkpointed simulation.\n");
+
+	/// Input type of the checkpoint settings.
+	static const Input::Type::Record & get_input_type();
+
+	/**
+	 * Constructor.
+	 * @param in_rec  Input record of type get_input_type().
+	 * @param tg      Time governor used for reading of checkpoint times (time units).
+	 */
+	Checkpoint(const Input::Record &in_rec, const TimeGovernor &tg);
+
+	/// Return true if the simulation starts from the latest checkpoint.
+	inline bool is_restart() const {
+		return restart_;
+	}
+
+	/**
+	 * Return true if the checkpoint should be written at given simulation @p time.
+	 * Collective, the decision is common to all processes.
+	 */
+	bool is_needed(double time);
+
+	/**
+	 * Write saved state @p data of the simulation at given @p time. Collective.
+	 * Failure of writing is reported as warning, the simulation continues.
+	 */
+	void write(CheckpointData &data, double time);
+
+	/**
+	 * Read the latest checkpoint to @p data and return its simulation time. Collective.
+	 * Throws ExcNoCheckpoint or ExcProcessMismatch.
+	 */
+	double read(CheckpointData &data);
+
+private:
+	/// Path to the file of given name in the checkpoint directory.
+	std::string file_path(const std::string &file_name) const;
+
+	/// Name of the data file of given checkpoint index and MPI rank.
+	static std::string data_file_name(unsigned int index, int rank);
+
+	/// Name of the index file referencing the latest complete checkpoint.
+	static const std::string index_file_name;
+
+	/// Directory of checkpoint files (relative to the output directory).
+	std::string directory_;
+	/// Simulation times of planned checkpoints, passed times are removed.
+	std::set<double> times_;
+	/// Minimal wall clock interval between checkpoints in seconds, zero for no interval.
+	double wall_time_interval_;
+	/// Wall clock time of the last checkpoint (or of the start of the simulation).
+	std::chrono::steady_clock::time_point last_wall_time_;
+	/// Number of kept checkpoints, older are deleted.
+	unsigned int n_keep_;
+	/// Restart flag.
+	bool restart_;
+	/// Index of the last written (or read) checkpoint.
+	unsigned int last_index_;
+	/// MPI rank and size.
+	int rank_, n_proc_;
+};
+
+
+#endif /* CHECKPOINT_HH_ */
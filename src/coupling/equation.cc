@@ -24,6 +24,8 @@
 #include "system/system.hh"
 #include "input/accessors.hh"
 #include "fields/field_set.hh"
+#include "coupling/balance.hh"
+#include "system/checkpoint_data.hh"
 
 #include <boost/foreach.hpp>
 
@@ -64,3 +66,39 @@ void EquationBase::set_time_governor(TimeGovernor &time)
   time_ = &time;
 }
 
+
+void EquationBase::save_state(CheckpointData &data)
+{
+    if (time_ != nullptr) time_->save_state(data);
+    if (balance_ != nullptr) balance_->save_state(data);
+}
+
+
+void EquationBase::restore_state(CheckpointData &data)
+{
+    if (time_ != nullptr) time_->restore_state(data);
+    if (balance_ != nullptr) balance_->restore_state(data);
+}
+
+
+void EquationBase::save_vec(CheckpointData &data, const std::string &name, Vec vec)
+{
+    PetscInt loc_size;
+    const PetscScalar *array;
+    chkerr(VecGetLocalSize(vec, &loc_size));
+    chkerr(VecGetArrayRead(vec, &array));
+    data.save_array(name, array, loc_size);
+    chkerr(VecRestoreArrayRead(vec, &array));
+}
+
+
+void EquationBase::restore_vec(CheckpointData &data, const std::string &name, Vec vec)
+{
+    PetscInt loc_size;
+    PetscScalar *array;
+    chkerr(VecGetLocalSize(vec, &loc_size));
+    chkerr(VecGetArray(vec, &array));
+    data.load_array(name, array, loc_size);
+    chkerr(VecRestoreArray(vec, &array));
+}
+
@@ -34,6 +34,7 @@
 #include "tools/time_governor.hh"                      // for TimeGovernor
 #include "tools/time_marks.hh"                         // for TimeMark, Time...
 class Balance;
+class CheckpointData;
 class FieldSet;
 class Mesh;
 
@@ -215,7 +216,28 @@ public:
       else DebugOut().fmt("Method 'output_data' of '{}' is not implemented.\n", typeid(*this).name());
     }
 
+    /**
+     * @brief Save state of the equation necessary for restart to the checkpoint.
+     *
+     * Default implementation saves the time governor and the balance. Equations override
+     * the method to save their solution vectors, overrides have to call the parent method.
+     */
+    virtual void save_state(CheckpointData &data);
+
+    /**
+     * @brief Restore state saved by @p save_state.
+     *
+     * Called on restart after @p zero_time_step, so all structures are already allocated.
+     */
+    virtual void restore_state(CheckpointData &data);
+
 protected:
+    /// Save local part of PETSc vector.
+    static void save_vec(CheckpointData &data, const std::string &name, Vec vec);
+
+    /// Restore local part of PETSc vector, local size must be the same as in the checkpoint.
+    static void restore_vec(CheckpointData &data, const std::string &name, Vec vec);
+
     bool equation_empty_;       ///< flag is true if only default constructor was called
     Mesh * mesh_;
     TimeGovernor *time_;
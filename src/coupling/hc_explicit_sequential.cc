@@ -17,6 +17,7 @@
  */
 
 #include "hc_explicit_sequential.hh"
+#include "coupling/checkpoint.hh"
 #include "flow/darcy_flow_interface.hh"
 #include "flow/darcy_flow_mh.hh"
 // TODO:
@@ -33,6 +34,8 @@
 #include "mesh/mesh.h"
 #include "io/msh_gmshreader.h"
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
+#include "la/distribution.hh"
 #include "input/input_type.hh"
 #include "input/accessors.hh"
 
@@ -73,6 +76,8 @@ const it::Record & HC_ExplicitSequential::get_input_type() {
 				"Transport of soluted substances, depends on the velocity field from a Flow equation.")
 		.declare_key("heat_equation", AdvectionProcessBase::get_input_type(),
 		        "Heat transfer, depends on the velocity field from a Flow equation.")
+		.declare_key("checkpoint", Checkpoint::get_input_type(), it::Default::optional(),
+		        "Periodic saving of the simulation state, restart from the saved state.")
 		.close();
 }
 
@@ -160,6 +165,77 @@ HC_ExplicitSequential::HC_ExplicitSequential(Input::Record in_record)
 
     processes_.push_back(AdvectionData(make_advection_process("solute_equation")));
     processes_.push_back(AdvectionData(make_advection_process("heat_equation")));
+
+    Record checkpoint_rec;
+    if (in_record.opt_val("checkpoint", checkpoint_rec))
+        checkpoint_ = std::make_shared<Checkpoint>(checkpoint_rec, water->time());
+}
+
+
+double HC_ExplicitSequential::min_solved_time()
+{
+    double time = TimeGovernor::inf_time;
+    if (! water->time().is_end()) time = water->solved_time();
+    for(auto &pdata : processes_)
+        if (! pdata.process->time().is_end()) time = min(time, pdata.process->solved_time());
+    return time;
+}
+
+
+void HC_ExplicitSequential::save_state(CheckpointData &data)
+{
+    START_TIMER("HC save state");
+    data.save("n_elements", mesh->n_elements());
+    data.save("el_ds_begin", mesh->get_el_ds()->begin());
+    data.save("el_ds_lsize", mesh->get_el_ds()->lsize());
+    TimeGovernor::marks().save_state(data);
+    {
+        CheckpointData::Scope scope(data, "flow");
+        water->save_state(data);
+    }
+    for (unsigned int i=0; i<processes_.size(); ++i) {
+        CheckpointData::Scope scope(data, "process_" + std::to_string(i));
+        AdvectionData &pdata = processes_[i];
+        bool started = (pdata.process->time().tlevel() > 0);
+        data.save("started", started);
+        data.save("velocity_time", pdata.velocity_time);
+        if (started) pdata.process->save_state(data);
+    }
+}
+
+
+void HC_ExplicitSequential::restore_state(CheckpointData &data)
+{
+    START_TIMER("HC restore state");
+    unsigned int n_elements, el_ds_begin, el_ds_lsize;
+    data.load("n_elements", n_elements);
+    data.load("el_ds_begin", el_ds_begin);
+    data.load("el_ds_lsize", el_ds_lsize);
+    if (n_elements != mesh->n_elements() || el_ds_begin != mesh->get_el_ds()->begin()
+            || el_ds_lsize != mesh->get_el_ds()->lsize())
+        THROW( Checkpoint::ExcPartitioning() );
+
+    TimeGovernor::marks().restore_state(data);
+    {
+        CheckpointData::Scope scope(data, "flow");
+        water->restore_state(data);
+    }
+    for (unsigned int i=0; i<processes_.size(); ++i) {
+        CheckpointData::Scope scope(data, "process_" + std::to_string(i));
+        AdvectionData &pdata = processes_[i];
+        bool started;
+        data.load("started", started);
+        data.load("velocity_time", pdata.velocity_time);
+        pdata.velocity_changed = true;
+        if (! started) continue;
+
+        // allocate structures of the process as in advection_process_step, then overwrite its state
+        auto& flux = pdata.process->data()["flow_flux"];
+        flux.copy_from(water->data()["flux"]);
+        flux.set_time_result_changed();
+        pdata.process->zero_time_step();
+        pdata.process->restore_state(data);
+    }
 }
 
 void HC_ExplicitSequential::advection_process_step(AdvectionData &pdata)
@@ -213,6 +289,12 @@ void HC_ExplicitSequential::run_simulation()
         water->zero_time_step();
     }
 
+    if (checkpoint_ && checkpoint_->is_restart()) {
+        CheckpointData data;
+        checkpoint_->read(data);
+        this->restore_state(data);
+    }
+
 
     // following cycle is designed to support independent time stepping of
     // both processes. The question is which value of the water field use to compute a transport step.
@@ -275,6 +357,15 @@ void HC_ExplicitSequential::run_simulation()
         }
         advection_process_step(processes_[0]); // solute
         advection_process_step(processes_[1]); // heat
+
+        if (checkpoint_ && !is_end_all_) {
+            double time = min_solved_time();
+            if (checkpoint_->is_needed(time)) {
+                CheckpointData data;
+                this->save_state(data);
+                checkpoint_->write(data, time);
+            }
+        }
     }
     //MessageOut().fmt("End of simulation at time: {}\n", max(solute->solved_time(), heat->solved_time()));
 }
@@ -29,6 +29,7 @@
 class DarcyFlowInterface;
 class Mesh;
 class AdvectionProcessBase;
+class Checkpoint;
 class FieldCommon;
 
 
@@ -54,6 +55,15 @@ public:
     void run_simulation();
     ~HC_ExplicitSequential();
 
+    /// Save state of all equations and of the coupling.
+    void save_state(CheckpointData &data) override;
+
+    /**
+     * Restore state saved by @p save_state. Flow has to perform its zero time step before,
+     * zero time step of the started processes is performed here.
+     */
+    void restore_state(CheckpointData &data) override;
+
 private:
     typedef std::shared_ptr<AdvectionProcessBase> AdvectionPtr;
 
@@ -77,6 +87,9 @@ private:
      */
     void advection_process_step(AdvectionData &pdata);
 
+    /// Minimal solved time of equations that are not finished.
+    double min_solved_time();
+
     static const int registrar;
 
     ///
@@ -98,6 +111,9 @@ private:
 
     FieldCommon *water_content_saturated_;
     FieldCommon *water_content_p0_;
+
+    /// Checkpoint controller, nullptr if checkpoints are off.
+    std::shared_ptr<Checkpoint> checkpoint_;
 };
 
 #endif /* HC_EXPLICIT_SEQUENTIAL_HH_ */
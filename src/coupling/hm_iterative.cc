@@ -16,8 +16,11 @@
  * @author  Jan Stebel
  */
 
+#include <cmath>
+#include <limits>
 #include "hm_iterative.hh"
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
 #include "input/input_type.hh"
 #include "flow/richards_lmh.hh"
 #include "fields/field_fe.hh"         // for create_field_fe()
@@ -48,6 +51,9 @@ const it::Record & HM_Iterative::get_input_type() {
         .declare_key( "iteration_parameter", it::Double(), it::Default("1"),
                 "Tuning parameter for iterative splitting. Its default value"
                 "corresponds to a theoretically optimal value with fastest convergence." )
+        .declare_key( "adaptive_iteration_parameter", it::Bool(), it::Default("false"),
+                "Adapt the iteration parameter between time steps (within 1/4 and 4 times the given value): "
+                "it is increased if the HM iterations oscillate and decreased if they converge slowly and monotonically." )
         .declare_key( "max_it", it::Integer(0), it::Default("100"),
                 "Maximal count of HM iterations." )
         .declare_key( "min_it", it::Integer(0), it::Default("1"),
@@ -117,6 +123,63 @@ void HM_Iterative::EqData::initialize(Mesh &mesh)
 
                                     
 
+HMCouplingParameters::HMCouplingParameters()
+: step_index_(-1)
+{}
+
+
+double HMCouplingParameters::fixed_stress_coef(double alpha, double young, double poisson, unsigned int dim)
+{
+    return 0.5*alpha*alpha/(2*lame_mu(young, poisson)/dim + lame_lambda(young, poisson));
+}
+
+
+bool HMCouplingParameters::update(const TimeStep &step, Field<3, FieldValue<3>::Scalar> &alpha,
+        Field<3, FieldValue<3>::Scalar> &young, Field<3, FieldValue<3>::Scalar> &poisson,
+        std::shared_ptr<DOFHandlerMultiDim> dh)
+{
+    if (is_current(step)) return false;
+    step_index_ = step.index();
+
+    unsigned int n_local = dh->local_size();
+    alpha_ele_.resize(n_local);
+    beta_coef_.resize(n_local);
+
+    // values of parameters on regions where all of them are constant, NaN if not evaluated yet
+    const RegionDB &region_db = dh->mesh()->region_db();
+    unsigned int n_regions = region_db.size();
+    std::vector<double> region_alpha(n_regions, std::numeric_limits<double>::quiet_NaN());
+    std::vector<double> region_coef(n_regions);
+    std::vector<bool> region_constant(n_regions, false);
+    for (const Region &reg : region_db.get_region_set("BULK"))
+        region_constant[reg.idx()] = alpha.is_constant(reg) && young.is_constant(reg) && poisson.is_constant(reg);
+
+    for ( auto ele : dh->local_range() )
+    {
+        auto elm = ele.elm();
+        unsigned int r = elm.region_idx().idx();
+        if (region_constant[r] && !std::isnan(region_alpha[r]))
+        {
+            alpha_ele_[ele.local_idx()] = region_alpha[r];
+            beta_coef_[ele.local_idx()] = region_coef[r];
+            continue;
+        }
+
+        double alpha_val = alpha.value(elm.centre(), elm);
+        double coef = fixed_stress_coef(alpha_val, young.value(elm.centre(), elm), poisson.value(elm.centre(), elm),
+                elm.dim());
+        alpha_ele_[ele.local_idx()] = alpha_val;
+        beta_coef_[ele.local_idx()] = coef;
+        if (region_constant[r])
+        {
+            region_alpha[r] = alpha_val;
+            region_coef[r] = coef;
+        }
+    }
+    return true;
+}
+
+
 HM_Iterative::HM_Iterative(Mesh &mesh, Input::Record in_record)
 : DarcyFlowInterface(mesh, in_record),
   IterativeCoupling(in_record)
@@ -144,6 +207,8 @@ HM_Iterative::HM_Iterative(Mesh &mesh, Input::Record in_record)
     
     // read parameters controlling the iteration
     beta_ = in_record.val<double>("iteration_parameter");
+    input_beta_ = beta_;
+    adaptive_beta_ = in_record.val<bool>("adaptive_iteration_parameter");
 
     this->eq_data_ = &data_;
     
@@ -170,6 +235,8 @@ void copy_field(const FieldCommon &from_field_common, FieldFE<dim, Value> &to_fi
     
     for ( auto cell : dh->own_range() )
         vec[cell.local_idx()] = from_field.value(cell.elm().centre(), cell.elm());
+    vec.local_to_ghost_begin();
+    vec.local_to_ghost_end();
 }
 
 
@@ -200,6 +267,57 @@ void HM_Iterative::update_solution()
     solve_step();
 }
 
+void HM_Iterative::save_state(CheckpointData &data)
+{
+    EquationBase::save_state(data);
+    {
+        CheckpointData::Scope scope(data, "flow");
+        flow_->save_state(data);
+    }
+    {
+        CheckpointData::Scope scope(data, "mechanics");
+        mechanics_->save_state(data);
+    }
+    for (auto field_ptr : coupling_fields())
+        save_vec(data, field_ptr.first, field_ptr.second->get_data_vec().petsc_vec());
+    data.save("iteration_parameter", beta_);
+}
+
+
+void HM_Iterative::restore_state(CheckpointData &data)
+{
+    EquationBase::restore_state(data);
+    {
+        CheckpointData::Scope scope(data, "flow");
+        flow_->restore_state(data);
+    }
+    {
+        CheckpointData::Scope scope(data, "mechanics");
+        mechanics_->restore_state(data);
+    }
+    for (auto field_ptr : coupling_fields())
+    {
+        restore_vec(data, field_ptr.first, field_ptr.second->get_data_vec().petsc_vec());
+        field_ptr.second->get_data_vec().local_to_ghost_begin();
+        field_ptr.second->get_data_vec().local_to_ghost_end();
+    }
+    if (data.contains("iteration_parameter")) data.load("iteration_parameter", beta_);
+    coupling_parameters_.invalidate();
+}
+
+
+std::vector< std::pair<std::string, std::shared_ptr<FieldFE<3, FieldValue<3>::Scalar> > > > HM_Iterative::coupling_fields()
+{
+    return { {"potential", data_.potential_ptr_},
+             {"beta", data_.beta_ptr_},
+             {"flow_source", data_.flow_source_ptr_},
+             {"old_pressure", data_.old_pressure_ptr_},
+             {"old_iter_pressure", data_.old_iter_pressure_ptr_},
+             {"div_u", data_.div_u_ptr_},
+             {"old_div_u", data_.old_div_u_ptr_} };
+}
+
+
 void HM_Iterative::solve_iteration()
 {
     // pass displacement (divergence) to flow
@@ -216,8 +334,43 @@ void HM_Iterative::solve_iteration()
 void HM_Iterative::update_after_iteration()
 {
     mechanics_->update_output_fields();
+
+    // Iterated quantities are pressure and divergence of displacement, the residual is measured by pressure.
+    auto pressure_vec = data_.old_iter_pressure_ptr_->get_data_vec();
+    auto div_u_vec = data_.div_u_ptr_->get_data_vec();
+    auto dh = data_.beta_ptr_->get_dofhandler();
+    unsigned int n_own = dh->distr()->lsize();
+    std::vector<double> x(2*n_own), g(2*n_own), weights(n_own);
+    for (auto cell : dh->own_range())
+    {
+        unsigned int i = cell.local_idx();
+        x[i] = pressure_vec[i];
+        x[n_own+i] = div_u_vec[i];
+        weights[i] = cell.elm().measure();
+    }
+
+    // pressure of the flow solution was evaluated in compute_iteration_error()
     copy_field(mechanics_->data().output_divergence, *data_.div_u_ptr_);
-    copy_field(*flow_->data().field("pressure_p0"), *data_.old_iter_pressure_ptr_);
+    for (unsigned int i=0; i<n_own; i++)
+    {
+        pressure_vec[i] = new_iter_pressure_[i];
+        g[i] = new_iter_pressure_[i];
+        g[n_own+i] = div_u_vec[i];
+    }
+
+    acceleration_.update(x, g, weights);
+    if (acceleration_.method() != IterationAcceleration::none)
+    {
+        for (unsigned int i=0; i<n_own; i++)
+        {
+            pressure_vec[i] = g[i];
+            div_u_vec[i] = g[n_own+i];
+        }
+    }
+    pressure_vec.local_to_ghost_begin();
+    pressure_vec.local_to_ghost_end();
+    div_u_vec.local_to_ghost_begin();
+    div_u_vec.local_to_ghost_end();
 }
 
 
@@ -229,6 +382,23 @@ void HM_Iterative::update_after_converged()
     
     copy_field(*flow_->data().field("pressure_p0"), *data_.old_pressure_ptr_);
     copy_field(mechanics_->data().output_divergence, *data_.old_div_u_ptr_);
+
+    if (adaptive_beta_ && iteration() > 2)
+    {
+        // Oscillating iterations indicate too weak stabilization, slow monotone convergence too strong one.
+        double correlation = acceleration_.residual_correlation();
+        double new_beta = beta_;
+        if (correlation < -0.2)
+            new_beta *= 1.25;
+        else if (correlation > 0.5 && acceleration_.residual_ratio() > 0.5)
+            new_beta *= 0.8;
+        new_beta = std::max(0.25*input_beta_, std::min(4*input_beta_, new_beta));
+        if (new_beta != beta_)
+        {
+            MessageOut().fmt("HM iteration parameter changed from {} to {}.\n", beta_, new_beta);
+            beta_ = new_beta;
+        }
+    }
 }
 
 
@@ -259,32 +429,53 @@ void HM_Iterative::update_potential()
 }
 
 
+void HM_Iterative::flow_coupling_terms(unsigned int n, double beta_param, double dt, const double *coef,
+        const double *alpha, const double *p, const double *old_p, const double *div_u, const double *old_div_u,
+        double *beta, double *src)
+{
+    const double inv_dt = 1.0 / dt;
+    for (unsigned int i=0; i<n; i++)
+    {
+        beta[i] = beta_param * coef[i];
+        src[i] = (beta[i]*(p[i]-old_p[i]) + alpha[i]*(old_div_u[i] - div_u[i])) * inv_dt;
+    }
+}
+
+
+void HM_Iterative::update_coupling_parameters()
+{
+    if (coupling_parameters_.is_current(time_->step())) return;
+
+    auto &mech_data = mechanics_->data();
+    mech_data.set_time(time_->step(), LimitSide::right);
+    coupling_parameters_.update(time_->step(), data_.alpha, mech_data.young_modulus, mech_data.poisson_ratio,
+            data_.beta_ptr_->get_dofhandler());
+}
+
+
 void HM_Iterative::update_flow_fields()
 {
+    update_coupling_parameters();
+
+    // P0 fields share the DOF handler, local DOF index is the local element index
     auto beta_vec = data_.beta_ptr_->get_data_vec();
     auto src_vec = data_.flow_source_ptr_->get_data_vec();
-    auto dh = data_.beta_ptr_->get_dofhandler();
-    Field<3,FieldValue<3>::Scalar> field_ele_pressure;
-    field_ele_pressure.copy_from(*flow_->data().field("pressure_p0"));
-    for ( auto ele : dh->local_range() )
-    {
-        auto elm = ele.elm();
-        
-        double alpha = data_.alpha.value(elm.centre(), elm);
-        double young = mechanics_->data().young_modulus.value(elm.centre(), elm);
-        double poisson = mechanics_->data().poisson_ratio.value(elm.centre(), elm);
-        double beta = beta_ * 0.5*alpha*alpha/(2*lame_mu(young, poisson)/elm.dim() + lame_lambda(young, poisson));
-        
-        double old_p = data_.old_pressure_ptr_->value(elm.centre(), elm);
-        double p = field_ele_pressure.value(elm.centre(), elm);
-        double div_u = data_.div_u_ptr_->value(elm.centre(), elm);
-        double old_div_u = data_.old_div_u_ptr_->value(elm.centre(), elm);
-        double src = (beta*(p-old_p) + alpha*(old_div_u - div_u)) / time_->dt();
-        
-        beta_vec[ele.local_idx()] = beta;
-        src_vec[ele.local_idx()] = src;
-    }
-    
+    auto old_p_vec = data_.old_pressure_ptr_->get_data_vec();
+    // pressure of the last iteration (possibly modified by the acceleration)
+    auto p_vec = data_.old_iter_pressure_ptr_->get_data_vec();
+    auto div_u_vec = data_.div_u_ptr_->get_data_vec();
+    auto old_div_u_vec = data_.old_div_u_ptr_->get_data_vec();
+
+    double *beta = beta_vec.data().data();
+    double *src = src_vec.data().data();
+    const double *old_p = old_p_vec.data().data();
+    const double *p = p_vec.data().data();
+    const double *div_u = div_u_vec.data().data();
+    const double *old_div_u = old_div_u_vec.data().data();
+    const std::vector<double> &coef = coupling_parameters_.coef();
+    flow_coupling_terms(coef.size(), beta_, time_->dt(), coef.data(), coupling_parameters_.alpha().data(),
+            p, old_p, div_u, old_div_u, beta, src);
+
     data_.beta.set_time_result_changed();
     data_.flow_source.set_time_result_changed();
     flow_->set_extra_storativity(data_.beta);
@@ -295,14 +486,16 @@ void HM_Iterative::update_flow_fields()
 void HM_Iterative::compute_iteration_error(double& abs_error, double& rel_error)
 {
     auto dh = data_.beta_ptr_->get_dofhandler();
+    auto old_iter_pressure_vec = data_.old_iter_pressure_ptr_->get_data_vec();
+    const Field<3,FieldValue<3>::Scalar> &field_ele_pressure = flow_->data().field_ele_pressure;
+    new_iter_pressure_.resize(dh->distr()->lsize());
     double p_dif2 = 0, p_norm2 = 0;
-    Field<3,FieldValue<3>::Scalar> field_ele_pressure;
-    field_ele_pressure.copy_from(*flow_->data().field("pressure_p0"));
     for (auto cell : dh->own_range())
     {
         auto elm = cell.elm();
         double new_p = field_ele_pressure.value(elm.centre(), elm);
-        double old_p = data_.old_iter_pressure_ptr_->value(elm.centre(), elm);
+        double old_p = old_iter_pressure_vec[cell.local_idx()];
+        new_iter_pressure_[cell.local_idx()] = new_p;
         p_dif2 += pow(new_p - old_p, 2)*elm.measure();
         p_norm2 += pow(old_p, 2)*elm.measure();
     }
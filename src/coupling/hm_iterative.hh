@@ -25,6 +25,8 @@
 #include "input/input_type_forward.hh"
 #include "input/accessors_forward.hh"
 #include "coupling/equation.hh"
+#include "coupling/iteration_acceleration.hh"
+#include "system/sys_profiler.hh"
 #include "flow/darcy_flow_interface.hh"
 #include "mechanics/elasticity.hh"
 
@@ -47,6 +49,12 @@ public:
                     "Absolute tolerance for difference in HM iteration." )
             .declare_key( "r_tol", it::Double(0), it::Default("1e-7"),
                     "Relative tolerance for difference in HM iteration." )
+            .declare_key( "acceleration", IterationAcceleration::get_method_selection_input_type(), it::Default("\"none\""),
+                    "Acceleration of the HM iterations." )
+            .declare_key( "acceleration_depth", it::Integer(1), it::Default("5"),
+                    "Number of previous iterations used by the Anderson acceleration." )
+            .declare_key( "acceleration_relaxation", it::Double(0), it::Default("1"),
+                    "Relaxation of the accelerated iterations (initial relaxation of the Aitken method)." )
             .close();
     }
 
@@ -57,21 +65,30 @@ public:
         max_it_ = in_record.val<unsigned int>("max_it");
         a_tol_ = in_record.val<double>("a_tol");
         r_tol_ = in_record.val<double>("r_tol");
+        acceleration_ = IterationAcceleration(in_record.val<IterationAcceleration::Method>("acceleration"),
+                                              in_record.val<unsigned int>("acceleration_depth"),
+                                              in_record.val<double>("acceleration_relaxation"),
+                                              PETSC_COMM_WORLD);
     }
 
     void solve_step()
     {
+        START_TIMER("HM time step");
         it = 0;
         double abs_error = std::numeric_limits<double>::max();
         double rel_error = std::numeric_limits<double>::max();
+        acceleration_.reset();
 
         while ( it < min_it_ || (abs_error > a_tol_ && rel_error > r_tol_ && it < max_it_) )
         {
+            // number of calls of the timer is the total number of iterations
+            START_TIMER("HM iteration");
             it++;
             solve_iteration();
             compute_iteration_error(abs_error, rel_error);
             update_after_iteration();
         }
+        MessageOut().fmt("HM iterations in time step: {}\n", it);
         update_after_converged();
     }
 
@@ -86,7 +103,7 @@ protected:
     /// Compute absolute and relative error in the solution.
     virtual void compute_iteration_error(double &abs_error, double &rel_error) = 0;
 
-    /// Save data (e.g. solution fields) for the next iteration.
+    /// Save data (e.g. solution fields) for the next iteration, apply the acceleration.
     virtual void update_after_iteration() = 0;
 
     /// Save data after iterations have finished.
@@ -105,6 +122,9 @@ protected:
     /// Relative tolerance for difference between two succeeding iterations.
     double r_tol_;
 
+    /// Acceleration of the iterations, reset at the beginning of every step.
+    IterationAcceleration acceleration_;
+
 private:
 
     /// Iteration index.
@@ -113,6 +133,55 @@ private:
 };
 
 
+/**
+ * @brief Parameters of the fixed-stress coupling on local elements, evaluated once per time step.
+ *
+ * Values are indexed by the local index of elements of the P0 DOF handler of the coupling fields.
+ * Parameters constant on a region are evaluated only once for the region.
+ */
+class HMCouplingParameters {
+public:
+    HMCouplingParameters();
+
+    /// Coefficient 0.5*alpha^2/(2*mu/dim + lambda) of the fixed-stress term, without the iteration parameter.
+    static double fixed_stress_coef(double alpha, double young, double poisson, unsigned int dim);
+
+    /// True if the parameters were evaluated in the time step @p step.
+    inline bool is_current(const TimeStep &step) const
+    { return step_index_ == (int)step.index(); }
+
+    /**
+     * Evaluate Biot coefficient @p alpha and the fixed-stress coefficient from @p young and @p poisson
+     * on local elements of @p dh, unless they are current for @p step. The fields have to be set
+     * to the time of @p step. Returns true if the parameters were evaluated.
+     */
+    bool update(const TimeStep &step, Field<3, FieldValue<3>::Scalar> &alpha, Field<3, FieldValue<3>::Scalar> &young,
+            Field<3, FieldValue<3>::Scalar> &poisson, std::shared_ptr<DOFHandlerMultiDim> dh);
+
+    /// Evaluate the parameters in the next update().
+    inline void invalidate()
+    { step_index_ = -1; }
+
+    /// Biot coefficient on local elements.
+    inline const std::vector<double> &alpha() const
+    { return alpha_ele_; }
+
+    /// Fixed-stress coefficient on local elements.
+    inline const std::vector<double> &coef() const
+    { return beta_coef_; }
+
+private:
+    /// Biot coefficient on local elements.
+    std::vector<double> alpha_ele_;
+
+    /// Coefficient 0.5*alpha^2/(2*mu/dim + lambda) of the fixed-stress term on local elements, without @p beta_.
+    std::vector<double> beta_coef_;
+
+    /// Index of the time step of @p alpha_ele_ and @p beta_coef_, -1 if not evaluated.
+    int step_index_;
+};
+
+
 /**
  * @brief Class for solution of fully coupled flow and mechanics using fixed-stress iterative splitting.
  * 
@@ -156,14 +225,30 @@ public:
     void initialize() override;
     void zero_time_step() override;
     void update_solution() override;
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
     ~HM_Iterative();
 
+    /**
+     * Extra storativity @p beta = beta_param*coef and source (beta*(p-old_p) + alpha*(old_div_u-div_u))/dt
+     * of the flow on @p n elements.
+     */
+    static void flow_coupling_terms(unsigned int n, double beta_param, double dt, const double *coef,
+            const double *alpha, const double *p, const double *old_p, const double *div_u, const double *old_div_u,
+            double *beta, double *src);
+
 private:
     
     void update_potential();
     
     void update_flow_fields();
 
+    /// Evaluate @p coupling_parameters_ for the current time step.
+    void update_coupling_parameters();
+
+    /// Named FE fields of the coupling saved to the checkpoint.
+    std::vector< std::pair<std::string, std::shared_ptr<FieldFE<3, FieldValue<3>::Scalar> > > > coupling_fields();
+
     void solve_iteration() override;
 
     void update_after_iteration() override;
@@ -184,6 +269,18 @@ private:
 
     /// Tuning parameter for iterative splitting.
     double beta_;
+
+    /// Value of @p beta_ given on input.
+    double input_beta_;
+
+    /// Adapt @p beta_ between time steps according to convergence of the iterations.
+    bool adaptive_beta_;
+
+    /// Biot coefficient and fixed-stress coefficient on local elements.
+    HMCouplingParameters coupling_parameters_;
+
+    /// Pressure of the last flow solution on own elements, evaluated in compute_iteration_error().
+    std::vector<double> new_iter_pressure_;
     
 };
 
@@ -0,0 +1,161 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    iteration_acceleration.cc
+ * @brief   Aitken and Anderson acceleration of fixed point iterations.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <armadillo>
+
+#include "coupling/iteration_acceleration.hh"
+#include "input/input_type.hh"
+#include "system/asserts.hh"
+
+
+namespace it = Input::Type;
+
+
+const it::Selection & IterationAcceleration::get_method_selection_input_type() {
+    return it::Selection("IterationAcceleration", "Acceleration of the coupling iterations.")
+        .add_value(none,     "none",     "Plain fixed point iteration.")
+        .add_value(aitken,   "aitken",   "Aitken dynamic relaxation.")
+        .add_value(anderson, "anderson", "Anderson acceleration over the history of iterations.")
+        .close();
+}
+
+
+IterationAcceleration::IterationAcceleration(Method method, unsigned int depth, double relaxation, MPI_Comm comm)
+: method_(method), depth_(depth), relaxation_(relaxation), comm_(comm)
+{
+    this->reset();
+}
+
+
+void IterationAcceleration::reset()
+{
+    has_prev_ = false;
+    f_prev_norm2_ = 0;
+    d_f_.clear();
+    d_x_.clear();
+    omega_ = relaxation_;
+    correlation_ = 0;
+    ratio_ = 0;
+}
+
+
+double IterationAcceleration::local_dot(const std::vector<double> &a, const std::vector<double> &b,
+        const std::vector<double> &weights)
+{
+    double sum = 0;
+    for (unsigned int i=0; i<weights.size(); i++) sum += weights[i]*a[i]*b[i];
+    return sum;
+}
+
+
+void IterationAcceleration::update(const std::vector<double> &x, std::vector<double> &g, const std::vector<double> &weights)
+{
+    ASSERT_EQ(x.size(), g.size());
+    ASSERT_LE(weights.size(), x.size());
+    unsigned int n = x.size();
+
+    std::vector<double> f(n);
+    for (unsigned int i=0; i<n; i++) f[i] = g[i] - x[i];
+
+    if (has_prev_ && method_ == anderson)
+    {
+        std::vector<double> d_f(n), d_x(n);
+        for (unsigned int i=0; i<n; i++)
+        {
+            d_f[i] = f[i] - f_prev_[i];
+            d_x[i] = x[i] - x_prev_[i];
+        }
+        d_f_.push_back(d_f);
+        d_x_.push_back(d_x);
+        if (d_f_.size() > depth_)
+        {
+            d_f_.pop_front();
+            d_x_.pop_front();
+        }
+    }
+
+    // local dot products: (f,f), (f,f_prev), Aitken: (f_prev,df), (df,df), Anderson: (dF,dF), (dF,f)
+    unsigned int m = d_f_.size();
+    std::vector<double> dots(4 + m*m + m, 0.0);
+    dots[0] = local_dot(f, f, weights);
+    if (has_prev_)
+    {
+        dots[1] = local_dot(f, f_prev_, weights);
+        if (method_ == aitken)
+        {
+            std::vector<double> d_f(weights.size());
+            for (unsigned int i=0; i<d_f.size(); i++) d_f[i] = f[i] - f_prev_[i];
+            dots[2] = local_dot(f_prev_, d_f, weights);
+            dots[3] = local_dot(d_f, d_f, weights);
+        }
+    }
+    for (unsigned int i=0; i<m; i++)
+    {
+        for (unsigned int j=0; j<=i; j++)
+            dots[4 + i*m + j] = local_dot(d_f_[i], d_f_[j], weights);
+        dots[4 + m*m + i] = local_dot(d_f_[i], f, weights);
+    }
+    std::vector<double> glob_dots(dots.size());
+    MPI_Allreduce(dots.data(), glob_dots.data(), dots.size(), MPI_DOUBLE, MPI_SUM, comm_);
+
+    // statistics of convergence
+    if (has_prev_ && glob_dots[0] > 0 && f_prev_norm2_ > 0)
+    {
+        correlation_ = glob_dots[1] / std::sqrt(glob_dots[0]*f_prev_norm2_);
+        ratio_ = std::sqrt(glob_dots[0]/f_prev_norm2_);
+    }
+
+    switch (method_)
+    {
+    case aitken:
+        if (has_prev_ && glob_dots[3] > 0)
+            omega_ = std::max(0.01, std::min(10.0, -omega_ * glob_dots[2] / glob_dots[3]));
+        for (unsigned int i=0; i<n; i++) g[i] = x[i] + omega_*f[i];
+        break;
+    case anderson:
+    {
+        for (unsigned int i=0; i<n; i++) g[i] = x[i] + relaxation_*f[i];
+        if (m == 0) break;
+
+        arma::mat a(m, m);
+        arma::vec r(m), gamma;
+        for (unsigned int i=0; i<m; i++)
+        {
+            for (unsigned int j=0; j<=i; j++) a(i,j) = a(j,i) = glob_dots[4 + i*m + j];
+            r(i) = glob_dots[4 + m*m + i];
+        }
+        double trace = arma::trace(a);
+        if (trace <= 0) break;
+        // small regularization for nearly dependent differences
+        a.diag() += 1e-12 * trace / m;
+        if (! arma::solve(gamma, a, r)) break;
+        for (unsigned int k=0; k<m; k++)
+            for (unsigned int i=0; i<n; i++)
+                g[i] -= gamma(k) * (d_x_[k][i] + relaxation_*d_f_[k][i]);
+        break;
+    }
+    default:
+        break;
+    }
+
+    f_prev_ = f;
+    x_prev_ = x;
+    f_prev_norm2_ = glob_dots[0];
+    has_prev_ = true;
+}
@@ -0,0 +1,120 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    iteration_acceleration.hh
+ * @brief   Aitken and Anderson acceleration of fixed point iterations.
+ */
+
+#ifndef ITERATION_ACCELERATION_HH_
+#define ITERATION_ACCELERATION_HH_
+
+#include <deque>
+#include <vector>
+#include "mpi.h"
+#include "input/input_type_forward.hh"
+
+
+/**
+ * @brief Acceleration of the fixed point iteration x_{k+1} = G(x_k) of a coupled problem.
+ *
+ * The caller passes the input @p x of the last iteration and its image g = G(x) (local parts
+ * of distributed vectors), the new input of the iteration is returned in @p g. Residual f = g - x
+ * is measured only on the leading entries of vectors given by the size of the weight vector,
+ * the remaining entries (e.g. other coupling quantities) are combined with the same coefficients.
+ *
+ * - Aitken: dynamic relaxation x_{k+1} = x_k + omega_k f_k,
+ *   omega_k = -omega_{k-1} (f_{k-1}, f_k - f_{k-1}) / |f_k - f_{k-1}|^2.
+ * - Anderson (type II): x_{k+1} = x_k + b f_k - (dX + b dF) gamma, where columns of dX, dF are
+ *   differences of the last @p depth inputs and residuals and gamma minimizes |f_k - dF gamma|.
+ *   Parameter b is the relaxation.
+ *
+ * With relaxation 1 the first iteration after reset() is the plain fixed point step.
+ */
+class IterationAcceleration {
+public:
+    /// Acceleration methods.
+    enum Method {
+        none = 0,
+        aitken = 1,
+        anderson = 2
+    };
+
+    /// Input type of the method selection.
+    static const Input::Type::Selection & get_method_selection_input_type();
+
+    /// Constructor.
+    IterationAcceleration(Method method = none, unsigned int depth = 5, double relaxation = 1.0,
+            MPI_Comm comm = MPI_COMM_WORLD);
+
+    /// Method of the acceleration.
+    inline Method method() const {
+        return method_;
+    }
+
+    /// Forget history of the iterations (e.g. at the beginning of a time step).
+    void reset();
+
+    /**
+     * Compute input of the next iteration from the input @p x of the last iteration and its
+     * result @p g, which is replaced by the new input. Size of @p weights gives the number
+     * of leading entries that form the residual.
+     */
+    void update(const std::vector<double> &x, std::vector<double> &g, const std::vector<double> &weights);
+
+    /**
+     * Correlation (f_k, f_{k-1}) / (|f_k| |f_{k-1}|) of the last two residuals, zero if not available.
+     * Negative values indicate oscillating iterations.
+     */
+    inline double residual_correlation() const {
+        return correlation_;
+    }
+
+    /// Ratio |f_k| / |f_{k-1}| of the last two residuals, zero if not available.
+    inline double residual_ratio() const {
+        return ratio_;
+    }
+
+private:
+    /// Weighted dot product of the leading (local) parts of vectors.
+    static double local_dot(const std::vector<double> &a, const std::vector<double> &b, const std::vector<double> &weights);
+
+    Method method_;
+    unsigned int depth_;
+    double relaxation_;
+    MPI_Comm comm_;
+
+    /// Residual of the last iteration.
+    std::vector<double> f_prev_;
+    /// Squared norm of @p f_prev_.
+    double f_prev_norm2_;
+    /// Input of the last iteration.
+    std::vector<double> x_prev_;
+    /// True if @p f_prev_ and @p x_prev_ are set.
+    bool has_prev_;
+
+    /// Differences of residuals (Anderson).
+    std::deque< std::vector<double> > d_f_;
+    /// Differences of inputs (Anderson).
+    std::deque< std::vector<double> > d_x_;
+
+    /// Relaxation of the last Aitken step.
+    double omega_;
+
+    /// Correlation of the last two residuals.
+    double correlation_;
+    /// Ratio of norms of the last two residuals.
+    double ratio_;
+};
+
+
+#endif /* ITERATION_ACCELERATION_HH_ */
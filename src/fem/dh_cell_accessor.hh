@@ -314,7 +314,7 @@ public:
      */
 	DHEdgeSide(const DHCellSide &cell_side, unsigned int side_idx)
     : dof_handler_(cell_side.dh_cell_accessor_.dof_handler_),
-	  edge_idx_(cell_side.dh_cell_accessor_.elm()->edge_idx(cell_side.side_idx_)),
+	  edge_idx_(cell_side.side().edge_idx()),
 	  side_idx_(side_idx)
     {}
 
@@ -405,7 +405,7 @@ public:
 
     /// This class is implicitly convertible to DHCellSide.
     operator DHCellSide() const {
-        SideIter side = dh_cell_.elm()->neigh_vb[neighb_idx_]->side();
+        SideIter side = dh_cell_.elm().neigh_vb_side(neighb_idx_);
         DHCellAccessor cell = dh_cell_.dof_handler_->cell_accessor_from_element( side->elem_idx() );
         return DHCellSide(cell, side->side_idx());
     }
@@ -414,7 +414,7 @@ private:
     /// Check if cell side of neighbour is not local (allow skip invalid accessors).
     inline bool not_local_cell() {
         return ( dh_cell_.dof_handler_->global_to_local_el_idx_.end() ==
-            dh_cell_.dof_handler_->global_to_local_el_idx_.find((LongIdx)dh_cell_.elm()->neigh_vb[neighb_idx_]->side()->elem_idx()) );
+            dh_cell_.dof_handler_->global_to_local_el_idx_.find((LongIdx)dh_cell_.elm().neigh_vb_side(neighb_idx_)->elem_idx()) );
     }
 
     /// Appropriate cell accessor.
@@ -491,10 +491,9 @@ inline RangeConvert<DHEdgeSide, DHCellSide> DHCellSide::edge_sides() const {
 
 
 inline unsigned int DHCellSide::n_edge_sides() const {
-    unsigned int edge_idx = dh_cell_accessor_.elm()->edge_idx(side_idx_);
-    Edge edg = dh_cell_accessor_.dof_handler_->mesh()->edge(edge_idx);
+    Edge edg = this->side().edge();
     for (uint sid=0; sid<edg.n_sides(); sid++)
-        if ( dh_cell_accessor_.dof_handler_->el_is_local(edg.side(sid)->element().idx()) ) return edg.n_sides();
+        if ( dh_cell_accessor_.dof_handler_->el_is_local(edg.side(sid)->elem_idx()) ) return edg.n_sides();
     return 0;
 }
 
@@ -320,6 +320,8 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
     init_status(node_status, edge_status);
     
     // Distribute dofs on local elements.
+    // DOFs are numbered in order of own cells, i.e. in order of local elements given by the mesh
+    // (possibly reordered by Partitioning::reorder_local_elements).
     dof_indices.resize(cell_starts[cell_starts.size()-1]);
     local_to_global_dof_idx_.reserve(dof_indices.size());
     for (auto cell : this->own_range())
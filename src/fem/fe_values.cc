@@ -18,6 +18,10 @@
  * @author  Jan Stebel
  */
 
+#include <map>
+#include <mutex>
+#include <typeinfo>
+
 #include "fem/mapping_p1.hh"
 #include "quadrature/quadrature.hh"
 #include "fem/element_values.hh"
@@ -157,7 +161,7 @@ void FEValues<spacedim>::initialize(
     // precompute finite element data
     if ( q.dim() == DIM )
     {
-        fe_data = init_fe_data(_fe, q);
+        fe_data = shared_fe_data(_fe, q);
     }
     else if ( q.dim() + 1 == DIM )
     {
@@ -169,7 +173,7 @@ void FEValues<spacedim>::initialize(
             // For each side transform the side quadrature points to the cell quadrature points
             // and then precompute side_fe_data.
             for (unsigned int pid = 0; pid < RefElement<DIM>::n_side_permutations; pid++)
-                side_fe_data[sid][pid] = init_fe_data(_fe, q.make_from_side<DIM>(sid,pid));
+                side_fe_data[sid][pid] = shared_fe_data(_fe, q.make_from_side<DIM>(sid,pid));
         }
     }
     else
@@ -264,6 +268,82 @@ std::shared_ptr<typename FEValues<spacedim>::FEInternalData> FEValues<spacedim>:
 }
 
 
+template<unsigned int spacedim>
+struct FEValues<spacedim>::SharedDataRegistry
+{
+    /// Names of FE and function space types and numbers identifying the FE and the quadrature.
+    typedef std::pair<std::string, std::vector<double> > Key;
+
+    std::mutex mutex;
+    std::map<Key, std::weak_ptr<const FEInternalData> > data;
+};
+
+
+template<unsigned int spacedim>
+typename FEValues<spacedim>::SharedDataRegistry &FEValues<spacedim>::shared_data_registry()
+{
+    static SharedDataRegistry registry;
+    return registry;
+}
+
+
+template<unsigned int spacedim>
+unsigned int FEValues<spacedim>::n_shared_fe_data()
+{
+    SharedDataRegistry &registry = shared_data_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    unsigned int n = 0;
+    for (auto &item : registry.data)
+        if (! item.second.expired()) n++;
+    return n;
+}
+
+
+template<unsigned int spacedim>
+template<unsigned int DIM>
+std::shared_ptr<const typename FEValues<spacedim>::FEInternalData> FEValues<spacedim>::shared_fe_data(const FiniteElement<DIM> &fe, const Quadrature &q)
+{
+    // shape functions are given by the raw basis of the function space and the node matrix,
+    // dofs distinguish components of vector valued and mixed elements
+    typename SharedDataRegistry::Key key;
+    key.first = std::string(typeid(fe).name()) + ":" + typeid(*fe.function_space_).name();
+    std::vector<double> &numbers = key.second;
+    numbers = { (double)DIM, (double)fe.type_, (double)fe.n_components(), (double)fe.n_dofs(),
+                (double)fe.node_matrix.n_rows, (double)fe.node_matrix.n_cols };
+    numbers.insert(numbers.end(), fe.node_matrix.begin(), fe.node_matrix.end());
+    for (const Dof &dof : fe.dofs_)
+    {
+        numbers.push_back(dof.type);
+        numbers.insert(numbers.end(), dof.coords.begin(), dof.coords.end());
+        numbers.insert(numbers.end(), dof.coefs.begin(), dof.coefs.end());
+    }
+    numbers.push_back(q.size());
+    for (unsigned int i=0; i<q.size(); i++)
+    {
+        arma::vec::fixed<DIM> p = q.point<DIM>(i);
+        numbers.insert(numbers.end(), p.begin(), p.end());
+    }
+
+    SharedDataRegistry &registry = shared_data_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.data.find(key);
+    if (it != registry.data.end())
+    {
+        std::shared_ptr<const FEInternalData> data = it->second.lock();
+        if (data) return data;
+    }
+
+    // drop data no longer used by any FEValues
+    for (auto item = registry.data.begin(); item != registry.data.end(); )
+        if (item->second.expired()) item = registry.data.erase(item);
+        else ++item;
+
+    std::shared_ptr<const FEInternalData> data = init_fe_data(fe, q);
+    registry.data[key] = data;
+    return data;
+}
+
+
 template<unsigned int spacedim>
 double FEValues<spacedim>::shape_value(const unsigned int function_no, const unsigned int point_no)
 {
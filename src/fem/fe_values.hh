@@ -284,6 +284,9 @@ public:
     /// Return dimension of reference space.
     inline unsigned int dim() const
     { return dim_; }
+
+    /// Number of reference data sets (FE on a quadrature) currently shared by FEValues objects.
+    static unsigned int n_shared_fe_data();
     
 
 protected:
@@ -333,6 +336,21 @@ protected:
     /// Precompute finite element data on reference element.
     template<unsigned int DIM>
     std::shared_ptr<FEInternalData> init_fe_data(const FiniteElement<DIM> &fe, const Quadrature &q);
+
+    /**
+     * Return finite element data on reference element shared with other FEValues objects.
+     *
+     * The data are determined by the type, the node matrix and the dofs of @p fe and by the points
+     * of @p q, so equal elements on equal quadratures (e.g. in several equations, for several
+     * substances or assembly threads) are evaluated and stored only once. The data are read only
+     * and live as long as some FEValues uses them.
+     */
+    template<unsigned int DIM>
+    std::shared_ptr<const FEInternalData> shared_fe_data(const FiniteElement<DIM> &fe, const Quadrature &q);
+
+    /// Registry of the shared reference data, see shared_fe_data().
+    struct SharedDataRegistry;
+    static SharedDataRegistry &shared_data_registry();
     
     /**
      * @brief Computes the shape function values and gradients on the actual cell
@@ -405,10 +423,10 @@ protected:
     ViewsCache views_cache_;
 
     /// Precomputed finite element data.
-    std::shared_ptr<FEInternalData> fe_data;
+    std::shared_ptr<const FEInternalData> fe_data;
 
     /// Precomputed FE data (shape functions on reference element) for all sides and permuted quadrature points.
-    std::vector<std::vector<shared_ptr<FEInternalData> > > side_fe_data;
+    std::vector<std::vector<shared_ptr<const FEInternalData> > > side_fe_data;
 };
 
 
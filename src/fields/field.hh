@@ -332,6 +332,15 @@ public:
     /// Implements FieldCommon::cache_update
     void cache_update(ElementCacheMap &cache_map) override;
 
+    /**
+     * Update cache on region where the field is constant in space.
+     *
+     * Value is evaluated only once per region and change of value (given by set_time), it is copied
+     * to the cache points of the region. Update is skipped if the cache content and the value are
+     * same as in the last update.
+     */
+    void cache_update_constant_region(ElementCacheMap &cache_map, unsigned int region_idx, unsigned int region_in_cache);
+
     /// returns reference to FieldValueCache.
     inline const FieldValueCache<typename Value::element_type> &value_cache() const {
         return value_cache_;
@@ -410,6 +419,41 @@ protected:
      */
     FieldValueCache<typename Value::element_type> value_cache_;
 
+    /**
+     * ElementCacheMap::cache_version of last write to @p value_cache_. States of all regions are
+     * invalidated when the cache is written with other version, i.e. by other ElementCacheMap
+     * or after change of its content.
+     */
+    unsigned int value_cache_version_;
+
+    /**
+     * Holds state of @p value_cache_ on one region, used for skipping of cache_update on
+     * regions where field is constant in space and neither value nor cache content changed.
+     */
+    struct RegionCacheState {
+        /// Constructor, sets invalid state.
+        RegionCacheState()
+        : cache_version_(0), value_version_(0), const_value_version_(0) {}
+
+        /// ElementCacheMap::cache_version of last update of the region, valid only if equal to @p value_cache_version_.
+        unsigned int cache_version_;
+        /// Value of @p region_value_version_ of last update of the region.
+        unsigned int value_version_;
+        /// Value of @p region_value_version_ of actual stored constant value of the region.
+        unsigned int const_value_version_;
+        /// Constant value of the region (only for fields constant in space), stored once per region.
+        std::vector<typename Value::element_type> const_value_;
+    };
+
+    /**
+     * Versions of values on individual regions, incremented by set_time if the region field
+     * or its value changes. Starts from 1, value 0 marks invalid state of RegionCacheState.
+     */
+    std::vector<unsigned int> region_value_version_;
+
+    /// States of @p value_cache_ on individual regions.
+    std::vector<RegionCacheState> region_cache_state_;
+
 
 
     template<int dim, class Val>
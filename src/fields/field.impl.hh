@@ -42,7 +42,8 @@
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field()
 : data_(std::make_shared<SharedData>()),
-  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
+  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) ),
+  value_cache_version_(0)
 {
 	// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
 	// this invariant is kept also by n_comp setter
@@ -56,7 +57,8 @@ Field<spacedim,Value>::Field()
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field(const string &name, bool bc)
 : data_(std::make_shared<SharedData>()),
-  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
+  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) ),
+  value_cache_version_(0)
 {
 		// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
 		// this invariant is kept also by n_comp setter
@@ -72,7 +74,8 @@ Field<spacedim,Value>::Field(const string &name, bool bc)
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field(unsigned int component_index, string input_name, string name, bool bc)
 : data_(std::make_shared<SharedData>()),
-  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
+  value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) ),
+  value_cache_version_(0)
 {
 	// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
 	// this invariant is kept also by n_comp setter
@@ -92,7 +95,8 @@ Field<spacedim,Value>::Field(const Field &other)
   data_(other.data_),
   region_fields_(other.region_fields_),
   factories_(other.factories_),
-  value_cache_(other.value_cache_)
+  value_cache_(other.value_cache_),
+  value_cache_version_(0)
 {
 	if (other.no_check_control_field_)
 		no_check_control_field_ =  make_shared<ControlField>(*other.no_check_control_field_);
@@ -126,6 +130,9 @@ Field<spacedim,Value> &Field<spacedim,Value>::operator=(const Field<spacedim,Val
 	factories_ = other.factories_;
 	region_fields_ = other.region_fields_;
 	value_cache_ = other.value_cache_;
+	value_cache_version_ = 0;
+	region_value_version_.clear();
+	region_cache_state_.clear();
 
 	if (other.no_check_control_field_) {
 		no_check_control_field_ =  make_shared<ControlField>(*other.no_check_control_field_);
@@ -293,6 +300,15 @@ bool Field<spacedim, Value>::set_time(const TimeStep &time_step, LimitSide limit
     // read all descriptors satisfying time.ge(input_time)
     update_history(time_step);
     check_initialized_region_fields_();
+    if (region_value_version_.size() != region_fields_.size())
+        region_value_version_.assign(region_fields_.size(), 1);
+
+    // Cache was written with other layout (other ElementCacheMap or its previous content),
+    // data of regions not updated since then are overwritten.
+    if (value_cache_version_ != cache_map.cache_version()) {
+        for (auto &state : region_cache_state_) state.cache_version_ = 0;
+        value_cache_version_ = cache_map.cache_version();
+    }
 
     //
     is_jump_time_=false;
@@ -330,12 +346,16 @@ bool Field<spacedim, Value>::set_time(const TimeStep &time_step, LimitSide limit
         // possibly update field pointer
 
         auto new_ptr = rh.at(i_history).second;
-        if (new_ptr != region_fields_[reg.idx()]) {
+        bool region_changed = (new_ptr != region_fields_[reg.idx()]);
+        if (region_changed) {
             region_fields_[reg.idx()]=new_ptr;
-            set_time_result_ = TimeStatus::changed;
         }
         // let FieldBase implementation set the time
-        if ( new_ptr->set_time(time_step) )  set_time_result_ = TimeStatus::changed;
+        if ( new_ptr->set_time(time_step) )  region_changed = true;
+        if (region_changed) {
+            set_time_result_ = TimeStatus::changed;
+            region_value_version_[reg.idx()]++;
+        }
 
     }
 
@@ -733,6 +753,7 @@ std::shared_ptr< FieldFE<spacedim, Value> > Field<spacedim,Value>::get_field_fe(
 template<int spacedim, class Value>
 void Field<spacedim, Value>::cache_allocate(std::shared_ptr<EvalPoints> eval_points) {
     value_cache_.init(eval_points, ElementCacheMap::n_cached_elements);
+    value_cache_version_ = 0;
 }
 
 
@@ -740,14 +761,65 @@ template<int spacedim, class Value>
 void Field<spacedim, Value>::cache_update(ElementCacheMap &cache_map) {
     auto update_cache_data = cache_map.update_cache_data();
 
+    if (region_cache_state_.size() != region_fields_.size())
+        region_cache_state_.assign(region_fields_.size(), RegionCacheState());
+    if (region_value_version_.size() != region_fields_.size())
+        region_value_version_.assign(region_fields_.size(), 1);
+
+    // Cache was written with other layout (other ElementCacheMap or its previous content),
+    // data of regions not updated since then are overwritten.
+    if (value_cache_version_ != cache_map.cache_version()) {
+        for (auto &state : region_cache_state_) state.cache_version_ = 0;
+        value_cache_version_ = cache_map.cache_version();
+    }
+
     // Call cache_update of FieldAlgoBase descendants
     std::unordered_map<unsigned int, unsigned int>::iterator reg_elm_it;
     for (reg_elm_it=update_cache_data.region_cache_indices_range_.begin(); reg_elm_it!=update_cache_data.region_cache_indices_range_.end(); ++reg_elm_it) {
-        region_fields_[reg_elm_it->first]->cache_update(value_cache_, cache_map, reg_elm_it->first);
+        unsigned int region_idx = reg_elm_it->first;
+        if ( region_fields_[region_idx]->is_constant_in_space() ) {
+            // Other fields (e.g. FieldFE or FieldModel) can change without change of time status,
+            // so they are always updated.
+            this->cache_update_constant_region(cache_map, region_idx, reg_elm_it->second);
+        } else {
+            region_cache_state_[region_idx].cache_version_ = 0;
+            region_fields_[region_idx]->cache_update(value_cache_, cache_map, region_idx);
+        }
     }
 }
 
 
+template<int spacedim, class Value>
+void Field<spacedim, Value>::cache_update_constant_region(ElementCacheMap &cache_map, unsigned int region_idx,
+        unsigned int region_in_cache) {
+    RegionCacheState &state = region_cache_state_[region_idx];
+    unsigned int value_version = region_value_version_[region_idx];
+
+    // Neither value nor layout of cache changed, data in cache are valid.
+    if ( (state.cache_version_ == cache_map.cache_version()) && (state.value_version_ == value_version) ) return;
+
+    auto &update_cache_data = cache_map.update_cache_data();
+    if (state.const_value_version_ != value_version) {
+        // evaluate value once per region and change of the value
+        ElementAccessor<3> elm = mesh()->element_accessor(
+                cache_map.elm_idx_on_position(update_cache_data.region_element_cache_range_[region_in_cache]) );
+        Value value( const_cast<typename Value::return_type &>(region_fields_[region_idx]->value(elm.centre(), elm)) );
+        unsigned int n_items = value_cache_.data().n_rows() * value_cache_.data().n_cols();
+        state.const_value_.assign(value.mem_ptr(), value.mem_ptr() + n_items);
+        state.const_value_version_ = value_version;
+    }
+
+    unsigned int i_cache_el_begin = update_cache_data.region_value_cache_range_[region_in_cache];
+    unsigned int i_cache_el_end = update_cache_data.region_value_cache_range_[region_in_cache+1];
+    Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> mat_value( state.const_value_.data() );
+    for (unsigned int i_cache = i_cache_el_begin; i_cache < i_cache_el_end; ++i_cache)
+        value_cache_.data().set(i_cache) = mat_value;
+
+    state.cache_version_ = cache_map.cache_version();
+    state.value_version_ = value_version;
+}
+
+
 
 
 
@@ -475,15 +475,46 @@ bool FieldFE<spacedim, Value>::set_time(const TimeStep &time) {
 template <int spacedim, class Value>
 void FieldFE<spacedim, Value>::interpolate_gauss(ElementDataCache<double>::ComponentDataPtr data_vec)
 {
+	InterpolationOperator::Key key(dh_->mesh(), dh_->mesh()->n_elements(), this->interpolation_, this->boundary_domain_);
+	std::shared_ptr<InterpolationOperator> interp = ReaderCache::get_interpolation_operator(reader_file_, key);
+	if (interp == nullptr) {
+		interp = this->create_gauss_operator();
+		ReaderCache::set_interpolation_operator(reader_file_, key, interp);
+	}
+
+	START_TIMER("apply_interpolation");
+	ADD_CALLS(interp->n_nonzeros());
+	std::vector<double> elem_value(dh_->max_elem_dofs()); // computed value of one (target) element
+	for (unsigned int row=0; row<interp->n_rows(); ++row) {
+		unsigned int elm_idx = interp->target_elm(row);
+		interp->row_values(row, *data_vec, elem_value.size(), elem_value);
+
+		LocDofVec loc_dofs;
+		if (this->boundary_domain_) loc_dofs = value_handler1_.get_loc_dof_indices(elm_idx);
+		else loc_dofs = dh_->cell_accessor_from_element(elm_idx).get_loc_dof_indices();
+
+		ASSERT_LE_DBG(loc_dofs.n_elem, elem_value.size());
+		for (unsigned int i=0; i < elem_value.size(); i++) {
+			ASSERT_LT_DBG( loc_dofs[i], (int)data_vec_.size());
+			data_vec_[loc_dofs[i]] = elem_value[i] * this->unit_conversion_coefficient_;
+		}
+	}
+	END_TIMER("apply_interpolation");
+}
+
+
+template <int spacedim, class Value>
+std::shared_ptr<InterpolationOperator> FieldFE<spacedim, Value>::create_gauss_operator()
+{
+	START_TIMER("create_gauss_operator");
 	static const unsigned int quadrature_order = 4; // parameter of quadrature
 	std::shared_ptr<Mesh> source_mesh = ReaderCache::get_mesh(reader_file_);
+	std::shared_ptr<InterpolationOperator> interp = std::make_shared<InterpolationOperator>();
 	std::vector<unsigned int> searched_elements; // stored suspect elements in calculating the intersection
+	std::vector<unsigned int> contain_elements; // source elements containing one quadrature point
 	std::vector<arma::vec::fixed<3>> q_points; // real coordinates of quadrature points
 	std::vector<double> q_weights; // weights of quadrature points
 	unsigned int quadrature_size=0; // size of quadrature point and weight vector
-	std::vector<double> sum_val(dh_->max_elem_dofs()); // sum of value of one quadrature point
-	unsigned int elem_count; // count of intersect (source) elements of one quadrature point
-	std::vector<double> elem_value(dh_->max_elem_dofs()); // computed value of one (target) element
 	bool contains; // sign if source element contains quadrature point
 
 	{
@@ -495,7 +526,7 @@ void FieldFE<spacedim, Value>::interpolate_gauss(ElementDataCache<double>::Compo
 
 	for (auto cell : dh_->own_range()) {
 		auto ele = cell.elm();
-		std::fill(elem_value.begin(), elem_value.end(), 0.0);
+		interp->new_row(cell.elm_idx());
 		switch (cell.dim()) {
 		case 0:
 			quadrature_size = 1;
@@ -516,8 +547,7 @@ void FieldFE<spacedim, Value>::interpolate_gauss(ElementDataCache<double>::Compo
 		source_mesh->get_bih_tree().find_bounding_box(ele.bounding_box(), searched_elements);
 
 		for (unsigned int i=0; i<quadrature_size; ++i) {
-			std::fill(sum_val.begin(), sum_val.end(), 0.0);
-			elem_count = 0;
+			contain_elements.clear();
 			for (std::vector<unsigned int>::iterator it = searched_elements.begin(); it!=searched_elements.end(); it++) {
 				ElementAccessor<3> elm = source_mesh->element_accessor(*it);
 				contains=false;
@@ -537,48 +567,64 @@ void FieldFE<spacedim, Value>::interpolate_gauss(ElementDataCache<double>::Compo
 				default:
 					ASSERT(false).error("Invalid element dimension!");
 				}
-				if ( contains ) {
-					// projection point in element
-					unsigned int index = sum_val.size() * (*it);
-					for (unsigned int j=0; j < sum_val.size(); j++) {
-						sum_val[j] += (*data_vec)[index+j];
-					}
-					++elem_count;
-				}
+				if ( contains ) contain_elements.push_back(*it);
 			}
 
-			if (elem_count > 0) {
-				for (unsigned int j=0; j < sum_val.size(); j++) {
-					elem_value[j] += (sum_val[j] / elem_count) * q_weights[i];
-				}
-			}
+			// value in quadrature point is average of values of all source elements containing it
+			for (unsigned int source_idx : contain_elements)
+				interp->add(source_idx, q_weights[i] / contain_elements.size());
 		}
+	}
+	END_TIMER("create_gauss_operator");
+
+	return interp;
+}
+
+
+template <int spacedim, class Value>
+void FieldFE<spacedim, Value>::interpolate_intersection(ElementDataCache<double>::ComponentDataPtr data_vec)
+{
+	Mesh *mesh;
+	if (this->boundary_domain_) mesh = dh_->mesh()->get_bc_mesh();
+	else mesh = dh_->mesh();
+
+	InterpolationOperator::Key key(mesh, mesh->n_elements(), this->interpolation_, this->boundary_domain_);
+	std::shared_ptr<InterpolationOperator> interp = ReaderCache::get_interpolation_operator(reader_file_, key);
+	if (interp == nullptr) {
+		interp = this->create_intersection_operator(mesh);
+		ReaderCache::set_interpolation_operator(reader_file_, key, interp);
+	}
+
+	START_TIMER("apply_interpolation");
+	ADD_CALLS(interp->n_nonzeros());
+	std::vector<double> value(dh_->max_elem_dofs());
+	VectorMPI::VectorDataPtr data_vector = data_vec_.data_ptr();
+	for (unsigned int row=0; row<interp->n_rows(); ++row) {
+		unsigned int elm_idx = interp->target_elm(row);
+		interp->row_values(row, *data_vec, value.size(), value);
 
 		LocDofVec loc_dofs;
-		if (this->boundary_domain_) loc_dofs = value_handler1_.get_loc_dof_indices(cell.elm_idx());
-		else loc_dofs = cell.get_loc_dof_indices();
+		if (this->boundary_domain_) loc_dofs = value_handler1_.get_loc_dof_indices(elm_idx);
+		else loc_dofs = dh_->cell_accessor_from_element(elm_idx).get_loc_dof_indices();
 
-		ASSERT_LE_DBG(loc_dofs.n_elem, elem_value.size());
-		for (unsigned int i=0; i < elem_value.size(); i++) {
-			ASSERT_LT_DBG( loc_dofs[i], (int)data_vec_.size());
-			data_vec_[loc_dofs[i]] = elem_value[i] * this->unit_conversion_coefficient_;
+		ASSERT_LE_DBG(loc_dofs.n_elem, value.size());
+		for (unsigned int i=0; i < value.size(); i++) {
+			(*data_vector)[ loc_dofs[i] ] = value[i];
 		}
 	}
+	END_TIMER("apply_interpolation");
 }
 
 
 template <int spacedim, class Value>
-void FieldFE<spacedim, Value>::interpolate_intersection(ElementDataCache<double>::ComponentDataPtr data_vec)
+std::shared_ptr<InterpolationOperator> FieldFE<spacedim, Value>::create_intersection_operator(Mesh *mesh)
 {
 	std::shared_ptr<Mesh> source_mesh = ReaderCache::get_mesh(reader_file_);
+	std::shared_ptr<InterpolationOperator> interp = std::make_shared<InterpolationOperator>();
 	std::vector<unsigned int> searched_elements; // stored suspect elements in calculating the intersection
-	std::vector<double> value(dh_->max_elem_dofs());
 	double total_measure;
 	double measure = 0;
 
-	Mesh *mesh;
-	if (this->boundary_domain_) mesh = dh_->mesh()->get_bc_mesh();
-	else mesh = dh_->mesh();
 	for (auto elm : mesh->elements_range()) {
 		if (elm.dim() == 3) {
 			xprintf(Err, "Dimension of element in target mesh must be 0, 1 or 2! elm.idx() = %d\n", elm.idx());
@@ -596,8 +642,7 @@ void FieldFE<spacedim, Value>::interpolate_intersection(ElementDataCache<double>
 			source_mesh->get_bih_tree().find_bounding_box(bb, searched_elements);
 		}
 
-		// set zero values of value object
-		std::fill(value.begin(), value.end(), 0.0);
+		interp->new_row(elm.idx());
 		total_measure=0.0;
 
 		START_TIMER("compute_pressure");
@@ -642,39 +687,26 @@ void FieldFE<spacedim, Value>::interpolate_intersection(ElementDataCache<double>
                     }
                 }
 
-				//adds values to value_ object if intersection exists
+				//adds weight of source element if intersection exists
 				if (measure > epsilon) {
-					unsigned int index = value.size() * (*it);
-			        std::vector<double> &vec = *( data_vec.get() );
-			        for (unsigned int i=0; i < value.size(); i++) {
-			        	value[i] += vec[index+i] * measure;
-			        }
+					interp->add(*it, measure);
 					total_measure += measure;
 				}
 			}
 		}
 
-		// computes weighted average, store it to data vector
+		// weights of weighted average
 		if (total_measure > epsilon) {
-			VectorMPI::VectorDataPtr data_vector = data_vec_.data_ptr();
-
-			LocDofVec loc_dofs;
-			if (this->boundary_domain_) loc_dofs = value_handler1_.get_loc_dof_indices(elm.idx());
-			else{
-				DHCellAccessor cell = dh_->cell_accessor_from_element(elm.idx());
-				loc_dofs = cell.get_loc_dof_indices();
-			}
-
-			ASSERT_LE_DBG(loc_dofs.n_elem, value.size());
-			for (unsigned int i=0; i < value.size(); i++) {
-				(*data_vector)[ loc_dofs[i] ] = value[i] / total_measure;
-			}
+			interp->scale_row(1.0 / total_measure);
 		} else {
+			interp->drop_row();
 			WarningOut().fmt("Processed element with idx {} is out of source mesh!\n", elm.idx());
 		}
 		END_TIMER("compute_pressure");
 
 	}
+
+	return interp;
 }
 
 
@@ -39,6 +39,8 @@
 
 #include <memory>
 
+class InterpolationOperator;
+
 
 
 /**
@@ -166,6 +168,12 @@ private:
 	/// Interpolate data (use intersection library) over all elements of target mesh.
 	void interpolate_intersection(ElementDataCache<double>::ComponentDataPtr data_vec);
 
+	/// Create interpolation operator of \p interpolate_gauss, it is computed only once and shared through ReaderCache.
+	std::shared_ptr<InterpolationOperator> create_gauss_operator();
+
+	/// Create interpolation operator of \p interpolate_intersection to elements of given target \p mesh.
+	std::shared_ptr<InterpolationOperator> create_intersection_operator(Mesh *mesh);
+
 	/// Calculate native data over all elements of target mesh.
 	void calculate_native_values(ElementDataCache<double>::ComponentDataPtr data_cache);
 
@@ -35,6 +35,10 @@ using namespace std;
  * This class assumes field python field with @p spacedim arguments containing coordinates of the given point.
  * The field should return  a tuple representing a vector value (possibly of size one for scalar fields)
  *
+ * Vectorized field (key 'vectorized') is called once for the whole list of points. It gets one NumPy array
+ * of shape (n_points, spacedim) that shares memory with the point list (read only) and returns an array of
+ * shape (n_points, n_components). This mode is used in @p value_list and @p cache_update.
+ *
  * TODO:
  * - use rather only one argument - tuple representing the whole point
  * - time fields
@@ -59,12 +63,17 @@ public:
      * Set the file and field to be called.
      * TODO: use FilePath
      */
-    void set_python_field_from_file( const FilePath &file_name, const string &func_name);
+    void set_python_field_from_file( const FilePath &file_name, const string &func_name, bool vectorized = false);
 
     /**
      * Set the source in a string and name of the field to be called.
      */
-    void set_python_field_from_string( const string &python_source, const string &func_name);
+    void set_python_field_from_string( const string &python_source, const string &func_name, bool vectorized = false);
+
+    /**
+     * Store mesh, it is necessary for computing of eval point coordinates in @p cache_update.
+     */
+    void set_mesh(const Mesh *mesh, bool boundary_domain) override;
 
     /**
      * Returns one value in one given point. ResultType can be used to avoid some costly calculation if the result is trivial.
@@ -77,6 +86,13 @@ public:
     virtual void value_list (const Armor::array &point_list, const ElementAccessor<spacedim> &elm,
                        std::vector<typename Value::return_type>  &value_list);
 
+    /**
+     * Overload @p FieldAlgorithmBase::cache_update, all eval points of the region chunk are computed by one
+     * call of vectorized function.
+     */
+    void cache_update(FieldValueCache<typename Value::element_type> &data_cache,
+			ElementCacheMap &cache_map, unsigned int region_idx) override;
+
 
     virtual ~FieldPython();
 
@@ -94,11 +110,42 @@ private:
      */
     inline void set_value(const Point &p, const ElementAccessor<spacedim> &elm, Value &value);
 
+    /**
+     * Call vectorized function for @p n_points points stored consecutively in @p points,
+     * results are stored to @p batch_values_.
+     */
+    void call_vectorized(const double *points, unsigned int n_points);
+
+    /// Copy result of @p call_vectorized in given point to @p value.
+    inline void set_batch_value(unsigned int i_point, Value &value);
+
+    /// Compute real coordinates of eval points of the region chunk of @p cache_map to @p cache_points_.
+    template <unsigned int dim>
+    void add_eval_points(const ElementAccessor<spacedim> &elm, unsigned int i_elm, const ElementCacheMap &cache_map);
+
+    /// Function is called with whole array of points.
+    bool vectorized_;
+
+    /// Mesh used in @p cache_update.
+    const Mesh *mesh_;
+
+    /// Results of last call of vectorized function.
+    std::vector<double> batch_values_;
+
+    /// Coordinates of eval points in @p cache_update.
+    std::vector<double> cache_points_;
+
+    /// Indices of eval points to FieldValueCache in @p cache_update.
+    std::vector<unsigned int> cache_indices_;
+
 #ifdef FLOW123D_HAVE_PYTHON
     PyObject *p_func_;
     PyObject *p_module_;
     mutable PyObject *p_args_;
     mutable PyObject *p_value_;
+    /// Functions numpy.frombuffer and numpy.ascontiguousarray used by vectorized function.
+    PyObject *p_frombuffer_;
+    PyObject *p_ascontiguous_;
 #endif // FLOW123D_HAVE_PYTHON
 
 };
@@ -21,6 +21,11 @@
 
 #include <boost/type_traits.hpp>
 #include "fields/field_python.hh"
+#include "fields/field_value_cache.hh"
+#include "fields/eval_points.hh"
+#include "fem/mapping_p1.hh"
+#include "mesh/ref_element.hh"
+#include "mesh/accessors.hh"
 
 /// Implementation.
 
@@ -43,6 +48,9 @@ const Input::Type::Record & FieldPython<spacedim, Value>::get_input_type()
 		.declare_key("function", it::String(), it::Default::obligatory(),
 				"Function in the given script that returns tuple containing components of the return type.\n"
 				"For NxM tensor values: tensor(row,col) = tuple( M*row + col ).")
+		.declare_key("vectorized", it::Bool(), it::Default("false"),
+				"If true, the function is called once for whole list of points. It gets NumPy array of point coordinates\n"
+				"of shape (n_points, spacedim) and returns array of values of shape (n_points, n_components).")
 		//.declare_key("units", FieldAlgorithmBase<spacedim, Value>::get_field_algo_common_keys(), it::Default::optional(),
 		//		"Definition of unit.")
 		.close();
@@ -58,7 +66,9 @@ const int FieldPython<spacedim, Value>::registrar =
 
 template <int spacedim, class Value>
 FieldPython<spacedim, Value>::FieldPython(unsigned int n_comp)
-: FieldAlgorithmBase<spacedim, Value>( n_comp)
+: FieldAlgorithmBase<spacedim, Value>( n_comp),
+  vectorized_(false),
+  mesh_(nullptr)
 {
 	this->is_constant_in_space_ = false;
 
@@ -67,6 +77,8 @@ FieldPython<spacedim, Value>::FieldPython(unsigned int n_comp)
     p_module_=NULL;
     p_args_=NULL;
     p_value_=NULL;
+    p_frombuffer_=NULL;
+    p_ascontiguous_=NULL;
 #else
     xprintf(UsrErr, "Flow123d compiled without support for Python, FieldPython can not be used.\n");
 #endif // FLOW123D_HAVE_PYTHON
@@ -75,8 +87,9 @@ FieldPython<spacedim, Value>::FieldPython(unsigned int n_comp)
 
 
 template <int spacedim, class Value>
-void FieldPython<spacedim, Value>::set_python_field_from_string(const string &python_source, const string &func_name)
+void FieldPython<spacedim, Value>::set_python_field_from_string(const string &python_source, const string &func_name, bool vectorized)
 {
+    vectorized_ = vectorized;
 #ifdef FLOW123D_HAVE_PYTHON
     p_module_ = PythonLoader::load_module_from_string("python_field_"+func_name, python_source);
     set_func(func_name);
@@ -91,14 +104,15 @@ template <int spacedim, class Value>
 void FieldPython<spacedim, Value>::init_from_input(const Input::Record &rec, const struct FieldAlgoBaseInitData& init_data) {
 	this->init_unit_conversion_coefficient(rec, init_data);
 
+    bool vectorized = rec.val<bool>("vectorized");
     Input::Iterator<string> it = rec.find<string>("script_string");
     if (it) {
-        set_python_field_from_string( *it, rec.val<string>("function") );
+        set_python_field_from_string( *it, rec.val<string>("function"), vectorized );
     } else {
         Input::Iterator<FilePath> it = rec.find<FilePath>("script_file");
         if (! it) xprintf(UsrErr, "Either 'script_string' or 'script_file' has to be specified in PythonField initialization.");
         try {
-            set_python_field_from_file( *it, rec.val<string>("function") );
+            set_python_field_from_file( *it, rec.val<string>("function"), vectorized );
         } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, rec)
     }
 }
@@ -106,8 +120,9 @@ void FieldPython<spacedim, Value>::init_from_input(const Input::Record &rec, con
 
 
 template <int spacedim, class Value>
-void FieldPython<spacedim, Value>::set_python_field_from_file(const FilePath &file_name, const string &func_name)
+void FieldPython<spacedim, Value>::set_python_field_from_file(const FilePath &file_name, const string &func_name, bool vectorized)
 {
+    vectorized_ = vectorized;
 #ifdef FLOW123D_HAVE_PYTHON
     p_module_ = PythonLoader::load_module_from_file( string(file_name) );
     set_func(func_name);
@@ -123,6 +138,19 @@ void FieldPython<spacedim, Value>::set_func(const string &func_name)
 #ifdef FLOW123D_HAVE_PYTHON
 	p_func_ = PythonLoader::get_callable(p_module_, func_name);
 
+    if (vectorized_) {
+        PyObject *p_numpy = PythonLoader::load_module_by_name("numpy");
+        p_frombuffer_ = PythonLoader::get_callable(p_numpy, "frombuffer");
+        p_ascontiguous_ = PythonLoader::get_callable(p_numpy, "ascontiguousarray");
+        Py_DECREF(p_numpy);
+
+        // try field call, checks size of returned array
+        std::vector<double> test_point(spacedim);
+        for(unsigned int i = 0; i < spacedim; i++) test_point[i] = double(i);
+        this->call_vectorized(&test_point[0], 1);
+        return;
+    }
+
     p_args_ = PyTuple_New( spacedim );
 
     // try field call
@@ -172,6 +200,16 @@ void FieldPython<spacedim, Value>::value_list (const Armor::array &point_list, c
 {
 	OLD_ASSERT_EQUAL( point_list.size(), value_list.size() );
     ASSERT_DBG( point_list.n_rows() == spacedim && point_list.n_cols() == 1 ).error("Invalid point size.\n");
+    if (vectorized_) {
+        if (point_list.size() == 0) return;
+        this->call_vectorized(point_list.data_, point_list.size());
+        for(unsigned int i=0; i< point_list.size(); i++) {
+            Value envelope(value_list[i]);
+            this->set_batch_value(i, envelope);
+            envelope.scale(this->unit_conversion_coefficient_);
+        }
+        return;
+    }
     for(unsigned int i=0; i< point_list.size(); i++) {
         Value envelope(value_list[i]);
         OLD_ASSERT( envelope.n_rows()==this->value_.n_rows(),
@@ -208,9 +246,127 @@ void FieldPython<spacedim, Value>::set_value(const Point &p, FMT_UNUSED const El
 
 
 
+template <int spacedim, class Value>
+void FieldPython<spacedim, Value>::call_vectorized(const double *points, unsigned int n_points)
+{
+#ifdef FLOW123D_HAVE_PYTHON
+    // NumPy array shares memory with given points, references are released also if check_error throws
+    PyObjectRef p_buffer( PyMemoryView_FromMemory( (char *)points, n_points * spacedim * sizeof(double), PyBUF_READ ) );
+    PythonLoader::check_error();
+    PyObjectRef p_flat( PyObject_CallFunctionObjArgs(p_frombuffer_, p_buffer.get(), NULL) );
+    PythonLoader::check_error();
+    PyObjectRef p_points( PyObject_CallMethod(p_flat.get(), "reshape", "(II)", n_points, (unsigned int)spacedim) );
+    PythonLoader::check_error();
+
+    PyObjectRef p_result( PyObject_CallFunctionObjArgs(p_func_, p_points.get(), NULL) );
+    PythonLoader::check_error();
+    PyObjectRef p_values( PyObject_CallFunction(p_ascontiguous_, "Os", p_result.get(), "float64") );
+    PythonLoader::check_error();
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(p_values.get(), &view, PyBUF_C_CONTIGUOUS) != 0) PythonLoader::check_error();
+    unsigned int value_size = this->value_.n_rows() * this->value_.n_cols();
+    unsigned int n_values = view.len / sizeof(double);
+    if ( n_values != n_points * value_size ) {
+        PyBuffer_Release(&view);
+    	stringstream ss;
+    	ss << "Vectorized field from the python module: " << PyModule_GetName(p_module_) << " returns " << n_values
+    	   << " values for " << n_points << " points but should return " << n_points * value_size << " values." << endl;
+        THROW( ExcMessage() << EI_Message( ss.str() ));
+    }
+    const double *data = static_cast<const double *>(view.buf);
+    batch_values_.assign(data, data + n_values);
+    PyBuffer_Release(&view);
+#endif // FLOW123D_HAVE_PYTHON
+}
+
+
+template <int spacedim, class Value>
+void FieldPython<spacedim, Value>::set_batch_value(unsigned int i_point, Value &value)
+{
+    unsigned int pos = i_point * value.n_rows() * value.n_cols();
+    for(unsigned int row=0; row < value.n_rows(); row++)
+        for(unsigned int col=0; col < value.n_cols(); col++, pos++)
+            value(row,col) = batch_values_[pos];
+}
+
+
+template <int spacedim, class Value>
+void FieldPython<spacedim, Value>::set_mesh(const Mesh *mesh, FMT_UNUSED bool boundary_domain)
+{
+    mesh_ = mesh;
+}
+
+
+template <int spacedim, class Value>
+template <unsigned int dim>
+void FieldPython<spacedim, Value>::add_eval_points(const ElementAccessor<spacedim> &elm, unsigned int i_elm,
+		const ElementCacheMap &cache_map)
+{
+    std::shared_ptr<EvalPoints> eval_points = cache_map.eval_points();
+    auto elm_map = MappingP1<dim,3>::element_map(elm);
+    for (unsigned int i_ep=0; i_ep<eval_points->size(dim); ++i_ep) {
+        int field_cache_idx = cache_map.get_field_value_cache_index(i_elm, i_ep);
+        if (field_cache_idx < 0) continue; // skip
+        arma::vec3 p = MappingP1<dim,3>::project_unit_to_real(
+                RefElement<dim>::local_to_bary(eval_points->local_point<dim>(i_ep)), elm_map);
+        cache_points_.insert(cache_points_.end(), p.memptr(), p.memptr() + spacedim);
+        cache_indices_.push_back(field_cache_idx);
+    }
+}
+
+
+template <int spacedim, class Value>
+void FieldPython<spacedim, Value>::cache_update(FieldValueCache<typename Value::element_type> &data_cache,
+		ElementCacheMap &cache_map, unsigned int region_idx)
+{
+    ASSERT_PTR(mesh_).error("Null mesh pointer, set_mesh() has to be called before.\n");
+    auto update_cache_data = cache_map.update_cache_data();
+    unsigned int region_in_cache = update_cache_data.region_cache_indices_range_.find(region_idx)->second;
+
+    // collect coordinates of all eval points of the region chunk
+    cache_points_.clear();
+    cache_indices_.clear();
+    for (unsigned int i_elm=update_cache_data.region_element_cache_range_[region_in_cache];
+            i_elm<update_cache_data.region_element_cache_range_[region_in_cache+1]; ++i_elm) {
+        ElementAccessor<spacedim> elm(mesh_, cache_map.elm_idx_on_position(i_elm));
+        switch (elm.dim()) {
+        case 1:
+            this->template add_eval_points<1>(elm, i_elm, cache_map);
+            break;
+        case 2:
+            this->template add_eval_points<2>(elm, i_elm, cache_map);
+            break;
+        case 3:
+            this->template add_eval_points<3>(elm, i_elm, cache_map);
+            break;
+        default:
+            ASSERT(false)(elm.dim()).error("Unsupported element dimension!\n");
+        }
+    }
+    if (cache_indices_.size() == 0) return;
+
+    if (vectorized_) this->call_vectorized(&cache_points_[0], cache_indices_.size());
+    for (unsigned int i=0; i<cache_indices_.size(); ++i) {
+        if (vectorized_) {
+            this->set_batch_value(i, this->value_);
+        } else {
+            Point p;
+            for (unsigned int j=0; j<spacedim; ++j) p[j] = cache_points_[i*spacedim+j];
+            this->set_value(p, ElementAccessor<spacedim>(), this->value_);
+        }
+        this->value_.scale(this->unit_conversion_coefficient_);
+        Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> mat_value( const_cast<typename Value::element_type*>(this->value_.mem_ptr()) );
+        data_cache.data().set(cache_indices_[i]) = mat_value;
+    }
+}
+
+
 template <int spacedim, class Value>
 FieldPython<spacedim, Value>::~FieldPython() {
 #ifdef FLOW123D_HAVE_PYTHON
+    Py_CLEAR(p_frombuffer_);
+    Py_CLEAR(p_ascontiguous_);
     Py_CLEAR(p_module_);
     Py_CLEAR(p_func_);
     Py_CLEAR(p_value_);
@@ -170,6 +170,14 @@ bool FieldSet::changed() const {
 
 
 
+bool FieldSet::multifield_changed() const {
+    for(auto field : field_list)
+        if (field->is_multifield() && field->changed()) return true;
+    return false;
+}
+
+
+
 bool FieldSet::is_constant(Region reg) const {
     bool const_all=true;
     for(auto field : field_list) const_all = const_all && field->is_constant(reg);
@@ -227,6 +227,11 @@ public:
      */
     bool changed() const;
 
+    /**
+     * Return true if some multifield (field with values given for every component) of the set has changed.
+     */
+    bool multifield_changed() const;
+
     /**
      * Collective interface to @p FieldCommonBase::set_mesh().
      */
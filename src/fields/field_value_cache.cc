@@ -17,6 +17,7 @@
  */
 
 #include <limits>
+#include <algorithm>
 #include "fields/field_value_cache.impl.hh"
 #include "fields/field_values.hh"
 #include "fields/eval_points.hh"
@@ -52,10 +53,13 @@ void FieldValueCache<elm_type>::init(std::shared_ptr<EvalPoints> eval_points, un
 
 const unsigned int ElementCacheMap::undef_elem_idx = std::numeric_limits<unsigned int>::max();
 
+unsigned int ElementCacheMap::n_cache_versions_ = 0;
+
 
 ElementCacheMap::ElementCacheMap()
 : elm_idx_(ElementCacheMap::n_cached_elements, ElementCacheMap::undef_elem_idx),
-  ready_to_reading_(false), element_eval_points_map_(nullptr), points_in_cache_(0) {
+  ready_to_reading_(false), element_eval_points_map_(nullptr), points_in_cache_(0),
+  cache_version_(++n_cache_versions_) {
     cache_idx_.reserve(ElementCacheMap::n_cached_elements);
     update_data_.n_elements_ = 0;
 }
@@ -77,6 +81,9 @@ void ElementCacheMap::init(std::shared_ptr<EvalPoints> eval_points) {
 	element_eval_points_map_ = new int* [ElementCacheMap::n_cached_elements];
 	for (unsigned int i=0; i<ElementCacheMap::n_cached_elements; ++i)
 	    element_eval_points_map_[i] = new int [size];
+	last_elm_idx_.assign(ElementCacheMap::n_cached_elements, ElementCacheMap::undef_elem_idx);
+	last_points_map_.assign(ElementCacheMap::n_cached_elements * size, ElementCacheMap::unused_point);
+	cache_version_ = ++n_cache_versions_;
 }
 
 
@@ -136,6 +143,7 @@ void ElementCacheMap::create_elements_points_map() {
         	region_last_elm = update_data_.region_element_cache_range_[idx_to_region];
         }
 	}
+	this->update_cache_version();
 }
 
 
@@ -183,6 +191,23 @@ void ElementCacheMap::add_to_region(ElementAccessor<3> elm) {
 }
 
 
+void ElementCacheMap::update_cache_version() {
+    unsigned int size = this->eval_points_->max_size();
+    bool changed = (elm_idx_ != last_elm_idx_);
+	for (unsigned int i_elm=0; i_elm<ElementCacheMap::n_cached_elements; ++i_elm) {
+	    int *last_points = &last_points_map_[i_elm*size];
+	    if ( !changed && !std::equal(element_eval_points_map_[i_elm], element_eval_points_map_[i_elm]+size, last_points) )
+	        changed = true;
+	    if (changed)
+	        std::copy(element_eval_points_map_[i_elm], element_eval_points_map_[i_elm]+size, last_points);
+	}
+	if (changed) {
+	    last_elm_idx_ = elm_idx_;
+	    cache_version_ = ++n_cache_versions_;
+	}
+}
+
+
 DHCellAccessor & ElementCacheMap::operator() (DHCellAccessor &dh_cell) const {
 	ASSERT_DBG(ready_to_reading_);
 	unsigned int elm_idx = dh_cell.elm_idx();
@@ -239,6 +239,17 @@ public:
         return element_eval_points_map_[elm_idx][loc_point_idx];
     }
 
+    /**
+     * Return version of the cache content.
+     *
+     * Version is changed (to the value unique among all instances) by every update of cache
+     * that changes set of cached elements or their evaluation points. Equal versions guarantee
+     * same layout of FieldValueCache, so data of unchanged fields don't need to be recomputed.
+     */
+    inline unsigned int cache_version() const {
+        return cache_version_;
+    }
+
     /// Return idx of element stored at given position of ElementCacheMap
     inline unsigned int elm_idx_on_position(unsigned pos) const {
         return elm_idx_[pos];
@@ -260,6 +271,9 @@ protected:
     /// Add element to appropriate region data of update_data_ object
     void add_to_region(ElementAccessor<3> elm);
 
+    /// Compare cache content with previous update, set new @p cache_version_ if it differs.
+    void update_cache_version();
+
     /// Vector of element indexes stored in cache.
     /// TODO: could be moved to UpdateCacheHelper structure
     std::vector<unsigned int> elm_idx_;
@@ -298,6 +312,18 @@ protected:
 
     /// Number of points stored in cache
     unsigned int points_in_cache_;
+
+    /// Version of cache content (@see cache_version).
+    unsigned int cache_version_;
+
+    /// Element indices of the previous update, used for detection of changes of cache content.
+    std::vector<unsigned int> last_elm_idx_;
+
+    /// Copy of element_eval_points_map_ of the previous update (flattened).
+    std::vector<int> last_points_map_;
+
+    /// Counter of cache versions shared by all instances.
+    static unsigned int n_cache_versions_;
 };
 
 
@@ -32,6 +32,7 @@
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
+#include "system/checkpoint_data.hh"
 #include "input/factory.hh"
 
 #include "mesh/mesh.h"
@@ -649,6 +650,33 @@ void DarcyLMH::accept_time_step()
 }
 
 
+void DarcyLMH::save_state(CheckpointData &data) {
+    EquationBase::save_state(data);
+    save_vec(data, "solution", data_->full_solution.petsc_vec());
+    save_vec(data, "p_edge_solution", data_->p_edge_solution.petsc_vec());
+    save_vec(data, "p_edge_solution_previous_time", data_->p_edge_solution_previous_time.petsc_vec());
+    output_object->save_state(data);
+}
+
+
+void DarcyLMH::restore_state(CheckpointData &data) {
+    EquationBase::restore_state(data);
+    restore_vec(data, "solution", data_->full_solution.petsc_vec());
+    restore_vec(data, "p_edge_solution", data_->p_edge_solution.petsc_vec());
+    restore_vec(data, "p_edge_solution_previous_time", data_->p_edge_solution_previous_time.petsc_vec());
+    data_->p_edge_solution_previous.copy_from(data_->p_edge_solution);
+
+    data_->full_solution.local_to_ghost_begin();
+    data_->full_solution.local_to_ghost_end();
+    data_->p_edge_solution.local_to_ghost_begin();
+    data_->p_edge_solution.local_to_ghost_end();
+    data_->p_edge_solution_previous_time.local_to_ghost_begin();
+    data_->p_edge_solution_previous_time.local_to_ghost_end();
+    output_object->restore_state(data);
+    data_changed_ = true;
+}
+
+
 void DarcyLMH::output_data() {
     START_TIMER("Darcy output data");
     
@@ -194,6 +194,9 @@ public:
     virtual void postprocess();
     virtual void output_data() override;
 
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
+
 
     EqData &data() { return *data_; }
 
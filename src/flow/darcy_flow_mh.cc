@@ -32,6 +32,7 @@
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
+#include "system/checkpoint_data.hh"
 #include "input/factory.hh"
 
 #include "mesh/mesh.h"
@@ -43,6 +44,7 @@
 #include "la/linsys_PETSC.hh"
 #include "la/linsys_BDDC.hh"
 #include "la/schur.hh"
+#include "la/sparsity_pattern.hh"
 //#include "la/sparse_graph.hh"
 #include "la/local_to_global_map.hh"
 #include "la/vector_mpi.hh"
@@ -745,6 +747,25 @@ void DarcyMH::postprocess()
 }
 
 
+void DarcyMH::save_state(CheckpointData &data) {
+    EquationBase::save_state(data);
+    save_vec(data, "solution", data_->full_solution.petsc_vec());
+    save_vec(data, "previous_solution", previous_solution);
+    output_object->save_state(data);
+}
+
+
+void DarcyMH::restore_state(CheckpointData &data) {
+    EquationBase::restore_state(data);
+    restore_vec(data, "solution", data_->full_solution.petsc_vec());
+    restore_vec(data, "previous_solution", previous_solution);
+    data_->full_solution.local_to_ghost_begin();
+    data_->full_solution.local_to_ghost_end();
+    output_object->restore_state(data);
+    data_changed_ = true;
+}
+
+
 void DarcyMH::output_data() {
     START_TIMER("Darcy output data");
     
@@ -803,11 +824,10 @@ void DarcyMH::allocate_mh_matrix()
 
     // set auxiliary flag for switchting Dirichlet like BC
     data_->n_schur_compls = n_schur_compls;
-    LinSys *ls = schur0;
 
-    // to make space for second schur complement, max. 10 neighbour edges of one el.
-    double zeros[100000];
-    for(int i=0; i<100000; i++) zeros[i] = 0.0;
+    // pattern is built directly from the DOF connectivity, without the allocation pass through the linear system
+    const Distribution &ds = *data_->dh_->distr();
+    auto pattern = std::make_shared<SparsityPattern>(ds.lsize());
 
     std::vector<LongIdx> tmp_rows;
     tmp_rows.reserve(200);
@@ -824,7 +844,7 @@ void DarcyMH::allocate_mh_matrix()
         dh_cell.get_dof_indices(dofs);
         
         // whole local MH matrix
-        ls->mat_set_values(ndofs, dofs.data(), ndofs, dofs.data(), zeros);
+        pattern->add_entries(ds, ndofs, dofs.data(), ndofs, dofs.data());
 
         tmp_rows.clear();
 
@@ -852,9 +872,9 @@ void DarcyMH::allocate_mh_matrix()
         const uint nsides = ele->n_sides();
         LongIdx * edge_rows = dofs.data() + nsides; // pointer to start of ele
         // allocate always also for schur 2
-        ls->mat_set_values(nsides+1, edge_rows, n_neighs, tmp_rows.data(), zeros); // (edges, ele)  x (neigh edges)
-        ls->mat_set_values(n_neighs, tmp_rows.data(), nsides+1, edge_rows, zeros); // (neigh edges) x (edges, ele)
-        ls->mat_set_values(n_neighs, tmp_rows.data(), n_neighs, tmp_rows.data(), zeros);  // (neigh edges) x (neigh edges)
+        pattern->add_entries(ds, nsides+1, edge_rows, n_neighs, tmp_rows.data()); // (edges, ele)  x (neigh edges)
+        pattern->add_entries(ds, n_neighs, tmp_rows.data(), nsides+1, edge_rows); // (neigh edges) x (edges, ele)
+        pattern->add_entries(ds, n_neighs, tmp_rows.data(), n_neighs, tmp_rows.data());  // (neigh edges) x (neigh edges)
 
         tmp_rows.clear();
 
@@ -882,9 +902,9 @@ void DarcyMH::allocate_mh_matrix()
         }*/
 
         edge_rows = dofs.data() + nsides +1; // pointer to start of edges
-        ls->mat_set_values(nsides, edge_rows, tmp_rows.size(), tmp_rows.data(), zeros);   // master edges x neigh edges
-        ls->mat_set_values(tmp_rows.size(), tmp_rows.data(), nsides, edge_rows, zeros);   // neigh edges  x master edges
-        ls->mat_set_values(tmp_rows.size(), tmp_rows.data(), tmp_rows.size(), tmp_rows.data(), zeros);  // neigh edges  x neigh edges
+        pattern->add_entries(ds, nsides, edge_rows, tmp_rows.size(), tmp_rows.data());   // master edges x neigh edges
+        pattern->add_entries(ds, tmp_rows.size(), tmp_rows.data(), nsides, edge_rows);   // neigh edges  x master edges
+        pattern->add_entries(ds, tmp_rows.size(), tmp_rows.data(), tmp_rows.size(), tmp_rows.data());  // neigh edges  x neigh edges
 
     }
 /*
@@ -908,6 +928,9 @@ void DarcyMH::allocate_mh_matrix()
     } else if (mortar_method_ == MortarP1) {
         P1_CouplingAssembler(*this).assembly(*ls);
     }*/
+
+    pattern->assemble(ds);
+    static_cast<LinSys_PETSC *>(schur0)->set_sparsity_pattern(pattern);
 }
 
 void DarcyMH::assembly_source_term()
@@ -1041,9 +1064,8 @@ void DarcyMH::create_linear_system(Input::AbstractRecord in_rec) {
 
             START_TIMER("PETSC PREALLOCATION");
             schur0->set_symmetric();
-            schur0->start_allocation();
-            
             allocate_mh_matrix();
+            schur0->start_allocation();
             
     	    VecZeroEntries(schur0->get_solution());
             END_TIMER("PETSC PREALLOCATION");
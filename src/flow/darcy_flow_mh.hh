@@ -244,6 +244,9 @@ public:
     virtual void postprocess();
     virtual void output_data() override;
 
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
+
     EqData &data() { return *data_; }
     
     void set_extra_storativity(const Field<3, FieldValue<3>::Scalar> &extra_stor)
@@ -299,7 +302,8 @@ protected:
     //virtual void local_assembly_specific(AssemblyData &local_data);
    
     /**
-     * Allocates linear system matrix for MH.
+     * Builds the sparsity pattern of the MH matrix from the connectivity of DOFs and sets it
+     * to the linear system, which then skips its own allocation pass.
      * TODO:
      * - use general preallocation methods in DofHandler
      */
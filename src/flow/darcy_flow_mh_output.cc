@@ -234,6 +234,18 @@ DarcyFlowMHOutput::~DarcyFlowMHOutput()
 
 
 
+void DarcyFlowMHOutput::save_state(CheckpointData &data)
+{
+    output_stream->save_state(data);
+}
+
+
+void DarcyFlowMHOutput::restore_state(CheckpointData &data)
+{
+    output_stream->restore_state(data);
+}
+
+
 //=============================================================================
 // CONVERT SOLUTION, CALCULATE BALANCES, ETC...
 //=============================================================================
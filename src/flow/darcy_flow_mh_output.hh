@@ -42,6 +42,7 @@
 #include "petscvec.h"                    // for Vec, _p_Vec
 #include "system/exceptions.hh"          // for ExcAssertMsg::~ExcAssertMsg
 
+class CheckpointData;
 class DOFHandlerMultiDim;
 class DarcyFlowInterface;
 class Mesh;
@@ -103,6 +104,12 @@ public:
     /** \brief Calculate values for output.  **/
     void output();
 
+    /// Save state of the output stream (observe data) to the checkpoint.
+    void save_state(CheckpointData &data);
+
+    /// Restore state of the output stream saved by @p save_state.
+    void restore_state(CheckpointData &data);
+
     //const OutputFields &get_output_fields() { return output_fields; }
 
 
@@ -9,6 +9,7 @@
 #include "system/global_defs.h"
 #include "system/sys_profiler.hh"
 #include "system/asserts.hh"
+#include "system/checkpoint_data.hh"
 
 #include "coupling/balance.hh"
 
@@ -180,6 +181,20 @@ void RichardsLMH::accept_time_step()
     data_->p_edge_solution_previous_time.local_to_ghost_end();
 }
 
+void RichardsLMH::save_state(CheckpointData &data)
+{
+    DarcyLMH::save_state(data);
+    save_vec(data, "water_content_previous_time", data_->water_content_previous_time.petsc_vec());
+}
+
+void RichardsLMH::restore_state(CheckpointData &data)
+{
+    DarcyLMH::restore_state(data);
+    restore_vec(data, "water_content_previous_time", data_->water_content_previous_time.petsc_vec());
+    data_->water_content_previous_time.local_to_ghost_begin();
+    data_->water_content_previous_time.local_to_ghost_end();
+}
+
 bool RichardsLMH::zero_time_term(bool time_global) {
     if (time_global) {
         return (data_->storativity.input_list_size() == 0)
@@ -97,6 +97,9 @@ public:
     static const Input::Type::Record & get_input_type();
     
     void accept_time_step() override;
+
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
     
 protected:
     /// Registrar of class to factory
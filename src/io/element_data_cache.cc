@@ -111,6 +111,19 @@ void ElementDataCache<T>::read_binary_data(std::istream &data_stream, unsigned i
 }
 
 
+template <typename T>
+void ElementDataCache<T>::set_row_data(const double *row_data, unsigned int n_components, unsigned int i_row) {
+	unsigned int idx;
+	for (unsigned int i_vec=0; i_vec<data_.size(); ++i_vec) {
+		idx = i_row * n_components;
+		std::vector<T> &vec = *( data_[i_vec].get() );
+		for (unsigned int i_col=0; i_col < n_components; ++i_col, ++idx, ++row_data) {
+			vec[idx] = static_cast<T>(*row_data);
+		}
+	}
+}
+
+
 /**
  * Output data element on given index @p idx. Method for writing data
  * to output stream.
@@ -196,6 +209,16 @@ void ElementDataCache<T>::print_yaml_subarray(ostream &out_stream, unsigned int
 }
 
 
+template <typename T>
+void ElementDataCache<T>::print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end)
+{
+	ASSERT_LE(end, this->n_values_);
+	std::vector<T> &vec = *( this->data_[0].get() );
+	if (begin < end)
+		out_stream.write(reinterpret_cast<const char*>(&(vec[n_comp_*begin])), n_comp_ * (end-begin) * sizeof(T));
+}
+
+
 template <typename T>
 void ElementDataCache<T>::get_min_max_range(double &min, double &max)
 {
@@ -97,6 +97,9 @@ public:
 	/// Implements @p ElementDataCacheBase::read_binary_data.
 	void read_binary_data(std::istream &data_stream, unsigned int n_components, unsigned int i_row) override;
 
+	/// Implements @p ElementDataCacheBase::set_row_data.
+	void set_row_data(const double *row_data, unsigned int n_components, unsigned int i_row) override;
+
     /**
      * Output data element on given index @p idx. Method for writing data
      * to output stream.
@@ -121,6 +124,9 @@ public:
 
     void print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end) override;
 
+    /// Implements @p ElementDataCacheBase::print_binary_subarray.
+    void print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end) override;
+
     /**
      * Store data element of given data value under given index.
      */
@@ -78,6 +78,11 @@ public:
 	 */
 	virtual void read_binary_data(std::istream &data_stream, unsigned int n_components, unsigned int i_row)=0;
 
+	/**
+	 * Set data of given \p i_row from array of already parsed values (n_components values for every stored vector)
+	 */
+	virtual void set_row_data(const double *row_data, unsigned int n_components, unsigned int i_row)=0;
+
     /**
      * Print one value at given index in ascii format
      */
@@ -99,6 +104,12 @@ public:
      */
     virtual void print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end) = 0;
 
+    /**
+     * Print stored values of given range in the binary format (without data size).
+     * Used for binary output of observe values.
+     */
+    virtual void print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end) = 0;
+
     /**
      * Find minimal and maximal range of stored data
      */
@@ -295,6 +306,11 @@ public:
     void print_yaml_subarray(ostream &, unsigned int, unsigned int , unsigned int) override
     {}
 
+    void print_binary_subarray(ostream &, unsigned int, unsigned int) override
+    {
+        ASSERT(false).error("Not implemented.");
+    }
+
     void get_min_max_range(double &, double &) override
     {}
 
@@ -304,6 +320,9 @@ public:
     void read_binary_data(std::istream &, unsigned int, unsigned int) override
     {}
 
+    void set_row_data(const double *, unsigned int, unsigned int) override
+    {}
+
     std::shared_ptr< ElementDataCacheBase > gather(Distribution *, LongIdx *) override
     {
     	return std::make_shared<DummyElementDataCache>(this->field_input_name_, this->n_comp_);
@@ -0,0 +1,149 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    element_data_lru.hh
+ * @brief   Least recently used cache of decoded element data of input files.
+ */
+
+#ifndef ELEMENT_DATA_LRU_HH_
+#define ELEMENT_DATA_LRU_HH_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+class ElementDataCacheBase;
+
+
+/**
+ * Least recently used cache of decoded data arrays of input files with limited memory budget.
+ *
+ * Reader keeps only data of last read time of every field (see BaseMeshReader::element_data_values_).
+ * If a field is evaluated alternately in more times (e.g. several equations with different time steps
+ * read data of the same file), every switch of time leads to repeated parsing (and decompression)
+ * of the data section. Decoded arrays are therefore stored here and reused until they are evicted
+ * by newer data. Memory budget is given in bytes, zero budget switches the cache off.
+ */
+class ElementDataLRU {
+public:
+	/**
+	 * Identification of decoded data: reader id, field name, time, number of components,
+	 * number of entities, boundary flag, name of value type.
+	 *
+	 * Data depend on mapping of elements of reader to target mesh, therefore the reader is
+	 * identified instead of the file.
+	 */
+	typedef std::tuple<unsigned int, std::string, double, unsigned int, unsigned int, bool, std::string> Key;
+
+	/// Constructor
+	ElementDataLRU(std::size_t capacity = 0)
+	: capacity_(capacity), size_(0), n_hits_(0), n_misses_(0) {}
+
+	/// Set memory budget in bytes, data over the new budget are evicted.
+	inline void set_capacity(std::size_t capacity) {
+		capacity_ = capacity;
+		this->evict();
+	}
+
+	/// Memory budget in bytes.
+	inline std::size_t capacity() const {
+		return capacity_;
+	}
+
+	/// Memory occupied by stored data in bytes.
+	inline std::size_t size() const {
+		return size_;
+	}
+
+	/// Number of stored data arrays.
+	inline unsigned int n_items() const {
+		return items_.size();
+	}
+
+	/// Number of successful calls of get.
+	inline unsigned int n_hits() const {
+		return n_hits_;
+	}
+
+	/// Number of unsuccessful calls of get.
+	inline unsigned int n_misses() const {
+		return n_misses_;
+	}
+
+	/// Returns stored data of given key and mark them as most recently used, or nullptr.
+	std::shared_ptr<ElementDataCacheBase> get(const Key &key) {
+		auto it = index_.find(key);
+		if (it == index_.end()) {
+			++n_misses_;
+			return nullptr;
+		}
+		++n_hits_;
+		items_.splice(items_.begin(), items_, it->second);
+		return it->second->data;
+	}
+
+	/// Store data of given size, least recently used data are evicted if the budget is exceeded.
+	void put(const Key &key, std::shared_ptr<ElementDataCacheBase> data, std::size_t n_bytes) {
+		if (n_bytes > capacity_) return; // data never fit to the cache
+		auto it = index_.find(key);
+		if (it != index_.end()) {
+			size_ -= it->second->n_bytes;
+			items_.erase(it->second);
+			index_.erase(it);
+		}
+		items_.push_front( Item{key, data, n_bytes} );
+		index_[key] = items_.begin();
+		size_ += n_bytes;
+		this->evict();
+	}
+
+	/// Remove all data.
+	void clear() {
+		items_.clear();
+		index_.clear();
+		size_ = 0;
+	}
+
+private:
+	/// Stored data array.
+	struct Item {
+		Key key;
+		std::shared_ptr<ElementDataCacheBase> data;
+		std::size_t n_bytes;
+	};
+
+	/// Evict least recently used data over the budget.
+	void evict() {
+		while (size_ > capacity_) {
+			size_ -= items_.back().n_bytes;
+			index_.erase(items_.back().key);
+			items_.pop_back();
+		}
+	}
+
+	/// Memory budget in bytes.
+	std::size_t capacity_;
+	/// Sum of sizes of stored data.
+	std::size_t size_;
+	/// Stored data ordered from most to least recently used.
+	std::list<Item> items_;
+	/// Map of keys to items.
+	std::map< Key, std::list<Item>::iterator > index_;
+	/// Statistics of get calls.
+	unsigned int n_hits_, n_misses_;
+};
+
+
+#endif /* ELEMENT_DATA_LRU_HH_ */
@@ -0,0 +1,127 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    interpolation_operator.hh
+ * @brief   Sparse source-to-target interpolation operator of elementwise data.
+ */
+
+#ifndef INTERPOLATION_OPERATOR_HH_
+#define INTERPOLATION_OPERATOR_HH_
+
+#include <vector>
+#include <tuple>
+#include "system/asserts.hh"
+
+class Mesh;
+
+
+/**
+ * Interpolation operator from elements of a source mesh to elements of a target mesh in CSR format.
+ *
+ * Every row belongs to one target element (index stored in @p target_elm_), columns are indices
+ * of source elements and values are their weights. The operator depends only on geometry of both
+ * meshes, so it is assembled once and every further time frame of the source data is interpolated
+ * by one sparse matrix-vector product. Weights are independent of the number of components, data
+ * of one source element are expected in consecutive block of size @p n_comp.
+ */
+class InterpolationOperator {
+public:
+	/**
+	 * Identification of the target: target mesh, its number of elements (guards against reuse
+	 * of the address by other mesh), type of interpolation, boundary flag.
+	 */
+	typedef std::tuple<const Mesh *, unsigned int, unsigned int, bool> Key;
+
+	/// Constructor
+	InterpolationOperator()
+	: row_ptr_(1, 0) {}
+
+	/// Start new row of target element @p elm_idx.
+	inline void new_row(unsigned int elm_idx) {
+		target_elm_.push_back(elm_idx);
+		row_ptr_.push_back(row_ptr_.back());
+	}
+
+	/// Add @p weight of source element @p source_idx to the last row, repeated source elements are summed.
+	inline void add(unsigned int source_idx, double weight) {
+		ASSERT_GT_DBG(target_elm_.size(), 0);
+		for (unsigned int k=row_ptr_[row_ptr_.size()-2]; k<row_ptr_.back(); ++k)
+			if (col_idx_[k] == source_idx) {
+				weights_[k] += weight;
+				return;
+			}
+		col_idx_.push_back(source_idx);
+		weights_.push_back(weight);
+		++row_ptr_.back();
+	}
+
+	/// Multiply all weights of the last row by @p coef.
+	inline void scale_row(double coef) {
+		ASSERT_GT_DBG(target_elm_.size(), 0);
+		for (unsigned int k=row_ptr_[row_ptr_.size()-2]; k<row_ptr_.back(); ++k) weights_[k] *= coef;
+	}
+
+	/// Remove last row (e.g. target element doesn't intersect source mesh).
+	inline void drop_row() {
+		ASSERT_GT_DBG(target_elm_.size(), 0);
+		row_ptr_.pop_back();
+		col_idx_.resize(row_ptr_.back());
+		weights_.resize(row_ptr_.back());
+		target_elm_.pop_back();
+	}
+
+	/// Number of rows.
+	inline unsigned int n_rows() const {
+		return target_elm_.size();
+	}
+
+	/// Index of target element of given row.
+	inline unsigned int target_elm(unsigned int row) const {
+		return target_elm_[row];
+	}
+
+	/// Number of nonzero weights.
+	inline unsigned int n_nonzeros() const {
+		return weights_.size();
+	}
+
+	/**
+	 * Compute values of one row, @p values has to be of size @p n_comp.
+	 *
+	 * @param row     Index of row.
+	 * @param source  Source data, @p n_comp values per source element.
+	 * @param n_comp  Number of components.
+	 * @param values  Output vector.
+	 */
+	inline void row_values(unsigned int row, const std::vector<double> &source, unsigned int n_comp,
+			std::vector<double> &values) const {
+		std::fill(values.begin(), values.begin()+n_comp, 0.0);
+		for (unsigned int k=row_ptr_[row]; k<row_ptr_[row+1]; ++k) {
+			const double *src = &source[ n_comp*col_idx_[k] ];
+			for (unsigned int i=0; i<n_comp; ++i) values[i] += weights_[k] * src[i];
+		}
+	}
+
+private:
+	/// Row offsets to @p col_idx_ and @p weights_, size n_rows+1.
+	std::vector<unsigned int> row_ptr_;
+	/// Source element indices.
+	std::vector<unsigned int> col_idx_;
+	/// Interpolation weights.
+	std::vector<double> weights_;
+	/// Target element index of every row.
+	std::vector<unsigned int> target_elm_;
+};
+
+
+#endif /* INTERPOLATION_OPERATOR_HH_ */
@@ -17,22 +17,29 @@
  */
 
 
+#include <typeinfo>
 #include "io/msh_basereader.hh"
 #include "io/msh_gmshreader.h"
 #include "io/msh_vtkreader.hh"
 #include "io/msh_pvdreader.hh"
+#include "io/reader_cache.hh"
 #include "mesh/mesh.h"
 #include "system/sys_profiler.hh"
 
 
+std::atomic<unsigned int> BaseMeshReader::n_readers_(0);
+
+
 BaseMeshReader::BaseMeshReader(const FilePath &file_name)
 : element_data_values_(std::make_shared<ElementDataFieldMap>()),
-  tok_(file_name)
+  tok_(file_name),
+  reader_id_(n_readers_++)
 {}
 
 BaseMeshReader::BaseMeshReader(const FilePath &file_name, std::shared_ptr<ElementDataFieldMap> element_data_values)
 : element_data_values_(element_data_values),
-  tok_(file_name)
+  tok_(file_name),
+  reader_id_(n_readers_++)
 {}
 
 std::shared_ptr< BaseMeshReader > BaseMeshReader::reader_factory(const FilePath &file_name) {
@@ -123,9 +130,20 @@ typename ElementDataCache<T>::ComponentDataPtr BaseMeshReader::get_element_data(
 	    	}
 	    }
 
-    	(*element_data_values_)[field_name]
-					= std::make_shared< ElementDataCache<T> >(field_name, actual_header_.time, size_of_cache, n_components*n_entities);
-    	this->read_element_data(*(it->second), actual_header_, n_components, boundary_domain );
+	    // decoded data of mesh definition are read only once, do not store them
+	    bool use_lru = (actual_header_.discretization != OutputTime::DiscreteSpace::MESH_DEFINITION);
+	    ElementDataLRU::Key lru_key(reader_id_, field_name, actual_header_.time, n_components, n_entities,
+	    		boundary_domain, typeid(T).name());
+	    ElementDataPtr lru_data = use_lru ? ReaderCache::data_lru().get(lru_key) : nullptr;
+
+	    if (lru_data) {
+	    	it->second = lru_data;
+	    } else {
+	    	it->second = std::make_shared< ElementDataCache<T> >(field_name, actual_header_.time, size_of_cache, n_components*n_entities);
+	    	this->read_element_data(*(it->second), actual_header_, n_components, boundary_domain );
+	    	if (use_lru)
+	    		ReaderCache::data_lru().put(lru_key, it->second, sizeof(T) * size_of_cache * n_components * n_entities);
+	    }
 	}
 
     actual_header_.reset();
@@ -21,6 +21,7 @@
 
 
 #include <boost/exception/info.hpp>  // for error_info::~error_info<Tag, T>
+#include <atomic>                    // for atomic
 #include <map>                       // for map, map<>::value_compare
 #include <memory>                    // for shared_ptr
 #include <string>                    // for string
@@ -262,6 +263,12 @@ protected:
     /// Header of actual loaded data.
     MeshDataHeader actual_header_;
 
+    /// Unique identifier of reader, used in keys of decoded data stored in ReaderCache::data_lru.
+    unsigned int reader_id_;
+
+    /// Counter of created readers, readers of PVD time frames may be created on background thread.
+    static std::atomic<unsigned int> n_readers_;
+
     friend class ReaderCache;
 };
 
@@ -25,8 +25,8 @@
 #include "io/element_data_cache_base.hh"
 
 #include "system/system.hh"
-#include "system/tokenizer.hh"
-#include "boost/lexical_cast.hpp"
+#include "system/mapped_file.hh"
+#include "system/sys_profiler.hh"
 
 #include "mesh/mesh.h"
 
@@ -36,124 +36,276 @@ using namespace std;
 
 
 GmshMeshReader::GmshMeshReader(const FilePath &file_name)
-: BaseMeshReader(file_name)
+: BaseMeshReader(file_name),
+  file_( std::make_shared<MappedFile>( string(file_name) ) ),
+  format_version_(2.2),
+  binary_(false)
 {
-    tok_.set_comment_pattern( "#");
     data_section_name_ = "$ElementData";
     has_compatible_mesh_ = false;
+    read_mesh_format();
     make_header_table();
 }
 
 
 
-GmshMeshReader::~GmshMeshReader()   // Tokenizer close the file automatically
+GmshMeshReader::~GmshMeshReader()   // MappedFile unmaps the file automatically
 {}
 
 
 
+BufferCursor GmshMeshReader::section_cursor(const std::string &section, const char *from) {
+    const char *pos = file_->find_line( (from == nullptr) ? file_->begin() : from, section );
+    if (pos == file_->end()) THROW(ExcMissingSection() << EI_Section(section) << EI_GMSHFile(tok_.f_name()) );
+
+    BufferCursor cursor(file_->begin(), file_->end());
+    cursor.set_pos(pos);
+    cursor.next_line();
+    return cursor;
+}
+
+
+
+std::string GmshMeshReader::position_msg(const BufferCursor &cursor) const {
+    return fmt::format("line: {}, in file '{}'", file_->line_number(cursor.pos()), tok_.f_name());
+}
+
+
+
+unsigned int GmshMeshReader::element_dim(unsigned int type, unsigned int id) const {
+    //get element type: supported:
+    //  1 Line (2 nodes)
+    //  2 Triangle (3 nodes)
+    //  4 Tetrahedron (4 nodes)
+    // 15 Point (1 node)
+    switch (type) {
+        case 1:
+            return 1;
+        case 2:
+            return 2;
+        case 4:
+            return 3;
+        case 15:
+            return 0;
+        default:
+            THROW(ExcUnsupportedType() << EI_ElementId(id) << EI_ElementType(type) << EI_GMSHFile(tok_.f_name()) );
+            break;
+    }
+    return 0;
+}
+
+
+
+void GmshMeshReader::read_mesh_format() {
+    // files without '$MeshFormat' section are read as ASCII 2.2
+    if (file_->find_line(file_->begin(), "$MeshFormat") == file_->end()) return;
+
+    BufferCursor cursor = section_cursor("$MeshFormat");
+    unsigned int file_type, data_size;
+    try {
+        format_version_ = cursor.read_double();
+        file_type = cursor.read_uint();
+        data_size = cursor.read_uint();
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("$MeshFormat") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
+    }
+    binary_ = (file_type == 1);
+
+    bool supported = (format_version_ >= 2.0 && format_version_ < 3.0) || (format_version_ == 4.1);
+    if (!supported || file_type > 1 || data_size != sizeof(double))
+        THROW(ExcUnsupportedVersion() << EI_Version(fmt::format("{} {} {}", format_version_, file_type, data_size))
+                << EI_GMSHFile(tok_.f_name()) );
+
+    if (binary_) {
+        // binary integer 1 written by GMSH allows check of byte order
+        cursor.next_line();
+        int one = 0;
+        try {
+            one = cursor.read_binary<std::int32_t>();
+        } catch (BufferCursor::ExcParse &) {}
+        if (one != 1)
+            THROW(ExcUnsupportedVersion() << EI_Version("binary with different byte order") << EI_GMSHFile(tok_.f_name()) );
+    }
+}
+
+
+
+void GmshMeshReader::read_entities() {
+    entity_physical_tags_.clear();
+    if (file_->find_line(file_->begin(), "$Entities") == file_->end()) return;
+
+    BufferCursor cursor = section_cursor("$Entities");
+    cursor.set_binary(binary_);
+    try {
+        std::uint64_t n_entities[4];
+        for (unsigned int dim=0; dim<4; ++dim) n_entities[dim] = cursor.size_value();
+
+        for (int dim=0; dim<4; ++dim)
+            for (std::uint64_t i=0; i<n_entities[dim]; ++i) {
+                // format: tag, coordinates (point) or bounding box (others), physical tags, bounding entities (not point)
+                int tag = cursor.int_value();
+                unsigned int n_coords = (dim == 0) ? 3 : 6;
+                for (unsigned int i_coord=0; i_coord<n_coords; ++i_coord) cursor.double_value();
+                std::uint64_t n_physicals = cursor.size_value();
+                for (std::uint64_t i_phys=0; i_phys<n_physicals; ++i_phys) {
+                    int physical_tag = cursor.int_value();
+                    if (i_phys == 0) entity_physical_tags_[ std::make_pair(dim, tag) ] = physical_tag;
+                }
+                if (dim > 0) {
+                    std::uint64_t n_bounding = cursor.size_value();
+                    for (std::uint64_t i_bound=0; i_bound<n_bounding; ++i_bound) cursor.int_value();
+                }
+            }
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("$Entities") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
+    }
+}
+
+
+
 void GmshMeshReader::read_nodes(Mesh * mesh) {
-    using namespace boost;
-    unsigned int n_nodes;
+    START_TIMER("GmshMeshReader - read nodes");
+    std::uint64_t n_nodes = 0;
     MessageOut() << "- Reading nodes...";
-    tok_.set_position( Tokenizer::Position() );
 
-    if (! tok_.skip_to("$Nodes")) THROW(ExcMissingSection() << EI_Section("$Nodes") << EI_GMSHFile(tok_.f_name()) );
+    BufferCursor cursor = section_cursor("$Nodes");
     try {
-    	tok_.next_line(false);
-        n_nodes = lexical_cast<unsigned int> (*tok_);
-        mesh->init_node_vector( n_nodes );
-        INPUT_CHECK( n_nodes > 0, "Zero number of nodes, %s.\n", tok_.position_msg().c_str() );
-        ++tok_; // end of line
-
-        for (unsigned int i = 0; i < n_nodes; ++i) {
-        	tok_.next_line();
-
-            unsigned int id = lexical_cast<unsigned int> (*tok_); ++tok_; // node id
-        	arma::vec3 coords;                                         // node coordinates
-        	coords(0) = lexical_cast<double> (*tok_); ++tok_;
-        	coords(1) = lexical_cast<double> (*tok_); ++tok_;
-        	coords(2) = lexical_cast<double> (*tok_); ++tok_;
-            ++tok_; // skip mesh size parameter
-
-            mesh->add_node(id, coords);
+        arma::vec3 coords;                                            // node coordinates
+        if (format_version_ < 4.0) {
+            n_nodes = cursor.read_uint();
+            mesh->init_node_vector( n_nodes );
+            INPUT_CHECK( n_nodes > 0, "Zero number of nodes, %s.\n", position_msg(cursor).c_str() );
+            cursor.next_line();
+            cursor.set_binary(binary_);
+
+            for (unsigned int i = 0; i < n_nodes; ++i) {
+                unsigned int id = cursor.int_value();                 // node id
+                coords(0) = cursor.double_value();
+                coords(1) = cursor.double_value();
+                coords(2) = cursor.double_value();
+                if (!binary_) cursor.next_line();                     // skip mesh size parameter
+
+                mesh->add_node(id, coords);
+            }
+        } else {
+            // entity blocks: node tags of the block, then their coordinates
+            cursor.set_binary(binary_);
+            std::uint64_t n_blocks = cursor.size_value();
+            n_nodes = cursor.size_value();
+            cursor.size_value(); cursor.size_value();                 // min and max node tag
+            mesh->init_node_vector( n_nodes );
+            INPUT_CHECK( n_nodes > 0, "Zero number of nodes, %s.\n", position_msg(cursor).c_str() );
+
+            std::vector<std::uint64_t> node_ids;
+            for (std::uint64_t i_block = 0; i_block < n_blocks; ++i_block) {
+                cursor.int_value(); cursor.int_value();               // entity dim and tag
+                int parametric = cursor.int_value();
+                INPUT_CHECK( parametric == 0, "Parametric nodes are not supported, %s.\n", position_msg(cursor).c_str() );
+                node_ids.resize( cursor.size_value() );
+                for (auto &id : node_ids) id = cursor.size_value();
+                for (auto id : node_ids) {
+                    coords(0) = cursor.double_value();
+                    coords(1) = cursor.double_value();
+                    coords(2) = cursor.double_value();
+                    mesh->add_node(id, coords);
+                }
+            }
         }
-
-    } catch (bad_lexical_cast &) {
-    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
     }
     MessageOut().fmt("... {} nodes read. \n", n_nodes);
 }
 
 
 void GmshMeshReader::read_elements(Mesh * mesh) {
-    using namespace boost;
+    START_TIMER("GmshMeshReader - read elements");
     MessageOut() << "- Reading elements...";
 
-    if (! tok_.skip_to("$Elements")) THROW(ExcMissingSection() << EI_Section("$Elements") << EI_GMSHFile(tok_.f_name()) );
+    if (format_version_ >= 4.0) read_entities();
+    BufferCursor cursor = section_cursor("$Elements");
     try {
-    	tok_.next_line(false);
-        unsigned int n_elements = lexical_cast<unsigned int> (*tok_);
-        INPUT_CHECK( n_elements > 0, "Zero number of elements, %s.\n", tok_.position_msg().c_str());
-        ++tok_; // end of line
-
         std::vector<unsigned int> node_ids; //node_ids of elements
         node_ids.resize(4); // maximal count of nodes
 
-        mesh->init_element_vector(n_elements);
-
-        for (unsigned int i = 0; i < n_elements; ++i) {
-        	tok_.next_line();
-            unsigned int id = lexical_cast<unsigned int>(*tok_); ++tok_;
-
-            //get element type: supported:
-            //  1 Line (2 nodes)
-            //  2 Triangle (3 nodes)
-            //  4 Tetrahedron (4 nodes)
-            // 15 Point (1 node)
-            unsigned int type = lexical_cast<unsigned int>(*tok_); ++tok_;
-            unsigned int dim;
-            switch (type) {
-                case 1:
-                    dim = 1;
-                    break;
-                case 2:
-                    dim = 2;
-                    break;
-                case 4:
-                    dim = 3;
-                    break;
-                case 15:
-                    dim = 0;
-                    break;
-                default:
-                    dim = 0;
-                    THROW(ExcUnsupportedType() << EI_ElementId(id) << EI_ElementType(type) << EI_GMSHFile(tok_.f_name()) );
-                    break;
+        if (format_version_ < 4.0 && !binary_) {
+            unsigned int n_elements = cursor.read_uint();
+            INPUT_CHECK( n_elements > 0, "Zero number of elements, %s.\n", position_msg(cursor).c_str());
+            mesh->init_element_vector(n_elements);
+
+            for (unsigned int i = 0; i < n_elements; ++i) {
+                cursor.next_line();
+                unsigned int id = cursor.read_uint();
+                unsigned int dim = element_dim(cursor.read_uint(), id);
+
+                //get number of tags (at least 2)
+                unsigned int n_tags = cursor.read_uint();
+                INPUT_CHECK(n_tags >= 2, "At least two element tags have to be defined for element with id=%d, %s.\n",
+                        id, position_msg(cursor).c_str());
+
+                //get tags 1 and 2
+                unsigned int region_id = cursor.read_uint();
+                cursor.read_uint();                                   // GMSH region number, we do not store this
+                //get remaining tags
+                unsigned int partition_id = 0;
+                if (n_tags > 2)  partition_id = cursor.read_uint();   // save partition number from the new GMSH format
+                for (unsigned int ti = 3; ti < n_tags; ti++) cursor.read_int();  //skip remaining tags
+
+                for (unsigned int ni=0; ni<dim+1; ++ni) node_ids[ni] = cursor.read_uint(); // read node ids
+                mesh->add_element(id, dim, region_id, partition_id, node_ids);
             }
-
-            //get number of tags (at least 2)
-            unsigned int n_tags = lexical_cast<unsigned int>(*tok_);
-            INPUT_CHECK(n_tags >= 2, "At least two element tags have to be defined for element with id=%d, %s.\n",
-                    id, tok_.position_msg().c_str());
-            ++tok_;
-
-            //get tags 1 and 2
-            unsigned int region_id = lexical_cast<unsigned int>(*tok_); ++tok_; // region_id
-            lexical_cast<unsigned int>(*tok_); ++tok_; // GMSH region number, we do not store this
-            //get remaining tags
-            unsigned int partition_id = 0;
-            if (n_tags > 2)  { partition_id = lexical_cast<unsigned int>(*tok_); ++tok_; } // save partition number from the new GMSH format
-            for (unsigned int ti = 3; ti < n_tags; ti++) ++tok_;         //skip remaining tags
-
-            for (unsigned int ni=0; ni<dim+1; ++ni) { // read node ids
-            	node_ids[ni] = lexical_cast<unsigned int>(*tok_);
-                ++tok_;
+        } else if (format_version_ < 4.0) {
+            // binary 2.2: blocks of elements of the same type and number of tags
+            unsigned int n_elements = cursor.read_uint();
+            INPUT_CHECK( n_elements > 0, "Zero number of elements, %s.\n", position_msg(cursor).c_str());
+            mesh->init_element_vector(n_elements);
+            cursor.next_line();
+            cursor.set_binary(true);
+
+            std::vector<int> tags;
+            unsigned int n_read = 0;
+            while (n_read < n_elements) {
+                unsigned int type = cursor.int_value();
+                unsigned int n_block = cursor.int_value();
+                unsigned int n_tags = cursor.int_value();
+                INPUT_CHECK(n_tags >= 2, "At least two element tags have to be defined, %s.\n", position_msg(cursor).c_str());
+                tags.resize(n_tags);
+                for (unsigned int i = 0; i < n_block; ++i, ++n_read) {
+                    unsigned int id = cursor.int_value();
+                    unsigned int dim = element_dim(type, id);
+                    for (auto &tag : tags) tag = cursor.int_value();
+                    for (unsigned int ni=0; ni<dim+1; ++ni) node_ids[ni] = cursor.int_value();
+                    mesh->add_element(id, dim, tags[0], (n_tags > 2) ? tags[2] : 0, node_ids);
+                }
+            }
+        } else {
+            // 4.1: entity blocks, region is given by physical tag of the entity
+            cursor.set_binary(binary_);
+            std::uint64_t n_blocks = cursor.size_value();
+            std::uint64_t n_elements = cursor.size_value();
+            cursor.size_value(); cursor.size_value();                 // min and max element tag
+            INPUT_CHECK( n_elements > 0, "Zero number of elements, %s.\n", position_msg(cursor).c_str());
+            mesh->init_element_vector(n_elements);
+
+            for (std::uint64_t i_block = 0; i_block < n_blocks; ++i_block) {
+                int entity_dim = cursor.int_value();
+                int entity_tag = cursor.int_value();
+                unsigned int type = cursor.int_value();
+                std::uint64_t n_block = cursor.size_value();
+                auto phys_it = entity_physical_tags_.find( std::make_pair(entity_dim, entity_tag) );
+                unsigned int region_id = (phys_it == entity_physical_tags_.end()) ? 0 : phys_it->second;
+
+                for (std::uint64_t i = 0; i < n_block; ++i) {
+                    unsigned int id = cursor.size_value();
+                    unsigned int dim = element_dim(type, id);
+                    for (unsigned int ni=0; ni<dim+1; ++ni) node_ids[ni] = cursor.size_value();
+                    mesh->add_element(id, dim, region_id, 0, node_ids);
+                }
             }
-            mesh->add_element(id, dim, region_id, partition_id, node_ids);
         }
 
-    } catch (bad_lexical_cast &) {
-    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
     }
 
     mesh->create_boundary_elements();
@@ -165,86 +317,78 @@ void GmshMeshReader::read_elements(Mesh * mesh) {
 void GmshMeshReader::read_physical_names(Mesh * mesh) {
 	ASSERT(mesh).error("Argument mesh is NULL.\n");
 
-    using namespace boost;
+    // section must precede the '$Nodes' section
+    const char *names_pos = file_->find_line(file_->begin(), "$PhysicalNames");
+    if ( names_pos == file_->end() || names_pos > file_->find_line(file_->begin(), "$Nodes") ) return;
 
-    if (! tok_.skip_to("$PhysicalNames", "$Nodes") ) return;
+    BufferCursor cursor = section_cursor("$PhysicalNames");
     try {
-    	tok_.next_line(false);
-        unsigned int n_physicals = lexical_cast<unsigned int> (*tok_);
-        ++tok_; // end of line
+        unsigned int n_physicals = cursor.read_uint();
 
         for (unsigned int i = 0; i < n_physicals; ++i) {
-        	tok_.next_line();
             // format of one line:
             // dim    physical-id    physical-name
-
-            unsigned int dim = lexical_cast<unsigned int>(*tok_); ++tok_;
-            unsigned int id = lexical_cast<unsigned int>(*tok_); ++tok_;
-            string name = *tok_; ++tok_;
+            cursor.next_line();
+            unsigned int dim = cursor.read_uint();
+            unsigned int id = cursor.read_uint();
+            string name = cursor.read_string();
             mesh->add_physical_name( dim, id, name );
         }
 
-    } catch (bad_lexical_cast &) {
-    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("number") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
     }
 
 }
 
 
-// Is assumed to be called just after tok.skip_to("..")
-// reads the header from the tokenizer @p tok and return it as the second parameter
-void GmshMeshReader::read_data_header(MeshDataHeader &head) {
-    using namespace boost;
+// Is assumed to be called with cursor at the line following "$ElementData",
+// header is in ASCII format also in binary files
+void GmshMeshReader::read_data_header(BufferCursor &cursor, MeshDataHeader &head) {
     try {
         // string tags
-    	tok_.next_line(false);
-        unsigned int n_str = lexical_cast<unsigned int>(*tok_); ++tok_;
+        unsigned int n_str = cursor.read_uint();
         head.field_name="";
         head.interpolation_scheme = "";
         if (n_str > 0) {
-        	tok_.next_line(); n_str--;
-            head.field_name= *tok_; ++tok_; //  unquoted by tokenizer if needed
+        	head.field_name = cursor.read_string(); n_str--;  //  unquoted if needed
         }
         if (n_str > 0) {
-        	tok_.next_line(); n_str--;
-            head.interpolation_scheme = *tok_; ++tok_;
+        	head.interpolation_scheme = cursor.read_string(); n_str--;
         }
-        for(;n_str>0;n_str--) tok_.next_line(false); // skip possible remaining tags
+        for(;n_str>0;n_str--) cursor.read_string(); // skip possible remaining tags
 
         //real tags
-        tok_.next_line();
-        unsigned int n_real = lexical_cast<unsigned int>(*tok_); ++tok_;
+        unsigned int n_real = cursor.read_uint();
         head.time=0.0;
         if (n_real>0) {
-        	tok_.next_line(); n_real--;
-            head.time=lexical_cast<double>(*tok_); ++tok_;
+            head.time = cursor.read_double(); n_real--;
         }
-        for(;n_real>0;n_real--) tok_.next_line(false);
+        for(;n_real>0;n_real--) cursor.read_double();
 
         // int tags
-        tok_.next_line();
-        unsigned int n_int = lexical_cast<unsigned int>(*tok_); ++tok_;
+        unsigned int n_int = cursor.read_uint();
         head.time_index=0;
         head.n_components=1;
         head.n_entities=0;
         head.partition_index=0;
         if (n_int>0) {
-        	tok_.next_line(); n_int--;
-            head.time_index=lexical_cast<unsigned int>(*tok_); ++tok_;
+            head.time_index = cursor.read_uint(); n_int--;
         }
         if (n_int>0) {
-        	tok_.next_line(); n_int--;
-            head.n_components=lexical_cast<unsigned int>(*tok_); ++tok_;
+            head.n_components = cursor.read_uint(); n_int--;
         }
         if (n_int>0) {
-        	tok_.next_line(); n_int--;
-            head.n_entities=lexical_cast<unsigned int>(*tok_); ++tok_;
+            head.n_entities = cursor.read_uint(); n_int--;
         }
-        for(;n_int>0;n_int--) tok_.next_line(false);
-        head.position = tok_.get_position();
+        for(;n_int>0;n_int--) cursor.read_int();
+        cursor.next_line();
+
+        // position of data is stored as offset in the mapped file
+        head.position = Tokenizer::Position( cursor.pos() - file_->begin(), 0, 0 );
         head.discretization = OutputTime::DiscreteSpace::ELEM_DATA;
-    } catch (bad_lexical_cast &) {
-    	THROW(ExcWrongFormat() << EI_Type("$ElementData header") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+    } catch (BufferCursor::ExcParse &) {
+    	THROW(ExcWrongFormat() << EI_Type("$ElementData header") << EI_TokenizerMsg(position_msg(cursor)) << EI_MeshFile(tok_.f_name()) );
     }
 }
 
@@ -252,20 +396,29 @@ void GmshMeshReader::read_data_header(MeshDataHeader &head) {
 
 void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDataHeader actual_header, unsigned int n_components,
 		bool boundary_domain) {
+    START_TIMER("GmshMeshReader - read element data");
     unsigned int id, i_row;
     unsigned int n_read = 0;
     std::vector<int> const & el_ids = this->get_element_vector(boundary_domain);
     vector<int>::const_iterator id_iter = el_ids.begin();
 
-    // read @p data buffer as we have correct header with already passed time
-    // we assume that @p data buffer is big enough
-    tok_.set_position(actual_header.position);
+    // number of values on one row in file, actual_header.n_components can be changed by caller
+    unsigned int n_file_components = actual_header.n_components;
+    HeaderTable::iterator table_it = header_table_.find(actual_header.field_name);
+    if (table_it != header_table_.end())
+        for (auto &head : table_it->second)
+            if (head.position.file_position_ == actual_header.position.file_position_) n_file_components = head.n_components;
+    std::vector<double> row_data( std::max(n_file_components, actual_header.n_components) );
+
+    // seek directly to the data of the header
+    BufferCursor cursor(file_->begin(), file_->end());
+    cursor.set_pos( file_->begin() + (std::streamoff)actual_header.position.file_position_ );
+    cursor.set_binary(binary_);
 
     // read data
     for (i_row = 0; i_row < actual_header.n_entities; ++i_row)
         try {
-            tok_.next_line();
-            id = boost::lexical_cast<unsigned int>(*tok_); ++tok_;
+            id = cursor.int_value();
             //skip_element = false;
             while (id_iter != el_ids.end() && *id_iter < (int)id) {
                 ++id_iter; // skip initialization of some rows in data if ID is missing
@@ -277,16 +430,22 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
             }
             // save data from the line if ID was found
             if (*id_iter == (int)id) {
-            	data_cache.read_ascii_data(tok_, n_components, (id_iter - el_ids.begin()) );
+                if (binary_) {
+                    for (unsigned int i=0; i<n_file_components; ++i) row_data[i] = cursor.double_value();
+                } else {
+                    for (unsigned int i=0; i<actual_header.n_components; ++i) row_data[i] = cursor.double_value();
+                }
+            	data_cache.set_row_data( &(row_data[0]), n_components, (id_iter - el_ids.begin()) );
                 n_read++;
+            } else if (binary_) {
+                // skip the row if ID on the row  < actual ID in the map el_ids
+                cursor.skip_bytes( n_file_components * sizeof(double) );
             }
-            // skip the line if ID on the line  < actual ID in the map el_ids
-        } catch (boost::bad_lexical_cast &) {
-        	THROW(ExcWrongFormat() << EI_Type("$ElementData line") << EI_TokenizerMsg(tok_.position_msg())
+            if (!binary_) cursor.next_line();
+        } catch (BufferCursor::ExcParse &) {
+        	THROW(ExcWrongFormat() << EI_Type("$ElementData line") << EI_TokenizerMsg(position_msg(cursor))
         			<< EI_MeshFile(tok_.f_name()) );
         }
-    // possibly skip remaining lines after break
-    while (i_row < actual_header.n_entities) tok_.next_line(false), ++i_row;
 
     LogOut().fmt("time: {}; {} entities of field {} read.\n",
     		actual_header.time, n_read, actual_header.field_name);
@@ -296,31 +455,36 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
 
 void GmshMeshReader::make_header_table()
 {
+    START_TIMER("GmshMeshReader - make header table");
 	header_table_.clear();
 	MeshDataHeader header;
-	while ( !tok_.eof() ) {
-        if ( tok_.skip_to("$ElementData") ) {
-            read_data_header(header);
-            HeaderTable::iterator it = header_table_.find(header.field_name);
-
-            if (it == header_table_.end()) {  // field doesn't exists, insert new vector to map
-            	std::vector<MeshDataHeader> vec;
-            	vec.push_back(header);
-            	header_table_[header.field_name]=vec;
-            } else if ( header.time <= it->second.back().time ) { // time is in wrong order. can't be add
-            	WarningOut().fmt("Wrong time order: field '{}', time '{}', file '{}'. Skipping this '$ElementData' section.\n",
-            		header.field_name, header.time, tok_.f_name() );
-            } else {  // add new time step
-            	it->second.push_back(header);
-            }
+	const char *pos = file_->find_line(file_->begin(), "$ElementData");
+	while ( pos != file_->end() ) {
+        BufferCursor cursor = section_cursor("$ElementData", pos);
+        read_data_header(cursor, header);
+        HeaderTable::iterator it = header_table_.find(header.field_name);
+
+        if (it == header_table_.end()) {  // field doesn't exists, insert new vector to map
+        	std::vector<MeshDataHeader> vec;
+        	vec.push_back(header);
+        	header_table_[header.field_name]=vec;
+        } else if ( header.time <= it->second.back().time ) { // time is in wrong order. can't be add
+        	WarningOut().fmt("Wrong time order: field '{}', time '{}', file '{}'. Skipping this '$ElementData' section.\n",
+        		header.field_name, header.time, tok_.f_name() );
+        } else {  // add new time step
+        	it->second.push_back(header);
         }
-	}
 
-	tok_.set_position( Tokenizer::Position() );
+        // skip data without parsing, size of binary data is known
+        if (binary_) {
+            std::size_t data_size = (std::size_t)header.n_entities * (sizeof(std::int32_t) + header.n_components * sizeof(double));
+            pos = ( (std::size_t)(file_->end() - cursor.pos()) > data_size ) ? cursor.pos() + data_size : file_->end();
+        } else {
+            pos = cursor.pos();
+        }
+        pos = file_->find_line(pos, "$ElementData");
+	}
 }
-
-
-
 BaseMeshReader::MeshDataHeader & GmshMeshReader::find_header(BaseMeshReader::HeaderQuery &header_query)
 {
 	// check discretization, only type element_data or undefined is supported
@@ -21,32 +21,47 @@
 
 #include <boost/exception/info.hpp>  // for error_info::~error_info<Tag, T>
 #include <map>                       // for map, map<>::value_compare
+#include <memory>                    // for shared_ptr
 #include <string>                    // for string
 #include <vector>                    // for vector
 #include "io/msh_basereader.hh"      // for MeshDataHeader, BaseMeshReader
 #include "system/exceptions.hh"      // for ExcStream, operator<<, EI, TYPED...
 
+class BufferCursor;
 class ElementDataCacheBase;
 class FilePath;
+class MappedFile;
 class Mesh;
 
 
 
+/**
+ * Reader of GMSH mesh files.
+ *
+ * Supported are formats 2.2 and 4.1, both ASCII and binary (only native byte order). The file is mapped
+ * to memory and parsed directly from the mapped buffer. Headers of all '$ElementData' sections are indexed
+ * by field name and time in the constructor, the data of requested time frame are then read directly
+ * from the stored position without parsing of other sections.
+ */
 class GmshMeshReader : public BaseMeshReader {
 public:
 	TYPEDEF_ERR_INFO(EI_GMSHFile, std::string);
 	TYPEDEF_ERR_INFO(EI_Section, std::string);
 	TYPEDEF_ERR_INFO(EI_ElementId, int);
 	TYPEDEF_ERR_INFO(EI_ElementType, int);
+	TYPEDEF_ERR_INFO(EI_Version, std::string);
 	DECLARE_EXCEPTION(ExcMissingSection,
 			<< "Missing section " << EI_Section::qval << " in the GMSH input file: " << EI_GMSHFile::qval);
 	DECLARE_EXCEPTION(ExcUnsupportedType,
 			<< "Element " << EI_ElementId::val << "in the GMSH input file " << EI_GMSHFile::qval
 			<< " is of the unsupported type " << EI_ElementType::val );
+	DECLARE_EXCEPTION(ExcUnsupportedVersion,
+			<< "Unsupported format " << EI_Version::val << " of the GMSH input file " << EI_GMSHFile::qval
+			<< ".\nSupported are versions 2.2 and 4.1, ASCII or binary with native byte order and 8 bytes data size.\n" );
 
     /**
      * Construct the GMSH format reader from given FilePath.
-     * This opens the file for reading.
+     * This maps the file to memory and reads table of '$ElementData' headers.
      */
     GmshMeshReader(const FilePath &file_name);
 
@@ -86,6 +101,28 @@ protected:
 	 */
 	typedef typename std::map< std::string, std::vector<MeshDataHeader> > HeaderTable;
 
+    /**
+     * Read '$MeshFormat' section, set @p format_version_ and @p binary_.
+     */
+    void read_mesh_format();
+    /**
+     * Read '$Entities' section of GMSH 4.1 file and fill @p entity_physical_tags_.
+     */
+    void read_entities();
+    /**
+     * Return cursor placed at start of the line following the line with given section name.
+     * Section is searched in the range [from, end of file), throws ExcMissingSection if it doesn't exist.
+     */
+    BufferCursor section_cursor(const std::string &section, const char *from = nullptr);
+    /**
+     * Message with file position for exceptions.
+     */
+    std::string position_msg(const BufferCursor &cursor) const;
+    /**
+     * Return dimension of element of given GMSH type, throws ExcUnsupportedType for other than point,
+     * line, triangle and tetrahedron.
+     */
+    unsigned int element_dim(unsigned int type, unsigned int id) const;
     /**
      * private method for reading of nodes
      */
@@ -100,11 +137,12 @@ protected:
      */
     void read_elements(Mesh * mesh);
     /**
-     * Reads the header from the tokenizer @p tok and return it as the second parameter.
+     * Reads the header from the @p cursor and return it as the second parameter.
+     * The cursor is left at the start of data.
      */
-    void read_data_header(MeshDataHeader &head);
+    void read_data_header(BufferCursor &cursor, MeshDataHeader &head);
     /**
-     * Reads table of ElementData headers from the tokenizer file.
+     * Reads table of ElementData headers of the file. Data sections are skipped without parsing.
      */
     void make_header_table() override;
     /**
@@ -116,6 +154,18 @@ protected:
 
     /// Table with data of ElementData headers
     HeaderTable header_table_;
+
+    /// File mapped to memory.
+    std::shared_ptr<MappedFile> file_;
+
+    /// Version of file format (2.2 or 4.1)
+    double format_version_;
+
+    /// Flag of binary file
+    bool binary_;
+
+    /// First physical tag of GMSH entities given by pair (dim, tag), used only in GMSH 4.1 format.
+    std::map< std::pair<int, int>, int > entity_physical_tags_;
 };
 
 #endif	/* _GMSHMESHREADER_H */
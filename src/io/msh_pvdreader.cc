@@ -38,6 +38,7 @@ PvdMeshReader::PvdMeshReader(const FilePath &file_name)
 
 PvdMeshReader::~PvdMeshReader()
 {
+	this->cancel_readahead();
 	for (auto file_data : file_list_) {
 		if (file_data.reader != nullptr) delete file_data.reader;
 	}
@@ -119,15 +120,58 @@ BaseMeshReader::MeshDataHeader & PvdMeshReader::find_header(BaseMeshReader::Head
 			comp);
 	--list_it_;
 
-	// check if VTK reader exists and eventually creates its
+	// check if VTK reader exists and eventually creates its or takes it from readahead
+	unsigned int i_file = list_it_ - file_list_.begin();
 	if (!list_it_->reader) {
-		list_it_->reader = new VtkMeshReader(list_it_->file_name, this->element_data_values_, list_it_->time);
+		if (readahead_.valid() && readahead_idx_ == i_file)
+			list_it_->reader = readahead_.get();
+		else
+			list_it_->reader = new VtkMeshReader(list_it_->file_name, this->element_data_values_, list_it_->time);
 		list_it_->reader->bulk_elements_id_ = this->bulk_elements_id_;
 		list_it_->reader->boundary_elements_id_ = this->boundary_elements_id_;
 		list_it_->reader->has_compatible_mesh_ = true;
 	}
 
 	actual_header_ = list_it_->reader->find_header(header_query);
+
+	// prepare next time frame during computation of the actual one
+	readahead_fields_.insert(header_query.field_name);
+	this->start_readahead(i_file+1);
+
 	return actual_header_;
 }
 
+
+void PvdMeshReader::start_readahead(unsigned int i_file) {
+	if (i_file >= file_list_.size() || file_list_[i_file].reader != nullptr) return;
+	if (readahead_.valid()) {
+		if (readahead_idx_ == i_file) return; // file is already prepared
+		this->cancel_readahead();
+	}
+
+	// background thread gets only copies of data, shared map of element data is not touched by VTK reader constructor
+	readahead_idx_ = i_file;
+	VtkFileData file_data = file_list_[i_file];
+	std::shared_ptr<ElementDataFieldMap> element_data_values = this->element_data_values_;
+	std::set<std::string> fields = readahead_fields_;
+	readahead_ = std::async(std::launch::async, [file_data, element_data_values, fields]() {
+		VtkMeshReader * reader = new VtkMeshReader(file_data.file_name, element_data_values, file_data.time);
+		try {
+			for (auto &field_name : fields) reader->preload_data(field_name);
+		} catch (...) {
+			// errors are reported during regular reading of data
+		}
+		return reader;
+	});
+}
+
+
+void PvdMeshReader::cancel_readahead() {
+	if (!readahead_.valid()) return;
+	try {
+		delete readahead_.get();
+	} catch (...) {
+		// file is not read, errors are reported only if it is really requested
+	}
+}
+
@@ -21,6 +21,8 @@
 
 #include <string>
 #include <istream>
+#include <future>
+#include <set>
 
 #include "io/msh_basereader.hh"
 #include "system/file_path.hh"
@@ -99,6 +101,18 @@ protected:
     void read_element_data(ElementDataCacheBase &data_cache, MeshDataHeader actual_header, unsigned int n_components,
     		bool boundary_domain) override;
 
+    /**
+     * Start readahead of VTK file of given index on background thread.
+     *
+     * VTK reader of the file is created (its header table and index of compressed blocks are built)
+     * and data of all fields read so far are decoded. Reader is taken over by \p find_header when
+     * the time frame is requested.
+     */
+    void start_readahead(unsigned int i_file);
+
+    /// Wait for running readahead and discard its result.
+    void cancel_readahead();
+
     /// Store list of VTK files and time steps declared in PVD file.
     std::vector<VtkFileData> file_list_;
 
@@ -108,6 +122,15 @@ protected:
     /// Iterator to items of \p file_list_
     std::vector<VtkFileData>::iterator list_it_;
 
+    /// Reader of VTK file prepared on background thread
+    std::future<VtkMeshReader *> readahead_;
+
+    /// Index of VTK file in \p file_list_ prepared by \p readahead_
+    unsigned int readahead_idx_;
+
+    /// Names of fields read so far, their data are decoded by readahead
+    std::set<std::string> readahead_fields_;
+
 };
 
 #endif	/* MSH_PVD_READER_HH */
@@ -18,6 +18,7 @@
 
 
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <pugixml.hpp>
 #include "boost/lexical_cast.hpp"
@@ -255,6 +256,109 @@ void VtkMeshReader::make_header_table()
 		auto header = create_header( subnode, n_elements, appended_pos, OutputTime::DiscreteSpace::NATIVE_DATA );
 		header_table_.insert( std::pair<std::string, MeshDataHeader>(header.field_name, header) );
 	}
+
+	// index of compressed blocks, headers of compressed data are read only once
+	block_tables_.clear();
+	preloaded_data_.clear();
+	if (data_format_ == DataFormat::binary_zlib) {
+		for (auto &header : header_table_) {
+			std::streamoff data_pos = header.second.position.file_position_;
+			if (block_tables_.find(data_pos) == block_tables_.end()) this->make_block_table(data_pos);
+		}
+	}
+}
+
+
+void VtkMeshReader::make_block_table(std::streamoff data_pos)
+{
+	CompressedBlockTable table;
+
+	data_stream_->seekg(data_pos);
+	uint64_t n_blocks = read_header_type(header_type_, *data_stream_);
+	table.u_size = read_header_type(header_type_, *data_stream_);
+	table.p_size = read_header_type(header_type_, *data_stream_);
+
+	table.sizes.reserve(n_blocks);
+	for (uint64_t i = 0; i < n_blocks; ++i) {
+		table.sizes.push_back( read_header_type(header_type_, *data_stream_) );
+	}
+	if (data_stream_->fail())
+		THROW(ExcWrongFormat() << EI_Type("header of compressed DataArray")
+				<< EI_TokenizerMsg("file position " + std::to_string(data_pos)) << EI_MeshFile(tok_.f_name()) );
+
+	// compressed blocks follow the header
+	std::streamoff block_pos = data_stream_->tellg();
+	table.offsets.reserve(n_blocks);
+	for (uint64_t i = 0; i < n_blocks; ++i) {
+		table.offsets.push_back(block_pos);
+		block_pos += table.sizes[i];
+	}
+
+	block_tables_[data_pos] = table;
+}
+
+
+std::shared_ptr<std::string> VtkMeshReader::decode_binary_data(std::streamoff data_pos)
+{
+	auto decoded = std::make_shared<std::string>();
+
+	if (data_format_ == DataFormat::binary_uncompressed) {
+		data_stream_->seekg(data_pos);
+		uint64_t n_bytes = read_header_type(header_type_, *data_stream_);
+		decoded->resize(n_bytes);
+		if (n_bytes > 0) data_stream_->read(&(*decoded)[0], n_bytes);
+		return decoded;
+	}
+
+	auto table_it = block_tables_.find(data_pos);
+	ASSERT(table_it != block_tables_.end())(tok_.f_name()).error("Missing table of compressed blocks.\n");
+	const CompressedBlockTable &table = table_it->second;
+	uint64_t n_blocks = table.sizes.size();
+
+	uint64_t decoded_size = 0;
+	for (uint64_t i = 0; i < n_blocks; ++i)
+		decoded_size += (i==n_blocks-1 && table.p_size>0) ? table.p_size : table.u_size;
+	decoded->resize(decoded_size);
+
+	// every block is uncompressed directly to its place in output data
+	std::vector<char> data_block;
+	uint64_t decoded_pos = 0;
+	for (uint64_t i = 0; i < n_blocks; ++i) {
+		uLongf block_size = (i==n_blocks-1 && table.p_size>0) ? table.p_size : table.u_size;
+		data_block.resize(table.sizes[i]);
+		data_stream_->seekg(table.offsets[i]);
+		data_stream_->read(&data_block[0], table.sizes[i]);
+
+		int err = uncompress( (Bytef *)(&(*decoded)[decoded_pos]), &block_size, (const Bytef *)(&data_block[0]), table.sizes[i] );
+		if (err != Z_OK || data_stream_->fail())
+			THROW(ExcWrongFormat() << EI_Type("compressed DataArray")
+					<< EI_TokenizerMsg("block " + std::to_string(i) + " at file position " + std::to_string(table.offsets[i]))
+					<< EI_MeshFile(tok_.f_name()) );
+		decoded_pos += block_size;
+	}
+
+	return decoded;
+}
+
+
+std::shared_ptr<std::string> VtkMeshReader::take_preloaded_data(std::streamoff data_pos)
+{
+	auto it = preloaded_data_.find(data_pos);
+	if (it == preloaded_data_.end()) return nullptr;
+
+	std::shared_ptr<std::string> data = it->second;
+	preloaded_data_.erase(it);
+	return data;
+}
+
+
+void VtkMeshReader::preload_data(const std::string &field_name)
+{
+	if (data_format_ == DataFormat::ascii) return;
+	if (header_table_.count(field_name) != 1) return; // missing or ambiguous, error is reported during reading
+
+	std::streamoff data_pos = header_table_.find(field_name)->second.position.file_position_;
+	preloaded_data_[data_pos] = this->decode_binary_data(data_pos);
 }
 
 
@@ -391,11 +495,19 @@ void VtkMeshReader::parse_binary_data(ElementDataCacheBase &data_cache, unsigned
 {
     n_read_ = 0;
 
-    data_stream_->seekg(pos.file_position_);
-	read_header_type(header_type_, *data_stream_);
+    std::shared_ptr<std::string> preloaded = this->take_preloaded_data(pos.file_position_);
+    std::istringstream preloaded_stream;
+    std::istream *data_stream = data_stream_;
+    if (preloaded) {
+    	preloaded_stream.str(*preloaded);
+    	data_stream = &preloaded_stream;
+    } else {
+    	data_stream_->seekg(pos.file_position_);
+    	read_header_type(header_type_, *data_stream_);
+    }
 
 	for (unsigned int i_row = 0; i_row < n_entities; ++i_row) {
-		data_cache.read_binary_data(*data_stream_, n_components, get_element_vector(boundary_domain)[i_row]);
+		data_cache.read_binary_data(*data_stream, n_components, get_element_vector(boundary_domain)[i_row]);
         n_read_++;
 	}
 }
@@ -404,46 +516,9 @@ void VtkMeshReader::parse_binary_data(ElementDataCacheBase &data_cache, unsigned
 void VtkMeshReader::parse_compressed_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
 		Tokenizer::Position pos, bool boundary_domain)
 {
-	data_stream_->seekg(pos.file_position_);
-	uint64_t n_blocks = read_header_type(header_type_, *data_stream_);
-	uint64_t u_size = read_header_type(header_type_, *data_stream_);
-	uint64_t p_size = read_header_type(header_type_, *data_stream_);
-
-	std::vector<uint64_t> block_sizes;
-	block_sizes.reserve(n_blocks);
-	for (uint64_t i = 0; i < n_blocks; ++i) {
-		block_sizes.push_back( read_header_type(header_type_, *data_stream_) );
-	}
-
-	stringstream decompressed_data;
-	uint64_t decompressed_data_size = 0;
-	for (uint64_t i = 0; i < n_blocks; ++i) {
-		uint64_t decompressed_block_size = (i==n_blocks-1 && p_size>0) ? p_size : u_size;
-		uint64_t compressed_block_size = block_sizes[i];
-
-		std::vector<char> data_block(compressed_block_size);
-		data_stream_->read(&data_block[0], compressed_block_size);
-
-		std::vector<char> buffer(decompressed_block_size);
-
-		// set zlib object
-		z_stream strm;
-		strm.zalloc = 0;
-		strm.zfree = 0;
-		strm.next_in = (Bytef *)(&data_block[0]);
-		strm.avail_in = compressed_block_size;
-		strm.next_out = (Bytef *)(&buffer[0]);
-		strm.avail_out = decompressed_block_size;
-
-		// decompression of data
-		inflateInit(&strm);
-		inflate(&strm, Z_NO_FLUSH);
-		inflateEnd(&strm);
-
-		// store decompressed data to stream
-		decompressed_data << std::string(buffer.begin(), buffer.end());
-		decompressed_data_size += decompressed_block_size;
-	}
+	std::shared_ptr<std::string> decoded = this->take_preloaded_data(pos.file_position_);
+	if (!decoded) decoded = this->decode_binary_data(pos.file_position_);
+	std::istringstream decompressed_data(*decoded);
 
     n_read_ = 0;
 
@@ -22,7 +22,9 @@
 #include <boost/exception/info.hpp>          // for error_info::~error_info<...
 #include <istream>                           // for istream
 #include <map>                               // for map, map<>::value_compare
+#include <memory>                            // for shared_ptr
 #include <string>                            // for string
+#include <vector>                            // for vector
 #include <armadillo>
 #include "io/msh_basereader.hh"              // for MeshDataHeader, DataType
 #include "system/exceptions.hh"              // for ExcStream, operator<<, EI
@@ -113,6 +115,20 @@ protected:
 	 */
 	typedef typename std::multimap< std::string, MeshDataHeader > HeaderTable;
 
+	/**
+	 * Table of blocks of one compressed DataArray.
+	 *
+	 * Compressed data starts with header: number of blocks, size of uncompressed block, size of last
+	 * uncompressed block and sizes of all compressed blocks. Header is read only once when the file is
+	 * opened, then every block can be read directly from its position.
+	 */
+	struct CompressedBlockTable {
+		uint64_t u_size;                         ///< size of uncompressed block
+		uint64_t p_size;                         ///< size of last uncompressed block (0 if it is equal to u_size)
+		std::vector<std::streamoff> offsets;     ///< positions of compressed blocks in file
+		std::vector<uint64_t> sizes;             ///< sizes of compressed blocks
+	};
+
     /**
      * Special constructor of VTK files defined in PVD file. Constructor is called from PVD mesh reader.
      *
@@ -161,6 +177,23 @@ protected:
 	void parse_compressed_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
 			Tokenizer::Position pos, bool boundary_domain);
 
+	/// Read header of compressed DataArray at given position and store its block table.
+	void make_block_table(std::streamoff data_pos);
+
+	/// Read binary data of DataArray at given position, compressed data are uncompressed.
+	std::shared_ptr<std::string> decode_binary_data(std::streamoff data_pos);
+
+	/// Returns data decoded by \p preload_data (and release them from reader) or nullptr.
+	std::shared_ptr<std::string> take_preloaded_data(std::streamoff data_pos);
+
+	/**
+	 * Decode binary data of given field in advance.
+	 *
+	 * Called by PVD reader for VTK file of next time frame on background thread, method doesn't touch
+	 * shared data of readers. Data of ASCII files are not preloaded.
+	 */
+	void preload_data(const std::string &field_name);
+
 	/// Set base attributes of VTK and get count of nodes and elements.
 	void read_base_vtk_attributes(pugi::xml_node vtk_node, unsigned int &n_nodes, unsigned int &n_elements);
 
@@ -193,6 +226,12 @@ protected:
     /// Table with data of DataArray headers
     HeaderTable header_table_;
 
+    /// Block tables of compressed DataArrays, indexed by position of DataArray in file
+    std::map<std::streamoff, CompressedBlockTable> block_tables_;
+
+    /// Binary data decoded in advance by \p preload_data, indexed by position of DataArray in file
+    std::map<std::streamoff, std::shared_ptr<std::string> > preloaded_data_;
+
     /// input stream allow read appended data, used only if this tag exists
     std::istream *data_stream_;
 
@@ -11,11 +11,19 @@
 #include <algorithm>
 #include <unordered_set>
 #include <queue>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
 
+#include <boost/functional/hash.hpp>
+
+#include "config.h"
 #include "system/global_defs.h"
+#include "system/sys_profiler.hh"
 #include "input/accessors.hh"
 #include "input/input_type.hh"
 #include "system/armadillo_tools.hh"
+#include "system/checkpoint_data.hh"
 
 #include "mesh/mesh.h"
 #include "mesh/bih_tree.hh"
@@ -196,19 +204,32 @@ void ObservePoint::snap(Mesh &mesh)
 
 
 void ObservePoint::find_observe_point(Mesh &mesh) {
-    RegionSet region_set = mesh.region_db().get_region_set(snap_region_name_);
-    if (region_set.size() == 0)
-        THROW( RegionDB::ExcUnknownSet() << RegionDB::EI_Label(snap_region_name_) << in_rec_.ei_address() );
+    RegionSet region_set;
+    vector<unsigned int> candidate_list;
+    find_candidates(mesh, region_set, candidate_list);
+    find_observe_element(mesh, region_set, candidate_list);
+    check_distance(mesh);
+}
 
 
-    const BIHTree &bih_tree=mesh.get_bih_tree();
-    vector<unsigned int> candidate_list;
-    std::unordered_set<unsigned int> closed_elements(1023);
-    std::priority_queue< ObservePointData, std::vector<ObservePointData>, CompareByDist > candidate_queue;
+
+void ObservePoint::find_candidates(Mesh &mesh, RegionSet &region_set, std::vector<unsigned int> &candidate_list) {
+    region_set = mesh.region_db().get_region_set(snap_region_name_);
+    if (region_set.size() == 0)
+        THROW( RegionDB::ExcUnknownSet() << RegionDB::EI_Label(snap_region_name_) << in_rec_.ei_address() );
 
     // search for the initial element
+    const BIHTree &bih_tree=mesh.get_bih_tree();
     auto projected_point = bih_tree.tree_box().project_point(input_point_);
+    candidate_list.clear();
     bih_tree.find_point(projected_point, candidate_list, true);
+}
+
+
+
+void ObservePoint::find_observe_element(Mesh &mesh, const RegionSet &region_set, const std::vector<unsigned int> &candidate_list) {
+    std::unordered_set<unsigned int> closed_elements(1023);
+    std::priority_queue< ObservePointData, std::vector<ObservePointData>, CompareByDist > candidate_queue;
 
     // closest element
     ObservePointData min_observe_point_data;
@@ -279,6 +300,11 @@ void ObservePoint::find_observe_point(Mesh &mesh) {
             << EI_ClosestEle(min_observe_point_data));
     }
     snap( mesh );
+}
+
+
+
+void ObservePoint::check_distance(Mesh &mesh) {
     ElementAccessor<3> elm = mesh.element_accessor(observe_data_.element_idx_);
     double dist = arma::norm(elm.centre() - input_point_, 2);
     double elm_norm = arma::norm(elm.bounding_box().max() - elm.bounding_box().min(), 2);
@@ -337,8 +363,20 @@ ObservePointData ObservePoint::point_projection(unsigned int i_elm, ElementAcces
 const unsigned int Observe::max_observe_value_time = 1000;
 
 
-Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigned int precision, std::string unit_str)
+const Input::Type::Selection & Observe::get_format_selection() {
+	return Input::Type::Selection("ObserveFormat", "Format of the observe output file.")
+		.add_value(ObserveFormat::yaml, "yaml", "YAML text file '<equation>_observe.yaml'.")
+		.add_value(ObserveFormat::binary, "binary",
+				"Binary file '<equation>_observe.bin' with YAML header and one record of all point values per time frame. "
+				"Suitable for large number of observe points, see 'flow123d/src/python/utils/observe_reader.py'.")
+		.close();
+}
+
+
+Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigned int precision, std::string unit_str,
+		ObserveFormat format, bool use_cache)
 : observe_name_(observe_name),
+  format_(format),
   precision_(precision),
   point_ds_(nullptr),
   observe_time_idx_(0)
@@ -346,12 +384,16 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigne
     observe_values_time_.reserve(max_observe_value_time);
     observe_values_time_.push_back(numeric_limits<double>::signaling_NaN());
 
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
     unsigned int global_point_idx=0, local_point_idx=0;
 
     // in_rec is Output input record.
     for(auto it = in_array.begin<Input::Record>(); it != in_array.end(); ++it) {
-        ObservePoint point(*it, mesh, points_.size());
-        point.find_observe_point(mesh);
+        points_.push_back( ObservePoint(*it, mesh, points_.size()) );
+    }
+    if (points_.size() > 0) this->find_observe_points(mesh, use_cache);
+
+    for(auto &point : points_) {
         point.observe_data_.global_idx_ = global_point_idx++;
         if (point.observe_data_.proc_ == mesh.get_el_ds()->myp()) {
         	point.observe_data_.local_idx_ = local_point_idx++;
@@ -359,7 +401,6 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigne
         }
         else
         	point.observe_data_.local_idx_ = -1;
-        points_.push_back( point );
         observed_element_indices_.push_back(point.observe_data_.element_idx_);
     }
     // make local to global map, distribution
@@ -374,11 +415,9 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigne
     time_unit_seconds_ = UnitSI().s().convert_unit_from(unit_str);
 
     if (points_.size() == 0) return;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
     if (rank_==0) {
-        FilePath observe_file_path(observe_name_ + "_observe.yaml", FilePath::output_file);
         try {
-            observe_file_path.open_stream(observe_file_);
+            observe_file_path().open_stream(observe_file_);
             //observe_file_.setf(std::ios::scientific);
             observe_file_.precision(this->precision_);
 
@@ -396,6 +435,167 @@ Observe::~Observe() {
 }
 
 
+void Observe::find_observe_points(Mesh &mesh, bool use_cache) {
+    START_TIMER("find_observe_points");
+    std::size_t hash = 0;
+    std::string cache_file;
+    if (use_cache) {
+        hash = this->search_hash(mesh);
+        cache_file = string( FilePath(observe_name_ + "_observe_points.cache", FilePath::output_file) );
+        if ( this->read_points_cache(mesh, cache_file, hash) ) {
+            MessageOut().fmt("Observe points of '{}' read from cache file.\n", observe_name_);
+            return;
+        }
+    }
+
+    // points are distributed cyclically over processes
+    int n_proc;
+    MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+    std::vector<unsigned int> own_points;
+    for (unsigned int i_point=rank_; i_point<points_.size(); i_point+=n_proc) own_points.push_back(i_point);
+
+    // initial elements of all own points (BIH tree is not thread safe)
+    std::vector<RegionSet> region_sets(own_points.size());
+    std::vector< std::vector<unsigned int> > candidates(own_points.size());
+    std::vector<int> failed(own_points.size(), 0);
+    for (unsigned int i=0; i<own_points.size(); ++i) {
+        try {
+            points_[own_points[i]].find_candidates(mesh, region_sets[i], candidates[i]);
+        } catch (...) {
+            failed[i] = 1;
+        }
+    }
+
+    // BFS and projection, errors are reported collectively below
+    mesh.node_elements();
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i=0; i<(int)own_points.size(); ++i) {
+        if (failed[i]) continue;
+        try {
+            points_[own_points[i]].find_observe_element(mesh, region_sets[i], candidates[i]);
+        } catch (...) {
+            failed[i] = 1;
+        }
+    }
+
+    // exchange results: element index + 1 (zero for failed point), distance, global and local coordinates
+    const unsigned int point_data_size = 8;
+    std::vector<double> send_data(point_data_size * points_.size(), 0.0), recv_data(point_data_size * points_.size());
+    for (unsigned int i=0; i<own_points.size(); ++i) {
+        if (failed[i]) continue;
+        ObservePointData &data = points_[own_points[i]].observe_data_;
+        double *point_data = &(send_data[point_data_size * own_points[i]]);
+        point_data[0] = data.element_idx_ + 1;
+        point_data[1] = data.distance_;
+        for (unsigned int j=0; j<3; ++j) point_data[2+j] = data.global_coords_[j];
+        for (unsigned int j=0; j<data.local_coords_.n_elem; ++j) point_data[5+j] = data.local_coords_[j];
+    }
+    MPI_Allreduce(&(send_data[0]), &(recv_data[0]), send_data.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    for (unsigned int i_point=0; i_point<points_.size(); ++i_point) {
+        double *point_data = &(recv_data[point_data_size * i_point]);
+        // repeat search of failed point on all processes, throws appropriate exception
+        if (point_data[0] == 0) {
+            points_[i_point].find_observe_point(mesh);
+            continue;
+        }
+
+        ObservePointData &data = points_[i_point].observe_data_;
+        data.element_idx_ = (unsigned int)(point_data[0]) - 1;
+        data.distance_ = point_data[1];
+        data.global_coords_ = arma::vec3( &(point_data[2]) );
+        ElementAccessor<3> elm = mesh.element_accessor(data.element_idx_);
+        data.local_coords_ = arma::vec( &(point_data[5]), elm.dim() );
+        data.proc_ = elm.proc();
+        points_[i_point].check_distance(mesh);
+    }
+
+    if (use_cache && rank_ == 0) this->write_points_cache(cache_file, hash);
+    END_TIMER("find_observe_points");
+}
+
+
+std::size_t Observe::search_hash(Mesh &mesh) {
+    std::size_t seed = 0;
+    for (auto elm : mesh.elements_range()) {
+        boost::hash_combine(seed, elm.region().id());
+        for (unsigned int n=0; n<elm->n_nodes(); ++n)
+            for (unsigned int j=0; j<3; ++j) boost::hash_combine(seed, (*elm.node(n))[j]);
+    }
+    for (auto &point : points_) {
+        boost::hash_combine(seed, point.name_);
+        for (unsigned int j=0; j<3; ++j) boost::hash_combine(seed, point.input_point_[j]);
+        boost::hash_combine(seed, point.snap_dim_);
+        boost::hash_combine(seed, point.snap_region_name_);
+        boost::hash_combine(seed, point.max_search_radius_);
+    }
+    return seed;
+}
+
+
+bool Observe::read_points_cache(Mesh &mesh, const std::string &file_name, std::size_t hash) {
+    // the file is read on the first process only, all processes then take the same path
+    // data of a point: element index, distance, global coordinates, number of and local coordinates
+    const unsigned int point_data_size = 9;
+    std::vector<double> cache_data(point_data_size * points_.size(), 0.0);
+    int success = 0;
+    if (rank_ == 0) {
+        std::ifstream cache(file_name);
+        std::string format;
+        std::size_t file_hash;
+        unsigned int n_points;
+        if (cache.is_open()) cache >> format >> file_hash >> n_points;
+        success = ( cache.is_open() && cache && format == "flow123d_observe_cache" && file_hash == hash
+                    && n_points == points_.size() );
+        for (unsigned int i_point=0; success && i_point<n_points; ++i_point) {
+            double *point_data = &(cache_data[point_data_size * i_point]);
+            unsigned int element_idx, n_local;
+            cache >> element_idx >> point_data[1] >> point_data[2] >> point_data[3] >> point_data[4] >> n_local;
+            success = ( cache && element_idx < mesh.n_elements() && n_local <= 3 );
+            if (! success) break;
+            point_data[0] = element_idx;
+            point_data[5] = n_local;
+            for (unsigned int j=0; j<n_local; ++j) cache >> point_data[6+j];
+            success = bool(cache);
+        }
+    }
+    MPI_Bcast(&success, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (! success) return false;
+    MPI_Bcast(&(cache_data[0]), cache_data.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    for (unsigned int i_point=0; i_point<points_.size(); ++i_point) {
+        const double *point_data = &(cache_data[point_data_size * i_point]);
+        ObservePointData &data = points_[i_point].observe_data_;
+        data.element_idx_ = (unsigned int)(point_data[0]);
+        data.distance_ = point_data[1];
+        data.global_coords_ = arma::vec3( &(point_data[2]) );
+        data.local_coords_ = arma::vec( &(point_data[6]), (unsigned int)(point_data[5]) );
+        data.proc_ = mesh.element_accessor(data.element_idx_).proc();
+    }
+    return true;
+}
+
+
+void Observe::write_points_cache(const std::string &file_name, std::size_t hash) {
+    std::ofstream cache(file_name);
+    if (! cache.is_open()) {
+        WarningOut().fmt("Can not write cache file of observe points: '{}'.\n", file_name);
+        return;
+    }
+    cache.precision(17);
+    cache << "flow123d_observe_cache " << hash << " " << points_.size() << endl;
+    for (auto &point : points_) {
+        const ObservePointData &data = point.observe_data_;
+        cache << data.element_idx_ << " " << data.distance_ << " " << data.global_coords_[0] << " "
+              << data.global_coords_[1] << " " << data.global_coords_[2] << " " << data.local_coords_.n_elem;
+        for (unsigned int j=0; j<data.local_coords_.n_elem; ++j) cache << " " << data.local_coords_[j];
+        cache << endl;
+    }
+}
+
+
 template <typename T>
 ElementDataCache<T> & Observe::prepare_compute_data(std::string field_name, double field_time, unsigned int n_rows,
 		unsigned int n_cols)
@@ -433,8 +633,76 @@ void Observe::output_header() {
     observe_file_ << "points:" << endl;
     for(auto &point : points_)
         point.output(observe_file_, indent, precision_);
-    observe_file_ << "data:" << endl;   
+    if (format_ == ObserveFormat::yaml)
+        observe_file_ << "data:" << endl;
+}
 
+void Observe::output_binary_header() {
+    unsigned int indent = 2;
+    // values are written in the native byte order
+    const uint16_t byte_order_test = 1;
+    bool little_endian = ( *reinterpret_cast<const unsigned char *>(&byte_order_test) == 1 );
+    observe_file_ << "byte_order: " << (little_endian ? "little_endian" : "big_endian") << endl;
+    observe_file_ << "fields:" << endl;
+    for(auto &field_data : observe_field_values_) {
+        std::string dtype;
+        switch (field_data.second->vtk_type()) {
+            case VTK_FLOAT64: dtype = "float64"; break;
+            case VTK_UINT32:  dtype = "uint32";  break;
+            case VTK_INT32:   dtype = "int32";   break;
+            default: ASSERT(false)(field_data.first).error("Unsupported data type of observe field.");
+        }
+        observe_file_ << setw(indent) << "" << "- name: " << field_data.second->field_input_name() << endl;
+        observe_file_ << setw(indent) << "" << "  n_comp: " << field_data.second->n_comp() << endl;
+        observe_file_ << setw(indent) << "" << "  dtype: " << dtype << endl;
+        binary_fields_.push_back(field_data.first);
+    }
+    observe_file_ << "binary_data:" << endl;
+}
+
+FilePath Observe::observe_file_path() const {
+    std::string extension = (format_ == ObserveFormat::binary) ? "_observe.bin" : "_observe.yaml";
+    return FilePath(observe_name_ + extension, FilePath::output_file);
+}
+
+void Observe::save_state(CheckpointData &data) {
+    if (points_.size() == 0) return;
+    if (observe_field_values_.size() > 0) flush_values();
+    if (rank_ != 0) return;
+
+    CheckpointData::Scope scope(data, "observe_" + observe_name_);
+    observe_file_.flush();
+    std::ifstream in( string(observe_file_path()), std::ios::binary );
+    std::stringstream content;
+    content << in.rdbuf();
+    data.save("file", content.str());
+
+    std::string fields;
+    for (auto &name : binary_fields_) fields += name + "\n";
+    data.save("binary_fields", fields);
+}
+
+void Observe::restore_state(CheckpointData &data) {
+    if (points_.size() == 0) return;
+    observe_values_time_.clear();
+    observe_values_time_.reserve(max_observe_value_time);
+    observe_values_time_.push_back(numeric_limits<double>::signaling_NaN());
+    observe_time_idx_ = 0;
+    if (rank_ != 0) return;
+
+    CheckpointData::Scope scope(data, "observe_" + observe_name_);
+    std::string content, fields;
+    data.load("file", content);
+    data.load("binary_fields", fields);
+
+    observe_file_.close();
+    observe_file_.open( string(observe_file_path()), std::ios::out | std::ios::trunc | std::ios::binary );
+    observe_file_.write(content.data(), content.size());
+    observe_file_.flush();
+
+    binary_fields_.clear();
+    std::istringstream fields_stream(fields);
+    for (std::string name; std::getline(fields_stream, name); ) binary_fields_.push_back(name);
 }
 
 void Observe::flush_values() {
@@ -447,7 +715,20 @@ void Observe::flush_values() {
         if (rank_==0) field_data.second = serial_data;
     }
 
-    if (rank_ == 0) {
+    if (rank_ == 0 && format_ == ObserveFormat::binary) {
+        DebugOut() << "Observe::output_time_frame WRITE BINARY\n";
+        if (binary_fields_.size() == 0) output_binary_header();
+        for(auto &field_data : observe_field_values_)
+            if ( std::find(binary_fields_.begin(), binary_fields_.end(), field_data.first) == binary_fields_.end() )
+                THROW( ExcObserveFieldMismatch() << EI_FieldName(field_data.first) );
+        ASSERT_EQ(binary_fields_.size(), observe_field_values_.size());
+        for (unsigned int i_time=0; i_time<observe_time_idx_; ++i_time) {
+            observe_file_.write(reinterpret_cast<const char*>(&(observe_values_time_[i_time])), sizeof(double));
+            for(auto &field_name : binary_fields_)
+                observe_field_values_[field_name]->print_binary_subarray(observe_file_, i_time*points_.size(), (i_time+1)*points_.size());
+        }
+        observe_file_.flush();
+    } else if (rank_ == 0) {
         unsigned int indent = 2;
         DebugOut() << "Observe::output_time_frame WRITE\n";
         for (unsigned int i_time=0; i_time<observe_time_idx_; ++i_time) {
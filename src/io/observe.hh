@@ -18,16 +18,19 @@
 #include <armadillo>
 #include "input/accessors.hh"                // for Array (ptr only), Record
 #include "input/input_exception.hh"          // for DECLARE_INPUT_EXCEPTION
+#include "system/file_path.hh"               // for FilePath
 #include "system/exceptions.hh"              // for operator<<, ExcStream, EI
 #include "system/armadillo_tools.hh"         // for Armadillo vec string
 #include "system/index_types.hh"             // for LongIdx
 #include "mesh/range_wrapper.hh"
+#include "mesh/region.hh"                    // for RegionSet
 #include "tools/general_iterator.hh"
 #include "la/distribution.hh"
 
+class CheckpointData;
 class ElementDataCacheBase;
 class Mesh;
-namespace Input { namespace Type { class Record; } }
+namespace Input { namespace Type { class Record; class Selection; } }
 template <typename T> class ElementDataCache;
 
 
@@ -145,6 +148,21 @@ protected:
      */
     void find_observe_point(Mesh &mesh);
 
+    /**
+     * First part of @p find_observe_point: get region set of snapping and elements containing
+     * the initial point. Uses BIH tree of the mesh, so it can't be called concurrently.
+     */
+    void find_candidates(Mesh &mesh, RegionSet &region_set, std::vector<unsigned int> &candidate_list);
+
+    /**
+     * Second part of @p find_observe_point: BFS from candidate elements, projection and snapping.
+     * Can be called concurrently for different points (Mesh::node_elements must be created before).
+     */
+    void find_observe_element(Mesh &mesh, const RegionSet &region_set, const std::vector<unsigned int> &candidate_list);
+
+    /// Warn if observe element is too distant from the initial point.
+    void check_distance(Mesh &mesh);
+
     /**
      * Output the observe point information into a YAML formated stream, indent by
      * given number of spaces + "- ".
@@ -193,9 +211,28 @@ class ObservePointAccessor;
 /**
  * This class takes care about the observe points in the output stream, storing observe values of the fields and
  * their output in the YAML format.
+ *
+ * Optionally values are written in the binary format. The file starts with a YAML header (same as the YAML output
+ * extended by the byte order of the values and the list of fields with their number of components and data types) terminated by the line
+ * 'binary_data:'. Then follows one fixed size record per time frame: time (float64) and for every field of
+ * the header the values of all observe points in the global point order (n_points * n_comp values).
+ * Records are appended at every flush, see src/python/utils/observe_reader.py.
  */
 class Observe {
 public:
+    /// Format of the observe output file.
+    enum ObserveFormat {
+        yaml,    //!< YAML text file (default)
+        binary   //!< YAML header followed by binary records
+    };
+
+    TYPEDEF_ERR_INFO(EI_FieldName, std::string);
+    DECLARE_EXCEPTION(ExcObserveFieldMismatch,
+            << "Field " << EI_FieldName::qval << " is not in the header of the binary observe file. "
+            << "All observe fields have to be computed in the first output time frame.\n");
+
+    /// Input type of the observe output format.
+    static const Input::Type::Selection & get_format_selection();
 
     typedef std::shared_ptr<ElementDataCacheBase> OutputDataPtr;
     typedef std::map< string,  OutputDataPtr > OutputDataFieldMap;
@@ -207,7 +244,8 @@ public:
      * mesh - the mesh used for search for the observe points
      * in_array - the array of observe points
      */
-    Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigned int precision, std::string unit_str);
+    Observe(string observe_name, Mesh &mesh, Input::Array in_array, unsigned int precision, std::string unit_str,
+            ObserveFormat format = ObserveFormat::yaml, bool use_cache = false);
 
     /// Destructor, must close the file.
     ~Observe();
@@ -262,12 +300,53 @@ public:
     template <typename T>
     ElementDataCache<T> & prepare_compute_data(std::string field_name, double field_time, unsigned int n_rows, unsigned int n_cols);
 
+    /**
+     * Write buffered values and save content of the observe file to the checkpoint.
+     * Collective, the file content is saved only by the process 0.
+     */
+    void save_state(CheckpointData &data);
+
+    /**
+     * Replace the observe file (truncated by the constructor) by the content saved in the checkpoint,
+     * following values are appended.
+     */
+    void restore_state(CheckpointData &data);
+
 
 
 protected:
     /// Effectively writes the data into the observe stream.
     void flush_values();
 
+    /// Write fields part of the header of binary file, called at first flush.
+    void output_binary_header();
+
+    /// Path to the observe file.
+    FilePath observe_file_path() const;
+
+    /**
+     * Find observe elements of all points.
+     *
+     * Initial elements of the points are found by BIH tree first, then the points are distributed
+     * over processes (and threads if OpenMP is enabled) for BFS and projection and the results
+     * are exchanged. If @p use_cache is set, results are read from / written to the cache file
+     * '<observe_name>_observe_points.cache' identified by hash of the mesh and the point inputs.
+     */
+    void find_observe_points(Mesh &mesh, bool use_cache);
+
+    /// Hash of the mesh geometry and the input of observe points, identifies the cache file.
+    std::size_t search_hash(Mesh &mesh);
+
+    /**
+     * Read results of @p find_observe_points from cache file, return false if the file doesn't match.
+     * The file is read by the first process, the result and the point data are broadcast, so the return value is
+     * the same on all processes.
+     */
+    bool read_points_cache(Mesh &mesh, const std::string &file_name, std::size_t hash);
+
+    /// Write results of @p find_observe_points to cache file.
+    void write_points_cache(const std::string &file_name, std::size_t hash);
+
     /// Maximal size of observe values times vector
     static const unsigned int max_observe_value_time;
 
@@ -292,6 +371,12 @@ protected:
     /// Output file stream.
     std::ofstream observe_file_;
 
+    /// Format of the output file.
+    ObserveFormat format_;
+
+    /// Names of fields written in the header of binary file, empty until the first flush.
+    std::vector<std::string> binary_fields_;
+
     /// String representation of the time unit.
     std::string time_unit_str_;
     /// Time unit in seconds.
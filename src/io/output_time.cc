@@ -57,6 +57,11 @@ const IT::Record & OutputTime::get_input_type() {
                 "Default is 17 decimal digits which are necessary to reproduce double values exactly after write-read cycle.")
         .declare_key("observe_points", IT::Array(ObservePoint::get_input_type()), IT::Default("[]"),
                 "Array of observe points.")
+        .declare_key("observe_format", Observe::get_format_selection(), IT::Default("\"yaml\""),
+                "Format of the file with values in observe points.")
+        .declare_key("observe_cache", IT::Bool(), IT::Default("false"),
+                "Store found observe elements to the file '<equation>_observe_points.cache' and reuse them in next runs "
+                "with the same mesh and observe points.")
 		.close();
 }
 
@@ -232,12 +237,27 @@ std::shared_ptr<Observe> OutputTime::observe(Mesh *mesh)
     if (! observe_) {
         auto observe_points = input_record_.val<Input::Array>("observe_points");
         unsigned int precision = input_record_.val<unsigned int>("precision");
-        observe_ = std::make_shared<Observe>(this->equation_name_, *mesh, observe_points, precision, this->unit_string_);
+        auto format = input_record_.val<Observe::ObserveFormat>("observe_format");
+        bool use_cache = input_record_.val<bool>("observe_cache");
+        observe_ = std::make_shared<Observe>(this->equation_name_, *mesh, observe_points, precision, this->unit_string_,
+                format, use_cache);
     }
     return observe_;
 }
 
 
+void OutputTime::save_state(CheckpointData &data)
+{
+    if (observe_) observe_->save_state(data);
+}
+
+
+void OutputTime::restore_state(CheckpointData &data)
+{
+    if (observe_) observe_->restore_state(data);
+}
+
+
 void OutputTime::clear_data(void)
 {
     // fill all the existing output data with dummy cash
@@ -25,6 +25,7 @@
 #include "input/accessors.hh"   // for Iterator, Array (ptr only), Record
 #include "system/file_path.hh"  // for FilePath
 
+class CheckpointData;
 class ElementDataCacheBase;
 class Mesh;
 class Observe;
@@ -148,6 +149,15 @@ public:
      */
     std::shared_ptr<Observe> observe(Mesh *mesh);
 
+    /**
+     * Save state of the observe output to the checkpoint. Other output files are not saved,
+     * after restart they contain only time frames written from the restart time.
+     */
+    void save_state(CheckpointData &data);
+
+    /// Restore state of the observe output saved by @p save_state.
+    void restore_state(CheckpointData &data);
+
     /**
      * \brief Clear data for output computed by method @p compute_field_data.
      */
@@ -28,6 +28,8 @@
  * Implementation of ReaderCache
  */
 
+const std::size_t ReaderCache::default_data_cache_size = 256 * 1024 * 1024;
+
 ReaderCache * ReaderCache::instance() {
 	static ReaderCache *instance = new ReaderCache;
 	return instance;
@@ -82,3 +84,24 @@ void ReaderCache::get_element_ids(const FilePath &file_path, const Mesh &mesh) {
 	reader_ptr->has_compatible_mesh_ = true;
 	mesh.elements_id_maps(reader_ptr->bulk_elements_id_, reader_ptr->boundary_elements_id_);
 }
+
+std::shared_ptr<InterpolationOperator> ReaderCache::get_interpolation_operator(const FilePath &file_path,
+		const InterpolationOperator::Key &key) {
+	auto &interpolations = ReaderCache::get_reader_data(file_path)->second.interpolations_;
+	auto it = interpolations.find(key);
+	if (it == interpolations.end()) return nullptr;
+	return it->second;
+}
+
+void ReaderCache::set_interpolation_operator(const FilePath &file_path, const InterpolationOperator::Key &key,
+		std::shared_ptr<InterpolationOperator> interp_operator) {
+	ReaderCache::get_reader_data(file_path)->second.interpolations_[key] = interp_operator;
+}
+
+ElementDataLRU &ReaderCache::data_lru() {
+	return ReaderCache::instance()->data_lru_;
+}
+
+void ReaderCache::set_data_cache_size(std::size_t n_bytes) {
+	ReaderCache::instance()->data_lru_.set_capacity(n_bytes);
+}
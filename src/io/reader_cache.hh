@@ -23,6 +23,8 @@
 #include <memory>               // for shared_ptr
 #include <string>               // for string
 #include "system/file_path.hh"  // for FilePath
+#include "io/interpolation_operator.hh"
+#include "io/element_data_lru.hh"
 
 class BaseMeshReader;
 class Mesh;
@@ -37,6 +39,8 @@ public:
 	struct ReaderData {
 		std::shared_ptr<BaseMeshReader> reader_;
 		std::shared_ptr<Mesh> mesh_;
+		/// Interpolation operators from mesh_ to target meshes
+		std::map< InterpolationOperator::Key, std::shared_ptr<InterpolationOperator> > interpolations_;
 	};
 
 	typedef std::map< string, ReaderData > ReaderTable;
@@ -61,18 +65,49 @@ public:
 	 */
 	static void get_element_ids(const FilePath &file_path, const Mesh &mesh);
 
+	/**
+	 * Returns interpolation operator from mesh of given FilePath to target given by \p key.
+	 *
+	 * Returns nullptr if operator was not stored by \p set_interpolation_operator yet.
+	 */
+	static std::shared_ptr<InterpolationOperator> get_interpolation_operator(const FilePath &file_path,
+			const InterpolationOperator::Key &key);
+
+	/**
+	 * Store interpolation operator from mesh of given FilePath to target given by \p key.
+	 */
+	static void set_interpolation_operator(const FilePath &file_path, const InterpolationOperator::Key &key,
+			std::shared_ptr<InterpolationOperator> interp_operator);
+
+	/**
+	 * Returns cache of decoded element data shared by all readers.
+	 */
+	static ElementDataLRU &data_lru();
+
+	/**
+	 * Set memory budget of the cache of decoded element data in bytes (zero switches the cache off).
+	 */
+	static void set_data_cache_size(std::size_t n_bytes);
+
+	/// Default memory budget of the cache of decoded element data, 256 MB.
+	static const std::size_t default_data_cache_size;
+
 private:
 	/// Returns singleton instance
 	static ReaderCache * instance();
 
 	/// Constructor
-	ReaderCache() {};
+	ReaderCache()
+	: data_lru_(default_data_cache_size) {};
 
 	/// Returns instance of given FilePath. If reader doesn't exist, creates new ReaderData object.
 	static ReaderTable::iterator get_reader_data(const FilePath &file_path);
 
 	/// Table of readers
 	ReaderTable reader_table_;
+
+	/// Decoded element data of all readers
+	ElementDataLRU data_lru_;
 };
 
 
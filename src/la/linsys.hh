@@ -207,10 +207,11 @@ public:
     }
     
     /**
-     * Sets matrix changed flag.
+     * Sets matrix changed flag. The flag can be also cleared, e.g. after assembly of the right hand side
+     * that does not modify the matrix, so that the preconditioner can be reused.
      */
-    void set_matrix_changed()
-    { matrix_changed_ = true;}
+    void set_matrix_changed(bool changed = true)
+    { matrix_changed_ = changed;}
 
     /**
      * Sets rhs changed flag  (only for PETSC solvers)
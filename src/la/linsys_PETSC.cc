@@ -17,12 +17,18 @@
  */
 
 // derived from base linsys
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "la/linsys_PETSC.hh"
+#include "la/single_precision_matrix.hh"
 #include "petscvec.h"
 #include "petscksp.h"
 #include "petscmat.h"
 #include "system/sys_profiler.hh"
 #include "system/system.hh"
+#include "system/time_point.hh"
 
 
 //#include <boost/bind.hpp>
@@ -51,6 +57,46 @@ const it::Record & LinSys_PETSC::get_input_type() {
                     "Maximum number of outer iterations of the linear solver.")
 		.declare_key("options", it::String(), it::Default("\"\""),  "This options is passed to PETSC to create a particular KSP (Krylov space method).\n"
                                                                     "If the string is left empty (by default), the internal default options is used.")
+		.declare_key("pc_reuse_steps", it::Integer(0), it::Default("0"),
+		            "Maximal number of solves with a changed matrix that reuse the preconditioner set up for an earlier matrix. "
+		            "Zero means that the preconditioner is set up for every changed matrix.")
+		.declare_key("pc_reuse_iteration_factor", it::Double(1.0), it::Default("2.0"),
+		            "The reused preconditioner is set up again when the number of iterations exceeds this factor "
+		            "times the number of iterations of the solve with the fresh preconditioner.")
+		.declare_key("refinement_r_tol", it::Double(0.0, 1.0), it::Default("0.0"),
+		            "Relative tolerance of the inner solves of the iterative refinement. "
+		            "If positive, the system is solved by repeated inner solves for the correction with this relaxed tolerance, "
+		            "the residual is recomputed in double precision after each correction until it satisfies 'r_tol' and 'a_tol'. "
+		            "The inner solves multiply by a single precision copy of the matrix, the preconditioner is set up from the original one. "
+		            "Note that the criterion uses the true (not preconditioned) residual. Zero switches the refinement off.")
+		.declare_key("refinement_max_steps", it::Integer(1), it::Default("20"),
+		            "Maximal number of steps of the iterative refinement.")
+		.declare_key("krylov_method", LinSys_PETSC::get_krylov_method_selection(), it::Default("\"options\""),
+		            "Krylov method of the solver. Pipelined methods hide the latency of global reductions and pay off "
+		            "on large number of processes. The pipelined CG methods need a symmetric preconditioner, "
+		            "for an incompatible one the classical method is used.")
+		.declare_key("log_reductions", it::Bool(), it::Default("false"),
+		            "Log time spent in global reductions (vector norms and dot products) of the Krylov method "
+		            "separately from the local work, as the profiler timer 'PETSC global reductions' in the linear iterations.")
+		.declare_key("local_elimination", it::Bool(), it::Default("false"),
+		            "Used only by Schur complement solvers (e.g. Darcy flow). If true, the Schur complement is formed "
+		            "from dense products of the eliminated local blocks instead of PETSc matrix products "
+		            "(except for the first formation that creates the nonzero patterns).")
+		.close();
+}
+
+
+const it::Selection & LinSys_PETSC::get_krylov_method_selection() {
+	return it::Selection("KrylovMethod", "Krylov method of the PETSc solver.")
+		.add_value(KrylovMethod::options, "options", "Method given by 'options' or by the internal default options.")
+		.add_value(KrylovMethod::cg, "cg", "Conjugate gradients.")
+		.add_value(KrylovMethod::pipecg, "pipecg", "Pipelined conjugate gradients, one non-blocking reduction per iteration.")
+		.add_value(KrylovMethod::groppcg, "groppcg", "Pipelined conjugate gradients by Gropp.")
+		.add_value(KrylovMethod::pipecr, "pipecr", "Pipelined conjugate residuals.")
+		.add_value(KrylovMethod::gmres, "gmres", "Restarted GMRES.")
+		.add_value(KrylovMethod::pgmres, "pgmres", "Pipelined GMRES.")
+		.add_value(KrylovMethod::pipefgmres, "pipefgmres", "Pipelined flexible GMRES.")
+		.add_value(KrylovMethod::bcgs, "bcgs", "Stabilized bi-conjugate gradients.")
 		.close();
 }
 
@@ -58,11 +104,86 @@ const it::Record & LinSys_PETSC::get_input_type() {
 const int LinSys_PETSC::registrar = LinSys_PETSC::get_input_type().size();
 
 
+namespace {
+
+/// Names of PETSc log events of global reductions in Krylov methods.
+const std::vector<std::string> reduction_events = {"VecNorm", "VecDot", "VecTDot", "VecMDot", "VecReduceComm", "VecReduceEnd"};
+
+typedef PetscErrorCode (*PetscLogHandler)(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject);
+
+/// PETSc log handlers installed before LinSys_PETSC::setup_reduction_log (e.g. by '-log_view'), called by our handlers.
+PetscLogHandler petsc_log_begin = nullptr, petsc_log_end = nullptr;
+
+/// Ids of @p reduction_events.
+std::vector<PetscLogEvent> reduction_event_ids;
+
+/// Number of running solves with logged reductions, reductions out of the solves are not logged.
+unsigned int n_logged_solves = 0;
+
+/// Depth of nested reduction events, the profiler timer is open for the outermost one.
+unsigned int reduction_depth = 0;
+
+/// Return true for a reduction event during a solve with logged reductions.
+inline bool is_logged_reduction(PetscLogEvent event)
+{
+    return n_logged_solves > 0
+           && std::find(reduction_event_ids.begin(), reduction_event_ids.end(), event) != reduction_event_ids.end();
+}
+
+/// PETSc log handler of event begin, opens the profiler timer of reductions.
+PetscErrorCode reduction_log_begin(PetscLogEvent event, int t, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+    if (petsc_log_begin != nullptr) chkerr(petsc_log_begin(event, t, o1, o2, o3, o4));
+#ifdef FLOW123D_DEBUG_PROFILER
+    if (is_logged_reduction(event) && reduction_depth++ == 0) {
+        static CONSTEXPR_ CodePoint cp = CODE_POINT("PETSC global reductions");
+        Profiler::instance()->start_timer(cp);
+    }
+#endif
+    return 0;
+}
+
+/// PETSc log handler of event end, closes the profiler timer of reductions.
+PetscErrorCode reduction_log_end(PetscLogEvent event, int t, PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+#ifdef FLOW123D_DEBUG_PROFILER
+    if (reduction_depth > 0 && is_logged_reduction(event) && --reduction_depth == 0) {
+        END_TIMER("PETSC global reductions");
+    }
+#endif
+    if (petsc_log_end != nullptr) chkerr(petsc_log_end(event, t, o1, o2, o3, o4));
+    return 0;
+}
+
+/// Marks a solve with logged reductions for the lifetime of the object.
+class LoggedSolve {
+public:
+    LoggedSolve(bool log) : log_(log)
+    { if (log_) n_logged_solves++; }
+
+    ~LoggedSolve()
+    { if (log_) n_logged_solves--; }
+private:
+    bool log_;
+};
+
+} // namespace
+
+
 LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &params)
         : LinSys( rows_ds ),
           params_(params),
           init_guess_nonzero(false),
-          matrix_(0)
+          matrix_(0),
+          count_pattern_(true),
+          system(nullptr),
+          refinement_r_tol_(0.0),
+          refinement_max_steps_(20),
+          krylov_method_(KrylovMethod::options),
+          log_reductions_(false),
+          direct_solver_(false),
+          block_size_(1),
+          near_null_space_(nullptr)
 {
     // create PETSC vectors:
     PetscErrorCode ierr;
@@ -71,6 +192,8 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
     ierr = VecCreateMPIWithArray( comm_, 1, rows_ds_->lsize(), PETSC_DECIDE, v_rhs_, &rhs_ ); CHKERRV( ierr );
     ierr = VecZeroEntries( rhs_ ); CHKERRV( ierr );
     VecDuplicate(rhs_, &residual_);
+    correction_ = NULL;
+    single_matrix_ = NULL;
 
     matrix_ = NULL;
     solution_precision_ = std::numeric_limits<double>::infinity();
@@ -79,8 +202,16 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
 }
 
 LinSys_PETSC::LinSys_PETSC( LinSys_PETSC &other )
-	: LinSys(other), params_(other.params_), v_rhs_(NULL), solution_precision_(other.solution_precision_)
+	: LinSys(other), params_(other.params_), v_rhs_(NULL), pattern_(other.pattern_), count_pattern_(other.count_pattern_),
+	  solution_precision_(other.solution_precision_), system(nullptr), pc_reuse_(other.pc_reuse_),
+	  refinement_r_tol_(other.refinement_r_tol_), refinement_max_steps_(other.refinement_max_steps_),
+	  krylov_method_(other.krylov_method_), log_reductions_(other.log_reductions_),
+	  direct_solver_(other.direct_solver_), block_size_(other.block_size_), near_null_space_(other.near_null_space_)
 {
+	correction_ = NULL;
+	single_matrix_ = NULL;
+	if (near_null_space_ != nullptr) PetscObjectReference((PetscObject)near_null_space_);
+	pc_reuse_.invalidate();
 	MatCopy(other.matrix_, matrix_, DIFFERENT_NONZERO_PATTERN);
 	VecCopy(other.rhs_, rhs_);
 	VecCopy(other.on_vec_, on_vec_);
@@ -107,11 +238,35 @@ void LinSys_PETSC::start_allocation( )
 {
     PetscErrorCode ierr;
 
-    ierr = VecCreateMPI( comm_, rows_ds_->lsize(), PETSC_DECIDE, &(on_vec_) ); CHKERRV( ierr ); 
-    ierr = VecDuplicate( on_vec_, &(off_vec_) ); CHKERRV( ierr ); 
+    if (count_pattern_) {
+        if (pattern_ == nullptr) pattern_ = std::make_shared<SparsityPattern>(rows_ds_->lsize());
+        else pattern_->clear();
+
+        ierr = VecCreateMPI( comm_, rows_ds_->lsize(), PETSC_DECIDE, &(on_vec_) ); CHKERRV( ierr );
+        ierr = VecDuplicate( on_vec_, &(off_vec_) ); CHKERRV( ierr );
+    }
     status_ = ALLOCATE;
 }
 
+
+void LinSys_PETSC::share_sparsity_pattern(LinSys_PETSC &other)
+{
+    ASSERT_EQ(rows_ds_->lsize(), other.rows_ds_->lsize()).error("Different distributions of systems sharing sparsity pattern.");
+    ASSERT(status_ == NONE || status_ == ALLOCATE)(status_).error("Sparsity pattern can be shared only before preallocation.");
+    if (other.pattern_ == nullptr) other.pattern_ = std::make_shared<SparsityPattern>(other.rows_ds_->lsize());
+    pattern_ = other.pattern_;
+    count_pattern_ = false;
+}
+
+void LinSys_PETSC::set_sparsity_pattern(std::shared_ptr<SparsityPattern> pattern)
+{
+    ASSERT(pattern != nullptr && pattern->is_complete()).error("Sparsity pattern has to be complete.");
+    ASSERT_EQ(rows_ds_->lsize(), pattern->lsize()).error("Sparsity pattern of different distribution.");
+    ASSERT(status_ == NONE || status_ == ALLOCATE)(status_).error("Sparsity pattern can be set only before preallocation.");
+    pattern_ = pattern;
+    count_pattern_ = false;
+}
+
 void LinSys_PETSC::start_add_assembly()
 {
     switch ( status_ ) {
@@ -157,7 +312,7 @@ void LinSys_PETSC::mat_set_values( int nrow, int *rows, int ncol, int *cols, dou
             chkerr(MatSetValues(matrix_,nrow,rows,ncol,cols,vals,(InsertMode)status_));
             break;
         case ALLOCATE:
-            this->preallocate_values(nrow,rows,ncol,cols); 
+            if (count_pattern_) this->preallocate_values(nrow,rows,ncol,cols);
             break;
         default: DebugOut() << "LS SetValues with non allowed insert mode.\n";
     }
@@ -205,46 +360,53 @@ void LinSys_PETSC::preallocate_matrix()
 	OLD_ASSERT(status_ == ALLOCATE, "Linear system has to be in ALLOCATE status.");
 
     PetscErrorCode ierr;
-    PetscInt *on_nz, *off_nz;
-    PetscScalar *on_array, *off_array;
 
-    // assembly and get values from counting vectors, destroy them
-    VecAssemblyBegin(on_vec_);
-    VecAssemblyBegin(off_vec_);
+    if (count_pattern_) {
+        PetscScalar *on_array, *off_array;
 
-    on_nz  = new PetscInt[ rows_ds_->lsize() ];
-    off_nz = new PetscInt[ rows_ds_->lsize() ];
+        // assembly and get values from counting vectors, destroy them
+        VecAssemblyBegin(on_vec_);
+        VecAssemblyBegin(off_vec_);
+        VecAssemblyEnd(on_vec_);
+        VecAssemblyEnd(off_vec_);
 
-    VecAssemblyEnd(on_vec_);
-    VecAssemblyEnd(off_vec_);
+        VecGetArray( on_vec_,  &on_array );
+        VecGetArray( off_vec_, &off_array );
 
-    VecGetArray( on_vec_,  &on_array );
-    VecGetArray( off_vec_, &off_array );
+        for ( unsigned int i=0; i<rows_ds_->lsize(); i++ ) {
+            pattern_->set_row(i,
+                    std::min( rows_ds_->lsize(), static_cast<uint>( on_array[i]+0.1  ) ),  // small fraction to ensure correct rounding
+                    std::min( rows_ds_->size() - rows_ds_->lsize(), static_cast<uint>( off_array[i]+0.1 ) ) );
+        }
+        pattern_->close();
 
-    for ( unsigned int i=0; i<rows_ds_->lsize(); i++ ) {
-        on_nz[i]  = std::min( rows_ds_->lsize(), static_cast<uint>( on_array[i]+0.1  ) );  // small fraction to ensure correct rounding
-        off_nz[i] = std::min( rows_ds_->size() - rows_ds_->lsize(), static_cast<uint>( off_array[i]+0.1 ) );
+        VecRestoreArray(on_vec_,&on_array);
+        VecRestoreArray(off_vec_,&off_array);
+        VecDestroy(&on_vec_);
+        VecDestroy(&off_vec_);
+    } else {
+        ASSERT(pattern_->is_complete()).error("Shared sparsity pattern is not complete, its owner has to be preallocated first.");
     }
 
-    VecRestoreArray(on_vec_,&on_array);
-    VecRestoreArray(off_vec_,&off_array);
-    VecDestroy(&on_vec_);
-    VecDestroy(&off_vec_);
-
     // create PETSC matrix with preallocation
     if (matrix_ != NULL)
     {
     	chkerr(MatDestroy(&matrix_));
     }
-    ierr = MatCreateAIJ(PETSC_COMM_WORLD, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE,
-                           0, on_nz, 0, off_nz, &matrix_); CHKERRV( ierr );
+    // preconditioner of the destroyed matrix can not be reused
+    pc_reuse_.invalidate();
+    // the same as MatCreateAIJ, but the block size has to be set before the preallocation
+    ierr = MatCreate(PETSC_COMM_WORLD, &matrix_); CHKERRV( ierr );
+    ierr = MatSetSizes(matrix_, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE); CHKERRV( ierr );
+    if (block_size_ > 1) { ierr = MatSetBlockSize(matrix_, block_size_); CHKERRV( ierr ); }
+    ierr = MatSetType(matrix_, MATAIJ); CHKERRV( ierr );
+    ierr = MatSeqAIJSetPreallocation(matrix_, 0, pattern_->on_nz()); CHKERRV( ierr );
+    ierr = MatMPIAIJSetPreallocation(matrix_, 0, pattern_->on_nz(), 0, pattern_->off_nz()); CHKERRV( ierr );
+    if (near_null_space_ != nullptr) { ierr = MatSetNearNullSpace(matrix_, near_null_space_); CHKERRV( ierr ); }
 
     if (symmetric_) MatSetOption(matrix_, MAT_SYMMETRIC, PETSC_TRUE);
     MatSetOption(matrix_, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
     MatSetOption(matrix_, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE);
-
-    delete[] on_nz;
-    delete[] off_nz;
 }
 
 void LinSys_PETSC::finish_assembly( )
@@ -261,9 +423,10 @@ void LinSys_PETSC::finish_assembly( MatAssemblyType assembly_type )
     	WarningOut() << "Finalizing linear system without setting values.\n";
         this->preallocate_matrix();
     }
-    ierr = MatAssemblyBegin(matrix_, assembly_type); CHKERRV( ierr ); 
+    // matrix can be released, see release_matrix()
+    if (matrix_ != NULL) { ierr = MatAssemblyBegin(matrix_, assembly_type); CHKERRV( ierr ); }
     ierr = VecAssemblyBegin(rhs_); CHKERRV( ierr ); 
-    ierr = MatAssemblyEnd(matrix_, assembly_type); CHKERRV( ierr ); 
+    if (matrix_ != NULL) { ierr = MatAssemblyEnd(matrix_, assembly_type); CHKERRV( ierr ); }
     ierr = VecAssemblyEnd(rhs_); CHKERRV( ierr ); 
 
     if (assembly_type == MAT_FINAL_ASSEMBLY) status_ = DONE;
@@ -362,58 +525,353 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     }
 
     if (params_ == "") params_ = petsc_dflt_opt;
-    LogOut().fmt("inserting petsc options: {}\n",params_.c_str());
-    
-    // now takes an optional PetscOptions object as the first argument
-    // value NULL will preserve previous behaviour previous behavior.
-    PetscOptionsInsertString(NULL, params_.c_str()); // overwrites previous options values
-    
+
     MatSetOption( matrix_, MAT_USE_INODES, PETSC_FALSE );
-    
-    chkerr(KSPCreate( comm_, &system ));
-    chkerr(KSPSetOperators(system, matrix_, matrix_));
 
+    // The KSP is created only for the first solve and kept alive, so that
+    // its preconditioner can be reused according to the pc_reuse_ policy.
+    if (system == nullptr) {
+        LogOut().fmt("inserting petsc options: {}\n",params_.c_str());
+
+        // now takes an optional PetscOptions object as the first argument
+        // value NULL will preserve previous behaviour previous behavior.
+        PetscOptionsInsertString(NULL, params_.c_str()); // overwrites previous options values
+
+        chkerr(KSPCreate( comm_, &system ));
+        chkerr(KSPSetOperators(system, inner_operator(), matrix_));
+
+        // TODO take care of tolerances - shall we support both input file and command line petsc setting
+        chkerr(KSPSetTolerances(system, r_tol_, a_tol_, PETSC_DEFAULT,  max_it_));
+        KSPSetFromOptions(system);
+        if (krylov_method_ != KrylovMethod::options) set_krylov_method();
+        if (direct_solver_) setup_direct_solver();
+        ksp_r_tol_ = r_tol_;
+        ksp_a_tol_ = a_tol_;
+        ksp_max_it_ = max_it_;
+    } else {
+        chkerr(KSPSetOperators(system, inner_operator(), matrix_));
+        // tolerances changed since the KSP creation, e.g. by the nonlinear solver
+        if (r_tol_ != ksp_r_tol_ || a_tol_ != ksp_a_tol_ || max_it_ != ksp_max_it_) {
+            chkerr(KSPSetTolerances(system, r_tol_, a_tol_, PETSC_DEFAULT,  max_it_));
+            ksp_r_tol_ = r_tol_;
+            ksp_a_tol_ = a_tol_;
+            ksp_max_it_ = max_it_;
+        }
+    }
 
-    // TODO take care of tolerances - shall we support both input file and command line petsc setting
-    chkerr(KSPSetTolerances(system, r_tol_, a_tol_, PETSC_DEFAULT,PETSC_DEFAULT));
-    chkerr(KSPSetTolerances(system, r_tol_, a_tol_, PETSC_DEFAULT,  max_it_));
-    KSPSetFromOptions(system);
     // We set the KSP flag set_initial_guess_nonzero
     // unless KSP type is preonly.
     // In such case PETSc fails (version 3.4.1)
-    if (init_guess_nonzero)
     {
     	KSPType type;
     	KSPGetType(system, &type);
     	if (strcmp(type, KSPPREONLY) != 0)
-    		KSPSetInitialGuessNonzero(system, PETSC_TRUE);
+    		KSPSetInitialGuessNonzero(system, init_guess_nonzero ? PETSC_TRUE : PETSC_FALSE);
+    }
+
+    // factorization of the direct solver can not be reused for a changed matrix
+    bool rebuild_pc = pc_reuse_.rebuild_needed(matrix_changed_) || (direct_solver_ && matrix_changed_);
+    chkerr(KSPSetReusePreconditioner(system, rebuild_pc ? PETSC_FALSE : PETSC_TRUE));
+
+    // setup of the preconditioner is done explicitly in order to measure it apart from the iterations
+    double setup_time, solve_time;
+    {
+        START_TIMER("PETSC preconditioner setup");
+        TimePoint t_start;
+        setup_ksp();
+        setup_time = TimePoint() - t_start;
     }
 
     {
 		START_TIMER("PETSC linear solver");
 		START_TIMER("PETSC linear iteration");
-		chkerr(KSPSolve(system, rhs_, solution_ ));
-		KSPGetConvergedReason(system,&reason);
-		KSPGetIterationNumber(system,&nits);
+		TimePoint t_start;
+		LoggedSolve logged_solve(log_reductions_);
+		if (refinement_r_tol_ > 0.0) {
+		    nits = solve_refinement(*this);
+		} else {
+		    chkerr(KSPSolve(system, rhs_, solution_ ));
+		    KSPGetConvergedReason(system,&reason);
+		    KSPGetIterationNumber(system,&nits);
+		    // get residual norm
+		    KSPGetResidualNorm(system, &solution_precision_);
+		}
 		ADD_CALLS(nits);
+		solve_time = TimePoint() - t_start;
     }
+    pc_reuse_.solved(rebuild_pc, matrix_changed_, nits);
+    matrix_changed_ = false;
+    rhs_changed_ = false;
+
+    if (rebuild_pc)
+        LogOut().fmt("preconditioner set up in {} s, solved in {} s\n", setup_time, solve_time);
+    else
+        LogOut().fmt("preconditioner reused ({}x), solved in {} s\n", pc_reuse_.n_reused(), solve_time);
+
     // substitute by PETSc call for residual
     VecNorm(rhs_, NORM_2, &residual_norm_);
     
     LogOut().fmt("convergence reason {}, number of iterations is {}\n", reason, nits);
 
-    // get residual norm
-    KSPGetResidualNorm(system, &solution_precision_);
-
     // TODO: I do not understand this 
     //Profiler::instance()->set_timer_subframes("SOLVING MH SYSTEM", nits);
 
-    chkerr(KSPDestroy(&system));
+    return LinSys::SolveInfo(static_cast<int>(reason), static_cast<int>(nits));
+
+}
+
+LinSys::SolveInfo LinSys_PETSC::solve_with_operator(LinSys_PETSC &owner)
+{
+    ASSERT_PTR(owner.system).error("Owner of the operator has to be solved first.\n");
+    int nits;
+
+    {
+        START_TIMER("PETSC linear solver");
+        START_TIMER("PETSC linear iteration");
+        TimePoint t_start;
+        LoggedSolve logged_solve(log_reductions_);
+        if (owner.refinement_r_tol_ > 0.0) {
+            // KSP of the owner uses the single precision operator and the relaxed tolerance
+            nits = solve_refinement(owner);
+        } else {
+            chkerr(KSPSolve(owner.system, rhs_, solution_));
+            KSPGetConvergedReason(owner.system, &reason);
+            KSPGetIterationNumber(owner.system, &nits);
+            KSPGetResidualNorm(owner.system, &solution_precision_);
+        }
+        ADD_CALLS(nits);
+        LogOut().fmt("shared operator, solved in {} s\n", TimePoint() - t_start);
+    }
+    rhs_changed_ = false;
+
+    VecNorm(rhs_, NORM_2, &residual_norm_);
+    LogOut().fmt("convergence reason {}, number of iterations is {}\n", reason, nits);
 
     return LinSys::SolveInfo(static_cast<int>(reason), static_cast<int>(nits));
+}
+
+
+void LinSys_PETSC::release_matrix()
+{
+    ASSERT(! count_pattern_).error("Only system with shared sparsity pattern can release its matrix.\n");
+    if (system != nullptr) chkerr(KSPDestroy(&system));
+    if (single_matrix_ != NULL) chkerr(MatDestroy(&single_matrix_));
+    if (matrix_ != NULL) chkerr(MatDestroy(&matrix_));
+    pc_reuse_.invalidate();
+    matrix_changed_ = true;
+}
+
+
+void LinSys_PETSC::set_direct_solver()
+{
+    ASSERT(system == nullptr).error("Direct solver has to be set before the first solve.\n");
+    direct_solver_ = true;
+}
+
+
+void LinSys_PETSC::set_block_size(unsigned int block_size)
+{
+    ASSERT(matrix_ == NULL).error("Block size has to be set before the allocation of the matrix.\n");
+    ASSERT(rows_ds_->lsize() % block_size == 0)(rows_ds_->lsize())(block_size).error("Local size is not divisible by the block size.\n");
+    block_size_ = block_size;
+}
+
+
+void LinSys_PETSC::set_near_null_space(std::vector<Vec> &basis)
+{
+    ASSERT(matrix_ == NULL).error("Near null space has to be set before the allocation of the matrix.\n");
+
+    // MatNullSpaceCreate requires orthonormal vectors, modified Gram-Schmidt
+    std::vector<Vec> orthonormal;
+    for (Vec v : basis) {
+        PetscReal norm_orig, norm;
+        chkerr(VecNorm(v, NORM_2, &norm_orig));
+        for (Vec u : orthonormal) {
+            PetscScalar dot;
+            chkerr(VecDot(v, u, &dot));
+            chkerr(VecAXPY(v, -dot, u));
+        }
+        chkerr(VecNormalize(v, &norm));
+        if (norm > 1e-10 * norm_orig) orthonormal.push_back(v);
+    }
+    if (orthonormal.size() < basis.size())
+        LogOut().fmt("Near null space: {} of {} vectors are linearly dependent and dropped.\n",
+                basis.size() - orthonormal.size(), basis.size());
+
+    if (near_null_space_ != nullptr) chkerr(MatNullSpaceDestroy(&near_null_space_));
+    chkerr(MatNullSpaceCreate(comm_, PETSC_FALSE, orthonormal.size(), orthonormal.data(), &near_null_space_));
+}
+
+
+void LinSys_PETSC::setup_direct_solver()
+{
+    PC pc;
+    chkerr(KSPGetPC(system, &pc));
+    if (rows_ds_->np() > 1) {
+#ifndef PETSC_HAVE_MUMPS
+        WarningOut() << "Parallel direct solver needs PETSc with MUMPS, Krylov method given by options is used.\n";
+        return;
+#endif
+    }
+    chkerr(KSPSetType(system, KSPPREONLY));
+    chkerr(PCSetType(pc, this->is_positive_definite() ? PCCHOLESKY : PCLU));
+#ifdef PETSC_HAVE_MUMPS
+    if (rows_ds_->np() > 1) {
+#if PETSC_VERSION_LT(3,9,0)
+        chkerr(PCFactorSetMatSolverPackage(pc, MATSOLVERMUMPS));
+#else
+        chkerr(PCFactorSetMatSolverType(pc, MATSOLVERMUMPS));
+#endif
+    }
+#endif
+    LogOut() << "Direct solver is used.\n";
+}
+
+
+void LinSys_PETSC::set_krylov_method()
+{
+    KSPType type, classic_type;
+    bool symmetric_pc = false;  // pipelined CG methods need symmetric preconditioner
+    switch (krylov_method_) {
+        case KrylovMethod::cg:         type = KSPCG;         classic_type = KSPCG;    break;
+        case KrylovMethod::pipecg:     type = KSPPIPECG;     classic_type = KSPCG;    symmetric_pc = true; break;
+        case KrylovMethod::groppcg:    type = KSPGROPPCG;    classic_type = KSPCG;    symmetric_pc = true; break;
+        case KrylovMethod::pipecr:     type = KSPPIPECR;     classic_type = KSPCR;    symmetric_pc = true; break;
+        case KrylovMethod::gmres:      type = KSPGMRES;      classic_type = KSPGMRES; break;
+        case KrylovMethod::pgmres:     type = KSPPGMRES;     classic_type = KSPGMRES; break;
+        case KrylovMethod::pipefgmres: type = KSPPIPEFGMRES; classic_type = KSPFGMRES; break;
+        case KrylovMethod::bcgs:       type = KSPBCGS;       classic_type = KSPBCGS;  break;
+        default: return;
+    }
+
+    if (symmetric_pc) {
+        PC pc;
+        PCType pc_type;
+        chkerr(KSPGetPC(system, &pc));
+        chkerr(PCGetType(pc, &pc_type));
+        bool compatible = true;
+        if (pc_type != NULL) {
+            if (strcmp(pc_type, PCILU) == 0 || strcmp(pc_type, PCSOR) == 0) compatible = false;
+            if (strcmp(pc_type, PCASM) == 0) {
+                PCASMType asm_type;
+                chkerr(PCASMGetType(pc, &asm_type));
+                if (asm_type != PC_ASM_BASIC) compatible = false;
+            }
+        }
+        if (! compatible) {
+            WarningOut().fmt("Krylov method '{}' needs symmetric preconditioner, '{}' is used with preconditioner '{}'.\n",
+                    type, classic_type, pc_type);
+            type = classic_type;
+        }
+    }
+    chkerr(KSPSetType(system, type));
+}
+
+
+void LinSys_PETSC::setup_ksp()
+{
+    PetscErrorCode ierr;
+    PetscPushErrorHandler(PetscReturnErrorHandler, NULL);
+    ierr = KSPSetUp(system);
+    if (ierr == 0) ierr = KSPSetUpOnBlocks(system);
+    PetscPopErrorHandler();
+
+    if (ierr != 0 && krylov_method_ != KrylovMethod::options) {
+        KSPType type;
+        KSPGetType(system, &type);
+        WarningOut().fmt("Setup of Krylov method '{}' failed (PETSc error {}), classical method is used.\n", type, ierr);
+        switch (krylov_method_) {
+            case KrylovMethod::pipecg:
+            case KrylovMethod::groppcg:    chkerr(KSPSetType(system, KSPCG)); break;
+            case KrylovMethod::pipecr:     chkerr(KSPSetType(system, KSPCR)); break;
+            case KrylovMethod::pgmres:     chkerr(KSPSetType(system, KSPGMRES)); break;
+            case KrylovMethod::pipefgmres: chkerr(KSPSetType(system, KSPFGMRES)); break;
+            default: chkerr(ierr);
+        }
+        chkerr(KSPSetUp(system));
+        chkerr(KSPSetUpOnBlocks(system));
+    } else {
+        chkerr(ierr);
+    }
+}
+
 
+void LinSys_PETSC::setup_reduction_log()
+{
+    // handlers are installed once for all systems
+    if (PetscLogPLB == reduction_log_begin) return;
+
+    for (const std::string &name : reduction_events) {
+        PetscLogEvent event;
+        if (PetscLogEventGetId(name.c_str(), &event) != 0 || event < 0) continue;
+        reduction_event_ids.push_back(event);
+    }
+    petsc_log_begin = PetscLogPLB;
+    petsc_log_end = PetscLogPLE;
+    chkerr(PetscLogSet(reduction_log_begin, reduction_log_end));
+}
+
+
+Mat LinSys_PETSC::inner_operator()
+{
+    if (refinement_r_tol_ == 0.0) return matrix_;
+    if (single_matrix_ == NULL || matrix_changed_) {
+        if (single_matrix_ != NULL) chkerr(MatDestroy(&single_matrix_));
+        single_matrix_ = SinglePrecisionMatrix::create(matrix_);
+    }
+    return single_matrix_;
 }
 
+
+int LinSys_PETSC::solve_refinement(LinSys_PETSC &owner)
+{
+    START_TIMER("PETSC iterative refinement");
+    int nits = 0, inner_its;
+    double res_norm, res_norm_0;
+    KSP ksp = owner.system;
+    Mat matrix = owner.matrix_;
+
+    if (correction_ == NULL) chkerr(VecDuplicate(rhs_, &correction_));
+
+    // inner solves start from zero correction with relaxed tolerance
+    chkerr(KSPSetTolerances(ksp, owner.refinement_r_tol_, 0.0, PETSC_DEFAULT, owner.max_it_));
+    chkerr(KSPSetInitialGuessNonzero(ksp, PETSC_FALSE));
+    owner.ksp_r_tol_ = owner.refinement_r_tol_;
+    owner.ksp_a_tol_ = 0.0;
+    owner.ksp_max_it_ = owner.max_it_;
+
+    if (! init_guess_nonzero) chkerr(VecZeroEntries(solution_));
+    chkerr(MatMult(matrix, solution_, residual_));
+    chkerr(VecAYPX(residual_, -1.0, rhs_));
+    chkerr(VecNorm(residual_, NORM_2, &res_norm_0));
+    res_norm = res_norm_0;
+    const double tolerance = std::max(r_tol_ * res_norm_0, a_tol_);
+
+    reason = KSP_CONVERGED_ITERATING;
+    for (unsigned int i_step=0; i_step < owner.refinement_max_steps_; i_step++) {
+        if (res_norm <= tolerance) break;
+
+        // correction from the residual computed in full precision, the inner KSP multiplies by single_matrix_
+        chkerr(KSPSolve(ksp, residual_, correction_));
+        KSPGetConvergedReason(ksp, &reason);
+        KSPGetIterationNumber(ksp, &inner_its);
+        nits += inner_its;
+        if (reason < 0 && reason != KSP_DIVERGED_ITS) break;
+
+        chkerr(VecAXPY(solution_, 1.0, correction_));
+        chkerr(MatMult(matrix, solution_, residual_));
+        chkerr(VecAYPX(residual_, -1.0, rhs_));
+        chkerr(VecNorm(residual_, NORM_2, &res_norm));
+        LogOut().fmt("refinement step {}, inner iterations {}, residual norm {}\n", i_step, inner_its, res_norm);
+    }
+
+    if (res_norm <= tolerance) reason = (res_norm <= a_tol_) ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+    else if (reason >= 0) reason = KSP_DIVERGED_ITS;
+    solution_precision_ = res_norm;
+    return nits;
+}
+
+
 void LinSys_PETSC::view( )
 {
     std::string matFileName = "flow123d_matrix.m";
@@ -442,10 +900,14 @@ void LinSys_PETSC::view( )
 
 LinSys_PETSC::~LinSys_PETSC( )
 {
+    if (system != nullptr) { chkerr(KSPDestroy(&system)); }
     if (matrix_ != NULL) { chkerr(MatDestroy(&matrix_)); }
+    if (near_null_space_ != nullptr) { chkerr(MatNullSpaceDestroy(&near_null_space_)); }
     chkerr(VecDestroy(&rhs_));
 
     if (residual_ != NULL) chkerr(VecDestroy(&residual_));
+    if (correction_ != NULL) chkerr(VecDestroy(&correction_));
+    if (single_matrix_ != NULL) chkerr(MatDestroy(&single_matrix_));
     if (v_rhs_ != NULL) delete[] v_rhs_;
 }
 
@@ -460,6 +922,14 @@ void LinSys_PETSC::set_from_input(const Input::Record in_rec)
     // otherwise keep settings provided in constructor of LinSys_PETSC.
     std::string user_params = in_rec.val<string>("options");
 	if (user_params != "") params_ = user_params;
+
+	pc_reuse_.set_parameters(in_rec.val<unsigned int>("pc_reuse_steps"),
+	                         in_rec.val<double>("pc_reuse_iteration_factor"));
+	refinement_r_tol_ = in_rec.val<double>("refinement_r_tol");
+	krylov_method_ = in_rec.val<KrylovMethod>("krylov_method");
+	log_reductions_ = in_rec.val<bool>("log_reductions");
+	if (log_reductions_) setup_reduction_log();
+	refinement_max_steps_ = in_rec.val<unsigned int>("refinement_max_steps");
 }
 
 
@@ -19,10 +19,13 @@
 #ifndef LA_LINSYS_PETSC_HH_
 #define LA_LINSYS_PETSC_HH_
 
+#include <algorithm>     // for max
 #include <functional>    // for unary_function
+#include <memory>        // for shared_ptr
 #include <string>        // for string
 #include <vector>        // for vector
 #include "la/linsys.hh"  // for LinSys
+#include "la/sparsity_pattern.hh"  // for SparsityPattern
 #include "petscksp.h"    // for KSP, KSPConvergedReason, _p_KSP
 #include "petscmat.h"    // for Mat, MatCopy, MatZeroEntries, MatAssemblyType
 #include "petscmath.h"   // for PetscScalar
@@ -34,20 +37,101 @@ namespace Input {
 	class Record;
 	namespace Type {
 		class Record;
+		class Selection;
 	}
 }
 namespace la {
     class BddcmlWrapper;
 }
 
+
+/**
+ * @brief Decides when the preconditioner of a persistent KSP has to be set up again.
+ *
+ * The preconditioner built for a matrix is reused for at most @p max_reuse_steps subsequent
+ * solves with a changed matrix. It is rebuilt earlier if the number of iterations exceeds
+ * @p iteration_factor times the number of iterations of the first solve with the fresh preconditioner.
+ * Zero @p max_reuse_steps means that the preconditioner is rebuilt whenever the matrix changes.
+ */
+class PcReusePolicy {
+public:
+    PcReusePolicy(unsigned int max_reuse_steps = 0, double iteration_factor = 2.0)
+    : max_reuse_steps_(max_reuse_steps), iteration_factor_(iteration_factor),
+      n_reused_(0), ref_iterations_(0), force_rebuild_(true)
+    {}
+
+    /// Set parameters of the policy, keeps the current state.
+    void set_parameters(unsigned int max_reuse_steps, double iteration_factor) {
+        max_reuse_steps_ = max_reuse_steps;
+        iteration_factor_ = iteration_factor;
+    }
+
+    /// Returns true if the preconditioner has to be set up before the next solve.
+    bool rebuild_needed(bool matrix_changed) const {
+        if (force_rebuild_) return true;
+        if (! matrix_changed) return false;
+        return (n_reused_ >= max_reuse_steps_);
+    }
+
+    /// Force the rebuild before the next solve, e.g. when the matrix was reallocated.
+    void invalidate()
+    { force_rebuild_ = true; }
+
+    /**
+     * Register a finished solve.
+     * @param rebuilt         True if the preconditioner was set up for this solve.
+     * @param matrix_changed  True if the matrix changed since the previous solve.
+     * @param n_its           Number of iterations of the solve.
+     */
+    void solved(bool rebuilt, bool matrix_changed, unsigned int n_its) {
+        if (rebuilt) {
+            n_reused_ = 0;
+            ref_iterations_ = n_its;
+            force_rebuild_ = false;
+        } else {
+            if (matrix_changed) n_reused_++;
+            if ( n_its > iteration_factor_ * std::max(ref_iterations_, 1u) ) force_rebuild_ = true;
+        }
+    }
+
+    /// Number of changed matrices solved with the current preconditioner after the one it was built for.
+    inline unsigned int n_reused() const
+    { return n_reused_; }
+
+private:
+    unsigned int max_reuse_steps_;   ///< Maximal number of solves with changed matrix reusing the preconditioner.
+    double iteration_factor_;        ///< Allowed growth of the iteration count against the reference solve.
+    unsigned int n_reused_;          ///< Number of changed matrices since the last setup of the preconditioner.
+    unsigned int ref_iterations_;    ///< Iterations of the solve with the fresh preconditioner.
+    bool force_rebuild_;             ///< Rebuild the preconditioner regardless of other criteria.
+};
+
 class LinSys_PETSC : public LinSys
 {
 
 public:
 	typedef LinSys FactoryBaseType;
 
+    /**
+     * Krylov methods selectable by the input record, in particular pipelined (communication hiding)
+     * variants that overlap the global reductions with the local work.
+     */
+    enum KrylovMethod {
+        options,     ///< KSP type given by PETSc options
+        cg,
+        pipecg,
+        groppcg,
+        pipecr,
+        gmres,
+        pgmres,
+        pipefgmres,
+        bcgs
+    };
+
     static const Input::Type::Record & get_input_type();
 
+    static const Input::Type::Selection & get_krylov_method_selection();
+
     LinSys_PETSC(const  Distribution * rows_ds, const std::string &params = "");
 
     /**
@@ -115,6 +199,26 @@ public:
 
     void preallocate_matrix();
 
+    /**
+     * Share the sparsity pattern of the @p other system, which must have the same distribution
+     * and the same structure of the matrix.
+     *
+     * This system then skips its own counting of nonzeros in the allocation pass. The @p other system
+     * counts the pattern and has to finish its allocation (call start_add_assembly or start_insert_assembly)
+     * before this system.
+     */
+    void share_sparsity_pattern(LinSys_PETSC &other);
+
+    /**
+     * Use the complete sparsity @p pattern (e.g. built by the equation from the connectivity of its DOFs),
+     * the allocation pass then does not count nonzeros and values set in this pass are ignored.
+     */
+    void set_sparsity_pattern(std::shared_ptr<SparsityPattern> pattern);
+
+    /// Returns the sparsity pattern of the matrix, nullptr before the first allocation.
+    inline std::shared_ptr<SparsityPattern> get_sparsity_pattern() const
+    { return pattern_; }
+
     void finish_assembly() override;
 
     void finish_assembly( MatAssemblyType assembly_type );
@@ -125,6 +229,43 @@ public:
 
     LinSys::SolveInfo solve() override;
 
+    /**
+     * Solve the system with own right hand side, but with the matrix, preconditioner and KSP settings
+     * of the @p owner system, which has to be solved before. Matrix of this system is not used.
+     * If the owner uses the iterative refinement, the same refinement is applied to this system.
+     * Intended for groups of systems with the same matrix (e.g. substances with equal coefficients).
+     */
+    LinSys::SolveInfo solve_with_operator(LinSys_PETSC &owner);
+
+    /**
+     * Destroy the matrix and the solver of a system solved by @p solve_with_operator. The right hand side
+     * can be assembled further, values of the matrix are not set. The matrix is created again after
+     * start_allocation(), without counting the nonzeros, the sparsity pattern has to be shared or set.
+     */
+    void release_matrix();
+
+    /**
+     * Solve the system by a sparse direct factorization (Cholesky for positive definite systems, LU otherwise)
+     * instead of the Krylov method given by options. In parallel the factorization needs PETSc with MUMPS,
+     * without it the setting is ignored. The factorization is reused while the matrix is unchanged.
+     * Has to be called before the first solve.
+     */
+    void set_direct_solver();
+
+    /**
+     * Set block size of the matrix, e.g. number of components of a vector field whose DOFs are numbered
+     * consecutively for every node. Used by block aware preconditioners (GAMG, ILU of BAIJ).
+     * Has to be called before the allocation of the matrix.
+     */
+    void set_block_size(unsigned int block_size);
+
+    /**
+     * Set near null space of the operator (e.g. rigid body modes of elasticity) attached to the matrix,
+     * used by algebraic multigrid preconditioners (GAMG, ML). Vectors @p basis are orthonormalized in place,
+     * linearly dependent ones are dropped. Has to be called before the allocation of the matrix.
+     */
+    void set_near_null_space(std::vector<Vec> &basis);
+
     /**
      * Returns information on absolute solver accuracy
      */
@@ -145,6 +286,43 @@ public:
 
     ~LinSys_PETSC( );
 
+protected:
+    /**
+     * Solve the system by the iterative refinement: the correction is computed from the residual
+     * by the KSP of @p owner with relaxed tolerance @p refinement_r_tol_, until the true residual
+     * computed with the matrix of @p owner satisfies the tolerances of the system. The owner is this
+     * system, or the system whose operator is shared by solve_with_operator().
+     * Returns the total number of inner iterations.
+     */
+    int solve_refinement(LinSys_PETSC &owner);
+
+    /**
+     * Operator of the KSP: @p matrix_, or its single precision copy @p single_matrix_ (created again
+     * for the changed matrix) if the iterative refinement is used.
+     */
+    Mat inner_operator();
+
+    /**
+     * Set KSP type according to @p krylov_method_. Pipelined CG variants need a symmetric preconditioner,
+     * for an incompatible one the classical variant is used.
+     */
+    void set_krylov_method();
+
+    /**
+     * Set up the KSP and its preconditioner. If the setup of a pipelined method fails,
+     * the classical variant is set up instead.
+     */
+    void setup_ksp();
+
+    /// Set KSP and PC of @p system for the direct solver.
+    void setup_direct_solver();
+
+    /**
+     * Install PETSc log handlers that open the profiler timer 'PETSC global reductions' for the reduction
+     * events in solves with @p log_reductions_. Called once, the handlers installed before are kept.
+     */
+    static void setup_reduction_log();
+
 private:
     /// Registrar of class to factory
     static const int registrar;
@@ -175,18 +353,38 @@ protected:
     Mat     matrix_;             //!< Petsc matrix of the problem.
     Vec     rhs_;                //!< PETSc vector constructed with vx array.
     Vec     residual_;
+    Vec     correction_;         //!< Correction of the solution in the iterative refinement.
+    Mat     single_matrix_;      //!< Single precision copy of @p matrix_ for the inner solves of the iterative refinement.
 
     double  *v_rhs_;             //!< local RHS array pointing to Vec rhs_
 
     Vec     on_vec_;             //!< Vectors for counting non-zero entries in diagonal block.
     Vec     off_vec_;            //!< Vectors for counting non-zero entries in off-diagonal block.
 
+    std::shared_ptr<SparsityPattern> pattern_; //!< Preallocation data, possibly shared with other systems.
+    bool    count_pattern_;      //!< True if this system fills @p pattern_ in the allocation pass.
+
 
     double  solution_precision_; // precision of KSP system solver
 
-    KSP                system;
+    KSP                system;   //!< Krylov solver, kept alive between solves in order to reuse the preconditioner.
     KSPConvergedReason reason;
 
+    PcReusePolicy pc_reuse_;     //!< Decides when the preconditioner of @p system is rebuilt.
+
+    double       refinement_r_tol_;        //!< Inner relative tolerance of the iterative refinement, zero if not used.
+    unsigned int refinement_max_steps_;    //!< Maximal number of steps of the iterative refinement.
+
+    KrylovMethod krylov_method_;           //!< Krylov method given by input, KrylovMethod::options if not given.
+    bool         log_reductions_;          //!< Log time of global reductions in the Krylov iterations.
+    bool         direct_solver_;           //!< Use sparse direct factorization instead of the Krylov method.
+    unsigned int block_size_;              //!< Block size of the matrix.
+    MatNullSpace near_null_space_;         //!< Near null space attached to the matrix, nullptr if not set.
+
+    double       ksp_r_tol_;     //!< Relative tolerance currently set to @p system.
+    double       ksp_a_tol_;     //!< Absolute tolerance currently set to @p system.
+    unsigned int ksp_max_it_;    //!< Maximal number of iterations currently set to @p system.
+
 
 };
 
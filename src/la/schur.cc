@@ -36,6 +36,7 @@
 #include <armadillo>
 #include <petscis.h>
 
+#include "config.h"
 #include "system/sys_profiler.hh"
 #include "la/distribution.hh"
 #include "la/local_to_global_map.hh"
@@ -43,6 +44,198 @@
 #include "la/linsys.hh"
 #include "la/schur.hh"
 
+
+namespace {
+
+/// Invert dense block of fixed size @p N given by column major @p vals in place, returns false for singular block.
+template <unsigned int N>
+inline bool invert_block(double *vals)
+{
+    arma::mat::fixed<N,N> block(vals);
+    arma::mat::fixed<N,N> inv_block;
+    if (! arma::inv(inv_block, block)) return false;
+    std::copy(inv_block.memptr(), inv_block.memptr() + N*N, vals);
+    return true;
+}
+
+/// Invert dense block of general size @p n given by column major @p vals in place, returns false for singular block.
+inline bool invert_block(double *vals, unsigned int n)
+{
+    arma::mat block(vals, n, n, false, true);
+    arma::mat inv_block;
+    if (! arma::inv(inv_block, block)) return false;
+    block = inv_block;
+    return true;
+}
+
+/**
+ * Split the AIJ matrix @p mat into its local diagonal and off-diagonal sequential blocks,
+ * @p off is null for a sequential matrix. Columns of @p off are compressed, @p colmap gives their global indices.
+ */
+void split_aij(Mat mat, Mat &diag, Mat &off, const PetscInt **colmap)
+{
+    PetscBool is_mpi;
+    chkerr(PetscObjectTypeCompare((PetscObject)mat, MATMPIAIJ, &is_mpi));
+    if (is_mpi) {
+        chkerr(MatMPIAIJGetSeqAIJ(mat, &diag, &off, colmap));
+    } else {
+        diag = mat;
+        off = nullptr;
+        *colmap = nullptr;
+    }
+}
+
+
+/**
+ * Nonzero pattern of the local rows of an AIJ matrix, used to find positions of entries in the CSR arrays.
+ *
+ * Position of an entry is its index in the values of the diagonal block (nonnegative), or -2-index
+ * in the values of the off-diagonal block; -1 denotes an entry out of the pattern or out of the local rows.
+ */
+class LocalCSRPattern {
+public:
+    LocalCSRPattern(Mat mat)
+    {
+        Mat diag, off;
+        split_aij(mat, diag, off, &colmap_);
+        chkerr(MatGetOwnershipRange(mat, &row_start_, &row_end_));
+        chkerr(MatGetOwnershipRangeColumn(mat, &col_start_, &col_end_));
+        read_ij(diag, diag_i_, diag_j_);
+        if (off != nullptr) read_ij(off, off_i_, off_j_);
+        else off_i_.assign(diag_i_.size(), 0);
+    }
+
+    /// Return true if the global @p row is local.
+    inline bool is_local(PetscInt row) const
+    { return row >= row_start_ && row < row_end_; }
+
+    /// Number of local entries.
+    inline PetscInt n_entries() const
+    { return diag_i_.back() + off_i_.back(); }
+
+    /// Position of the entry given by global indices @p row and @p col.
+    PetscInt position(PetscInt row, PetscInt col) const
+    {
+        if (! is_local(row)) return -1;
+        PetscInt r = row - row_start_;
+        if (col >= col_start_ && col < col_end_) {
+            auto first = diag_j_.begin() + diag_i_[r], last = diag_j_.begin() + diag_i_[r+1];
+            auto it = std::lower_bound(first, last, col - col_start_);
+            return (it != last && *it == col - col_start_) ? it - diag_j_.begin() : -1;
+        }
+        // compressed columns of the off-diagonal block are ordered as the global ones
+        auto first = off_j_.begin() + off_i_[r], last = off_j_.begin() + off_i_[r+1];
+        auto it = std::lower_bound(first, last, col, [this](PetscInt c, PetscInt value) { return colmap_[c] < value; });
+        return (it != last && colmap_[*it] == col) ? -2 - (it - off_j_.begin()) : -1;
+    }
+
+    /**
+     * Sorted union @p cols of global columns of the local rows @p first_row, ..., @p first_row + @p n_rows - 1
+     * and positions @p pos of the dense block (n_rows x cols.size(), column major) of these rows.
+     */
+    void dense_block(PetscInt first_row, unsigned int n_rows, std::vector<PetscInt> &cols, std::vector<PetscInt> &pos) const
+    {
+        cols.clear();
+        for (PetscInt r = first_row - row_start_; r < first_row - row_start_ + (PetscInt)n_rows; r++) {
+            for (PetscInt k = diag_i_[r]; k < diag_i_[r+1]; k++) cols.push_back(diag_j_[k] + col_start_);
+            for (PetscInt k = off_i_[r]; k < off_i_[r+1]; k++) cols.push_back(colmap_[ off_j_[k] ]);
+        }
+        std::sort(cols.begin(), cols.end());
+        cols.erase( std::unique(cols.begin(), cols.end()), cols.end() );
+
+        std::vector<PetscInt> rows(n_rows);
+        for (unsigned int i=0; i<n_rows; i++) rows[i] = first_row + i;
+        dense_positions(rows, cols, pos);
+    }
+
+    /// Positions @p pos of the dense block (rows.size() x cols.size(), column major) given by global indices.
+    void dense_positions(const std::vector<PetscInt> &rows, const std::vector<PetscInt> &cols, std::vector<PetscInt> &pos) const
+    {
+        pos.resize(rows.size() * cols.size());
+        for (unsigned int j=0; j<cols.size(); j++)
+            for (unsigned int i=0; i<rows.size(); i++)
+                pos[i + j*rows.size()] = position(rows[i], cols[j]);
+    }
+
+private:
+    /// Copy row offsets and columns of the sequential AIJ matrix @p mat.
+    static void read_ij(Mat mat, std::vector<PetscInt> &ia, std::vector<PetscInt> &ja)
+    {
+        PetscInt n;
+        const PetscInt *i, *j;
+        PetscBool done;
+        chkerr(MatGetRowIJ(mat, 0, PETSC_FALSE, PETSC_FALSE, &n, &i, &j, &done));
+        ASSERT(done).error("Can not get CSR structure of the matrix.");
+        ia.assign(i, i + n + 1);
+        ja.assign(j, j + ia.back());
+        chkerr(MatRestoreRowIJ(mat, 0, PETSC_FALSE, PETSC_FALSE, &n, &i, &j, &done));
+    }
+
+    PetscInt row_start_, row_end_, col_start_, col_end_;
+    std::vector<PetscInt> diag_i_, diag_j_;
+    std::vector<PetscInt> off_i_, off_j_;
+    const PetscInt *colmap_;
+};
+
+
+/**
+ * Direct access to the values of the local rows of an AIJ matrix by positions of LocalCSRPattern.
+ * The values are restored to the matrix by the destructor.
+ */
+class LocalCSRValues {
+public:
+    LocalCSRValues(Mat mat)
+    : mat_(mat), off_vals_(nullptr), n_diag_(0)
+    {
+        const PetscInt *colmap;
+        split_aij(mat, diag_, off_, &colmap);
+        MatInfo info;
+        chkerr(MatGetInfo(diag_, MAT_LOCAL, &info));
+        n_diag_ = (PetscInt)info.nz_used;
+        n_off_ = 0;
+        chkerr(MatSeqAIJGetArray(diag_, &diag_vals_));
+        if (off_ != nullptr) {
+            chkerr(MatGetInfo(off_, MAT_LOCAL, &info));
+            n_off_ = (PetscInt)info.nz_used;
+            chkerr(MatSeqAIJGetArray(off_, &off_vals_));
+        }
+    }
+
+    ~LocalCSRValues()
+    {
+        chkerr(MatSeqAIJRestoreArray(diag_, &diag_vals_));
+        if (off_ != nullptr) chkerr(MatSeqAIJRestoreArray(off_, &off_vals_));
+        chkerr(PetscObjectStateIncrease((PetscObject)mat_));
+    }
+
+    /// Number of local entries.
+    inline PetscInt size() const
+    { return n_diag_ + n_off_; }
+
+    /// Local entry @p k, entries of the diagonal block first.
+    inline PetscScalar &entry(PetscInt k)
+    { return (k < n_diag_) ? diag_vals_[k] : off_vals_[k - n_diag_]; }
+
+    /// Entry at position @p pos (not -1) given by LocalCSRPattern.
+    inline PetscScalar &operator()(PetscInt pos)
+    { return (pos >= 0) ? diag_vals_[pos] : off_vals_[-2 - pos]; }
+
+    /// Fill the dense block @p dense (of prescribed size) by entries at positions @p pos, zero for missing entries.
+    void gather(const std::vector<PetscInt> &pos, arma::mat &dense)
+    {
+        for (unsigned int k=0; k<dense.n_elem; k++)
+            dense(k) = (pos[k] == -1) ? 0.0 : (*this)(pos[k]);
+    }
+
+private:
+    Mat mat_, diag_, off_;
+    PetscScalar *diag_vals_, *off_vals_;
+    PetscInt n_diag_, n_off_;
+};
+
+} // namespace
+
+
 /**
  *  Create Schur complement system.
  *  @param[in] orig  : original system
@@ -58,7 +251,7 @@
  */
 
 SchurComplement::SchurComplement(Distribution *ds, IS ia, IS ib)
-: LinSys_PETSC(ds), IsA(ia), IsB(ib), state(created)
+: LinSys_PETSC(ds), IsA(ia), IsB(ib), state(created), local_elimination_(false)
 {
         // check index set
         OLD_ASSERT(IsA != NULL, "Index set IsA is not defined.\n" );
@@ -69,12 +262,17 @@ SchurComplement::SchurComplement(Distribution *ds, IS ia, IS ib)
         IA      = NULL;
         B       = NULL;
         Bt      = NULL;
+        BtT     = NULL;
         C       = NULL;
         xA      = NULL;
         IAB     = NULL;
         IsB     = NULL;
         RHS1    = NULL;
         RHS2    = NULL;
+        IARHS1  = NULL;
+        bt_values_  = NULL;
+        btt_values_ = NULL;
+        bt_scatter_ = NULL;
         Sol1    = NULL;
         Sol2    = NULL;
         rhs1sc  = NULL;
@@ -115,7 +313,8 @@ SchurComplement::SchurComplement(Distribution *ds, IS ia, IS ib)
 SchurComplement::SchurComplement(SchurComplement &other)
 : LinSys_PETSC(other),
   loc_size_A(other.loc_size_A), loc_size_B(other.loc_size_B), state(other.state),
-  Compl(other.Compl), ds_(other.ds_)
+  Compl(other.Compl), ds_(other.ds_), a_blocks_(other.a_blocks_), a_block_values_(other.a_block_values_),
+  local_elimination_(other.local_elimination_)
 {
 	MatCopy(other.A, A, DIFFERENT_NONZERO_PATTERN);
 	MatCopy(other.IA, IA, DIFFERENT_NONZERO_PATTERN);
@@ -129,8 +328,13 @@ SchurComplement::SchurComplement(SchurComplement &other)
 
 	B   = NULL;
 	Bt  = NULL;
+	BtT = NULL;
 	xA  = NULL;
 	C   = NULL;
+	IARHS1 = NULL;
+	bt_values_  = NULL;
+	btt_values_ = NULL;
+	bt_scatter_ = NULL;
 }
 
 
@@ -138,6 +342,7 @@ SchurComplement::SchurComplement(SchurComplement &other)
 void SchurComplement::set_from_input(const Input::Record in_rec)
 {
     LinSys_PETSC::set_from_input( in_rec );
+    local_elimination_ = in_rec.val<bool>("local_elimination");
 
     ASSERT_PTR(Compl).error();
     Compl->set_from_input( in_rec );
@@ -175,10 +380,7 @@ void SchurComplement::form_schur()
 
     mat_reuse=MAT_REUSE_MATRIX;
     mat_subset_pattern=SUBSET_NONZERO_PATTERN;
-    if (state==created) {
-    	mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
-    	mat_subset_pattern=DIFFERENT_NONZERO_PATTERN;
-
+    if (state==created && RHS1 == NULL) {
         // create complement system
         // TODO: introduce LS as true object, clarify its internal states
         // create RHS sub vecs RHS1, RHS2
@@ -196,8 +398,10 @@ void SchurComplement::form_schur()
         VecGetArray( Sol2, &sol_array );
         Compl->set_solution( sol_array );
         VecRestoreArray( Sol2, &sol_array );
-
-
+    }
+    if (state==created) {
+    	mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
+    	mat_subset_pattern=DIFFERENT_NONZERO_PATTERN;
     }
     DebugOut() << print_var(mat_reuse) << print_var(matrix_changed_) << print_var(state);
 
@@ -218,7 +422,11 @@ void SchurComplement::form_schur()
     // format for schur complement matrix, store local systems and perform elimination localy.
     // Or even better assembly the complement directly. (not compatible with raw P0 method)
 
-    if (matrix_changed_) {
+    if (matrix_changed_ && local_elimination_ && state != created) {
+        // patterns of IAB and of the complement are known from the first formation
+       	create_inversion_matrix();
+       	form_schur_local();
+    } else if (matrix_changed_) {
        	create_inversion_matrix();
 
        	// compute IAB=IA*B, loc_size_B removed
@@ -231,7 +439,11 @@ void SchurComplement::form_schur()
 		// get C block, loc_size_B removed
 		ierr+=MatGetSubMatrix( matrix_, IsB, IsB, mat_reuse, &C);
 
-		if (state==created) MatDuplicate(C, MAT_DO_NOT_COPY_VALUES, const_cast<Mat *>( Compl->get_matrix() ) );
+		if (state==created) {
+		    Mat *compl_mat = const_cast<Mat *>( Compl->get_matrix() );
+		    if (*compl_mat != NULL) chkerr(MatDestroy(compl_mat));
+		    MatDuplicate(C, MAT_DO_NOT_COPY_VALUES, compl_mat);
+		}
 		MatZeroEntries( *( Compl->get_matrix()) );
 
 		// compute complement = (-1)cA+xA = Bt*IA*B - C
@@ -264,7 +476,14 @@ void SchurComplement::form_rhs()
 	    VecScatterBegin(rhs2sc, rhs_, RHS2, INSERT_VALUES, SCATTER_FORWARD);
 	    VecScatterEnd(  rhs2sc, rhs_, RHS2, INSERT_VALUES, SCATTER_FORWARD);
 
-	    MatMultTranspose(IAB, RHS1, *( Compl->get_rhs() ));
+	    if ( is_symmetric() ) {
+	        MatMultTranspose(IAB, RHS1, *( Compl->get_rhs() ));
+	    } else {
+	        // IAB' = B' IA' differs from Bt IA
+	        if (IARHS1 == NULL) VecDuplicate(RHS1, &IARHS1);
+	        MatMult(IA, RHS1, IARHS1);
+	        MatMult(Bt, IARHS1, *( Compl->get_rhs() ));
+	    }
 	    VecAXPY(*( Compl->get_rhs() ), -1, RHS2);
 	    if ( is_negative_definite() ) {
 	    	VecScale(*( Compl->get_rhs() ), -1.0);
@@ -298,34 +517,18 @@ Distribution *SchurComplement::make_complement_distribution()
 	return ds_;
 }
 
-void SchurComplement::create_inversion_matrix()
+void SchurComplement::find_local_blocks()
 {
-    START_TIMER("create inversion matrix");
-    PetscInt ncols, pos_start, pos_start_IA;
-
-    MatReuse mat_reuse=MAT_REUSE_MATRIX;
-    if (state==created) mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
-
-    MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &A);
-    MatDuplicate(A, MAT_DO_NOT_COPY_VALUES, &IA);
-    //MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &IA);
-
-    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
-    MatGetOwnershipRange(IA,&pos_start_IA,PETSC_NULL);
-
-    std::vector<PetscInt> submat_rows;
+    PetscInt ncols, pos_start;
     const PetscInt *cols;
-    const PetscScalar *vals;
-
-    std::vector<unsigned int> processed_rows(loc_size_A,0);
 
-    unsigned int mat_block=1;   //actual processed block of matrix
-    for(unsigned int loc_row=0; loc_row < processed_rows.size(); loc_row++) {
-        if (processed_rows[loc_row] != 0) continue;
+    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
 
+    a_blocks_.clear();
+    unsigned int n_values = 0;
+    for(unsigned int loc_row=0; loc_row < (unsigned int)loc_size_A; ) {
         PetscInt min=std::numeric_limits<int>::max(), max=-1, size_submat;
         PetscInt b_vals = 0; // count of values stored in B-block of Orig system
-        submat_rows.clear();
         MatGetRow(A, loc_row + pos_start, &ncols, &cols, PETSC_NULL);
         for (PetscInt i=0; i<ncols; i++) {
             if (cols[i] < pos_start || cols[i] >= pos_start+loc_size_A) {
@@ -341,37 +544,254 @@ void SchurComplement::create_inversion_matrix()
         }
         size_submat = max - min + 1;
         OLD_ASSERT(ncols-b_vals == size_submat, "Submatrix cannot contains empty values.\n");
-
         MatRestoreRow(A, loc_row + pos_start, &ncols, &cols, PETSC_NULL);
-        arma::mat submat2(size_submat, size_submat);
-        submat2.zeros();
-        for (PetscInt i=0; i<size_submat; i++) {
-            processed_rows[ loc_row + i ] = mat_block;
-            submat_rows.push_back( i + loc_row + pos_start_IA );
-            MatGetRow(A, i + loc_row + pos_start, &ncols, &cols, &vals);
+
+        a_blocks_.push_back( {loc_row, (unsigned int)size_submat, n_values} );
+        n_values += size_submat * size_submat;
+        loc_row += size_submat;
+    }
+    a_block_values_.resize(n_values);
+}
+
+
+void SchurComplement::invert_local_blocks()
+{
+    START_TIMER("invert local blocks");
+    int n_singular = 0;
+    const int n_blocks = a_blocks_.size();
+
+    // blocks are independent, small blocks (one per element) use specialized routines
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(static) reduction(+:n_singular)
+#endif
+    for (int i_block=0; i_block < n_blocks; i_block++) {
+        const LocalBlock &block = a_blocks_[i_block];
+        double *vals = &( a_block_values_[block.val_offset] );
+        bool regular;
+        switch (block.size) {
+        case 1: regular = invert_block<1>(vals); break;
+        case 2: regular = invert_block<2>(vals); break;
+        case 3: regular = invert_block<3>(vals); break;
+        case 4: regular = invert_block<4>(vals); break;
+        default: regular = invert_block(vals, block.size); break;
+        }
+        if (! regular) n_singular++;
+    }
+    ASSERT_EQ(n_singular, 0).error("Singular diagonal block of the eliminated matrix.");
+}
+
+
+void SchurComplement::create_inversion_matrix()
+{
+    START_TIMER("create inversion matrix");
+    PetscInt ncols, pos_start, pos_start_IA;
+    const PetscInt *cols;
+    const PetscScalar *vals;
+
+    MatReuse mat_reuse=MAT_REUSE_MATRIX;
+    if (state==created) mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
+
+    MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &A);
+    if (state==created) {
+        MatDuplicate(A, MAT_DO_NOT_COPY_VALUES, &IA);
+        // values of the blocks are stored column-wise
+        MatSetOption(IA, MAT_ROW_ORIENTED, PETSC_FALSE);
+        find_local_blocks();
+    }
+
+    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
+    MatGetOwnershipRange(IA,&pos_start_IA,PETSC_NULL);
+
+    // gather values of the blocks
+    std::fill(a_block_values_.begin(), a_block_values_.end(), 0.0);
+    for (const LocalBlock &block : a_blocks_) {
+        PetscInt block_start = pos_start + block.loc_row;
+        for (unsigned int i=0; i<block.size; i++) {
+            MatGetRow(A, block_start + i, &ncols, &cols, &vals);
             for (PetscInt j=0; j<ncols; j++) {
-                if (cols[j] >= pos_start && cols[j] < pos_start+loc_size_A) {
-                    submat2( i, cols[j] - loc_row - pos_start ) = vals[j];
+                if (cols[j] >= block_start && cols[j] < block_start + (PetscInt)block.size) {
+                    a_block_values_[ block.val_offset + (cols[j] - block_start)*block.size + i ] = vals[j];
                 }
             }
-            MatRestoreRow(A, i + loc_row + pos_start, &ncols, &cols, &vals);
-		}
-        // get inversion matrix
-        arma::mat invmat = submat2.i();
-        // stored to inversion IA matrix
-        const PetscInt* rows = &submat_rows[0];
-        MatSetValues(IA, submat_rows.size(), rows, submat_rows.size(), rows, invmat.memptr(), INSERT_VALUES);
+            MatRestoreRow(A, block_start + i, &ncols, &cols, &vals);
+        }
+    }
+
+    invert_local_blocks();
 
-        mat_block++;
+    // store to inversion IA matrix
+    std::vector<PetscInt> submat_rows;
+    for (const LocalBlock &block : a_blocks_) {
+        submat_rows.resize(block.size);
+        for (unsigned int i=0; i<block.size; i++) submat_rows[i] = pos_start_IA + block.loc_row + i;
+        MatSetValues(IA, block.size, &submat_rows[0], block.size, &submat_rows[0],
+                &( a_block_values_[block.val_offset] ), INSERT_VALUES);
     }
 
     MatAssemblyBegin(IA, MAT_FINAL_ASSEMBLY);
     MatAssemblyEnd(IA, MAT_FINAL_ASSEMBLY);
+}
+
+
+void SchurComplement::setup_transpose()
+{
+    // values of a copy of Bt are replaced by (one based) global indices of its entries,
+    // the transposed copy then gives the source entry of every entry of BtT
+    Mat bt_ids;
+    chkerr(MatDuplicate(Bt, MAT_DO_NOT_COPY_VALUES, &bt_ids));
+    PetscInt first_id;
+    {
+        LocalCSRValues ids(bt_ids);
+        chkerr(VecCreateMPI(PETSC_COMM_WORLD, ids.size(), PETSC_DETERMINE, &bt_values_));
+        chkerr(VecGetOwnershipRange(bt_values_, &first_id, PETSC_NULL));
+        for (PetscInt k=0; k<ids.size(); k++) ids.entry(k) = first_id + k + 1;
+    }
+    chkerr(MatTranspose(bt_ids, MAT_INITIAL_MATRIX, &BtT));
+    chkerr(MatDestroy(&bt_ids));
+
+    std::vector<PetscInt> src_ids;
+    {
+        LocalCSRValues btt(BtT);
+        src_ids.resize(btt.size());
+        for (PetscInt k=0; k<btt.size(); k++) src_ids[k] = (PetscInt)(btt.entry(k) + 0.5) - 1;
+    }
+    chkerr(VecCreateMPI(PETSC_COMM_WORLD, src_ids.size(), PETSC_DETERMINE, &btt_values_));
+    PetscInt first_btt;
+    chkerr(VecGetOwnershipRange(btt_values_, &first_btt, PETSC_NULL));
+    IS is_from, is_to;
+    chkerr(ISCreateGeneral(PETSC_COMM_SELF, src_ids.size(), src_ids.data(), PETSC_COPY_VALUES, &is_from));
+    chkerr(ISCreateStride(PETSC_COMM_SELF, src_ids.size(), first_btt, 1, &is_to));
+    chkerr(VecScatterCreate(bt_values_, is_from, btt_values_, is_to, &bt_scatter_));
+    chkerr(ISDestroy(&is_from));
+    chkerr(ISDestroy(&is_to));
+}
+
+
+void SchurComplement::update_transpose()
+{
+    START_TIMER("update transpose");
+    PetscScalar *vals;
+    {
+        LocalCSRValues bt(Bt);
+        chkerr(VecGetArray(bt_values_, &vals));
+        for (PetscInt k=0; k<bt.size(); k++) vals[k] = bt.entry(k);
+        chkerr(VecRestoreArray(bt_values_, &vals));
+    }
+    chkerr(VecScatterBegin(bt_scatter_, bt_values_, btt_values_, INSERT_VALUES, SCATTER_FORWARD));
+    chkerr(VecScatterEnd(bt_scatter_, bt_values_, btt_values_, INSERT_VALUES, SCATTER_FORWARD));
+    {
+        LocalCSRValues btt(BtT);
+        chkerr(VecGetArray(btt_values_, &vals));
+        for (PetscInt k=0; k<btt.size(); k++) btt.entry(k) = vals[k];
+        chkerr(VecRestoreArray(btt_values_, &vals));
+    }
+}
 
 
-    /*
-    MatCreateMPIAIJSumSeqAIJ(PETSC_COMM_WORLD, locIA, PETSC_DECIDE, PETSC_DECIDE, reuse, &IA);
-    */
+void SchurComplement::setup_local_formation()
+{
+    START_TIMER("setup local formation");
+    // rows of B' corresponding to the local blocks of A are rows of its transpose, that is B for symmetric systems
+    if (! is_symmetric()) setup_transpose();
+    Mat bt_mat = is_symmetric() ? B : BtT;
+
+    LocalCSRPattern b_pattern(B), bt_pattern(bt_mat), iab_pattern(IAB), compl_pattern(*( Compl->get_matrix() ));
+    PetscInt pos_start, pos_start_bt, pos_start_IA;
+    chkerr(MatGetOwnershipRange(B, &pos_start, PETSC_NULL));
+    chkerr(MatGetOwnershipRange(bt_mat, &pos_start_bt, PETSC_NULL));
+    chkerr(MatGetOwnershipRange(IAB, &pos_start_IA, PETSC_NULL));
+
+    block_patterns_.resize(a_blocks_.size());
+    std::vector<PetscInt> block_rows;
+    for (unsigned int i_block=0; i_block < a_blocks_.size(); i_block++) {
+        const LocalBlock &block = a_blocks_[i_block];
+        BlockPattern &p = block_patterns_[i_block];
+        b_pattern.dense_block(pos_start + block.loc_row, block.size, p.b_cols, p.b_pos);
+        bt_pattern.dense_block(pos_start_bt + block.loc_row, block.size, p.bt_cols, p.bt_pos);
+
+        block_rows.resize(block.size);
+        for (unsigned int i=0; i<block.size; i++) block_rows[i] = pos_start_IA + block.loc_row + i;
+        iab_pattern.dense_positions(block_rows, p.b_cols, p.iab_pos);
+        compl_pattern.dense_positions(p.bt_cols, p.b_cols, p.compl_pos);
+
+        // patterns of IAB and the complement contain the products from the first formation
+        ASSERT(std::find(p.iab_pos.begin(), p.iab_pos.end(), -1) == p.iab_pos.end()).error("Missing entry of IAB.");
+        p.remote_rows.clear();
+        for (unsigned int i=0; i<p.bt_cols.size(); i++) {
+            if (! compl_pattern.is_local(p.bt_cols[i])) {
+                p.remote_rows.push_back(i);
+                continue;
+            }
+            for (unsigned int j=0; j<p.b_cols.size(); j++)
+                ASSERT(p.compl_pos[i + j*p.bt_cols.size()] != -1).error("Missing entry of the Schur complement.");
+        }
+    }
+}
+
+
+void SchurComplement::form_schur_local()
+{
+    START_TIMER("form schur local");
+
+    chkerr(MatGetSubMatrix(matrix_, IsA, IsB, MAT_REUSE_MATRIX, &B));
+    chkerr(MatGetSubMatrix(matrix_, IsB, IsA, MAT_REUSE_MATRIX, &Bt));
+    chkerr(MatGetSubMatrix(matrix_, IsB, IsB, MAT_REUSE_MATRIX, &C));
+    if (block_patterns_.empty()) setup_local_formation();
+    if (! is_symmetric()) update_transpose();
+
+    // compute complement = (-1)cA+xA = Bt*IA*B - C
+    double x_sign = ( is_negative_definite() ? -1.0 : 1.0 );
+    Mat compl_mat = *( Compl->get_matrix() );
+    chkerr(MatZeroEntries(compl_mat));
+    chkerr(MatAXPY(compl_mat, -x_sign, C, SUBSET_NONZERO_PATTERN));
+
+    const int n_blocks = a_blocks_.size();
+    std::vector<arma::mat> x_block(n_blocks);
+    {
+        LocalCSRValues b_vals(B), iab_vals(IAB), compl_vals(compl_mat);
+        LocalCSRValues *bt_vals = is_symmetric() ? &b_vals : new LocalCSRValues(BtT);
+
+        // local contributions: IAB_k = IA_k * B_k, written directly to the rows of the block,
+        // xA_k = B'_k * IA_k * B_k
+#ifdef FLOW123D_HAVE_OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (int i_block=0; i_block < n_blocks; i_block++) {
+            const LocalBlock &block = a_blocks_[i_block];
+            const BlockPattern &p = block_patterns_[i_block];
+            arma::mat ia_block( &( a_block_values_[block.val_offset] ), block.size, block.size, false, true);
+            arma::mat b_block(block.size, p.b_cols.size()), bt_block(block.size, p.bt_cols.size());
+            b_vals.gather(p.b_pos, b_block);
+            bt_vals->gather(p.bt_pos, bt_block);
+
+            arma::mat iab_block = ia_block * b_block;
+            for (unsigned int k=0; k<iab_block.n_elem; k++) iab_vals(p.iab_pos[k]) = iab_block(k);
+            x_block[i_block] = x_sign * bt_block.t() * iab_block;
+        }
+
+        // blocks share rows of the complement, local rows are added serially
+        for (int i_block=0; i_block < n_blocks; i_block++) {
+            const BlockPattern &p = block_patterns_[i_block];
+            for (unsigned int k=0; k<x_block[i_block].n_elem; k++)
+                if (p.compl_pos[k] != -1) compl_vals(p.compl_pos[k]) += x_block[i_block](k);
+        }
+        if (bt_vals != &b_vals) delete bt_vals;
+    }
+
+    // rows of other processes are sent through the stash
+    std::vector<PetscScalar> row_vals;
+    for (int i_block=0; i_block < n_blocks; i_block++) {
+        const BlockPattern &p = block_patterns_[i_block];
+        for (unsigned int i : p.remote_rows) {
+            row_vals.resize(p.b_cols.size());
+            for (unsigned int j=0; j<p.b_cols.size(); j++) row_vals[j] = x_block[i_block](i, j);
+            chkerr(MatSetValues(compl_mat, 1, &p.bt_cols[i], p.b_cols.size(), p.b_cols.data(), row_vals.data(), ADD_VALUES));
+        }
+    }
+    chkerr(MatAssemblyBegin(compl_mat, MAT_FINAL_ASSEMBLY));
+    chkerr(MatAssemblyEnd(compl_mat, MAT_FINAL_ASSEMBLY));
+
+    Compl->set_matrix_changed();
 }
 
 
@@ -384,6 +804,33 @@ double SchurComplement::get_solution_precision()
 }
 
 
+void SchurComplement::start_allocation()
+{
+    LinSys_PETSC::start_allocation();
+    if (state != created) {
+        destroy_blocks();
+        state = created;
+    }
+}
+
+
+void SchurComplement::destroy_blocks()
+{
+    if ( A  != NULL )             chkerr(MatDestroy(&A));
+    if ( B  != NULL )             chkerr(MatDestroy(&B));
+    if ( Bt != NULL )             chkerr(MatDestroy(&Bt));
+    if ( BtT != NULL )            chkerr(MatDestroy(&BtT));
+    if ( C != NULL )              chkerr(MatDestroy(&C));
+    if ( xA != NULL )             chkerr(MatDestroy(&xA));
+    if ( IA != NULL )             chkerr(MatDestroy(&IA));
+    if ( IAB != NULL )            chkerr(MatDestroy(&IAB));
+    if ( bt_scatter_ != NULL )    chkerr(VecScatterDestroy(&bt_scatter_));
+    if ( bt_values_ != NULL )     chkerr(VecDestroy(&bt_values_));
+    if ( btt_values_ != NULL )    chkerr(VecDestroy(&btt_values_));
+    block_patterns_.clear();
+}
+
+
 LinSys::SolveInfo SchurComplement::solve() {
     START_TIMER("SchurComplement::solve");
     this->form_schur();
@@ -448,6 +895,7 @@ SchurComplement :: ~SchurComplement() {
     if ( A  != NULL )             chkerr(MatDestroy(&A));
     if ( B  != NULL )             chkerr(MatDestroy(&B));
     if ( Bt != NULL )             chkerr(MatDestroy(&Bt));
+    if ( BtT != NULL )            chkerr(MatDestroy(&BtT));
     if ( C != NULL )              chkerr(MatDestroy(&C));
     if ( xA != NULL )             chkerr(MatDestroy(&xA));
     if ( IA != NULL )             chkerr(MatDestroy(&IA));
@@ -456,6 +904,7 @@ SchurComplement :: ~SchurComplement() {
     if ( IsB != NULL )            chkerr(ISDestroy(&IsB));
     if ( RHS1 != NULL )           chkerr(VecDestroy(&RHS1));
     if ( RHS2 != NULL )           chkerr(VecDestroy(&RHS2));
+    if ( IARHS1 != NULL )         chkerr(VecDestroy(&IARHS1));
     if ( Sol1 != NULL )           chkerr(VecDestroy(&Sol1));
     if ( Sol2 != NULL )           chkerr(VecDestroy(&Sol2));
     if ( rhs1sc != NULL )         chkerr(VecScatterDestroy(&rhs1sc));
@@ -463,6 +912,9 @@ SchurComplement :: ~SchurComplement() {
     if ( sol1sc != NULL )         chkerr(VecScatterDestroy(&sol1sc));
     if ( sol2sc != NULL )         chkerr(VecScatterDestroy(&sol2sc));
     if ( IA != NULL )             chkerr(MatDestroy(&IA));
+    if ( bt_scatter_ != NULL )    chkerr(VecScatterDestroy(&bt_scatter_));
+    if ( bt_values_ != NULL )     chkerr(VecDestroy(&bt_values_));
+    if ( btt_values_ != NULL )    chkerr(VecDestroy(&btt_values_));
 
     if (Compl != NULL)            delete Compl;
     if (ds_ != NULL)              delete ds_;
@@ -20,6 +20,7 @@
 #define LA_SCHUR_HH_
 
 #include <petscmat.h>          // for Mat, _p_Mat
+#include <vector>              // for vector
 #include "la/linsys_PETSC.hh"  // for LinSys_PETSC
 #include "petscistypes.h"      // for IS, _p_IS
 #include "petscvec.h"          // for Vec, _p_Vec
@@ -52,7 +53,8 @@ namespace Input { class Record; }
  *   schur->solve();
  * @ENDCODE
  *
- * Input record is passed to the complement system.
+ * Input record is passed to the complement system, in particular the preconditioner
+ * reuse settings (see PcReusePolicy) apply to the solver of the complement.
  */
 
 typedef enum SchurState {
@@ -137,23 +139,88 @@ public:
     int loc_size_A, loc_size_B; // loc size of the A and B block
     IS IsA, IsB;                // parallel index sets of the A and B block
 
+    /**
+     * Switch on elimination of the local blocks of A directly, without PETSc matrix products.
+     *
+     * The matrices IA*B and B'*IA*B are then formed block by block from small dense products,
+     * reusing the nonzero patterns created by the first (PETSc based) formation of the complement.
+     */
+    inline void set_local_elimination(bool local_elimination)
+    { local_elimination_ = local_elimination; }
+
+    /**
+     * Start allocation of the original matrix. If the complement was already formed,
+     * its blocks are released and formed anew for the new matrix (its pattern can differ).
+     */
+    void start_allocation() override;
+
 protected:
+    /**
+     * Diagonal block of the local part of A. Given by the first local row, the size
+     * and the offset of its values in @p a_block_values_ (column major order).
+     */
+    struct LocalBlock {
+        unsigned int loc_row;
+        unsigned int size;
+        unsigned int val_offset;
+    };
+
+    /// Find the diagonal blocks of A, performed only for the first formation of the complement.
+    void find_local_blocks();
+
+    /// Invert all local blocks of A stored in @p a_block_values_.
+    void invert_local_blocks();
+
     /// create IA matrix
     void create_inversion_matrix();
 
     void form_schur();
 
+    /**
+     * Columns of B and B'^T in rows of a local block of A and positions of the entries of the dense block products
+     * in the CSR arrays of B (or B'^T), IAB and the complement. Dense blocks are stored column-wise.
+     */
+    struct BlockPattern {
+        std::vector<PetscInt> b_cols;             ///< Columns of B in rows of the block.
+        std::vector<PetscInt> bt_cols;            ///< Columns of B'^T in rows of the block (rows of the complement).
+        std::vector<PetscInt> b_pos;              ///< Positions of the entries of the dense block of B.
+        std::vector<PetscInt> bt_pos;             ///< Positions of the entries of the dense block of B'^T.
+        std::vector<PetscInt> iab_pos;            ///< Positions of the entries of IA*B.
+        std::vector<PetscInt> compl_pos;          ///< Positions of the entries of B'*IA*B in the complement.
+        std::vector<unsigned int> remote_rows;    ///< Rows of the block of B'*IA*B owned by other processes.
+    };
+
+    /// Form IAB and the complement from dense products of the local blocks, see set_local_elimination.
+    void form_schur_local();
+
+    /**
+     * Find positions of block entries in the CSR arrays (@p block_patterns_), performed for the first local formation.
+     * Patterns of IAB and the complement are given by the preceding formation by PETSc products.
+     */
+    void setup_local_formation();
+
+    /// Create BtT = Bt' and the scatter of values of Bt to the transposed entries, for nonsymmetric systems.
+    void setup_transpose();
+
+    /// Copy values of Bt to BtT by the scatter created by setup_transpose().
+    void update_transpose();
+
+    /// Destroy submatrices and products of the formed complement, keeps vectors and scatters.
+    void destroy_blocks();
+
 
 
     Mat A;                      // Submatrix of matrix_ contains only data given by IsA parallel index set
     Mat IA;                     // Inverse of block A
 
     Mat B, Bt;                  // B and B' block (could be different from real B transpose)
+    Mat BtT;                    // transpose of Bt, distributed by rows of A (only for local elimination of nonsymmetric systems)
     Mat C;                      // Sub matrix.
     Mat xA;                     // Bt*IA*B
     Mat IAB;                    // reconstruction matrix IA * B
 
     Vec RHS1, RHS2;             // A and B - part of the RHS
+    Vec IARHS1;                 // IA * RHS1, for nonsymmetric systems
     Vec Sol1, Sol2;             // A and B part of solution
     VecScatter rhs1sc, rhs2sc;  // scatter to parts of rhs
     VecScatter sol1sc, sol2sc;  // scatter to parts of solution
@@ -164,6 +231,13 @@ protected:
     LinSys_PETSC *Compl;        // Schur complement system: (C - B' IA B) * Sol2 = (B' * IA * RHS1 - RHS2)
 
     Distribution *ds_;          // Distribution of B block
+
+    std::vector<LocalBlock> a_blocks_;    ///< Diagonal blocks of the local part of A.
+    std::vector<double> a_block_values_;  ///< Values of local blocks of A, inverted in place.
+    bool local_elimination_;              ///< Use form_schur_local instead of PETSc matrix products.
+    std::vector<BlockPattern> block_patterns_;  ///< Patterns of the local blocks, empty before the first local formation.
+    Vec bt_values_, btt_values_;          ///< Values of local entries of Bt and BtT.
+    VecScatter bt_scatter_;               ///< Moves values of entries of Bt to the transposed entries of BtT.
 } SchurComplement;
 
 #endif /* LA_SCHUR_HH_ */
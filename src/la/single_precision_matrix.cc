@@ -0,0 +1,173 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    single_precision_matrix.cc
+ * @brief   Single precision copy of a PETSc AIJ matrix wrapped in a shell matrix.
+ */
+
+#include "la/single_precision_matrix.hh"
+#include "petscis.h"
+#include "system/asserts.hh"
+#include "system/system.hh"
+
+
+Mat SinglePrecisionMatrix::create(Mat mat)
+{
+    SinglePrecisionMatrix *ctx = new SinglePrecisionMatrix(mat);
+
+    PetscInt m, n, M, N;
+    chkerr(MatGetLocalSize(mat, &m, &n));
+    chkerr(MatGetSize(mat, &M, &N));
+    Mat shell;
+    chkerr(MatCreateShell(PetscObjectComm((PetscObject)mat), m, n, M, N, ctx, &shell));
+    chkerr(MatShellSetOperation(shell, MATOP_MULT, (void(*)(void))SinglePrecisionMatrix::mult));
+    chkerr(MatShellSetOperation(shell, MATOP_DIAGONAL_SCALE, (void(*)(void))SinglePrecisionMatrix::diagonal_scale));
+    chkerr(MatShellSetOperation(shell, MATOP_DESTROY, (void(*)(void))SinglePrecisionMatrix::destroy));
+    return shell;
+}
+
+
+SinglePrecisionMatrix::SinglePrecisionMatrix(Mat mat)
+: ghost_(NULL), scatter_(NULL)
+{
+    PetscBool is_mpi, is_seq;
+    chkerr(PetscObjectTypeCompare((PetscObject)mat, MATMPIAIJ, &is_mpi));
+    chkerr(PetscObjectTypeCompare((PetscObject)mat, MATSEQAIJ, &is_seq));
+    ASSERT(is_mpi || is_seq).error("Single precision copy needs AIJ matrix.");
+
+    if (is_seq) {
+        copy_block(mat, diag_);
+        off_.row_ptr.assign(diag_.row_ptr.size(), 0);
+        return;
+    }
+
+    Mat diag, off;
+    const PetscInt *colmap;
+    chkerr(MatMPIAIJGetSeqAIJ(mat, &diag, &off, &colmap));
+    copy_block(diag, diag_);
+    copy_block(off, off_);
+
+    // columns of the off-diagonal block are compressed, colmap gives their global indices
+    PetscInt n_ghost;
+    chkerr(MatGetSize(off, NULL, &n_ghost));
+    Vec x;
+    IS is;
+    chkerr(MatCreateVecs(mat, &x, NULL));
+    chkerr(VecCreateSeq(PETSC_COMM_SELF, n_ghost, &ghost_));
+    chkerr(ISCreateGeneral(PETSC_COMM_SELF, n_ghost, colmap, PETSC_COPY_VALUES, &is));
+    chkerr(VecScatterCreate(x, is, ghost_, NULL, &scatter_));
+    chkerr(ISDestroy(&is));
+    chkerr(VecDestroy(&x));
+}
+
+
+SinglePrecisionMatrix::~SinglePrecisionMatrix()
+{
+    if (scatter_ != NULL) chkerr(VecScatterDestroy(&scatter_));
+    if (ghost_ != NULL) chkerr(VecDestroy(&ghost_));
+}
+
+
+void SinglePrecisionMatrix::copy_block(Mat seq, Block &b)
+{
+    PetscInt n;
+    const PetscInt *ia, *ja;
+    PetscBool done;
+    chkerr(MatGetRowIJ(seq, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+    ASSERT(done).error("Can not get CSR structure of the matrix.");
+    b.row_ptr.assign(ia, ia + n + 1);
+    b.cols.assign(ja, ja + ia[n]);
+    chkerr(MatRestoreRowIJ(seq, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+
+    PetscScalar *vals;
+    chkerr(MatSeqAIJGetArray(seq, &vals));
+    b.vals.assign(vals, vals + b.cols.size());
+    chkerr(MatSeqAIJRestoreArray(seq, &vals));
+}
+
+
+void SinglePrecisionMatrix::add_product(const Block &b, const PetscScalar *x, PetscScalar *y)
+{
+    for (unsigned int i=0; i+1 < b.row_ptr.size(); i++) {
+        double sum = 0.0;
+        for (PetscInt k=b.row_ptr[i]; k<b.row_ptr[i+1]; k++) sum += b.vals[k] * x[ b.cols[k] ];
+        y[i] += sum;
+    }
+}
+
+
+PetscErrorCode SinglePrecisionMatrix::mult(Mat A, Vec x, Vec y)
+{
+    SinglePrecisionMatrix *ctx;
+    chkerr(MatShellGetContext(A, &ctx));
+
+    if (ctx->scatter_ != NULL)
+        chkerr(VecScatterBegin(ctx->scatter_, x, ctx->ghost_, INSERT_VALUES, SCATTER_FORWARD));
+
+    const PetscScalar *x_array;
+    PetscScalar *y_array;
+    chkerr(VecZeroEntries(y));
+    chkerr(VecGetArrayRead(x, &x_array));
+    chkerr(VecGetArray(y, &y_array));
+    add_product(ctx->diag_, x_array, y_array);
+    chkerr(VecRestoreArrayRead(x, &x_array));
+
+    if (ctx->scatter_ != NULL) {
+        chkerr(VecScatterEnd(ctx->scatter_, x, ctx->ghost_, INSERT_VALUES, SCATTER_FORWARD));
+        const PetscScalar *ghost_array;
+        chkerr(VecGetArrayRead(ctx->ghost_, &ghost_array));
+        add_product(ctx->off_, ghost_array, y_array);
+        chkerr(VecRestoreArrayRead(ctx->ghost_, &ghost_array));
+    }
+    chkerr(VecRestoreArray(y, &y_array));
+    return 0;
+}
+
+
+PetscErrorCode SinglePrecisionMatrix::diagonal_scale(Mat A, Vec l, Vec r)
+{
+    SinglePrecisionMatrix *ctx;
+    chkerr(MatShellGetContext(A, &ctx));
+
+    const PetscScalar *array;
+    if (l != NULL) {
+        chkerr(VecGetArrayRead(l, &array));
+        for (Block *b : {&ctx->diag_, &ctx->off_})
+            for (unsigned int i=0; i+1 < b->row_ptr.size(); i++)
+                for (PetscInt k=b->row_ptr[i]; k<b->row_ptr[i+1]; k++) b->vals[k] *= array[i];
+        chkerr(VecRestoreArrayRead(l, &array));
+    }
+    if (r != NULL) {
+        chkerr(VecGetArrayRead(r, &array));
+        for (unsigned int k=0; k<ctx->diag_.cols.size(); k++) ctx->diag_.vals[k] *= array[ ctx->diag_.cols[k] ];
+        chkerr(VecRestoreArrayRead(r, &array));
+
+        if (ctx->scatter_ != NULL) {
+            chkerr(VecScatterBegin(ctx->scatter_, r, ctx->ghost_, INSERT_VALUES, SCATTER_FORWARD));
+            chkerr(VecScatterEnd(ctx->scatter_, r, ctx->ghost_, INSERT_VALUES, SCATTER_FORWARD));
+            chkerr(VecGetArrayRead(ctx->ghost_, &array));
+            for (unsigned int k=0; k<ctx->off_.cols.size(); k++) ctx->off_.vals[k] *= array[ ctx->off_.cols[k] ];
+            chkerr(VecRestoreArrayRead(ctx->ghost_, &array));
+        }
+    }
+    return 0;
+}
+
+
+PetscErrorCode SinglePrecisionMatrix::destroy(Mat A)
+{
+    SinglePrecisionMatrix *ctx;
+    chkerr(MatShellGetContext(A, &ctx));
+    delete ctx;
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    single_precision_matrix.hh
+ * @brief   Single precision copy of a PETSc AIJ matrix wrapped in a shell matrix.
+ */
+
+#ifndef LA_SINGLE_PRECISION_MATRIX_HH_
+#define LA_SINGLE_PRECISION_MATRIX_HH_
+
+#include <vector>                // for vector
+#include "petscmat.h"            // for Mat
+#include "petscvec.h"            // for Vec, VecScatter
+
+
+/**
+ * @brief Shell matrix with values of an AIJ matrix stored in single precision.
+ *
+ * The diagonal and off-diagonal blocks of the local rows are copied into CSR arrays with float values,
+ * the products are accumulated in double precision. Since the matrix values dominate the memory traffic
+ * of the product, it is considerably cheaper than the product of the original matrix. Ghost values of the
+ * input vector are gathered by own scatter, which overlaps with the product of the diagonal block.
+ *
+ * Used as the operator of the inner solves of the iterative refinement (see LinSys_PETSC::solve_refinement),
+ * while the preconditioner is still set up from the original matrix. Besides the product the matrix supports
+ * only the diagonal scaling needed by the KSP option '-ksp_diagonal_scale'.
+ */
+class SinglePrecisionMatrix {
+public:
+    /**
+     * Create the shell matrix with the copy of the assembled AIJ matrix @p mat.
+     * The copy is not updated, it has to be created again when @p mat changes.
+     * The returned matrix is destroyed by MatDestroy.
+     */
+    static Mat create(Mat mat);
+
+private:
+    /// Local block of the matrix in CSR format.
+    struct Block {
+        std::vector<PetscInt> row_ptr;
+        std::vector<PetscInt> cols;
+        std::vector<float> vals;
+    };
+
+    SinglePrecisionMatrix(Mat mat);
+
+    ~SinglePrecisionMatrix();
+
+    /// Copy the sequential AIJ matrix @p seq into the block @p b.
+    static void copy_block(Mat seq, Block &b);
+
+    /// Add product of the block @p b and @p x to @p y.
+    static void add_product(const Block &b, const PetscScalar *x, PetscScalar *y);
+
+    /// MATOP_MULT of the shell matrix.
+    static PetscErrorCode mult(Mat A, Vec x, Vec y);
+
+    /// MATOP_DIAGONAL_SCALE of the shell matrix, @p l or @p r may be NULL.
+    static PetscErrorCode diagonal_scale(Mat A, Vec l, Vec r);
+
+    /// MATOP_DESTROY of the shell matrix.
+    static PetscErrorCode destroy(Mat A);
+
+    Block diag_;            ///< Diagonal block, local column indices.
+    Block off_;             ///< Off-diagonal block, column indices into @p ghost_.
+    Vec ghost_;             ///< Sequential vector of ghost values of the input vector, NULL in sequential case.
+    VecScatter scatter_;    ///< Scatter of the ghost values.
+};
+
+
+#endif /* LA_SINGLE_PRECISION_MATRIX_HH_ */
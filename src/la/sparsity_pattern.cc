@@ -0,0 +1,82 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ * 
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * 
+ * @file    sparsity_pattern.cc
+ * @brief   Cached preallocation data of a parallel AIJ matrix.
+ */
+
+#include <mpi.h>
+#include "la/sparsity_pattern.hh"
+#include "la/distribution.hh"
+
+
+void SparsityPattern::add_entries(const Distribution &ds, unsigned int n_rows, const LongIdx *rows,
+        unsigned int n_cols, const LongIdx *cols)
+{
+    ASSERT_EQ_DBG(ds.lsize(), lsize());
+    if (row_cols_.size() != lsize()) row_cols_.resize(lsize());
+
+    for (unsigned int i=0; i<n_rows; i++) {
+        if (! ds.is_local(rows[i])) {
+            for (unsigned int j=0; j<n_cols; j++) remote_entries_.push_back( {rows[i], cols[j]} );
+            continue;
+        }
+        std::vector<LongIdx> &row = row_cols_[ rows[i] - ds.begin() ];
+        for (unsigned int j=0; j<n_cols; j++) {
+            auto it = std::lower_bound(row.begin(), row.end(), cols[j]);
+            if (it == row.end() || *it != cols[j]) row.insert(it, cols[j]);
+        }
+    }
+}
+
+
+void SparsityPattern::assemble(const Distribution &ds)
+{
+    ASSERT_EQ(ds.lsize(), lsize());
+    if (row_cols_.size() != lsize()) row_cols_.resize(lsize());
+    MPI_Comm comm = ds.get_comm();
+    unsigned int np = ds.np();
+
+    // send entries of rows of other processes to their owners
+    std::vector<int> send_counts(np, 0), recv_counts(np), send_offsets(np+1, 0), recv_offsets(np+1, 0);
+    for (auto &e : remote_entries_) send_counts[ ds.get_proc(e.first) ] += 2;
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+    for (unsigned int p=0; p<np; p++) {
+        send_offsets[p+1] = send_offsets[p] + send_counts[p];
+        recv_offsets[p+1] = recv_offsets[p] + recv_counts[p];
+    }
+    std::vector<LongIdx> send_buf(send_offsets[np]), recv_buf(recv_offsets[np]);
+    std::vector<int> pos(send_offsets.begin(), send_offsets.end()-1);
+    for (auto &e : remote_entries_) {
+        int &k = pos[ ds.get_proc(e.first) ];
+        send_buf[k++] = e.first;
+        send_buf[k++] = e.second;
+    }
+    remote_entries_.clear();
+    remote_entries_.shrink_to_fit();
+    MPI_Alltoallv(send_buf.data(), send_counts.data(), send_offsets.data(), MPI_LONG_IDX,
+                  recv_buf.data(), recv_counts.data(), recv_offsets.data(), MPI_LONG_IDX, comm);
+    for (unsigned int k=0; k<recv_buf.size(); k+=2)
+        add_entries(ds, 1, &recv_buf[k], 1, &recv_buf[k+1]);
+
+    // count nonzeros in the diagonal and off-diagonal blocks
+    for (unsigned int i=0; i<lsize(); i++) {
+        PetscInt on_nz = 0;
+        for (LongIdx col : row_cols_[i])
+            if (ds.is_local(col)) on_nz++;
+        set_row(i, on_nz, row_cols_[i].size() - on_nz);
+    }
+    row_cols_.clear();
+    row_cols_.shrink_to_fit();
+    close();
+}
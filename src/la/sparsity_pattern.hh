@@ -0,0 +1,109 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ * 
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * 
+ * @file    sparsity_pattern.hh
+ * @brief   Cached preallocation data of a parallel AIJ matrix.
+ */
+
+#ifndef LA_SPARSITY_PATTERN_HH_
+#define LA_SPARSITY_PATTERN_HH_
+
+#include <algorithm>             // for fill
+#include <utility>               // for pair
+#include <vector>                // for vector
+#include "petscsys.h"            // for PetscInt
+#include "system/asserts.hh"     // for ASSERT
+#include "system/index_types.hh" // for LongIdx
+
+class Distribution;
+
+
+/**
+ * @brief Numbers of nonzero entries in the local rows of a parallel AIJ matrix.
+ *
+ * The pattern is filled once by the counting pass of a linear system (see LinSys_PETSC::start_allocation)
+ * and can be shared by other linear systems with the same distribution and structure of the matrix
+ * (e.g. systems of individual substances), which then skip their own counting pass.
+ *
+ * Alternatively an equation can build the pattern directly from the connectivity of its DOFs by add_entries()
+ * and assemble(), without the assembly pass through the linear system (see LinSys_PETSC::set_sparsity_pattern).
+ * Unlike the counting pass, repeated entries are counted once.
+ */
+class SparsityPattern {
+public:
+    /// Constructor, @p lsize is the number of local rows.
+    SparsityPattern(unsigned int lsize)
+    : on_nz_(lsize, 0), off_nz_(lsize, 0), complete_(false)
+    {}
+
+    /// Number of local rows.
+    inline unsigned int lsize() const
+    { return on_nz_.size(); }
+
+    /// Returns true if the pattern was filled.
+    inline bool is_complete() const
+    { return complete_; }
+
+    /// Discard the counts, the pattern has to be filled again.
+    void clear() {
+        std::fill(on_nz_.begin(), on_nz_.end(), 0);
+        std::fill(off_nz_.begin(), off_nz_.end(), 0);
+        row_cols_.clear();
+        remote_entries_.clear();
+        complete_ = false;
+    }
+
+    /**
+     * Set counts of nonzeros of the local row @p loc_row in the diagonal (@p on_nz)
+     * and in the off-diagonal (@p off_nz) block.
+     */
+    inline void set_row(unsigned int loc_row, PetscInt on_nz, PetscInt off_nz) {
+        ASSERT_LT_DBG(loc_row, lsize());
+        on_nz_[loc_row] = on_nz;
+        off_nz_[loc_row] = off_nz;
+    }
+
+    /// Mark the pattern as filled.
+    inline void close()
+    { complete_ = true; }
+
+    /**
+     * Add entries (@p rows x @p cols) given by global indices. Rows of other processes are allowed,
+     * repeated entries are stored once. The pattern has to be completed by assemble().
+     */
+    void add_entries(const Distribution &ds, unsigned int n_rows, const LongIdx *rows, unsigned int n_cols, const LongIdx *cols);
+
+    /**
+     * Send entries of rows of other processes to their owners, count nonzeros of local rows in the diagonal
+     * and in the off-diagonal block, release the entries and close the pattern. COLLECTIVE.
+     */
+    void assemble(const Distribution &ds);
+
+    /// Counts of nonzeros in the diagonal block, suitable for MatCreateAIJ.
+    inline const PetscInt *on_nz() const
+    { return on_nz_.data(); }
+
+    /// Counts of nonzeros in the off-diagonal block, suitable for MatCreateAIJ.
+    inline const PetscInt *off_nz() const
+    { return off_nz_.data(); }
+
+private:
+    std::vector<PetscInt> on_nz_;    ///< Nonzeros of local rows in the diagonal block.
+    std::vector<PetscInt> off_nz_;   ///< Nonzeros of local rows in the off-diagonal block.
+    bool complete_;                  ///< True if the counts are set.
+
+    std::vector<std::vector<LongIdx>> row_cols_;               ///< Sorted columns of local rows added by add_entries().
+    std::vector<std::pair<LongIdx, LongIdx>> remote_entries_;  ///< Entries of rows of other processes.
+};
+
+#endif /* LA_SPARSITY_PATTERN_HH_ */
@@ -21,6 +21,7 @@
 #include "system/python_loader.hh"
 #include "coupling/hc_explicit_sequential.hh"
 #include "coupling/balance.hh"
+#include "io/reader_cache.hh"
 #include "input/accessors.hh"
 #include "input/reader_to_storage.hh"
 #include "input/reader_internal_base.hh"
@@ -70,6 +71,9 @@ it::Record & Application::get_input_type() {
     		"Simulation problem to be solved.")
     .declare_key("pause_after_run", it::Bool(), it::Default("false"),
     		"If true, the program will wait for key press before it terminates.")
+    .declare_key("input_data_cache_size", it::Integer(0), it::Default("256"),
+    		"Memory budget [MB] of the cache of decoded data of input fields (GMSH, VTK and PVD files). "
+    		"Cached data are reused if a field reads the same time frame repeatedly. Zero switches the cache off.")
 	.close();
 
     return type;
@@ -342,6 +346,8 @@ void Application::run() {
 
         // should flow123d wait for pressing "Enter", when simulation is completed
         sys_info.pause_after_run = i_rec.val<bool>("pause_after_run");
+        // memory budget of decoded input data
+        ReaderCache::set_data_cache_size( (std::size_t)i_rec.val<int>("input_data_cache_size") * 1024 * 1024 );
         // read record with problem configuration
         Input::AbstractRecord i_problem = i_rec.val<AbstractRecord>("problem");
 
@@ -17,6 +17,7 @@
  */
 
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
 #include "mechanics/elasticity.hh"
 
 #include "io/output_time.hh"
@@ -25,6 +26,7 @@
 #include "fem/fe_p.hh"
 #include "fem/fe_rt.hh"
 #include "fem/fe_system.hh"
+#include "fem/mapping_p1.hh"
 #include "fields/field_fe.hh"
 #include "la/linsys_PETSC.hh"
 #include "coupling/balance.hh"
@@ -52,6 +54,12 @@ const Record & Elasticity::get_input_type() {
                     "Parameters of output stream.")
            .declare_key("solver", LinSys_PETSC::get_input_type(), Default::obligatory(),
 				"Linear solver for elasticity.")
+           .declare_key("direct_solver_max_size", IT::Integer(0), IT::Default("0"),
+                "Maximal number of unknowns of the system solved by a sparse direct factorization "
+                "(Cholesky; in parallel only with PETSc configured with MUMPS) instead of the iterative solver. "
+                "The factorization is computed only when the matrix changes, e.g. once for the constant coefficients, "
+                "and reused in all further solves (time steps, iterations of coupled problems). "
+                "Zero switches the direct solver off.")
 		   .declare_key("input_fields", Array(
 		        Elasticity::EqData()
 		            .make_field_descriptor_type(equation_name)),
@@ -335,11 +343,17 @@ void Elasticity::initialize()
 
     // equation default PETSc solver options
     std::string petsc_default_opts;
-    petsc_default_opts = "-ksp_type cg -pc_type hypre -pc_hypre_type boomeramg";
+    // GAMG uses the rigid body modes set as the near null space, BoomerAMG ignores them
+    petsc_default_opts = "-ksp_type cg -pc_type gamg";
     
     // allocate matrix and vector structures
     ls = new LinSys_PETSC(feo->dh()->distr().get(), petsc_default_opts);
     ( (LinSys_PETSC *)ls )->set_from_input( input_rec.val<Input::Record>("solver") );
+    // stiffness matrix with the penalty Dirichlet condition is s.p.d., the direct solver uses Cholesky factorization
+    ls->set_positive_definite();
+    if (feo->dh()->n_global_dofs() <= input_rec.val<unsigned int>("direct_solver_max_size"))
+        ( (LinSys_PETSC *)ls )->set_direct_solver();
+    set_rigid_body_modes();
     ls->set_solution(data_.output_field_ptr->get_data_vec().petsc_vec());
 
     // initialization of balance object
@@ -362,6 +376,24 @@ Elasticity::~Elasticity()
 
 
 
+void Elasticity::save_state(CheckpointData &data)
+{
+    EquationBase::save_state(data);
+    save_vec(data, "solution", data_.output_field_ptr->get_data_vec().petsc_vec());
+    output_stream_->save_state(data);
+}
+
+
+void Elasticity::restore_state(CheckpointData &data)
+{
+    EquationBase::restore_state(data);
+    restore_vec(data, "solution", data_.output_field_ptr->get_data_vec().petsc_vec());
+    update_output_fields();
+    output_stream_->restore_state(data);
+}
+
+
+
 void Elasticity::update_output_fields()
 {
     // update ghost values of solution vector
@@ -463,6 +495,93 @@ void Elasticity::next_time()
 
 
 
+template<unsigned int dim>
+void Elasticity::own_dof_points(Mechanics::FEObjects &feo, std::vector<arma::vec3> &points,
+        std::vector<unsigned int> &components)
+{
+    auto fe = feo.fe<dim>();
+    const unsigned int ndofs = fe->n_dofs();
+    std::vector< arma::vec::fixed<dim+1> > bary_points = fe->dof_points();
+    const Distribution &distr = *feo.dh()->distr();
+    vector<int> dof_indices(ndofs);
+
+    // own DOFs may lie also on ghost elements
+    for (auto cell : feo.dh()->local_range())
+    {
+        if (cell.dim() != dim) continue;
+        cell.get_dof_indices(dof_indices);
+        auto map = MappingP1<dim,3>::element_map(cell.elm());
+        for (unsigned int i=0; i<ndofs; i++)
+        {
+            if (!distr.is_local(dof_indices[i])) continue;
+            unsigned int loc = dof_indices[i] - distr.begin();
+            points[loc] = MappingP1<dim,3>::project_unit_to_real(bary_points[i], map);
+            const arma::vec &coefs = fe->dof(i).coefs;
+            for (unsigned int c=0; c<coefs.n_elem; c++)
+                if (coefs(c) != 0) { components[loc] = c; break; }
+        }
+    }
+}
+
+
+bool Elasticity::rigid_body_modes(Mechanics::FEObjects &feo, std::vector<Vec> &modes)
+{
+    const Distribution &distr = *feo.dh()->distr();
+    const unsigned int n_own = distr.lsize();
+    std::vector<arma::vec3> points(n_own);
+    std::vector<unsigned int> components(n_own);
+    own_dof_points<1>(feo, points, components);
+    own_dof_points<2>(feo, points, components);
+    own_dof_points<3>(feo, points, components);
+
+    // rotations around the centre of DOF points are better conditioned
+    double local_sum[4] = { 0, 0, 0, (double)n_own }, sum[4];
+    for (const arma::vec3 &p : points)
+        for (unsigned int d=0; d<3; d++) local_sum[d] += p(d);
+    MPI_Allreduce(local_sum, sum, 4, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    arma::vec3 centre;
+    for (unsigned int d=0; d<3; d++) centre(d) = sum[d] / std::max(sum[3], 1.0);
+
+    // translations e_m and rotations e_m x (x - centre)
+    modes.resize(6);
+    for (unsigned int m=0; m<6; m++)
+    {
+        chkerr(VecCreateMPI(PETSC_COMM_WORLD, n_own, PETSC_DECIDE, &modes[m]));
+        PetscScalar *array;
+        chkerr(VecGetArray(modes[m], &array));
+        arma::vec3 axis = arma::zeros<arma::vec>(3);
+        axis(m%3) = 1;
+        for (unsigned int i=0; i<n_own; i++)
+        {
+            if (m < 3)
+                array[i] = (components[i] == m) ? 1.0 : 0.0;
+            else
+                array[i] = arma::vec3(arma::cross(axis, points[i] - centre))(components[i]);
+        }
+        chkerr(VecRestoreArray(modes[m], &array));
+    }
+
+    // block size requires DOFs of every node numbered consecutively by components on all processes
+    int interleaved = (n_own % 3 == 0), all_interleaved;
+    for (unsigned int i=0; interleaved && i<n_own; i++)
+        if (components[i] != i%3 || arma::any(points[i] != points[i - i%3])) interleaved = 0;
+    MPI_Allreduce(&interleaved, &all_interleaved, 1, MPI_INT, MPI_MIN, PETSC_COMM_WORLD);
+    return all_interleaved;
+}
+
+
+void Elasticity::set_rigid_body_modes()
+{
+    std::vector<Vec> modes;
+    bool all_interleaved = rigid_body_modes(*feo, modes);
+    ( (LinSys_PETSC *)ls )->set_near_null_space(modes);
+    for (Vec &v : modes) chkerr(VecDestroy(&v));
+    if (all_interleaved) ( (LinSys_PETSC *)ls )->set_block_size(3);
+    LogOut().fmt("Mechanics: rigid body modes set as near null space, block size {}.\n", all_interleaved ? 3 : 1);
+}
+
+
+
 void Elasticity::solve_linear_system()
 {
     START_TIMER("data reinit");
@@ -470,9 +589,11 @@ void Elasticity::solve_linear_system()
     END_TIMER("data reinit");
     
     // assemble stiffness matrix
+    bool matrix_assembled = false;
     if (stiffness_matrix == NULL
         || data_.subset(FieldFlag::in_main_matrix).changed())
     {
+        matrix_assembled = true;
         DebugOut() << "Mechanics: Assembling matrix.\n";
         ls->start_add_assembly();
         ls->mat_zero_entries();
@@ -497,6 +618,10 @@ void Elasticity::solve_linear_system()
 
         if (rhs == nullptr) VecDuplicate(*( ls->get_rhs() ), &rhs);
         VecCopy(*( ls->get_rhs() ), rhs);
+
+        // the assembly of the right hand side keeps the matrix, so the preconditioner
+        // (or factorization) can be reused, e.g. in iterations of the coupled HM problem
+        if (!matrix_assembled) ls->set_matrix_changed(false);
     }
 
     START_TIMER("solve");
@@ -57,9 +57,9 @@ public:
 	template<unsigned int dim>
 	inline Quadrature *q() { return &(q_[dim]); }
 
-	inline std::shared_ptr<DOFHandlerMultiDim> dh();
-    inline std::shared_ptr<DOFHandlerMultiDim> dh_scalar();
-    inline std::shared_ptr<DOFHandlerMultiDim> dh_tensor();
+	std::shared_ptr<DOFHandlerMultiDim> dh();
+    std::shared_ptr<DOFHandlerMultiDim> dh_scalar();
+    std::shared_ptr<DOFHandlerMultiDim> dh_tensor();
     
 //     const FEValuesViews::Vector<dim,3> vec;
 
@@ -177,6 +177,9 @@ public:
 	 */
 	void output_data();
 
+	void save_state(CheckpointData &data) override;
+	void restore_state(CheckpointData &data) override;
+
 	/**
 	 * @brief Destructor.
 	 */
@@ -200,6 +203,15 @@ public:
     
     typedef Elasticity FactoryBaseType;
 
+	/**
+	 * @brief Creates rigid body modes of the displacement given by the DOF handler of @p feo.
+	 *
+	 * The 3 translations and 3 rotations are computed from support points of own DOFs, the vectors
+	 * are created in @p modes. Returns true if DOFs of every node are numbered consecutively
+	 * by components on all processes. COLLECTIVE.
+	 */
+	static bool rigid_body_modes(Mechanics::FEObjects &feo, std::vector<Vec> &modes);
+
 
 
 
@@ -212,6 +224,19 @@ private:
 
 	void preallocate();
 
+	/**
+	 * @brief Passes rigid body modes to the linear solver as the near null space of the matrix.
+	 *
+	 * The block size of the matrix is set if DOFs of every node are numbered consecutively by components.
+	 * Both are used by algebraic multigrid preconditioners.
+	 */
+	void set_rigid_body_modes();
+
+	/// Fills support points and components of own DOFs (indexed by local index) on elements of dimension @p dim.
+	template<unsigned int dim>
+	static void own_dof_points(Mechanics::FEObjects &feo, std::vector<arma::vec3> &points,
+	        std::vector<unsigned int> &components);
+
 	/**
 	 * @brief Assembles the stiffness matrix.
 	 *
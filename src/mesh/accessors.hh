@@ -198,9 +198,13 @@ public:
 
 
     NodeAccessor<3> node(unsigned int ni) const {
+        if (mesh_->topology_.is_built()) return mesh_->node( mesh_->topology_.elem_node(element_idx_, ni) );
         return mesh_->node( element()->node_idx(ni) );
     }
 
+    /// Return side of higher dimensional element of @p i-th VB neighbour, read from Mesh::topology().
+    SideIter neigh_vb_side(unsigned int i) const;
+
     /**
     * Return bounding box of the element.
     * Simpler code, but need to check performance penelty.
@@ -297,8 +301,10 @@ public:
     }
 
     /// Returns number of sides aligned with the edge.
-    unsigned int n_sides() const
-    { return edge_data()->n_sides;}
+    unsigned int n_sides() const {
+        if (mesh_->topology_.is_built()) return mesh_->topology_.edge_n_sides(edge_idx_);
+        return edge_data()->n_sides;
+    }
 
 private:
     /// Pointer to the mesh owning the node.
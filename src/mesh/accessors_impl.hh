@@ -166,6 +166,14 @@ const SideIter ElementAccessor<spacedim>::side(const unsigned int loc_index) con
     return SideIter( Side(mesh_, element_idx_, loc_index) );
 }
 
+template <int spacedim> inline
+SideIter ElementAccessor<spacedim>::neigh_vb_side(unsigned int i) const {
+    ASSERT_DBG(mesh_->topology_.is_built()).error("Mesh topology arrays are not created.");
+    const MeshTopology &topology = mesh_->topology_;
+    unsigned int side = topology.neigh_side( topology.elem_neigh_vb(element_idx_, i) );
+    return SideIter( Side(mesh_, topology.side_element(side), topology.side_local_idx(side)) );
+}
+
 
 
 /*******************************************************************************
@@ -190,6 +198,11 @@ inline const EdgeData* Edge::edge_data() const
 }
 
 inline SideIter Edge::side(const unsigned int i) const {
+    const MeshTopology &topology = mesh_->topology_;
+    if (topology.is_built()) {
+        unsigned int side = topology.edge_side(edge_idx_, i);
+        return SideIter( Side(mesh_, topology.side_element(side), topology.side_local_idx(side)) );
+    }
     return edge_data()->side_[i];
 }
 
@@ -211,8 +224,9 @@ inline Side::Side(const Mesh * mesh, unsigned int elem_idx, unsigned int set_lnu
 }
 
 inline unsigned int Side::dim() const {
-        return element()->dim()-1;
-    }
+    if (mesh_->topology_.is_built()) return mesh_->topology_.elem_n_nodes(elem_idx_)-2;
+    return element()->dim()-1;
+}
 
 // returns true for all sides either on boundary or connected to vb neigboring
 inline bool Side::is_external() const {
@@ -227,6 +241,7 @@ inline bool Side::is_boundary() const {
 inline NodeAccessor<3> Side::node(unsigned int i) const {
     int i_n = mesh_->side_nodes[dim()][side_idx_][i];
 
+    if (mesh_->topology_.is_built()) return mesh_->node( mesh_->topology_.elem_node(elem_idx_, i_n) );
     return element().node( i_n );
 }
 
@@ -236,6 +251,7 @@ inline ElementAccessor<3> Side::element() const {
 }
 
 inline unsigned int Side::edge_idx() const {
+    if (mesh_->topology_.is_built()) return mesh_->topology_.side_edge( mesh_->topology_.elem_side(elem_idx_, side_idx_) );
     return element()->edge_idx(side_idx_);
 }
 
@@ -248,6 +264,7 @@ inline Boundary Side::cond() const {
 }
 
 inline unsigned int Side::cond_idx() const {
+        if (mesh_->topology_.is_built()) return mesh_->topology_.side_boundary( mesh_->topology_.elem_side(elem_idx_, side_idx_) );
         if (element()->boundary_idx_ == nullptr) return Mesh::undef_idx;
         else return element()->boundary_idx_[side_idx_];
 }
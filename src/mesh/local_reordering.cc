@@ -0,0 +1,198 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    local_reordering.cc
+ * @ingroup mesh
+ * @brief   Locality improving orderings of local elements.
+ */
+
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <unordered_map>
+
+#include "mesh/local_reordering.hh"
+#include "system/asserts.hh"
+
+
+std::vector<unsigned int> LocalReordering::inverse(const std::vector<unsigned int> &order)
+{
+	std::vector<unsigned int> pos(order.size());
+	for (unsigned int k=0; k<order.size(); ++k) pos[ order[k] ] = k;
+	return pos;
+}
+
+
+std::vector<unsigned int> LocalReordering::reverse_cuthill_mckee(const Graph &graph)
+{
+	unsigned int n = graph.size();
+	std::vector<unsigned int> order;
+	order.reserve(n);
+	std::vector<bool> visited(n, false);
+	std::vector<unsigned int> level(n);
+
+	// breadth first search from @p root, returns last vertex of the last level and its level
+	auto bfs = [&](unsigned int root, std::vector<unsigned int> &queue) {
+		queue.clear();
+		queue.push_back(root);
+		visited[root] = true;
+		level[root] = 0;
+		for (unsigned int head=0; head<queue.size(); ++head) {
+			unsigned int v = queue[head];
+			unsigned int first = queue.size();
+			for (unsigned int j=graph.offsets[v]; j<graph.offsets[v+1]; ++j) {
+				unsigned int w = graph.adj[j];
+				if (visited[w]) continue;
+				visited[w] = true;
+				level[w] = level[v]+1;
+				queue.push_back(w);
+			}
+			// neighbours in order of increasing degree
+			std::sort(queue.begin()+first, queue.end(), [&graph](unsigned int a, unsigned int b) {
+				return graph.degree(a) < graph.degree(b) || (graph.degree(a) == graph.degree(b) && a < b);
+			});
+		}
+	};
+
+	std::vector<unsigned int> component;
+	for (unsigned int start=0; start<n; ++start) {
+		if (visited[start]) continue;
+
+		// find pseudo-peripheral vertex: repeat BFS from the vertex of minimal degree in the last level
+		unsigned int root = start, root_ecc = 0;
+		for (unsigned int it=0; it<10; ++it) {
+			bfs(root, component);
+			unsigned int ecc = level[component.back()];
+			for (unsigned int v : component) visited[v] = false;
+			if (it > 0 && ecc <= root_ecc) break;
+			root_ecc = ecc;
+			unsigned int best = component.back();
+			for (unsigned int v : component)
+				if (level[v] == ecc && graph.degree(v) < graph.degree(best)) best = v;
+			if (best == root) break;
+			root = best;
+		}
+
+		bfs(root, component);
+		order.insert(order.end(), component.begin(), component.end());
+	}
+
+	std::reverse(order.begin(), order.end());
+	ASSERT_EQ_DBG(order.size(), n);
+	return order;
+}
+
+
+unsigned long long LocalReordering::hilbert_index(unsigned int coords[3], unsigned int n_bits)
+{
+	// Skilling's transform of coordinates to the transposed Hilbert index
+	unsigned int x[3] = {coords[0], coords[1], coords[2]};
+	unsigned int m = 1u << (n_bits-1);
+	for (unsigned int q=m; q>1; q>>=1) {
+		unsigned int p = q-1;
+		for (unsigned int i=0; i<3; ++i) {
+			if (x[i] & q) x[0] ^= p;
+			else {
+				unsigned int t = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+	for (unsigned int i=1; i<3; ++i) x[i] ^= x[i-1];
+	unsigned int t = 0;
+	for (unsigned int q=m; q>1; q>>=1)
+		if (x[2] & q) t ^= q-1;
+	for (unsigned int i=0; i<3; ++i) x[i] ^= t;
+
+	// interleave bits of the transposed index
+	unsigned long long index = 0;
+	for (int b=n_bits-1; b>=0; --b)
+		for (unsigned int i=0; i<3; ++i)
+			index = (index << 1) | ((x[i] >> b) & 1);
+	return index;
+}
+
+
+std::vector<unsigned int> LocalReordering::hilbert(const std::vector<arma::vec3> &points)
+{
+	static const unsigned int n_bits = 20;
+	std::vector<unsigned int> order(points.size());
+	std::iota(order.begin(), order.end(), 0);
+	if (points.size() < 2) return order;
+
+	arma::vec3 min = points[0], max = points[0];
+	for (const arma::vec3 &p : points) {
+		min = arma::min(min, p);
+		max = arma::max(max, p);
+	}
+	double size = arma::max(max - min);
+	if (size <= 0.0) return order;
+	double scale = ((1u << n_bits) - 1) / size; // same scale in all directions
+
+	std::vector<unsigned long long> keys(points.size());
+	for (unsigned int i=0; i<points.size(); ++i) {
+		unsigned int coords[3];
+		for (unsigned int d=0; d<3; ++d) coords[d] = (unsigned int)( (points[i](d) - min(d)) * scale );
+		keys[i] = hilbert_index(coords, n_bits);
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](unsigned int a, unsigned int b) {
+		return keys[a] < keys[b];
+	});
+	return order;
+}
+
+
+unsigned int LocalReordering::bandwidth(const Graph &graph, const std::vector<unsigned int> &order)
+{
+	std::vector<unsigned int> pos = inverse(order);
+	unsigned int bw = 0;
+	for (unsigned int i=0; i<graph.size(); ++i)
+		for (unsigned int j=graph.offsets[i]; j<graph.offsets[i+1]; ++j) {
+			unsigned int a = pos[i], b = pos[ graph.adj[j] ];
+			bw = std::max(bw, (a > b) ? a-b : b-a);
+		}
+	return bw;
+}
+
+
+unsigned int LocalReordering::cache_misses(const Graph &graph, const std::vector<unsigned int> &order,
+		unsigned int n_lines, unsigned int line_size)
+{
+	std::vector<unsigned int> pos = inverse(order);
+	std::list<unsigned int> lru;
+	std::unordered_map<unsigned int, std::list<unsigned int>::iterator> cached;
+	unsigned int n_misses = 0;
+
+	auto access = [&](unsigned int vertex) {
+		unsigned int line = pos[vertex] / line_size;
+		auto it = cached.find(line);
+		if (it != cached.end()) {
+			lru.splice(lru.begin(), lru, it->second);
+			return;
+		}
+		++n_misses;
+		lru.push_front(line);
+		cached[line] = lru.begin();
+		if (lru.size() > n_lines) {
+			cached.erase(lru.back());
+			lru.pop_back();
+		}
+	};
+
+	for (unsigned int v : order) {
+		access(v);
+		for (unsigned int j=graph.offsets[v]; j<graph.offsets[v+1]; ++j) access(graph.adj[j]);
+	}
+	return n_misses;
+}
@@ -0,0 +1,83 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    local_reordering.hh
+ * @ingroup mesh
+ * @brief   Locality improving orderings of local elements.
+ */
+
+#ifndef LOCAL_REORDERING_HH_
+#define LOCAL_REORDERING_HH_
+
+#include <vector>
+#include <armadillo>
+
+
+/**
+ * @brief Orderings of the local part of the mesh that improve data locality.
+ *
+ * Graph of local elements is given in CSR format: neighbours of the vertex @p i are
+ * @p adj[ offsets[i] ] ... @p adj[ offsets[i+1]-1 ]. All orderings return vector @p order,
+ * @p order[k] is the original index of the vertex placed at position @p k.
+ */
+class LocalReordering {
+public:
+	/// Graph in CSR format.
+	struct Graph {
+		/// Offsets to @p adj, size n_vertices+1.
+		std::vector<unsigned int> offsets;
+		/// Neighbouring vertices.
+		std::vector<unsigned int> adj;
+
+		/// Number of vertices.
+		inline unsigned int size() const {
+			return offsets.size() - 1;
+		}
+
+		/// Number of neighbours of vertex @p i.
+		inline unsigned int degree(unsigned int i) const {
+			return offsets[i+1] - offsets[i];
+		}
+	};
+
+	/// Reverse Cuthill-McKee ordering, every connected component starts from a pseudo-peripheral vertex.
+	static std::vector<unsigned int> reverse_cuthill_mckee(const Graph &graph);
+
+	/// Ordering of points along the Hilbert space filling curve over their bounding box.
+	static std::vector<unsigned int> hilbert(const std::vector<arma::vec3> &points);
+
+	/**
+	 * Hilbert index of the point with integer coordinates @p coords (each of them less than 2^@p n_bits)
+	 * on the 3D curve of order @p n_bits.
+	 */
+	static unsigned long long hilbert_index(unsigned int coords[3], unsigned int n_bits);
+
+	/// Maximal distance of positions of neighbouring vertices in given @p order (bandwidth of the graph matrix).
+	static unsigned int bandwidth(const Graph &graph, const std::vector<unsigned int> &order);
+
+	/**
+	 * Number of misses of a fully associative LRU cache of @p n_lines lines, each holding data
+	 * of @p line_size consecutive vertices, during traversal of vertices in given @p order that reads
+	 * data of the vertex and all its neighbours (access pattern of matrix-vector product).
+	 *
+	 * Data of vertices are expected to be stored in the same order as they are traversed.
+	 */
+	static unsigned int cache_misses(const Graph &graph, const std::vector<unsigned int> &order,
+			unsigned int n_lines = 512, unsigned int line_size = 8);
+
+	/// Return inverse permutation to @p order (position of every vertex).
+	static std::vector<unsigned int> inverse(const std::vector<unsigned int> &order);
+};
+
+
+#endif /* LOCAL_REORDERING_HH_ */
@@ -394,6 +394,11 @@ void Mesh::setup_topology() {
     make_neighbours_and_edges();
     element_to_neigh_vb();
     make_edge_permutations();
+
+    topology_.build(*this);
+    MessageOut().fmt("Mesh topology arrays: {:.1f} B per element, {} kB in total.\n",
+            (double)topology_.memory_size() / element_vec_.size(), topology_.memory_size() / 1024);
+
     count_side_types();
     
     tree = new DuplicateNodes(this);
@@ -408,6 +413,7 @@ void Mesh::setup_topology() {
     part_->id_maps(n_elements(), id_4_old, el_ds, el_4_loc, row_4_el);
 
     delete[] id_4_old;
+    part_->reorder_local_elements(*el_ds, el_4_loc, row_4_el);
     
     this->distribute_nodes();
 
@@ -1278,6 +1284,7 @@ void Mesh::permute_tetrahedron(unsigned int elm_idx, std::vector<unsigned int> p
        	tmp_nodes[i] = elem.nodes_[permutation_vec[i]];
     }
     elem.nodes_ = tmp_nodes;
+    if (topology_.is_built()) topology_.update_element_nodes(elm_idx, elem.nodes_.data());
 }
 
 
@@ -1295,6 +1302,7 @@ void Mesh::permute_triangle(unsigned int elm_idx, std::vector<unsigned int> perm
        	tmp_nodes[i] = elem.nodes_[permutation_vec[i]];
     }
     elem.nodes_ = tmp_nodes;
+    if (topology_.is_built()) topology_.update_element_nodes(elm_idx, elem.nodes_.data());
 }
 
 
@@ -1339,12 +1347,28 @@ void Mesh::distribute_nodes() {
     node_4_loc_ = new LongIdx [ n_local_nodes ];
     i_node=0;
     i_ghost_node = n_own_nodes;
-    for (unsigned int i=0; i<this->n_nodes(); ++i) {
-        if (local_node_flag[i]) {
-            if (node_proc[i]==my_proc)
-                node_4_loc_[i_node++] = i;
-            else
-                node_4_loc_[i_ghost_node++] = i;
+    if (part_->reorders_elements()) {
+        // number local nodes in order of their first use by reordered local elements
+        for (unsigned int i_loc=0; i_loc<el_ds->lsize(); ++i_loc) {
+            ElementAccessor<3> elm = this->element_accessor( el_4_loc[i_loc] );
+            for (elm_node=0; elm_node<elm->n_nodes(); elm_node++) {
+                unsigned int i = elm->node_idx(elm_node);
+                if (!local_node_flag[i]) continue;
+                local_node_flag[i] = false; // node is numbered
+                if (node_proc[i]==my_proc)
+                    node_4_loc_[i_node++] = i;
+                else
+                    node_4_loc_[i_ghost_node++] = i;
+            }
+        }
+    } else {
+        for (unsigned int i=0; i<this->n_nodes(); ++i) {
+            if (local_node_flag[i]) {
+                if (node_proc[i]==my_proc)
+                    node_4_loc_[i_node++] = i;
+                else
+                    node_4_loc_[i_ghost_node++] = i;
+            }
         }
     }
 
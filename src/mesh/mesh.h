@@ -33,6 +33,7 @@
 #include "mesh/bounding_box.hh"              // for BoundingBox
 #include "mesh/range_wrapper.hh"
 #include "mesh/mesh_data.hh"
+#include "mesh/mesh_topology.hh"
 #include "tools/bidirectional_map.hh"
 #include "tools/general_iterator.hh"
 #include "system/index_types.hh"             // for LongIdx
@@ -138,6 +139,11 @@ public:
     Edge edge(uint edge_idx) const;
     Boundary boundary(uint edge_idx) const;
 
+    /// Compact topology arrays, filled at the end of setup_topology.
+    inline const MeshTopology &topology() const {
+        return topology_;
+    }
+
     unsigned int n_corners();
 
     inline const RegionDB &region_db() const {
@@ -532,6 +538,9 @@ protected:
     /// Vector of MH edges, this should not be part of the geometrical mesh
     std::vector<EdgeData> edges;
 
+    /// Compact copy of element, side, edge and neighbour connectivity used by accessors.
+    MeshTopology topology_;
+
 
     friend class Edge;
     friend class Side;
@@ -540,6 +549,7 @@ protected:
     friend class BIHTree;
     friend class Boundary;
     friend class BCMesh;
+    friend class MeshTopology;
     template <int spacedim> friend class ElementAccessor;
     template <int spacedim> friend class NodeAccessor;
 
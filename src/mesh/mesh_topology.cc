@@ -0,0 +1,129 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    mesh_topology.cc
+ * @ingroup mesh
+ * @brief   Compact arrays of mesh topology.
+ */
+
+#include <limits>
+
+#include "mesh/mesh_topology.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+#include "mesh/neighbours.h"
+#include "system/sys_profiler.hh"
+
+
+MeshTopology::MeshTopology()
+: built_(false)
+{
+	this->clear();
+}
+
+
+void MeshTopology::clear()
+{
+	built_ = false;
+	elem_offset_.assign(1, 0);
+	edge_offset_.assign(1, 0);
+	elem_ngh_offset_.assign(1, 0);
+	std::vector<Idx>().swap(elem_nodes_);
+	std::vector<Idx>().swap(side_edge_);
+	std::vector<Idx>().swap(side_boundary_);
+	std::vector<Idx>().swap(side_element_);
+	std::vector<Idx>().swap(edge_sides_);
+	std::vector<Idx>().swap(elem_nghs_);
+	std::vector<Idx>().swap(ngh_side_);
+}
+
+
+void MeshTopology::build(Mesh &mesh)
+{
+	START_TIMER("MESH - build topology arrays");
+	this->clear();
+
+	unsigned int n_elem = mesh.element_vec_.size();
+
+	// element -> nodes, sides
+	elem_offset_.resize(n_elem+1);
+	std::size_t n_sides = 0;
+	for (unsigned int i=0; i<n_elem; ++i) {
+		elem_offset_[i] = n_sides;
+		n_sides += mesh.element_vec_[i].n_nodes();
+	}
+	ASSERT_LE(n_sides, std::numeric_limits<Idx>::max()).error("Too many sides for 32-bit indices.");
+	elem_offset_[n_elem] = n_sides;
+
+	elem_nodes_.resize(n_sides);
+	side_edge_.resize(n_sides);
+	side_boundary_.resize(n_sides);
+	side_element_.resize(n_sides);
+	for (unsigned int i=0; i<n_elem; ++i) {
+		const Element &elm = mesh.element_vec_[i];
+		for (unsigned int s=0; s<elm.n_nodes(); ++s) {
+			Idx side = elem_offset_[i] + s;
+			elem_nodes_[side] = elm.node_idx(s);
+			side_edge_[side] = elm.edge_idx(s);
+			side_boundary_[side] = (elm.boundary_idx_ == nullptr) ? undef_idx : elm.boundary_idx_[s];
+			side_element_[side] = i;
+		}
+	}
+
+	// edge -> sides
+	unsigned int n_edges = mesh.edges.size();
+	edge_offset_.resize(n_edges+1);
+	unsigned int n_edge_sides = 0;
+	for (unsigned int i=0; i<n_edges; ++i) {
+		edge_offset_[i] = n_edge_sides;
+		n_edge_sides += mesh.edges[i].n_sides;
+	}
+	edge_offset_[n_edges] = n_edge_sides;
+
+	edge_sides_.resize(n_edge_sides);
+	for (unsigned int i=0; i<n_edges; ++i) {
+		const EdgeData &edg = mesh.edges[i];
+		for (unsigned int s=0; s<edg.n_sides; ++s)
+			edge_sides_[ edge_offset_[i] + s ] = elem_offset_[ edg.side_[s]->elem_idx() ] + edg.side_[s]->side_idx();
+	}
+
+	// VB neighbours
+	unsigned int n_ngh = mesh.vb_neighbours_.size();
+	ngh_side_.resize(n_ngh);
+	elem_ngh_offset_.assign(n_elem+1, 0);
+	for (unsigned int i=0; i<n_ngh; ++i) {
+		Neighbour &ngh = mesh.vb_neighbours_[i];
+		SideIter side = ngh.side();
+		ngh_side_[i] = elem_offset_[ side->elem_idx() ] + side->side_idx();
+		elem_ngh_offset_[ ngh.element().mesh_idx()+1 ]++;
+	}
+	for (unsigned int i=0; i<n_elem; ++i) elem_ngh_offset_[i+1] += elem_ngh_offset_[i];
+
+	// same order of neighbours as in Element::neigh_vb
+	elem_nghs_.resize(n_ngh);
+	std::vector<Idx> fill_pos(elem_ngh_offset_.begin(), elem_ngh_offset_.end()-1);
+	for (unsigned int i=0; i<n_ngh; ++i)
+		elem_nghs_[ fill_pos[ mesh.vb_neighbours_[i].element().mesh_idx() ]++ ] = i;
+
+	built_ = true;
+}
+
+
+std::size_t MeshTopology::memory_size() const
+{
+	std::size_t n_items = elem_offset_.size() + elem_nodes_.size()
+			+ side_edge_.size() + side_boundary_.size() + side_element_.size()
+			+ edge_offset_.size() + edge_sides_.size()
+			+ elem_ngh_offset_.size() + elem_nghs_.size() + ngh_side_.size();
+	return n_items * sizeof(Idx);
+}
@@ -0,0 +1,200 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    mesh_topology.hh
+ * @ingroup mesh
+ * @brief   Compact arrays of mesh topology.
+ */
+
+#ifndef MESH_TOPOLOGY_HH_
+#define MESH_TOPOLOGY_HH_
+
+#include <cstdint>
+#include <vector>
+#include "system/asserts.hh"
+
+class Mesh;
+
+
+/**
+ * @brief Compact store of mesh topology in CSR arrays of 32-bit indices.
+ *
+ * Element, edge, boundary and neighbour objects of the Mesh are connected through pointers and
+ * per element allocated arrays, the accessors (ElementAccessor, Side, Edge) therefore jump between
+ * many separate structures. This class gathers the same connectivity into few contiguous arrays:
+ *  - element -> nodes
+ *  - element -> sides (global side index is @p elem_offset_ + local side index)
+ *  - side -> edge, side -> boundary, side -> element
+ *  - edge -> sides
+ *  - element -> VB neighbours -> side of the higher dimensional element
+ *
+ * All elements are simplices, number of sides is equal to number of nodes, so both element -> nodes
+ * and element -> sides use the same offset array. Arrays cover whole Mesh::element_vec_ (bulk and
+ * boundary elements), sides of boundary elements have undefined edge and boundary.
+ *
+ * The store is created at the end of Mesh::setup_topology(), accessors fall back to the original
+ * structures until then.
+ */
+class MeshTopology {
+public:
+	/// Type of stored indices.
+	typedef std::uint32_t Idx;
+
+	/// Value of undefined index (same as Mesh::undef_idx).
+	static const Idx undef_idx = (Idx)(-1);
+
+	/// Constructor, creates empty store.
+	MeshTopology();
+
+	/// Fill arrays from element, edge and neighbour data of the @p mesh.
+	void build(Mesh &mesh);
+
+	/// Release all arrays.
+	void clear();
+
+	/// Return true if arrays are filled.
+	inline bool is_built() const {
+		return built_;
+	}
+
+	/// Number of elements (bulk and boundary).
+	inline unsigned int n_elements() const {
+		return elem_offset_.size() - 1;
+	}
+
+	/// Total number of sides of all elements.
+	inline unsigned int n_sides() const {
+		return side_edge_.size();
+	}
+
+	/// Number of edges.
+	inline unsigned int n_edges() const {
+		return edge_offset_.size() - 1;
+	}
+
+	/// Number of VB neighbours.
+	inline unsigned int n_vb_neighbours() const {
+		return ngh_side_.size();
+	}
+
+	/// Number of nodes (and sides) of element @p elm_idx.
+	inline unsigned int elem_n_nodes(unsigned int elm_idx) const {
+		ASSERT_LT_DBG(elm_idx, n_elements());
+		return elem_offset_[elm_idx+1] - elem_offset_[elm_idx];
+	}
+
+	/// Index of @p i-th node of element @p elm_idx.
+	inline unsigned int elem_node(unsigned int elm_idx, unsigned int i) const {
+		ASSERT_LT_DBG(i, elem_n_nodes(elm_idx));
+		return elem_nodes_[ elem_offset_[elm_idx] + i ];
+	}
+
+	/// Global index of @p i-th side of element @p elm_idx.
+	inline unsigned int elem_side(unsigned int elm_idx, unsigned int i) const {
+		ASSERT_LT_DBG(i, elem_n_nodes(elm_idx));
+		return elem_offset_[elm_idx] + i;
+	}
+
+	/// Edge of the side given by global index.
+	inline unsigned int side_edge(unsigned int side) const {
+		ASSERT_LT_DBG(side, n_sides());
+		return side_edge_[side];
+	}
+
+	/// Boundary of the side given by global index, undef_idx for inner sides.
+	inline unsigned int side_boundary(unsigned int side) const {
+		ASSERT_LT_DBG(side, n_sides());
+		return side_boundary_[side];
+	}
+
+	/// Element of the side given by global index.
+	inline unsigned int side_element(unsigned int side) const {
+		ASSERT_LT_DBG(side, n_sides());
+		return side_element_[side];
+	}
+
+	/// Local index of the side given by global index on its element.
+	inline unsigned int side_local_idx(unsigned int side) const {
+		return side - elem_offset_[ side_element(side) ];
+	}
+
+	/// Number of sides of edge @p edge_idx.
+	inline unsigned int edge_n_sides(unsigned int edge_idx) const {
+		ASSERT_LT_DBG(edge_idx, n_edges());
+		return edge_offset_[edge_idx+1] - edge_offset_[edge_idx];
+	}
+
+	/// Global index of @p i-th side of edge @p edge_idx.
+	inline unsigned int edge_side(unsigned int edge_idx, unsigned int i) const {
+		ASSERT_LT_DBG(i, edge_n_sides(edge_idx));
+		return edge_sides_[ edge_offset_[edge_idx] + i ];
+	}
+
+	/// Number of VB neighbours of element @p elm_idx (element of lower dimension).
+	inline unsigned int elem_n_neighs_vb(unsigned int elm_idx) const {
+		ASSERT_LT_DBG(elm_idx, n_elements());
+		return elem_ngh_offset_[elm_idx+1] - elem_ngh_offset_[elm_idx];
+	}
+
+	/// Index (into Mesh::vb_neighbours_) of @p i-th VB neighbour of element @p elm_idx.
+	inline unsigned int elem_neigh_vb(unsigned int elm_idx, unsigned int i) const {
+		ASSERT_LT_DBG(i, elem_n_neighs_vb(elm_idx));
+		return elem_nghs_[ elem_ngh_offset_[elm_idx] + i ];
+	}
+
+	/// Global index of side of the higher dimensional element of VB neighbour @p ngh_idx.
+	inline unsigned int neigh_side(unsigned int ngh_idx) const {
+		ASSERT_LT_DBG(ngh_idx, n_vb_neighbours());
+		return ngh_side_[ngh_idx];
+	}
+
+	/// Update nodes of element @p elm_idx after permutation of its nodes.
+	inline void update_element_nodes(unsigned int elm_idx, const unsigned int *nodes) {
+		for (unsigned int i=0; i<elem_n_nodes(elm_idx); ++i)
+			elem_nodes_[ elem_offset_[elm_idx] + i ] = nodes[i];
+	}
+
+	/// Memory occupied by the arrays in bytes.
+	std::size_t memory_size() const;
+
+private:
+	/// Flag is set after call of build.
+	bool built_;
+
+	/// Offsets of elements to @p elem_nodes_ and to side arrays, size n_elements+1.
+	std::vector<Idx> elem_offset_;
+	/// Nodes of elements.
+	std::vector<Idx> elem_nodes_;
+
+	/// Edge of every side.
+	std::vector<Idx> side_edge_;
+	/// Boundary of every side.
+	std::vector<Idx> side_boundary_;
+	/// Element of every side.
+	std::vector<Idx> side_element_;
+
+	/// Offsets of edges to @p edge_sides_, size n_edges+1.
+	std::vector<Idx> edge_offset_;
+	/// Global indices of sides of edges.
+	std::vector<Idx> edge_sides_;
+
+	/// Offsets of elements to @p elem_nghs_, size n_elements+1.
+	std::vector<Idx> elem_ngh_offset_;
+	/// Indices of VB neighbours of elements.
+	std::vector<Idx> elem_nghs_;
+	/// Side of higher dimensional element of every VB neighbour.
+	std::vector<Idx> ngh_side_;
+};
+
+
+#endif /* MESH_TOPOLOGY_HH_ */
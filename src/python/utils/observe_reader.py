@@ -0,0 +1,82 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+"""
+Reader of binary observe files '<equation>_observe.bin' (OutputStream key observe_format: binary).
+
+The file starts with a YAML header terminated by the line 'binary_data:'. The header contains
+the same data as the YAML observe file (time unit, observe points), the byte order of the writing
+machine ('little_endian' or 'big_endian', files without the key are little endian) and the list
+of fields with number of components and data type. Then follows one record per time frame:
+time (float64) and values of every field in all points (n_points * n_comp values).
+
+Example:
+    obs = ObserveReader('flow_observe.bin')
+    obs.times                 # array of shape (n_times,)
+    obs.field('pressure_p0')  # array of shape (n_times, n_points, n_comp)
+"""
+
+import numpy as np
+import yaml
+
+
+class ObserveReader(object):
+    """
+    Reads binary observe file, data are mapped to memory (not loaded at once).
+    """
+    BINARY_MARKER = b'binary_data:\n'
+    BYTE_ORDERS = {'little_endian': '<', 'big_endian': '>'}
+
+    def __init__(self, file_name):
+        self.file_name = file_name
+        header_lines = []
+        with open(file_name, 'rb') as f:
+            for line in f:
+                if line == self.BINARY_MARKER:
+                    break
+                header_lines.append(line)
+            else:
+                raise ValueError("File '{}' is not binary observe file.".format(file_name))
+            offset = f.tell()
+            f.seek(0, 2)
+            file_size = f.tell()
+
+        self.header = yaml.safe_load(b''.join(header_lines).decode('utf-8'))
+        self.points = self.header.get('points') or []
+        self.time_unit = self.header.get('time_unit')
+        self.fields = self.header.get('fields') or []
+        byte_order = self.header.get('byte_order', 'little_endian')
+        if byte_order not in self.BYTE_ORDERS:
+            raise ValueError("Unknown byte order '{}' in file '{}'.".format(byte_order, file_name))
+        self.byte_order = self.BYTE_ORDERS[byte_order]
+
+        n_points = len(self.points)
+        dtype = [('time', np.dtype('f8').newbyteorder(self.byte_order))]
+        for field in self.fields:
+            dtype.append((field['name'], np.dtype(field['dtype']).newbyteorder(self.byte_order),
+                          (n_points, field['n_comp'])))
+        self.dtype = np.dtype(dtype)
+
+        n_times = (file_size - offset) // self.dtype.itemsize
+        if n_times > 0:
+            self.data = np.memmap(file_name, dtype=self.dtype, mode='r', offset=offset, shape=(n_times,))
+        else:
+            self.data = np.zeros(0, dtype=self.dtype)
+
+    @property
+    def times(self):
+        """Array of observe times."""
+        return self.data['time']
+
+    @property
+    def point_names(self):
+        """List of observe point names in the order of stored values."""
+        return [point['name'] for point in self.points]
+
+    def field(self, name):
+        """Values of given field, array of shape (n_times, n_points, n_comp)."""
+        return self.data[name]
+
+    def point(self, name, point_name):
+        """Values of given field in one observe point, array of shape (n_times, n_comp)."""
+        return self.data[name][:, self.point_names.index(point_name), :]
@@ -23,6 +23,7 @@
 #include "reaction/reaction_term.hh"
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
 
 #include "la/distribution.hh"
 #include "mesh/mesh.h"
@@ -363,6 +364,40 @@ double **DualPorosity::compute_reaction(FMT_UNUSED double **concentrations, int
 }
 
 
+void DualPorosity::save_state(CheckpointData &data)
+{
+  ReactionTerm::save_state(data);
+  for (unsigned int sbi = 0; sbi < substances_.size(); sbi++)
+    data.save_array("conc_immobile_" + substances_[sbi].name(), conc_immobile[sbi], distribution_->lsize());
+
+  if (reaction_mobile) {
+    CheckpointData::Scope scope(data, "mobile");
+    reaction_mobile->save_state(data);
+  }
+  if (reaction_immobile) {
+    CheckpointData::Scope scope(data, "immobile");
+    reaction_immobile->save_state(data);
+  }
+}
+
+
+void DualPorosity::restore_state(CheckpointData &data)
+{
+  ReactionTerm::restore_state(data);
+  for (unsigned int sbi = 0; sbi < substances_.size(); sbi++)
+    data.load_array("conc_immobile_" + substances_[sbi].name(), conc_immobile[sbi], distribution_->lsize());
+
+  if (reaction_mobile) {
+    CheckpointData::Scope scope(data, "mobile");
+    reaction_mobile->restore_state(data);
+  }
+  if (reaction_immobile) {
+    CheckpointData::Scope scope(data, "immobile");
+    reaction_immobile->restore_state(data);
+  }
+}
+
+
 void DualPorosity::output_data(void )
 {
     data_.output_fields.set_time(time_->step(), LimitSide::right);
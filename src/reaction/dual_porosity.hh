@@ -104,6 +104,9 @@ public:
   
   /// Main output routine.
   void output_data(void) override;
+
+  void save_state(CheckpointData &data) override;
+  void restore_state(CheckpointData &data) override;
   
   bool evaluate_time_constraint(double &time_constraint) override;
   
@@ -26,6 +26,7 @@
 
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
 
 #include "la/distribution.hh"
 #include "mesh/mesh.h"
@@ -604,6 +605,40 @@ double **SorptionBase::compute_reaction(double **concentrations, int loc_el)
 
 /**************************************** OUTPUT ***************************************************/
 
+void SorptionBase::save_state(CheckpointData &data)
+{
+  ReactionTerm::save_state(data);
+  for (unsigned int sbi = 0; sbi < substances_.size(); sbi++)
+    data.save_array("conc_solid_" + substances_[sbi].name(), conc_solid[sbi], distribution_->lsize());
+
+  if (reaction_liquid) {
+    CheckpointData::Scope scope(data, "liquid");
+    reaction_liquid->save_state(data);
+  }
+  if (reaction_solid) {
+    CheckpointData::Scope scope(data, "solid");
+    reaction_solid->save_state(data);
+  }
+}
+
+
+void SorptionBase::restore_state(CheckpointData &data)
+{
+  ReactionTerm::restore_state(data);
+  for (unsigned int sbi = 0; sbi < substances_.size(); sbi++)
+    data.load_array("conc_solid_" + substances_[sbi].name(), conc_solid[sbi], distribution_->lsize());
+
+  if (reaction_liquid) {
+    CheckpointData::Scope scope(data, "liquid");
+    reaction_liquid->restore_state(data);
+  }
+  if (reaction_solid) {
+    CheckpointData::Scope scope(data, "solid");
+    reaction_solid->restore_state(data);
+  }
+}
+
+
 void SorptionBase::output_data(void )
 {
     data_->output_fields.set_time(time().step(), LimitSide::right);
@@ -133,6 +133,9 @@ public:
   void update_solution(void) override;
   
   void output_data(void) override;
+
+  void save_state(CheckpointData &data) override;
+  void restore_state(CheckpointData &data) override;
   
   bool evaluate_time_constraint(FMT_UNUSED double &time_constraint) override { return false; }
   
@@ -0,0 +1,138 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint_data.cc
+ * @brief   Named binary records of the simulation state written to checkpoint files.
+ */
+
+#include <cstdint>
+#include <fstream>
+
+#include "system/checkpoint_data.hh"
+#include "system/asserts.hh"
+
+
+namespace {
+	/// Identification of checkpoint file.
+	const std::string checkpoint_magic = "FLOW123D_CHECKPOINT\n";
+	/// Version of the file format.
+	const std::uint32_t checkpoint_version = 1;
+
+	void write_string(std::ofstream &out, const std::string &str) {
+		std::uint64_t len = str.size();
+		out.write( (const char *)&len, sizeof(len) );
+		out.write( str.data(), len );
+	}
+
+	bool read_string(std::ifstream &in, std::string &str) {
+		std::uint64_t len;
+		if (! in.read( (char *)&len, sizeof(len) )) return false;
+		str.resize(len);
+		if (len > 0 && ! in.read( &str[0], len )) return false;
+		return true;
+	}
+}
+
+
+CheckpointData::CheckpointData()
+: scopes_(1, "")
+{}
+
+
+void CheckpointData::push_scope(const std::string &name)
+{
+	scopes_.push_back( scopes_.back() + name + "/" );
+}
+
+
+void CheckpointData::pop_scope()
+{
+	ASSERT_GT(scopes_.size(), 1).error("No scope to close.");
+	scopes_.pop_back();
+}
+
+
+bool CheckpointData::contains(const std::string &name) const
+{
+	return records_.find( full_name(name) ) != records_.end();
+}
+
+
+std::string CheckpointData::full_name(const std::string &name) const
+{
+	return scopes_.back() + name;
+}
+
+
+const std::string &CheckpointData::record(const std::string &name) const
+{
+	auto it = records_.find( full_name(name) );
+	if (it == records_.end()) THROW( ExcMissingRecord() << EI_Record(full_name(name)) );
+	return it->second;
+}
+
+
+void CheckpointData::save_bytes(const std::string &name, const void *data, std::size_t n_bytes)
+{
+	records_[ full_name(name) ].assign( (const char *)data, n_bytes );
+}
+
+
+void CheckpointData::load_bytes(const std::string &name, void *data, std::size_t n_bytes) const
+{
+	const std::string &rec = record(name);
+	if (rec.size() != n_bytes)
+		THROW( ExcRecordSize() << EI_Record(full_name(name)) << EI_Size(rec.size()) << EI_Expected(n_bytes) );
+	if (n_bytes > 0) memcpy(data, rec.data(), n_bytes);
+}
+
+
+void CheckpointData::write(const std::string &file_name) const
+{
+	std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+	if (! out.is_open()) THROW( ExcCheckpointFile() << EI_FileName(file_name) );
+
+	out.write( checkpoint_magic.data(), checkpoint_magic.size() );
+	out.write( (const char *)&checkpoint_version, sizeof(checkpoint_version) );
+	std::uint64_t n_rec = records_.size();
+	out.write( (const char *)&n_rec, sizeof(n_rec) );
+	for (auto &rec : records_) {
+		write_string(out, rec.first);
+		write_string(out, rec.second);
+	}
+	out.close();
+	if (out.fail()) THROW( ExcCheckpointFile() << EI_FileName(file_name) );
+}
+
+
+void CheckpointData::read(const std::string &file_name)
+{
+	std::ifstream in(file_name, std::ios::binary);
+	if (! in.is_open()) THROW( ExcCheckpointFile() << EI_FileName(file_name) );
+
+	std::string magic(checkpoint_magic.size(), ' ');
+	std::uint32_t version;
+	std::uint64_t n_rec;
+	if ( ! in.read( &magic[0], magic.size() ) || magic != checkpoint_magic
+			|| ! in.read( (char *)&version, sizeof(version) ) || version != checkpoint_version
+			|| ! in.read( (char *)&n_rec, sizeof(n_rec) ) )
+		THROW( ExcCheckpointFormat() << EI_FileName(file_name) );
+
+	records_.clear();
+	std::string name, data;
+	for (std::uint64_t i=0; i<n_rec; ++i) {
+		if ( !read_string(in, name) || !read_string(in, data) )
+			THROW( ExcCheckpointFormat() << EI_FileName(file_name) );
+		records_[name] = data;
+	}
+}
@@ -0,0 +1,177 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint_data.hh
+ * @brief   Named binary records of the simulation state written to checkpoint files.
+ */
+
+#ifndef CHECKPOINT_DATA_HH_
+#define CHECKPOINT_DATA_HH_
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "system/exceptions.hh"
+
+
+/**
+ * @brief Container of the simulation state of one process.
+ *
+ * State is stored as named records of raw bytes. Names are prefixed by the actual scope,
+ * so every equation saves its data under its own prefix (see Scope) and records of sub-objects
+ * (time governor, balance, ...) don't collide. Data are saved in native binary format, checkpoint
+ * is expected to be read by the same build on the same machine type.
+ *
+ * Size of every loaded record must match the size of target data. Local sizes depend on
+ * the partitioning, so a different partitioning (or problem setup) is reported by ExcRecordSize.
+ */
+class CheckpointData {
+public:
+	TYPEDEF_ERR_INFO(EI_Record, std::string);
+	TYPEDEF_ERR_INFO(EI_FileName, std::string);
+	TYPEDEF_ERR_INFO(EI_Size, std::size_t);
+	TYPEDEF_ERR_INFO(EI_Expected, std::size_t);
+	DECLARE_EXCEPTION(ExcMissingRecord,
+			<< "Record " << EI_Record::qval << " is missing in the checkpoint.\n"
+			<< "Restart requires the same problem setup as the checkpointed simulation.\n");
+	DECLARE_EXCEPTION(ExcRecordSize,
+			<< "Size of record " << EI_Record::qval << " in the checkpoint is " << EI_Size::val
+			<< " bytes, expected " << EI_Expected::val << " bytes.\n"
+			<< "Restart requires the same problem setup and the same partitioning (number of processes) "
+			<< "as the checkpointed simulation.\n");
+	DECLARE_EXCEPTION(ExcCheckpointFile,
+			<< "Can not open or write the checkpoint file " << EI_FileName::qval << ".\n");
+	DECLARE_EXCEPTION(ExcCheckpointFormat,
+			<< "File " << EI_FileName::qval << " is not a valid checkpoint file.\n");
+
+	/**
+	 * Scope of record names, active for its life time.
+	 *
+	 * @code
+	 *   CheckpointData::Scope scope(data, "flow");
+	 *   data.save("solution", vec);    // record "flow/solution"
+	 * @endcode
+	 */
+	class Scope {
+	public:
+		Scope(CheckpointData &data, const std::string &name)
+		: data_(data) {
+			data_.push_scope(name);
+		}
+		~Scope() {
+			data_.pop_scope();
+		}
+	private:
+		CheckpointData &data_;
+	};
+
+	/// Constructor.
+	CheckpointData();
+
+	/// Open new scope of record names.
+	void push_scope(const std::string &name);
+
+	/// Close last opened scope.
+	void pop_scope();
+
+	/// Return true if record of given name (in actual scope) exists.
+	bool contains(const std::string &name) const;
+
+	/// Save value of trivially copyable type.
+	template <class T>
+	void save(const std::string &name, const T &value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be saved.");
+		save_bytes(name, &value, sizeof(T));
+	}
+
+	/// Load value of trivially copyable type.
+	template <class T>
+	void load(const std::string &name, T &value) const {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be loaded.");
+		load_bytes(name, &value, sizeof(T));
+	}
+
+	/// Save vector of trivially copyable type.
+	template <class T>
+	void save(const std::string &name, const std::vector<T> &vec) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be saved.");
+		save_bytes(name, vec.data(), vec.size() * sizeof(T));
+	}
+
+	/// Load vector of trivially copyable type, vector is resized to the size of the record.
+	template <class T>
+	void load(const std::string &name, std::vector<T> &vec) const {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be loaded.");
+		const std::string &rec = record(name);
+		if (rec.size() % sizeof(T) != 0)
+			THROW( ExcRecordSize() << EI_Record(full_name(name)) << EI_Size(rec.size())
+					<< EI_Expected( (rec.size() / sizeof(T) + 1) * sizeof(T) ) );
+		vec.resize(rec.size() / sizeof(T));
+		if (rec.size() > 0) memcpy(vec.data(), rec.data(), rec.size());
+	}
+
+	/// Save string.
+	void save(const std::string &name, const std::string &str) {
+		save_bytes(name, str.data(), str.size());
+	}
+
+	/// Load string.
+	void load(const std::string &name, std::string &str) const {
+		str = record(name);
+	}
+
+	/// Save array of @p n doubles (e.g. local part of PETSc vector).
+	void save_array(const std::string &name, const double *array, std::size_t n) {
+		save_bytes(name, array, n * sizeof(double));
+	}
+
+	/// Load array of @p n doubles, size of the record must be the same.
+	void load_array(const std::string &name, double *array, std::size_t n) const {
+		load_bytes(name, array, n * sizeof(double));
+	}
+
+	/// Number of records.
+	inline unsigned int n_records() const {
+		return records_.size();
+	}
+
+	/// Write all records to binary file.
+	void write(const std::string &file_name) const;
+
+	/// Replace all records by records of given file.
+	void read(const std::string &file_name);
+
+private:
+	/// Name of record in actual scope.
+	std::string full_name(const std::string &name) const;
+
+	/// Return data of the record, throws ExcMissingRecord.
+	const std::string &record(const std::string &name) const;
+
+	/// Store @p n_bytes of @p data.
+	void save_bytes(const std::string &name, const void *data, std::size_t n_bytes);
+
+	/// Copy @p n_bytes of the record to @p data, throws ExcRecordSize if sizes doesn't match.
+	void load_bytes(const std::string &name, void *data, std::size_t n_bytes) const;
+
+	/// Records of raw data.
+	std::map<std::string, std::string> records_;
+
+	/// Stack of scopes, the last item is the full prefix of the actual scope.
+	std::vector<std::string> scopes_;
+};
+
+
+#endif /* CHECKPOINT_DATA_HH_ */
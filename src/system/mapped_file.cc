@@ -0,0 +1,115 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    mapped_file.cc
+ * @brief   Read only memory mapped file and fast parser of its content.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "system/mapped_file.hh"
+
+
+MappedFile::MappedFile(const std::string &file_name)
+: file_name_(file_name), data_(nullptr), size_(0)
+{
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) THROW( ExcMapFile() << EI_FileName(file_name) );
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) < 0) {
+		close(fd);
+		THROW( ExcMapFile() << EI_FileName(file_name) );
+	}
+	size_ = file_stat.st_size;
+
+	if (size_ > 0) {
+		void *ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr == MAP_FAILED) {
+			close(fd);
+			THROW( ExcMapFile() << EI_FileName(file_name) );
+		}
+		data_ = static_cast<const char *>(ptr);
+	}
+	close(fd); // mapping is kept after closing of the descriptor
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (data_ != nullptr) munmap( const_cast<char *>(data_), size_ );
+}
+
+
+const char *MappedFile::find_line(const char *from, const std::string &pattern) const
+{
+	// pattern at the start of the range
+	bool line_start = (from == begin()) || (*(from-1) == '\n');
+	if ( line_start && (std::size_t)(end() - from) >= pattern.size() && std::equal(pattern.begin(), pattern.end(), from) )
+		return from;
+
+	std::string line_pattern = "\n" + pattern;
+	const char *found = std::search(from, end(), line_pattern.begin(), line_pattern.end());
+	return (found == end()) ? end() : found + 1;
+}
+
+
+unsigned int MappedFile::line_number(const char *pos) const
+{
+	return std::count(begin(), std::min(pos, end()), '\n') + 1;
+}
+
+
+
+double BufferCursor::read_double()
+{
+	skip_ws();
+	// copy token to terminated buffer, mapped data need not to be terminated
+	char buf[64];
+	unsigned int len = 0;
+	while (pos_ < end_ && len < sizeof(buf)-1) {
+		char c = *pos_;
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') break;
+		buf[len++] = c;
+		++pos_;
+	}
+	buf[len] = 0;
+
+	char *num_end;
+	double val = strtod(buf, &num_end);
+	if (len == 0 || num_end != buf + len) throw ExcParse();
+	return val;
+}
+
+
+std::string BufferCursor::read_string()
+{
+	skip_ws();
+	if (pos_ >= end_) throw ExcParse();
+	const char *start;
+	if (*pos_ == '"') {
+		start = ++pos_;
+		while (pos_ < end_ && *pos_ != '"' && *pos_ != '\n') ++pos_;
+		if (pos_ >= end_ || *pos_ != '"') throw ExcParse();
+		return std::string(start, pos_++);
+	}
+
+	start = pos_;
+	while (pos_ < end_ && *pos_ != ' ' && *pos_ != '\t' && *pos_ != '\n' && *pos_ != '\r') ++pos_;
+	return std::string(start, pos_);
+}
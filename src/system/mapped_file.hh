@@ -0,0 +1,217 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    mapped_file.hh
+ * @brief   Read only memory mapped file and fast parser of its content.
+ */
+
+#ifndef MAPPED_FILE_HH_
+#define MAPPED_FILE_HH_
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include "system/exceptions.hh"
+
+
+/**
+ * @brief Read only file mapped to memory.
+ *
+ * Whole file is mapped at once, the operating system loads only pages that are really accessed.
+ * That allows to skip large data sections (e.g. data of unused time frames) without reading them.
+ */
+class MappedFile {
+public:
+	TYPEDEF_ERR_INFO(EI_FileName, std::string);
+	DECLARE_EXCEPTION(ExcMapFile,
+			<< "Can not map the file " << EI_FileName::qval << " to memory.\n");
+
+	/// Map file of given name.
+	MappedFile(const std::string &file_name);
+
+	/// Unmap file.
+	~MappedFile();
+
+	/// Begin of the file data.
+	inline const char *begin() const {
+		return data_;
+	}
+
+	/// End of the file data.
+	inline const char *end() const {
+		return data_ + size_;
+	}
+
+	/// Size of the file in bytes.
+	inline std::size_t size() const {
+		return size_;
+	}
+
+	/// Name of the file.
+	inline const std::string &file_name() const {
+		return file_name_;
+	}
+
+	/**
+	 * Find first line starting with @p pattern in range [from, end()).
+	 * Returns pointer to the start of the line or end() if pattern is not found.
+	 */
+	const char *find_line(const char *from, const std::string &pattern) const;
+
+	/// Return line number (starting from 1) of the given position, used only for error messages.
+	unsigned int line_number(const char *pos) const;
+
+private:
+	/// Forbidden copy.
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	std::string file_name_;
+	const char *data_;
+	std::size_t size_;
+};
+
+
+/**
+ * @brief Cursor for parsing of data mapped to memory.
+ *
+ * Numbers are parsed directly from the buffer without creating of tokens. The cursor supports
+ * ASCII data separated by white spaces (including lines comments starting by '#') and binary data
+ * in native byte order. Methods @p int_value, @p size_value and @p double_value read the value
+ * in format given by @p set_binary.
+ *
+ * All methods throw ExcParse if the data have wrong format or the end of the data is reached.
+ */
+class BufferCursor {
+public:
+	/// Exception thrown on parse error, catched and reported by the user of cursor with own message.
+	class ExcParse : public std::exception {
+	public:
+		const char *what() const noexcept override {
+			return "Parse error.";
+		}
+	};
+
+	/// Constructor.
+	BufferCursor(const char *begin, const char *end)
+	: pos_(begin), end_(end), binary_(false), size_t_bytes_(8) {}
+
+	/// Set binary (or ASCII) format of values and size of binary 'size_t' values.
+	inline void set_binary(bool binary, unsigned int size_t_bytes = 8) {
+		binary_ = binary;
+		size_t_bytes_ = size_t_bytes;
+	}
+
+	/// Actual position.
+	inline const char *pos() const {
+		return pos_;
+	}
+
+	/// Set actual position.
+	inline void set_pos(const char *pos) {
+		pos_ = pos;
+	}
+
+	/// Check end of data.
+	inline bool eof() const {
+		return pos_ >= end_;
+	}
+
+	/// Skip white spaces and comments.
+	inline void skip_ws() {
+		while (pos_ < end_) {
+			char c = *pos_;
+			if (c == ' ' || c == '\t' || c == '\n' || c == '\r') ++pos_;
+			else if (c == '#') next_line();
+			else break;
+		}
+	}
+
+	/// Move to start of the next line.
+	inline void next_line() {
+		const char *eol = static_cast<const char *>( memchr(pos_, '\n', end_ - pos_) );
+		pos_ = (eol == nullptr) ? end_ : eol + 1;
+	}
+
+	/// Read ASCII unsigned integer.
+	inline std::uint64_t read_uint() {
+		skip_ws();
+		const char *start = pos_;
+		std::uint64_t val = 0;
+		while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+			val = 10 * val + (*pos_ - '0');
+			++pos_;
+		}
+		if (pos_ == start) throw ExcParse();
+		return val;
+	}
+
+	/// Read ASCII signed integer.
+	inline std::int64_t read_int() {
+		skip_ws();
+		bool negative = false;
+		if (pos_ < end_ && (*pos_ == '-' || *pos_ == '+')) {
+			negative = (*pos_ == '-');
+			++pos_;
+		}
+		std::int64_t val = read_uint();
+		return negative ? -val : val;
+	}
+
+	/// Read ASCII floating point number.
+	double read_double();
+
+	/// Read ASCII string, possibly quoted by '"' (quotes are removed).
+	std::string read_string();
+
+	/// Read binary value of type T.
+	template<class T>
+	inline T read_binary() {
+		if (pos_ + sizeof(T) > end_) throw ExcParse();
+		T val;
+		memcpy(&val, pos_, sizeof(T));
+		pos_ += sizeof(T);
+		return val;
+	}
+
+	/// Read 'int' value (4 bytes in binary format).
+	inline int int_value() {
+		return binary_ ? read_binary<std::int32_t>() : read_int();
+	}
+
+	/// Read 'size_t' value (@p size_t_bytes_ in binary format).
+	inline std::uint64_t size_value() {
+		if (!binary_) return read_uint();
+		return (size_t_bytes_ == 8) ? read_binary<std::uint64_t>() : read_binary<std::uint32_t>();
+	}
+
+	/// Read 'double' value (8 bytes in binary format).
+	inline double double_value() {
+		return binary_ ? read_binary<double>() : read_double();
+	}
+
+	/// Skip @p n_bytes of binary data.
+	inline void skip_bytes(std::size_t n_bytes) {
+		if (pos_ + n_bytes > end_) throw ExcParse();
+		pos_ += n_bytes;
+	}
+
+private:
+	const char *pos_;
+	const char *end_;
+	bool binary_;
+	unsigned int size_t_bytes_;
+};
+
+
+#endif /* MAPPED_FILE_HH_ */
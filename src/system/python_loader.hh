@@ -136,6 +136,33 @@ public:
 
 
 
+/**
+ * Owner of a new reference to a Python object, the reference is released by the destructor,
+ * so that no reference leaks when an exception (e.g. from PythonLoader::check_error) is thrown.
+ */
+class PyObjectRef {
+public:
+    /// Take over the new reference @p obj, may be NULL.
+    explicit PyObjectRef(PyObject *obj = NULL)
+    : obj_(obj)
+    {}
+
+    PyObjectRef(const PyObjectRef &) = delete;
+    PyObjectRef & operator =(const PyObjectRef &) = delete;
+
+    ~PyObjectRef()
+    { Py_XDECREF(obj_); }
+
+    /// Return the borrowed pointer.
+    inline PyObject * get() const
+    { return obj_; }
+
+private:
+    PyObject *obj_;
+};
+
+
+
 #endif // FLOW123D_HAVE_PYTHON
 
 #endif /* PYTHON_UTILS_HH_ */
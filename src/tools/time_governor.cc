@@ -22,6 +22,7 @@
 #include "time_governor.hh"
 #include "time_marks.hh"
 #include "unit_si.hh"
+#include "system/checkpoint_data.hh"
 
 /*******************************************************************
  * implementation of TimeGovernor static values and methods
@@ -760,6 +761,75 @@ void TimeGovernor::view(const char *name) const
 
 
 
+void TimeGovernor::save_state(CheckpointData &data) const
+{
+    CheckpointData::Scope scope(data, "time");
+    // recent steps from the actual one to the oldest
+    std::vector<unsigned int> step_index;
+    std::vector<double> step_length, step_end;
+    for (const TimeStep &ts : recent_steps_) {
+        step_index.push_back(ts.index_);
+        step_length.push_back(ts.length_);
+        step_end.push_back(ts.end_);
+    }
+    data.save("step_index", step_index);
+    data.save("step_length", step_length);
+    data.save("step_end", step_end);
+
+    data.save("end_of_fixed_dt_interval", end_of_fixed_dt_interval_);
+    data.save("fixed_time_step", fixed_time_step_);
+    data.save("is_time_step_fixed", is_time_step_fixed_);
+    data.save("time_step_changed", time_step_changed_);
+    data.save("upper_constraint", upper_constraint_);
+    data.save("lower_constraint", lower_constraint_);
+    data.save("last_upper_constraint", last_upper_constraint_);
+    data.save("last_lower_constraint", last_lower_constraint_);
+    data.save("max_time_step", max_time_step_);
+    data.save("min_time_step", min_time_step_);
+    data.save("dt_limits_pos", dt_limits_pos_);
+    data.save("last_printed_timestep", last_printed_timestep_);
+}
+
+
+void TimeGovernor::restore_state(CheckpointData &data)
+{
+    CheckpointData::Scope scope(data, "time");
+    std::vector<unsigned int> step_index;
+    std::vector<double> step_length, step_end;
+    data.load("step_index", step_index);
+    data.load("step_length", step_length);
+    data.load("step_end", step_end);
+    ASSERT_GT(step_index.size(), 0).error("Empty list of time steps in the checkpoint.\n");
+    ASSERT( step_index.size() == step_length.size() && step_index.size() == step_end.size() ).error();
+    ASSERT_LE(step_index.size(), size_of_recent_steps_).error();
+
+    recent_steps_.clear();
+    for (unsigned int i=0; i<step_index.size(); ++i) {
+        TimeStep ts(step_end[i], time_unit_conversion_);
+        ts.index_ = step_index[i];
+        ts.length_ = step_length[i];
+        recent_steps_.push_back(ts);
+    }
+
+    data.load("end_of_fixed_dt_interval", end_of_fixed_dt_interval_);
+    data.load("fixed_time_step", fixed_time_step_);
+    data.load("is_time_step_fixed", is_time_step_fixed_);
+    data.load("time_step_changed", time_step_changed_);
+    data.load("upper_constraint", upper_constraint_);
+    data.load("lower_constraint", lower_constraint_);
+    data.load("last_upper_constraint", last_upper_constraint_);
+    data.load("last_lower_constraint", last_lower_constraint_);
+    data.load("max_time_step", max_time_step_);
+    data.load("min_time_step", min_time_step_);
+    data.load("dt_limits_pos", dt_limits_pos_);
+    data.load("last_printed_timestep", last_printed_timestep_);
+    ASSERT_LT(dt_limits_pos_, dt_limits_table_.size()).error("Different DT limits in the checkpoint.\n");
+    upper_constraint_message_ = "Restored from checkpoint.";
+    lower_constraint_message_ = "Restored from checkpoint.";
+}
+
+
+
 double TimeGovernor::read_time(Input::Iterator<Input::Tuple> time_it, double default_time) const {
 	return time_unit_conversion_->read_time(time_it, default_time);
 }
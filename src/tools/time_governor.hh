@@ -37,6 +37,8 @@
 #include "system/exceptions.hh"
 #include "tools/time_marks.hh"
 
+class CheckpointData;
+
 namespace Input {
     class Record;
     class Tuple;
@@ -226,6 +228,9 @@ private:
     double end_;
     /// Conversion unit of all time values within the equation.
     std::shared_ptr<TimeUnitConversion> time_unit_conversion_;
+
+    /// Time governor restores time steps from checkpoint.
+    friend class TimeGovernor;
 };
 
 std::ostream& operator<<(std::ostream& out, const TimeStep& t_step);
@@ -614,6 +619,18 @@ public:
      */
 	std::string get_unit_string() const;
 
+    /**
+     * Save actual time, recent time steps and time step constraints to the checkpoint.
+     * Time marks are common for all equations and are saved separately (see TimeMarks::save_state).
+     */
+    void save_state(CheckpointData &data) const;
+
+    /**
+     * Restore state saved by @p save_state. Time governor has to be created from the same input
+     * as the saved one, the permanent settings (end time, DT limits table) are not restored.
+     */
+    void restore_state(CheckpointData &data);
+
 	// Maximal tiem of simulation. More then age of the universe in seconds.
     static const double max_end_time;
 
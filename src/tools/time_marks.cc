@@ -22,6 +22,7 @@
 #include "system/global_defs.h"
 #include "time_governor.hh"
 #include "time_marks.hh"
+#include "system/checkpoint_data.hh"
 
 // ------------------------------------------------------
 // implementation of members of class TimeMark
@@ -115,6 +116,43 @@ void TimeMarks::add_time_marks(double time, double dt, double end_time, TimeMark
 }
 
 
+void TimeMarks::save_state(CheckpointData &data) const
+{
+    CheckpointData::Scope scope(data, "time_marks");
+    data.save("n_mark_types", (unsigned int)marks_.size());
+    for (unsigned int i_eq=0; i_eq<marks_.size(); ++i_eq) {
+        std::vector<double> times;
+        std::vector<unsigned long int> bitmaps;
+        // skip start and end stoppers
+        for (unsigned int i=1; i+1<marks_[i_eq].size(); ++i) {
+            times.push_back( marks_[i_eq][i].time() );
+            bitmaps.push_back( marks_[i_eq][i].mark_type().bitmap_ );
+        }
+        data.save("times_" + std::to_string(i_eq), times);
+        data.save("types_" + std::to_string(i_eq), bitmaps);
+    }
+}
+
+
+void TimeMarks::restore_state(CheckpointData &data)
+{
+    CheckpointData::Scope scope(data, "time_marks");
+    unsigned int n_mark_types;
+    data.load("n_mark_types", n_mark_types);
+    ASSERT_EQ(n_mark_types, marks_.size()).error("Different number of equations in the checkpoint.\n");
+
+    for (unsigned int i_eq=0; i_eq<marks_.size(); ++i_eq) {
+        std::vector<double> times;
+        std::vector<unsigned long int> bitmaps;
+        data.load("times_" + std::to_string(i_eq), times);
+        data.load("types_" + std::to_string(i_eq), bitmaps);
+        ASSERT_EQ(times.size(), bitmaps.size()).error();
+        for (unsigned int i=0; i<times.size(); ++i)
+            add( TimeMark(times[i], TimeMark::Type(bitmaps[i], i_eq)) );
+    }
+}
+
+
 void  TimeMarks::add_to_type_all(TimeMark::Type filter_type, TimeMark::Type add_type) {
     ASSERT(filter_type.equation_index_ != 0).error();
     ASSERT( (filter_type.equation_index_ == add_type.equation_index_) || (add_type.equation_index_ == 0) )
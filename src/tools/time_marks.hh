@@ -171,6 +171,7 @@ std::ostream& operator<<(std::ostream& stream, const TimeMark &marks);
 class TimeStep;
 class TimeGovernor;
 class TimeMarksIterator;
+class CheckpointData;
 
 /**
  * @brief This class is a collection of time marks to manage various events occurring during simulation time.
@@ -322,6 +323,17 @@ public:
     /// Friend output operator.
     friend std::ostream& operator<<(std::ostream& stream, const TimeMarks &marks);
 
+    /**
+     * Save all marks (without stoppers) to the checkpoint.
+     */
+    void save_state(CheckpointData &data) const;
+
+    /**
+     * Add marks saved by @p save_state. Mark types have to be already created in the same order
+     * as in the checkpointed simulation, marks created during the setup are merged with the saved ones.
+     */
+    void restore_state(CheckpointData &data);
+
 private:
 
     /// MarkType that will be used at next new_time_mark() call.
@@ -19,6 +19,7 @@
 #define ASSEMBLY_DG_HH_
 
 #include "transport/transport_dg.hh"
+#include "transport/assembly_dg_kernels.hh"
 #include "fem/mapping_p1.hh"
 #include "fem/fe_p.hh"
 #include "fem/fe_rt.hh"
@@ -448,15 +449,19 @@ public:
 
         for (unsigned int sbi=0; sbi<model_->n_substances(); ++sbi)
         {
-            // assemble the local mass matrix
-            for (unsigned int i=0; i<ndofs_; i++)
+            // assemble the local mass matrix, substances sharing the operator use matrix of the group owner
+            if (data_->assemble_matrix(sbi))
             {
-                for (unsigned int j=0; j<ndofs_; j++)
+                for (unsigned int i=0; i<ndofs_; i++)
                 {
-                    local_matrix_[i*ndofs_+j] = 0;
-                    for (unsigned int k=0; k<qsize_; k++)
-                        local_matrix_[i*ndofs_+j] += (mm_coef_[k]+ret_coef_[sbi][k])*fe_values_.shape_value(j,k)*fe_values_.shape_value(i,k)*fe_values_.JxW(k);
+                    for (unsigned int j=0; j<ndofs_; j++)
+                    {
+                        local_matrix_[i*ndofs_+j] = 0;
+                        for (unsigned int k=0; k<qsize_; k++)
+                            local_matrix_[i*ndofs_+j] += (mm_coef_[k]+ret_coef_[sbi][k])*fe_values_.shape_value(j,k)*fe_values_.shape_value(i,k)*fe_values_.JxW(k);
+                    }
                 }
+                data_->ls_dt[sbi]->mat_set_values(ndofs_, &(dof_indices_[0]), ndofs_, &(dof_indices_[0]), &(local_matrix_[0]));
             }
 
             for (unsigned int i=0; i<ndofs_; i++)
@@ -473,7 +478,6 @@ public:
             model_->balance()->add_mass_values(model_->get_subst_idx()[sbi], cell, cell.get_loc_dof_indices(),
                                                local_mass_balance_vector_, 0);
 
-            data_->ls_dt[sbi]->mat_set_values(ndofs_, &(dof_indices_[0]), ndofs_, &(dof_indices_[0]), &(local_matrix_[0]));
             VecSetValues(data_->ret_vec[sbi], ndofs_, &(dof_indices_[0]), &(local_retardation_balance_vector_[0]), ADD_VALUES);
         }
     }
@@ -595,6 +599,11 @@ public:
             ret_coef_[sbi].resize(qsize_);
         }
 
+        // gradients of P0 and P1 functions are constant on simplices
+        const_grads_ = (data_->dg_order <= 1);
+        side_tables_.resize(data_->ad_coef_edg.size());
+        side_W_.resize(2);
+
         fe_values_vec_.resize(data_->ad_coef_edg.size());
         for (unsigned int sid=0; sid<data_->ad_coef_edg.size(); sid++)
         {
@@ -626,27 +635,14 @@ public:
         calculate_velocity(elm, velocity_, fv_rt_.point_list());
         model_->compute_advection_diffusion_coefficients(fe_values_.point_list(), velocity_, elm, data_->ad_coef, data_->dif_coef);
         model_->compute_sources_sigma(fe_values_.point_list(), elm, sources_sigma_);
+        tables_.fill(fe_values_, const_grads_);
 
         // assemble the local stiffness matrix
         for (unsigned int sbi=0; sbi<model_->n_substances(); sbi++)
         {
-            for (unsigned int i=0; i<ndofs_; i++)
-                for (unsigned int j=0; j<ndofs_; j++)
-                    local_matrix_[i*ndofs_+j] = 0;
-
-            for (unsigned int k=0; k<qsize_; k++)
-            {
-                for (unsigned int i=0; i<ndofs_; i++)
-                {
-                    arma::vec3 Kt_grad_i = data_->dif_coef[sbi][k].t()*fe_values_.shape_grad(i,k);
-                    double ad_dot_grad_i = arma::dot(data_->ad_coef[sbi][k], fe_values_.shape_grad(i,k));
-
-                    for (unsigned int j=0; j<ndofs_; j++)
-                        local_matrix_[i*ndofs_+j] += (arma::dot(Kt_grad_i, fe_values_.shape_grad(j,k))
-                                                  -fe_values_.shape_value(j,k)*ad_dot_grad_i
-                                                  +sources_sigma_[sbi][k]*fe_values_.shape_value(j,k)*fe_values_.shape_value(i,k))*fe_values_.JxW(k);
-                }
-            }
+            if (!data_->assemble_matrix(sbi)) continue;
+            DGKernels::volume_matrix(tables_, data_->dif_coef[sbi], data_->ad_coef[sbi], sources_sigma_[sbi], kernel_matrix_);
+            DGKernels::to_local_matrix(kernel_matrix_, local_matrix_);
             data_->ls[sbi]->mat_set_values(ndofs_, &(dof_indices_[0]), ndofs_, &(dof_indices_[0]), &(local_matrix_[0]));
         }
     }
@@ -674,6 +670,7 @@ public:
 
         for (unsigned int sbi=0; sbi<model_->n_substances(); sbi++)
         {
+            if (!data_->assemble_matrix(sbi)) continue;
             std::fill(local_matrix_.begin(), local_matrix_.end(), 0);
 
             // On Neumann boundaries we have only term from integrating by parts the advective term,
@@ -744,6 +741,7 @@ public:
             ElementAccessor<3> edg_elm = dh_edge_cell.elm();
             dh_edge_cell.get_dof_indices(side_dof_indices_[sid]);
             fe_values_vec_[sid].reinit(edge_side.side());
+            side_tables_[sid].fill(fe_values_vec_[sid], const_grads_);
             fsv_rt_.reinit(edge_side.side());
             calculate_velocity(edg_elm, side_velocity_vec_[sid], fsv_rt_.point_list());
             model_->compute_advection_diffusion_coefficients(fe_values_vec_[sid].point_list(), side_velocity_vec_[sid], edg_elm, data_->ad_coef_edg[sid], data_->dif_coef_edg[sid]);
@@ -757,6 +755,7 @@ public:
         // fluxes and penalty
         for (unsigned int sbi=0; sbi<model_->n_substances(); sbi++)
         {
+            if (!data_->assemble_matrix(sbi)) continue;
             vector<double> fluxes(edge_side_range.begin()->n_edge_sides());
             double pflux = 0, nflux = 0; // calculate the total in- and out-flux through the edge
             sid=0;
@@ -826,10 +825,10 @@ public:
                     int sd[2]; bool is_side_own[2];
                     sd[0] = s1; is_side_own[0] = edge_side1.cell().is_own();
                     sd[1] = s2; is_side_own[1] = edge_side2.cell().is_own();
+                    const double sign[2] = { 1, -1 }; // sign of the jump on the sides
 
-#define AVERAGE(i,k,side_id)  (fe_values_vec_[sd[side_id]].shape_value(i,k)*0.5)
-#define WAVERAGE(i,k,side_id) (arma::dot(data_->dif_coef_edg[sd[side_id]][sbi][k]*fe_values_vec_[sd[side_id]].shape_grad(i,k),nv)*omega[side_id])
-#define JUMP(i,k,side_id)     ((side_id==0?1:-1)*fe_values_vec_[sd[side_id]].shape_value(i,k))
+                    for (int n=0; n<2; n++)
+                        DGKernels::normal_derivatives(side_tables_[sd[n]], data_->dif_coef_edg[sd[n]][sbi], nv, omega[n], side_W_[n]);
 
                     // For selected pair of elements:
                     for (int n=0; n<2; n++)
@@ -838,44 +837,12 @@ public:
 
                         for (int m=0; m<2; m++)
                         {
-                            for (unsigned int i=0; i<fe_values_vec_[sd[n]].n_dofs(); i++)
-                                for (unsigned int j=0; j<fe_values_vec_[sd[m]].n_dofs(); j++)
-                                    local_matrix_[i*fe_values_vec_[sd[m]].n_dofs()+j] = 0;
-
-                            for (unsigned int k=0; k<qsize_lower_dim_; k++)
-                            {
-                                double flux_times_JxW = transport_flux*fe_values_vec_[0].JxW(k);
-                                double gamma_times_JxW = gamma_l*fe_values_vec_[0].JxW(k);
-
-                                for (unsigned int i=0; i<fe_values_vec_[sd[n]].n_dofs(); i++)
-                                {
-                                    double flux_JxW_jump_i = flux_times_JxW*JUMP(i,k,n);
-                                    double gamma_JxW_jump_i = gamma_times_JxW*JUMP(i,k,n);
-                                    double JxW_jump_i = fe_values_vec_[0].JxW(k)*JUMP(i,k,n);
-                                    double JxW_var_wavg_i = fe_values_vec_[0].JxW(k)*WAVERAGE(i,k,n)*data_->dg_variant;
-
-                                    for (unsigned int j=0; j<fe_values_vec_[sd[m]].n_dofs(); j++)
-                                    {
-                                        int index = i*fe_values_vec_[sd[m]].n_dofs()+j;
-
-                                        // flux due to transport (applied on interior edges) (average times jump)
-                                        local_matrix_[index] += flux_JxW_jump_i*AVERAGE(j,k,m);
-
-                                        // penalty enforcing continuity across edges (applied on interior and Dirichlet edges) (jump times jump)
-                                        local_matrix_[index] += gamma_JxW_jump_i*JUMP(j,k,m);
-
-                                        // terms due to diffusion
-                                        local_matrix_[index] -= WAVERAGE(j,k,m)*JxW_jump_i;
-                                        local_matrix_[index] -= JUMP(j,k,m)*JxW_var_wavg_i;
-                                    }
-                                }
-                            }
+                            DGKernels::edge_matrix(side_tables_[sd[n]], side_W_[n], sign[n], side_tables_[sd[m]], side_W_[m], sign[m],
+                                    side_tables_[0].JxW, transport_flux, gamma_l, data_->dg_variant, kernel_matrix_);
+                            DGKernels::to_local_matrix(kernel_matrix_, local_matrix_);
                             data_->ls[sbi]->mat_set_values(fe_values_vec_[sd[n]].n_dofs(), &(side_dof_indices_[sd[n]][0]), fe_values_vec_[sd[m]].n_dofs(), &(side_dof_indices_[sd[m]][0]), &(local_matrix_[0]));
                         }
                     }
-#undef AVERAGE
-#undef WAVERAGE
-#undef JUMP
                 }
             s1++;
             }
@@ -923,6 +890,7 @@ public:
 
         for (unsigned int sbi=0; sbi<model_->n_substances(); sbi++) // Optimize: SWAP LOOPS
         {
+            if (!data_->assemble_matrix(sbi)) continue;
             for (unsigned int i=0; i<n_dofs[0]+n_dofs[1]; i++)
                 for (unsigned int j=0; j<n_dofs[0]+n_dofs[1]; j++)
                     local_matrix_[i*(n_dofs[0]+n_dofs[1])+j] = 0;
@@ -1018,6 +986,11 @@ private:
     vector<double> csection_;                                 ///< Auxiliary vector for assemble boundary fluxes, element-side fluxes and set boundary conditions
     vector<double> csection_higher_;                          ///< Auxiliary vector for assemble element-side fluxes
     vector<vector<double> > dg_penalty_;                      ///< Auxiliary vectors for assemble element-element fluxes
+    bool const_grads_;                                        ///< Shape gradients are constant on elements (dg_order <= 1).
+    DGKernels::ShapeTables tables_;                           ///< Shape function tables for volume integrals.
+    vector<DGKernels::ShapeTables> side_tables_;              ///< Shape function tables of sides of an edge.
+    vector<arma::mat> side_W_;                                ///< Weighted normal derivatives of the pair of sides of an edge.
+    arma::mat kernel_matrix_;                                 ///< Local matrix computed by DGKernels.
 
 	/// Mass matrix coefficients.
 	vector<double> mm_coef_;
@@ -0,0 +1,213 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    assembly_dg_kernels.hh
+ * @brief   Local matrices of the DG transport as dense contractions of shape function tables.
+ */
+
+#ifndef ASSEMBLY_DG_KERNELS_HH_
+#define ASSEMBLY_DG_KERNELS_HH_
+
+#include <vector>
+#include <armadillo>
+#include "fem/fe_values.hh"
+#include "system/asserts.hh"
+
+
+/**
+ * @brief Kernels computing local matrices of the DG transport.
+ *
+ * Shape values and gradients of an element (or of an element side) are gathered from FEValues
+ * into ShapeTables, local matrices are then formed by small dense matrix products instead of
+ * loops over (dof, dof, point) triples. On simplices the mapping is affine, so gradients of P1
+ * functions are constant on the element and the sums over quadrature points are contracted
+ * before the products with the gradients (e.g. diffusion G * (sum_k w_k K_k) * G^T).
+ *
+ * Methods with suffix @p _generic are the original loops, kept as the reference for tests and benchmarks.
+ * All matrices have rows corresponding to test functions (index i) and columns to trial functions (index j).
+ */
+class DGKernels {
+public:
+    /// Shape function values and gradients at quadrature points of an element or side.
+    struct ShapeTables {
+        /// Values, n_dofs x n_points.
+        arma::mat values;
+        /// Gradients in the real space, for every point n_dofs x 3 (only the first one if @p const_grads).
+        std::vector<arma::mat> grads;
+        /// Jacobian times weight of quadrature points.
+        arma::vec JxW;
+        /// True if gradients are constant on the element (P0 and P1 on simplices).
+        bool const_grads;
+
+        /// Gradients at the @p k-th point.
+        inline const arma::mat &grad(unsigned int k) const
+        { return const_grads ? grads[0] : grads[k]; }
+
+        /// Number of dofs.
+        inline unsigned int n_dofs() const
+        { return values.n_rows; }
+
+        /// Number of quadrature points.
+        inline unsigned int n_points() const
+        { return values.n_cols; }
+
+        /// Gather data of @p fv reinitialized on an element or side.
+        void fill(FEValues<3> &fv, bool constant_gradients)
+        {
+            const_grads = constant_gradients;
+            values.set_size(fv.n_dofs(), fv.n_points());
+            grads.resize(const_grads ? 1 : fv.n_points());
+            for (unsigned int k=0; k<fv.n_points(); k++)
+                for (unsigned int i=0; i<fv.n_dofs(); i++)
+                    values(i,k) = fv.shape_value(i,k);
+            for (unsigned int k=0; k<grads.size(); k++)
+            {
+                grads[k].set_size(fv.n_dofs(), 3);
+                for (unsigned int i=0; i<fv.n_dofs(); i++)
+                    grads[k].row(i) = fv.shape_grad(i,k).t();
+            }
+            JxW.set_size(fv.n_points());
+            for (unsigned int k=0; k<fv.n_points(); k++) JxW(k) = fv.JxW(k);
+        }
+    };
+
+
+    /**
+     * Volume matrix of the advection-diffusion-reaction operator:
+     * A_ij = sum_k ( K_k grad_j . grad_i - (a_k . grad_i) phi_j + sigma_k phi_i phi_j ) JxW_k.
+     */
+    static void volume_matrix(const ShapeTables &t, const std::vector<arma::mat33> &K, const std::vector<arma::vec3> &a,
+            const std::vector<double> &sigma, arma::mat &A)
+    {
+        const unsigned int n_points = t.n_points();
+        arma::vec sigma_JxW(n_points);
+        for (unsigned int k=0; k<n_points; k++) sigma_JxW(k) = sigma[k]*t.JxW(k);
+        arma::mat values_JxW = t.values.each_row() % t.JxW.t();
+
+        // reaction: Phi diag(sigma JxW) Phi^T
+        A = (t.values.each_row() % sigma_JxW.t()) * t.values.t();
+
+        if (t.const_grads)
+        {
+            const arma::mat &G = t.grad(0);
+            arma::mat33 K_sum(arma::fill::zeros);
+            arma::mat a_mat(3, n_points);
+            for (unsigned int k=0; k<n_points; k++)
+            {
+                K_sum += t.JxW(k)*K[k];
+                a_mat.col(k) = a[k];
+            }
+            // diffusion G (sum_k JxW_k K_k) G^T, advection G (sum_k JxW_k a_k phi_k^T)
+            A += G * (K_sum * G.t() - a_mat * values_JxW.t());
+        }
+        else
+        {
+            for (unsigned int k=0; k<n_points; k++)
+            {
+                const arma::mat &G = t.grad(k);
+                A += G * ( t.JxW(k) * K[k] * G.t() - a[k] * values_JxW.col(k).t() );
+            }
+        }
+    }
+
+
+    /// Reference implementation of volume_matrix().
+    static void volume_matrix_generic(const ShapeTables &t, const std::vector<arma::mat33> &K, const std::vector<arma::vec3> &a,
+            const std::vector<double> &sigma, arma::mat &A)
+    {
+        const unsigned int n_dofs = t.n_dofs();
+        A.zeros(n_dofs, n_dofs);
+        for (unsigned int k=0; k<t.n_points(); k++)
+        {
+            const arma::mat &G = t.grad(k);
+            for (unsigned int i=0; i<n_dofs; i++)
+            {
+                arma::vec3 grad_i = G.row(i).t();
+                arma::vec3 Kt_grad_i = K[k].t()*grad_i;
+                double ad_dot_grad_i = arma::dot(a[k], grad_i);
+
+                for (unsigned int j=0; j<n_dofs; j++)
+                    A(i,j) += (arma::dot(Kt_grad_i, G.row(j).t())
+                              -t.values(j,k)*ad_dot_grad_i
+                              +sigma[k]*t.values(j,k)*t.values(i,k))*t.JxW(k);
+            }
+        }
+    }
+
+
+    /**
+     * Weighted normal derivatives on a side: W_ik = omega * (K_k grad_i(x_k)) . @p normal.
+     */
+    static void normal_derivatives(const ShapeTables &t, const std::vector<arma::mat33> &K, const arma::vec3 &normal,
+            double omega, arma::mat &W)
+    {
+        W.set_size(t.n_dofs(), t.n_points());
+        for (unsigned int k=0; k<t.n_points(); k++)
+            W.col(k) = omega * ( t.grad(k) * (K[k].t()*normal) );
+    }
+
+
+    /**
+     * Coupling matrix of the sides @p n (test functions) and @p m (trial functions) of an edge in the SIPG/NIPG scheme:
+     * A_ij = sum_k ( flux * jump_i avg_j + gamma * jump_i jump_j - jump_i W^m_jk - variant * W^n_ik jump_j ) JxW_k,
+     * where jump on side @p s has sign @p sign_s, avg = phi/2 and @p W are normal_derivatives().
+     */
+    static void edge_matrix(const ShapeTables &t_n, const arma::mat &W_n, double sign_n,
+            const ShapeTables &t_m, const arma::mat &W_m, double sign_m,
+            const arma::vec &JxW, double flux, double gamma, double variant, arma::mat &A)
+    {
+        arma::mat values_n_JxW = t_n.values.each_row() % JxW.t();
+        A = (sign_n*(0.5*flux + gamma*sign_m)) * values_n_JxW * t_m.values.t()
+            - sign_n * values_n_JxW * W_m.t()
+            - (variant*sign_m) * (W_n.each_row() % JxW.t()) * t_m.values.t();
+    }
+
+
+    /// Reference implementation of edge_matrix().
+    static void edge_matrix_generic(const ShapeTables &t_n, const arma::mat &W_n, double sign_n,
+            const ShapeTables &t_m, const arma::mat &W_m, double sign_m,
+            const arma::vec &JxW, double flux, double gamma, double variant, arma::mat &A)
+    {
+        A.zeros(t_n.n_dofs(), t_m.n_dofs());
+        for (unsigned int k=0; k<JxW.n_elem; k++)
+        {
+            double flux_times_JxW = flux*JxW(k);
+            double gamma_times_JxW = gamma*JxW(k);
+            for (unsigned int i=0; i<t_n.n_dofs(); i++)
+            {
+                double jump_i = sign_n*t_n.values(i,k);
+                for (unsigned int j=0; j<t_m.n_dofs(); j++)
+                {
+                    double jump_j = sign_m*t_m.values(j,k);
+                    A(i,j) += flux_times_JxW*jump_i*0.5*t_m.values(j,k)
+                            + gamma_times_JxW*jump_i*jump_j
+                            - W_m(j,k)*JxW(k)*jump_i
+                            - jump_j*JxW(k)*W_n(i,k)*variant;
+                }
+            }
+        }
+    }
+
+
+    /// Copy @p A to the row-major array @p local (format of LinSys::mat_set_values).
+    static void to_local_matrix(const arma::mat &A, std::vector<double> &local)
+    {
+        ASSERT_LE_DBG(A.n_elem, local.size());
+        for (unsigned int i=0; i<A.n_rows; i++)
+            for (unsigned int j=0; j<A.n_cols; j++)
+                local[i*A.n_cols+j] = A(i,j);
+    }
+};
+
+
+#endif /* ASSEMBLY_DG_KERNELS_HH_ */
@@ -0,0 +1,119 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    dg_time_integrator.cc
+ * @brief   Implicit time steps of the semi-discrete DG transport equation.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "transport/dg_time_integrator.hh"
+#include "system/system.hh"
+
+
+DGTimeIntegrator::DGTimeIntegrator()
+{}
+
+
+DGTimeIntegrator::~DGTimeIntegrator()
+{
+    for (Vec &v : stage_vec_)
+        chkerr(VecDestroy(&v));
+}
+
+
+void DGTimeIntegrator::bdf_step(double dt, double omega, Vec rhs, Vec mass_vec, Vec mass_vec_prev,
+        const SetMatrix &set_matrix, const Solve &solve)
+{
+    Vec w;
+    chkerr(VecDuplicate(rhs, &w));
+    if (mass_vec_prev != nullptr)
+    {
+        set_matrix((1+2*omega)/(1+omega)/dt);
+        chkerr(VecWAXPY(w, (1+omega)/dt, mass_vec, rhs));
+        chkerr(VecAXPY(w, -omega*omega/(1+omega)/dt, mass_vec_prev));
+    }
+    else
+    {
+        set_matrix(1./dt);
+        chkerr(VecWAXPY(w, 1./dt, mass_vec, rhs));
+    }
+    solve(w);
+    chkerr(VecDestroy(&w));
+}
+
+
+double DGTimeIntegrator::esdirk_step(double dt, Mat stiffness, Vec rhs, Vec mass_vec, Vec solution, double error_tol,
+        const SetMatrix &set_matrix, const Solve &solve)
+{
+    /* TR-BDF2 written as ESDIRK for M u' = F(u) = f - A u:
+     *
+     *   c = (0, g, 1),  A = ( (0, 0, 0), (d, d, 0), (w, w, d) ),  b = (w, w, d),  b_hat = ((1-w)/3, (3w+1)/3, d/3),
+     *   g = 2-sqrt(2), d = g/2, w = (1-d)/2.
+     *
+     * Stages z_2, z_3 (z_1 = u^{k-1}) solve
+     *
+     *   (1/(d dt) M + A) z_s = f + 1/(d dt) M u^{k-1} + sum_{j<s} a_sj/d F_j,
+     *
+     * the method is stiffly accurate, u^k = z_3.
+     */
+    static const double g = 2.0 - std::sqrt(2.0), d = g/2, w = (1.0-d)/2;
+    static const double a[3][2] = { {0, 0}, {d, 0}, {w, w} };
+    static const double b[3] = { w, w, d };
+    static const double b_hat[3] = { (1.0-w)/3, (3*w+1)/3, d/3 };
+
+    if (stage_vec_.size() == 0)
+    {
+        stage_vec_.resize(5);
+        for (Vec &v : stage_vec_) chkerr(VecDuplicate(rhs, &v));
+    }
+    Vec *F = &stage_vec_[0];
+    Vec u_old = stage_vec_[3], y = stage_vec_[4];
+
+    set_matrix(1./(d*dt));
+    chkerr(VecCopy(solution, u_old));
+
+    // F_1 = f - A u^{k-1}
+    chkerr(MatMult(stiffness, solution, F[0]));
+    chkerr(VecAYPX(F[0], -1.0, rhs));
+    for (unsigned int s=1; s<3; s++)
+    {
+        chkerr(VecWAXPY(y, 1./(d*dt), mass_vec, rhs));
+        for (unsigned int j=0; j<s; j++)
+            chkerr(VecAXPY(y, a[s][j]/d, F[j]));
+        solve(y);
+
+        chkerr(MatMult(stiffness, solution, F[s]));
+        chkerr(VecAYPX(F[s], -1.0, rhs));
+    }
+
+    if (error_tol <= 0) return 0;
+
+    /* Error M (u^k - u_hat^k) = dt sum_j (b_j - b_hat_j) F_j is filtered by (1/(d dt) M + A)^{-1} 1/(d dt),
+     * which gives estimate in the units of solution that does not overestimate stiff components.
+     */
+    double old_norm, new_norm, error_norm;
+    chkerr(VecNorm(u_old, NORM_INFINITY, &old_norm));
+    chkerr(VecNorm(solution, NORM_INFINITY, &new_norm));
+    chkerr(VecZeroEntries(y));
+    for (unsigned int j=0; j<3; j++)
+        chkerr(VecAXPY(y, (b[j]-b_hat[j])/d, F[j]));
+    chkerr(VecCopy(solution, u_old));
+    chkerr(VecZeroEntries(solution));
+    solve(y);
+    chkerr(VecNorm(solution, NORM_INFINITY, &error_norm));
+    chkerr(VecCopy(u_old, solution));
+
+    double scale = error_tol * std::max(old_norm, new_norm);
+    return (scale > 0) ? error_norm / scale : 0;
+}
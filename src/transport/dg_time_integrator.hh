@@ -0,0 +1,86 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    dg_time_integrator.hh
+ * @brief   Implicit time steps of the semi-discrete DG transport equation.
+ */
+
+#ifndef DG_TIME_INTEGRATOR_HH_
+#define DG_TIME_INTEGRATOR_HH_
+
+#include <functional>                          // for function
+#include <vector>                              // for vector
+#include "petscmat.h"                          // for Mat
+#include "petscvec.h"                          // for Vec
+
+
+/**
+ * @brief Time steps of the semi-discrete system M u' = f - A u, where M, A and f are constant within the step.
+ *
+ * The linear systems (c M + A) u = g are not handled directly, the integrator calls the functions given
+ * to every step: @p SetMatrix sets the system matrix for the coefficient c and @p Solve solves the system
+ * for the right hand side g, the solution is written to the solution vector of the step. This way substances
+ * sharing the operator can solve with the system of the group owner (see TransportDG).
+ */
+class DGTimeIntegrator {
+public:
+    /// Set matrix of the linear system to @p mass_coef M + A.
+    typedef std::function<void(double mass_coef)> SetMatrix;
+
+    /// Solve the linear system with right hand side @p rhs.
+    typedef std::function<void(Vec rhs)> Solve;
+
+    DGTimeIntegrator();
+
+    ~DGTimeIntegrator();
+
+    /**
+     * Step of the implicit Euler method, or of the variable step BDF2 method if @p mass_vec_prev is given:
+     *
+     *   ((1+2 omega)/(1+omega)/dt M + A) u^k = f + 1/dt ( (1+omega) M u^{k-1} - omega^2/(1+omega) M u^{k-2} ),
+     *
+     * where omega = dt/dt_prev.
+     *
+     * @param dt             Time step.
+     * @param omega          Ratio of the time step and the previous time step, not used by the implicit Euler method.
+     * @param rhs            Vector f.
+     * @param mass_vec       Vector M u^{k-1}.
+     * @param mass_vec_prev  Vector M u^{k-2}, nullptr for the implicit Euler method.
+     */
+    void bdf_step(double dt, double omega, Vec rhs, Vec mass_vec, Vec mass_vec_prev,
+            const SetMatrix &set_matrix, const Solve &solve);
+
+    /**
+     * Step of the ESDIRK method TR-BDF2.
+     *
+     * Both implicit stages use the same matrix A + 1/(d dt) M. If @p error_tol is positive, the local error
+     * is estimated from the embedded third order solution, filtered by one more solve with the same matrix.
+     * Returns ratio of the estimated error and the tolerance (zero if not estimated).
+     *
+     * @param dt         Time step.
+     * @param stiffness  Matrix A.
+     * @param rhs        Vector f.
+     * @param mass_vec   Vector M u^{k-1}.
+     * @param solution   Vector u^{k-1} on input, u^k on output, the solution vector of @p solve.
+     * @param error_tol  Relative tolerance of the local error.
+     */
+    double esdirk_step(double dt, Mat stiffness, Vec rhs, Vec mass_vec, Vec solution, double error_tol,
+            const SetMatrix &set_matrix, const Solve &solve);
+
+private:
+    /// Work vectors of the ESDIRK stages: stage right hand sides F_1..F_3, old solution, right hand side of the system.
+    std::vector<Vec> stage_vec_;
+};
+
+
+#endif /* DG_TIME_INTEGRATOR_HH_ */
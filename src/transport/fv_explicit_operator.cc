@@ -0,0 +1,187 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    fv_explicit_operator.cc
+ * @brief   Matrix-free upwind operator of the explicit finite volume transport.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "transport/fv_explicit_operator.hh"
+#include "la/distribution.hh"
+#include "system/asserts.hh"
+#include "system/sys_profiler.hh"
+
+
+FVExplicitOperator::FVExplicitOperator(const Distribution *el_ds, unsigned int n_components)
+: el_ds_(el_ds),
+  n_comp_(n_components),
+  n_own_(el_ds->lsize()),
+  row_offsets_(el_ds->lsize()+1, 0),
+  x_(PETSC_COMM_WORLD),
+  y_(el_ds->lsize() * n_components, 0.0)
+{
+    ASSERT_GT(n_comp_, 0);
+    std::vector<LongIdx> no_ghosts;
+    x_.resize(n_own_ * n_comp_, no_ghosts);
+}
+
+
+void FVExplicitOperator::start_assembly()
+{
+    entries_.clear();
+}
+
+
+void FVExplicitOperator::add(LongIdx row, LongIdx col, double value)
+{
+    entries_.push_back({row, col, value});
+}
+
+
+void FVExplicitOperator::finish_assembly()
+{
+    START_TIMER("fv_operator_assembly");
+    MPI_Comm comm = el_ds_->get_comm();
+    unsigned int np = el_ds_->np();
+
+    // send entries of rows of other processes to their owners
+    std::vector<int> send_counts(np, 0), recv_counts(np), send_offsets(np+1, 0), recv_offsets(np+1, 0);
+    for (const Entry &e : entries_)
+        if (! el_ds_->is_local(e.row)) send_counts[ el_ds_->get_proc(e.row) ]++;
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+    for (unsigned int p=0; p<np; p++) {
+        send_offsets[p+1] = send_offsets[p] + send_counts[p];
+        recv_offsets[p+1] = recv_offsets[p] + recv_counts[p];
+    }
+
+    std::vector<LongIdx> send_idx(2*send_offsets[np]), recv_idx(2*recv_offsets[np]);
+    std::vector<double> send_val(send_offsets[np]), recv_val(recv_offsets[np]);
+    std::vector<int> pos(send_offsets.begin(), send_offsets.end()-1);
+    std::vector<Entry> local_entries;
+    local_entries.reserve(entries_.size());
+    for (const Entry &e : entries_) {
+        if (el_ds_->is_local(e.row)) {
+            local_entries.push_back(e);
+            continue;
+        }
+        int &k = pos[ el_ds_->get_proc(e.row) ];
+        send_idx[2*k] = e.row;
+        send_idx[2*k+1] = e.col;
+        send_val[k] = e.value;
+        k++;
+    }
+    entries_.clear();
+
+    MPI_Alltoallv(send_val.data(), send_counts.data(), send_offsets.data(), MPI_DOUBLE,
+                  recv_val.data(), recv_counts.data(), recv_offsets.data(), MPI_DOUBLE, comm);
+    for (unsigned int p=0; p<np; p++) {
+        send_counts[p] *= 2; send_offsets[p] *= 2;
+        recv_counts[p] *= 2; recv_offsets[p] *= 2;
+    }
+    MPI_Alltoallv(send_idx.data(), send_counts.data(), send_offsets.data(), MPI_LONG_IDX,
+                  recv_idx.data(), recv_counts.data(), recv_offsets.data(), MPI_LONG_IDX, comm);
+    for (unsigned int k=0; k<recv_val.size(); k++)
+        local_entries.push_back({recv_idx[2*k], recv_idx[2*k+1], recv_val[k]});
+
+    // sort by rows and columns, sum duplicate entries
+    std::sort(local_entries.begin(), local_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.row < b.row || (a.row == b.row && a.col < b.col);
+    });
+
+    // local column indices, ghost elements numbered after own elements
+    std::unordered_map<LongIdx, unsigned int> ghost_pos;
+    ghosts_.clear();
+    cols_.clear();
+    values_.clear();
+    std::fill(row_offsets_.begin(), row_offsets_.end(), 0);
+    for (unsigned int k=0; k<local_entries.size(); k++) {
+        const Entry &e = local_entries[k];
+        if (k > 0 && e.row == local_entries[k-1].row && e.col == local_entries[k-1].col) {
+            values_.back() += e.value;
+            continue;
+        }
+        unsigned int col;
+        if (el_ds_->is_local(e.col)) col = e.col - el_ds_->begin();
+        else {
+            auto it = ghost_pos.find(e.col);
+            if (it == ghost_pos.end()) {
+                it = ghost_pos.insert({e.col, n_own_ + ghosts_.size()}).first;
+                ghosts_.push_back(e.col);
+            }
+            col = it->second;
+        }
+        cols_.push_back(col);
+        values_.push_back(e.value);
+        row_offsets_[e.row - el_ds_->begin() + 1]++;
+    }
+    for (unsigned int i=0; i<n_own_; i++) row_offsets_[i+1] += row_offsets_[i];
+
+    interior_rows_.clear();
+    boundary_rows_.clear();
+    for (unsigned int i=0; i<n_own_; i++) {
+        bool interior = true;
+        for (unsigned int k=row_offsets_[i]; k<row_offsets_[i+1]; k++)
+            if (cols_[k] >= n_own_) interior = false;
+        if (interior) interior_rows_.push_back(i);
+        else boundary_rows_.push_back(i);
+    }
+
+    // ghosted vector of all components, keeps own values
+    std::vector<double> own_values(x_.data().begin(), x_.data().begin() + n_own_ * n_comp_);
+    std::vector<LongIdx> ghost_idx(ghosts_.size() * n_comp_);
+    for (unsigned int g=0; g<ghosts_.size(); g++)
+        for (unsigned int c=0; c<n_comp_; c++) ghost_idx[g*n_comp_ + c] = ghosts_[g]*n_comp_ + c;
+    x_.resize(n_own_ * n_comp_, ghost_idx);
+    std::copy(own_values.begin(), own_values.end(), x_.data().begin());
+}
+
+
+void FVExplicitOperator::scale(double factor)
+{
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (unsigned int k=0; k<values_.size(); k++) values_[k] *= factor;
+}
+
+
+void FVExplicitOperator::apply_rows(const std::vector<unsigned int> &rows)
+{
+    const double *x = x_.data().data();
+    double *y = y_.data();
+
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (unsigned int r=0; r<rows.size(); r++) {
+        unsigned int i = rows[r];
+        double *y_i = y + i*n_comp_;
+        for (unsigned int c=0; c<n_comp_; c++) y_i[c] = 0.0;
+        for (unsigned int k=row_offsets_[i]; k<row_offsets_[i+1]; k++) {
+            const double a = values_[k];
+            const double *x_j = x + cols_[k]*n_comp_;
+            for (unsigned int c=0; c<n_comp_; c++) y_i[c] += a * x_j[c];
+        }
+    }
+}
+
+
+void FVExplicitOperator::apply()
+{
+    x_.local_to_ghost_begin();
+    apply_rows(interior_rows_);
+    x_.local_to_ghost_end();
+    apply_rows(boundary_rows_);
+}
@@ -0,0 +1,131 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    fv_explicit_operator.hh
+ * @brief   Matrix-free upwind operator of the explicit finite volume transport.
+ */
+
+#ifndef FV_EXPLICIT_OPERATOR_HH_
+#define FV_EXPLICIT_OPERATOR_HH_
+
+#include <vector>
+#include "la/vector_mpi.hh"
+#include "system/index_types.hh"
+
+class Distribution;
+
+
+/**
+ * @brief Upwind operator of the explicit FV transport applied to all substances at once.
+ *
+ * Replaces the PETSc transport matrix: coefficients of element rows (fluxes through sides divided
+ * by the element measure) are stored in compact arrays with local column indices, own elements
+ * first and ghost elements of other processes after them. Values of all components (substances)
+ * of an element are stored together, so one sweep over elements updates all of them.
+ *
+ * Rows coupled only to own elements are processed while the ghost values are exchanged,
+ * the remaining rows after the exchange is finished. The sweeps are parallelized by OpenMP.
+ *
+ * Usage:
+ * - start_assembly(), add() entries given by global row and column indices (rows of other processes
+ *   are allowed, e.g. the coupling of a lower dimensional element to its higher dimensional neighbour),
+ *   finish_assembly() (collective);
+ * - scale() by the time step;
+ * - fill own values in x(), call apply() (collective), read the result from y().
+ */
+class FVExplicitOperator {
+public:
+    /// Constructor, @p el_ds is the distribution of rows (elements), @p n_components number of substances.
+    FVExplicitOperator(const Distribution *el_ds, unsigned int n_components);
+
+    /// Remove all entries.
+    void start_assembly();
+
+    /// Add @p value to the entry (@p row, @p col) given by global indices.
+    void add(LongIdx row, LongIdx col, double value);
+
+    /**
+     * Send entries of rows of other processes to their owners, build compact rows,
+     * the list of ghost elements and the ghosted vector. COLLECTIVE.
+     */
+    void finish_assembly();
+
+    /// Multiply all coefficients by @p factor.
+    void scale(double factor);
+
+    /**
+     * Values of own elements, component @p c of the local element @p i at index i*n_components()+c.
+     * Entries after the own values are the ghost values, overwritten by apply().
+     */
+    inline std::vector<double> &x()
+    { return x_.data(); }
+
+    /// Result of apply() in the same layout as the own part of x().
+    inline const std::vector<double> &y() const
+    { return y_; }
+
+    /// Compute y = A x for all components. COLLECTIVE.
+    void apply();
+
+    /// Number of components.
+    inline unsigned int n_components() const
+    { return n_comp_; }
+
+    /// Number of stored coefficients (including diagonal).
+    inline unsigned int n_entries() const
+    { return values_.size(); }
+
+    /// Number of ghost elements.
+    inline unsigned int n_ghosts() const
+    { return ghosts_.size(); }
+
+private:
+    /// Entry added in the assembly.
+    struct Entry {
+        LongIdx row;
+        LongIdx col;
+        double value;
+    };
+
+    /// Compute rows given by @p rows of y = A x.
+    void apply_rows(const std::vector<unsigned int> &rows);
+
+    const Distribution *el_ds_;
+    unsigned int n_comp_;
+    unsigned int n_own_;
+
+    /// Entries added since start_assembly().
+    std::vector<Entry> entries_;
+
+    /// Offsets of rows in @p cols_ and @p values_, size n_own_+1.
+    std::vector<unsigned int> row_offsets_;
+    /// Local column indices: own elements 0..n_own_-1, ghost elements from n_own_.
+    std::vector<unsigned int> cols_;
+    /// Coefficients.
+    std::vector<double> values_;
+
+    /// Global indices of ghost elements.
+    std::vector<LongIdx> ghosts_;
+    /// Rows coupled only to own elements.
+    std::vector<unsigned int> interior_rows_;
+    /// Rows coupled to ghost elements.
+    std::vector<unsigned int> boundary_rows_;
+
+    /// Ghosted vector of values of all components.
+    VectorMPI x_;
+    /// Result of the product.
+    std::vector<double> y_;
+};
+
+
+#endif /* FV_EXPLICIT_OPERATOR_HH_ */
@@ -21,6 +21,7 @@
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
+#include "system/checkpoint_data.hh"
 
 #include "mesh/mesh.h"
 #include "mesh/partitioning.hh"
@@ -28,6 +29,7 @@
 #include "mesh/range_wrapper.hh"
 #include "mesh/neighbours.h"
 #include "transport/transport.h"
+#include "transport/fv_explicit_operator.hh"
 
 #include "la/distribution.hh"
 
@@ -82,6 +84,10 @@ const IT::Record &ConvectionTransport::get_input_type()
                     EqData().output_fields.make_output_type(_equation_name, ""),
                     IT::Default("{ \"fields\": [ \"conc\" ] }"),
                     "Specification of output fields and output times.")
+            .declare_key("matrix_free", IT::Bool(), IT::Default("false"),
+                    "Apply the upwind operator without assembling the transport matrix. Coefficients of sides are stored "
+                    "in compact arrays and all substances are updated in one (OpenMP parallel) sweep over elements, "
+                    "the exchange of concentrations on the boundary of the subdomain overlaps with the interior work.")
 			.close();
 }
 
@@ -159,6 +165,7 @@ ConvectionTransport::ConvectionTransport(Mesh &init_mesh, const Input::Record in
 : ConcentrationTransportBase(init_mesh, in_rec),
   is_mass_diag_changed(false),
   sources_corr(nullptr),
+  matrix_free_(in_rec.val<bool>("matrix_free")),
   input_rec(in_rec)
 {
 	START_TIMER("ConvectionTransport");
@@ -255,7 +262,7 @@ ConvectionTransport::~ConvectionTransport()
 
     if (sources_corr) {
         //Destroy mpi vectors at first
-        chkerr(MatDestroy(&tm));
+        if (!matrix_free_) chkerr(MatDestroy(&tm));
         chkerr(VecDestroy(&mass_diag));
         chkerr(VecDestroy(&vpmass_diag));
         chkerr(VecDestroy(&vcfl_flow_));
@@ -369,8 +376,11 @@ void ConvectionTransport::alloc_transport_structs_mpi() {
     }
 
 
-    MatCreateAIJ(PETSC_COMM_WORLD, el_ds->lsize(), el_ds->lsize(), mesh_->n_elements(),
-            mesh_->n_elements(), 16, PETSC_NULL, 4, PETSC_NULL, &tm);
+    if (matrix_free_)
+        fv_operator_ = std::make_shared<FVExplicitOperator>(el_ds, n_subst);
+    else
+        MatCreateAIJ(PETSC_COMM_WORLD, el_ds->lsize(), el_ds->lsize(), mesh_->n_elements(),
+                mesh_->n_elements(), 16, PETSC_NULL, 4, PETSC_NULL, &tm);
     
     VecCreateMPI(PETSC_COMM_WORLD, el_ds->lsize(), mesh_->n_elements(), &mass_diag);
     VecCreateMPI(PETSC_COMM_WORLD, el_ds->lsize(), mesh_->n_elements(), &vpmass_diag);
@@ -641,7 +651,8 @@ void ConvectionTransport::update_solution() {
         //choose between fresh scaling with new dt or rescaling to a new dt
         double dt = (!is_convection_matrix_scaled) ? dt_new : dt_scaled;
         
-        MatScale(tm, dt);
+        if (matrix_free_) fv_operator_->scale(dt);
+        else MatScale(tm, dt);
         is_convection_matrix_scaled = true;
     }
     
@@ -657,8 +668,9 @@ void ConvectionTransport::update_solution() {
     
 
     // Compute new concentrations for every substance.
+    if (matrix_free_) update_solution_matrix_free();
     
-    for (unsigned int sbi = 0; sbi < n_substances(); sbi++) {
+    for (unsigned int sbi = 0; sbi < n_substances() && !matrix_free_; sbi++) {
       // one step in MOBILE phase
       START_TIMER("mat mult");
       
@@ -698,6 +710,60 @@ void ConvectionTransport::update_solution() {
 }
 
 
+void ConvectionTransport::update_solution_matrix_free()
+{
+    START_TIMER("matrix free step");
+    const unsigned int n_subst = n_substances();
+    const unsigned int n_loc = el_ds->lsize();
+
+    // previous concentrations of all substances
+    std::vector<double> &x = fv_operator_->x();
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (unsigned int i=0; i<n_loc; i++)
+        for (unsigned int sbi=0; sbi<n_subst; sbi++)
+            x[i*n_subst+sbi] = conc[sbi][i];
+
+    // y = tm*pconc
+    fv_operator_->apply();
+    const std::vector<double> &y = fv_operator_->y();
+
+    double *mass, *pmass;
+    std::vector<double *> bc(n_subst), pconc(n_subst);
+    VecGetArray(mass_diag, &mass);
+    VecGetArray(vpmass_diag, &pmass);
+    for (unsigned int sbi=0; sbi<n_subst; sbi++) {
+        VecGetArray(bcvcorr[sbi], &bc[sbi]);
+        VecGetArray(vpconc[sbi], &pconc[sbi]);
+    }
+
+    const bool mass_changed = is_mass_diag_changed;
+#ifdef FLOW123D_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (unsigned int i=0; i<n_loc; i++)
+        for (unsigned int sbi=0; sbi<n_subst; sbi++)
+        {
+            double c_prev = x[i*n_subst+sbi];
+            // tm*pconc + D*pconc + bcvcorr + v_sources_corr
+            double rhs = y[i*n_subst+sbi] + tm_diag[sbi][i]*c_prev + bc[sbi][i] + sources_corr[sbi][i];
+            pconc[sbi][i] = c_prev;
+            if (mass_changed)
+                conc[sbi][i] = (c_prev*pmass[i] + rhs) / mass[i];
+            else
+                conc[sbi][i] = rhs / mass[i] + c_prev;
+        }
+
+    for (unsigned int sbi=0; sbi<n_subst; sbi++) {
+        VecRestoreArray(bcvcorr[sbi], &bc[sbi]);
+        VecRestoreArray(vpconc[sbi], &pconc[sbi]);
+    }
+    VecRestoreArray(mass_diag, &mass);
+    VecRestoreArray(vpmass_diag, &pmass);
+}
+
+
 void ConvectionTransport::set_target_time(double target_time)
 {
 
@@ -766,8 +832,17 @@ void ConvectionTransport::create_transport_matrix_mpi() {
     int j;
     LongIdx new_j, new_i;
     double aij, aii;
-        
-    MatZeroEntries(tm);
+
+    // zero entries are not stored by the matrix-free operator, it is rebuilt whenever the fluxes change
+    auto set_value = [this](LongIdx row, LongIdx col, double value) {
+        if (matrix_free_) {
+            if (value != 0.0) fv_operator_->add(row, col, value);
+        } else
+            MatSetValue(tm, row, col, value, INSERT_VALUES);
+    };
+
+    if (matrix_free_) fv_operator_->start_assembly();
+    else MatZeroEntries(tm);
 
     double flux, flux2, edg_flux;
 
@@ -796,7 +871,7 @@ void ConvectionTransport::create_transport_matrix_mpi() {
                         if ( flux2 > 0.0 && flux <0.0)
                             aij = -(flux * flux2 / ( edg_flux * dh_cell.elm().measure() ) );
                         else aij =0;
-                        MatSetValue(tm, new_i, new_j, aij, INSERT_VALUES);
+                        set_value(new_i, new_j, aij);
                     }
             }
             if (flux > 0.0)
@@ -813,7 +888,7 @@ void ConvectionTransport::create_transport_matrix_mpi() {
             // volume source - out-flow from higher dimension
             if (flux > 0.0)  aij = flux / dh_cell.elm().measure();
             else aij=0;
-            MatSetValue(tm, new_i, new_j, aij, INSERT_VALUES);
+            set_value(new_i, new_j, aij);
             // out flow from higher dim. already accounted
 
             // volume drain - in-flow to higher dimension
@@ -821,17 +896,20 @@ void ConvectionTransport::create_transport_matrix_mpi() {
                 aii -= (-flux) / dh_cell.elm().measure();                           // diagonal drain
                 aij = (-flux) / neighb_side.element().measure();
             } else aij=0;
-            MatSetValue(tm, new_j, new_i, aij, INSERT_VALUES);
+            set_value(new_j, new_i, aij);
         }
 
-    MatSetValue(tm, new_i, new_i, aii, INSERT_VALUES);
+    set_value(new_i, new_i, aii);
 
     cfl_flow_[loc_el++] = fabs(aii);
     aii = 0.0;
     }
 
-    MatAssemblyBegin(tm, MAT_FINAL_ASSEMBLY);
-    MatAssemblyEnd(tm, MAT_FINAL_ASSEMBLY);
+    if (matrix_free_) fv_operator_->finish_assembly();
+    else {
+        MatAssemblyBegin(tm, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(tm, MAT_FINAL_ASSEMBLY);
+    }
 
     is_convection_matrix_scaled = false;
     END_TIMER("convection_matrix_assembly");
@@ -860,6 +938,25 @@ LongIdx *ConvectionTransport::get_row_4_el(){
 
 
 
+void ConvectionTransport::save_state(CheckpointData &data) {
+    EquationBase::save_state(data);
+    for (unsigned int sbi=0; sbi<n_substances(); ++sbi)
+        save_vec(data, "conc_" + substances_[sbi].name(), vconc[sbi]);
+    save_vec(data, "mass_diag", mass_diag);
+    output_stream_->save_state(data);
+}
+
+
+void ConvectionTransport::restore_state(CheckpointData &data) {
+    EquationBase::restore_state(data);
+    for (unsigned int sbi=0; sbi<n_substances(); ++sbi)
+        restore_vec(data, "conc_" + substances_[sbi].name(), vconc[sbi]);
+    // mass matrix of the checkpoint time is the previous one for the first step after restart
+    restore_vec(data, "mass_diag", mass_diag);
+    output_stream_->restore_state(data);
+}
+
+
 void ConvectionTransport::output_data() {
 
     data_.output_fields.set_time(time().step(), LimitSide::right);
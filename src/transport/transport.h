@@ -47,6 +47,7 @@
 
 class OutputTime;
 class Mesh;
+class FVExplicitOperator;
 class Distribution;
 class Balance;
 namespace Input {
@@ -215,6 +216,9 @@ public:
      */
     virtual void output_data() override;
 
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
+
     void set_output_stream(std::shared_ptr<OutputTime> stream) override
     { output_stream_ = stream; }
 
@@ -274,6 +278,12 @@ private:
 	 */
 	void transport_matrix_step_mpi(double time_step); //
 
+    /**
+     * Compute new concentrations of all substances by the matrix-free operator @p fv_operator_
+     * in one sweep over local elements (same scheme as the matrix version in update_solution()).
+     */
+    void update_solution_matrix_free();
+
     void alloc_transport_vectors();
     void alloc_transport_structs_mpi();
 
@@ -323,7 +333,12 @@ private:
 
 
     VecScatter vconc_out_scatter;
-    Mat tm; // PETSc transport matrix
+    Mat tm; // PETSc transport matrix, not created if matrix_free_
+
+    /// Apply the upwind operator without the PETSc matrix @p tm.
+    bool matrix_free_;
+    /// Matrix-free upwind operator for all substances, used instead of @p tm.
+    std::shared_ptr<FVExplicitOperator> fv_operator_;
     Vec mass_diag;  // diagonal entries in pass matrix (cross_section * porosity)
     Vec vpmass_diag;  // diagonal entries in mass matrix from last time (cross_section * porosity)
     Vec *v_tm_diag; // additions to PETSC transport matrix on the diagonal - from sources (for each substance)
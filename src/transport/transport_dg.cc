@@ -18,6 +18,7 @@
 
 #include "system/index_types.hh"
 #include "system/sys_profiler.hh"
+#include "system/checkpoint_data.hh"
 #include "transport/transport_dg.hh"
 
 #include "io/output_time.hh"
@@ -29,6 +30,7 @@
 #include "fields/field_fe.hh"
 #include "fields/fe_value_handler.hh"
 #include "la/linsys_PETSC.hh"
+#include "la/schur.hh"
 #include "coupling/balance.hh"
 #include "transport/advection_diffusion_model.hh"
 #include "transport/concentration_model.hh"
@@ -57,6 +59,17 @@ const Selection & TransportDG<Model>::get_dg_variant_selection_input_type() {
         .close();
 }
 
+template<class Model>
+const Selection & TransportDG<Model>::get_time_scheme_selection_input_type() {
+    return Selection("DG_time_scheme", "Time integration scheme of the DG transport.")
+        .add_value(implicit_euler, "implicit_euler", "First order implicit Euler method.")
+        .add_value(bdf2,           "bdf2",           "Second order backward differentiation formula with variable time step, "
+                                                     "the first step is made by the implicit Euler method.")
+        .add_value(esdirk,         "esdirk",         "Second order ESDIRK method TR-BDF2 with embedded error estimate, "
+                                                     "both implicit stages use the same matrix.")
+        .close();
+}
+
 /*
 *  Should be removed
 template<class Model>
@@ -89,6 +102,19 @@ const Record & TransportDG<Model>::get_input_type() {
                 "Variant of the interior penalty discontinuous Galerkin method.")
         .declare_key("dg_order", Integer(0,3), Default("1"),
                 "Polynomial order for the finite element in DG method (order 0 is suitable if there is no diffusion/dispersion).")
+        .declare_key("share_operator", Bool(), Default("false"),
+                "If true, substances with identical stiffness and mass matrices are detected and form groups. "
+                "The matrices are assembled only once per group and all substances of the group are solved "
+                "with the same matrix and preconditioner.")
+        .declare_key("static_condensation", Bool(), Default("false"),
+                "If true, DOFs interior to elements (present for 'dg_order' 2 and 3 on 1D elements and 3 on 2D elements) "
+                "are eliminated from the global system by the Schur complement and reconstructed after its solution. "
+                "Not combined with 'share_operator'.")
+        .declare_key("time_scheme", TransportDG<Model>::get_time_scheme_selection_input_type(), Default("\"implicit_euler\""),
+                "Time integration scheme.")
+        .declare_key("time_error_tolerance", Double(0.0), Default("0.0"),
+                "Relative tolerance of the local time error estimated by the 'esdirk' scheme. "
+                "The estimate constrains the next time step, steps are not rejected. Zero switches the estimate off.")
         .declare_key("output",
                 EqData().output_fields.make_output_type(equation_name, ""),
                 IT::Default("{ \"fields\": [ " + Model::ModelEqData::default_output_field() + "] }"),
@@ -198,7 +224,8 @@ template<typename Model>
 TransportDG<Model>::TransportDG(Mesh & init_mesh, const Input::Record in_rec)
         : Model(init_mesh, in_rec),
           input_rec(in_rec),
-          allocation_done(false)
+          allocation_done(false),
+          operator_groups_found_(false)
 {
     // Can not use name() + "constructor" here, since START_TIMER only accepts const char *
     // due to constexpr optimization.
@@ -219,6 +246,10 @@ TransportDG<Model>::TransportDG(Mesh & init_mesh, const Input::Record in_rec)
     // DG variant and order
     data_->dg_variant = in_rec.val<DGVariant>("dg_variant");
     data_->dg_order = in_rec.val<unsigned int>("dg_order");
+    share_operators_ = in_rec.val<bool>("share_operator");
+    static_condensation_ = in_rec.val<bool>("static_condensation");
+    time_scheme_ = in_rec.val<TimeScheme>("time_scheme");
+    time_error_tol_ = in_rec.val<double>("time_error_tolerance");
     
     Model::init_from_input(in_rec);
 
@@ -305,13 +336,47 @@ void TransportDG<Model>::initialize()
     solution_elem_ = new double*[Model::n_substances()];
 
     stiffness_matrix.resize(Model::n_substances(), nullptr);
+    data_->operator_owner.resize(Model::n_substances());
+    for (unsigned int sbi = 0; sbi < Model::n_substances(); sbi++) data_->operator_owner[sbi] = sbi;
     mass_matrix.resize(Model::n_substances(), nullptr);
     rhs.resize(Model::n_substances(), nullptr);
     mass_vec.resize(Model::n_substances(), nullptr);
+    mass_vec_prev.resize(Model::n_substances(), nullptr);
     data_->ret_vec.resize(Model::n_substances(), nullptr);
 
+    std::vector<LongIdx> interior_dofs;
+    if (static_condensation_)
+    {
+        interior_dofs = element_interior_dofs();
+        unsigned int n_loc_interior = interior_dofs.size(), n_interior;
+        MPI_Allreduce(&n_loc_interior, &n_interior, 1, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
+        if (n_interior == 0)
+        {
+            WarningOut() << "No DOFs interior to elements, static condensation is not used.\n";
+            static_condensation_ = false;
+        }
+        else
+        {
+            MessageOut().fmt("Static condensation eliminates {} of {} DOFs.\n", n_interior, data_->dh_->n_global_dofs());
+            if (share_operators_)
+            {
+                WarningOut() << "Key 'share_operator' is ignored with static condensation.\n";
+                share_operators_ = false;
+            }
+        }
+    }
+
     for (unsigned int sbi = 0; sbi < Model::n_substances(); sbi++) {
-    	data_->ls[sbi] = new LinSys_PETSC(data_->dh_->distr().get(), petsc_default_opts);
+        if (static_condensation_)
+        {
+            IS is;
+            ISCreateGeneral(PETSC_COMM_SELF, interior_dofs.size(), interior_dofs.data(), PETSC_COPY_VALUES, &is);
+            SchurComplement *schur = new SchurComplement(data_->dh_->distr().get(), is); // is is deallocated by SchurComplement
+            schur->set_complement( new LinSys_PETSC(schur->make_complement_distribution(), petsc_default_opts) );
+            data_->ls[sbi] = schur;
+        }
+        else
+            data_->ls[sbi] = new LinSys_PETSC(data_->dh_->distr().get(), petsc_default_opts);
         ( (LinSys_PETSC *)data_->ls[sbi] )->set_from_input( input_rec.val<Input::Record>("solver") );
         data_->ls[sbi]->set_solution(output_vec[sbi].petsc_vec());
 
@@ -320,6 +385,12 @@ void TransportDG<Model>::initialize()
         solution_elem_[sbi] = new double[Model::mesh_->get_el_ds()->lsize()];
         
         VecDuplicate(data_->ls[sbi]->get_solution(), &data_->ret_vec[sbi]);
+
+        // matrices of all substances have the same structure, only the first substance counts the nonzeros
+        if (sbi > 0) {
+            ( (LinSys_PETSC *)data_->ls[sbi] )->share_sparsity_pattern( *(LinSys_PETSC *)data_->ls[0] );
+            ( (LinSys_PETSC *)data_->ls_dt[sbi] )->share_sparsity_pattern( *(LinSys_PETSC *)data_->ls_dt[0] );
+        }
     }
 
 
@@ -367,6 +438,8 @@ TransportDG<Model>::~TransportDG()
             	chkerr(VecDestroy(&rhs[i]));
             if (mass_vec[i])
             	chkerr(VecDestroy(&mass_vec[i]));
+            if (mass_vec_prev[i])
+            	chkerr(VecDestroy(&mass_vec_prev[i]));
             if (data_->ret_vec[i])
             	chkerr(VecDestroy(&data_->ret_vec[i]));
         }
@@ -437,6 +510,9 @@ void TransportDG<Model>::preallocate()
         data_->ls_dt[i]->start_allocation();
         mass_matrix[i] = NULL;
         VecZeroEntries(data_->ret_vec[i]);
+
+        // other substances share the sparsity pattern of the first one, their matrices are not assembled in the allocation pass
+        data_->operator_owner[i] = 0;
     }
     START_TIMER("assemble_stiffness");
     data_->stiffness_assembly_->assemble(data_->dh_);
@@ -444,6 +520,8 @@ void TransportDG<Model>::preallocate()
     START_TIMER("assemble_mass");
     data_->mass_assembly_->assemble(data_->dh_);
     END_TIMER("assemble_mass");
+    for (unsigned int i=0; i<Model::n_substances(); i++)
+        data_->operator_owner[i] = i;
     START_TIMER("assemble_sources");
     data_->sources_assembly_->assemble(data_->dh_);
     END_TIMER("assemble_sources");
@@ -473,44 +551,73 @@ void TransportDG<Model>::update_solution()
     data_->set_time(Model::time_->step(), LimitSide::left);
     END_TIMER("data reinit");
     
+    bool mass_changed = (mass_matrix[0] == NULL || data_->subset(FieldFlag::in_time_term).changed());
+    // new fluxes can change the location of Neumann boundary,
+    // thus stiffness matrix must be reassembled
+    bool stiffness_changed = (stiffness_matrix[0] == NULL
+            || data_->subset(FieldFlag::in_main_matrix).changed()
+            || data_->flow_flux.changed());
+
+    // Groups of substances with shared operator remain valid until some substance dependent
+    // coefficient changes, then matrices of all substances are assembled and compared again.
+    bool find_groups = false;
+    if (share_operators_ && (mass_changed || stiffness_changed)
+            && (!operator_groups_found_
+                || data_->subset(FieldFlag::in_time_term).multifield_changed()
+                || data_->subset(FieldFlag::in_main_matrix).multifield_changed()))
+    {
+        for (unsigned int i=0; i<Model::n_substances(); i++)
+        {
+            // released matrices of substances that shared the operator are created again
+            if (!data_->assemble_matrix(i))
+            {
+                ( (LinSys_PETSC *)data_->ls[i] )->start_allocation();
+                ( (LinSys_PETSC *)data_->ls_dt[i] )->start_allocation();
+            }
+            data_->operator_owner[i] = i;
+        }
+        mass_changed = stiffness_changed = find_groups = true;
+    }
+
     // assemble mass matrix
-    if (mass_matrix[0] == NULL || data_->subset(FieldFlag::in_time_term).changed() )
+    if (mass_changed)
     {
         for (unsigned int i=0; i<Model::n_substances(); i++)
         {
+            VecZeroEntries(data_->ret_vec[i]);
+            // substances sharing the operator have no matrices, see find_operator_groups()
+            if (!data_->assemble_matrix(i)) continue;
         	data_->ls_dt[i]->start_add_assembly();
         	data_->ls_dt[i]->mat_zero_entries();
-            VecZeroEntries(data_->ret_vec[i]);
         }
         START_TIMER("assemble_mass");
         data_->mass_assembly_->assemble(data_->dh_);
         END_TIMER("assemble_mass");
         for (unsigned int i=0; i<Model::n_substances(); i++)
         {
-        	data_->ls_dt[i]->finish_assembly();
+            if (data_->assemble_matrix(i)) data_->ls_dt[i]->finish_assembly();
             VecAssemblyBegin(data_->ret_vec[i]);
             VecAssemblyEnd(data_->ret_vec[i]);
             // construct mass_vec for initial time
-            if (mass_matrix[i] == NULL)
+            if (mass_vec[i] == NULL)
             {
                 VecDuplicate(data_->ls[i]->get_solution(), &mass_vec[i]);
-                MatMult(*(data_->ls_dt[i]->get_matrix()), data_->ls[i]->get_solution(), mass_vec[i]);
-                MatConvert(*( data_->ls_dt[i]->get_matrix() ), MATSAME, MAT_INITIAL_MATRIX, &mass_matrix[i]);
+                MatMult(*(data_->ls_dt[ data_->operator_owner[i] ]->get_matrix()), data_->ls[i]->get_solution(), mass_vec[i]);
             }
+            if (!data_->assemble_matrix(i)) continue;
+            if (mass_matrix[i] == NULL)
+                MatConvert(*( data_->ls_dt[i]->get_matrix() ), MATSAME, MAT_INITIAL_MATRIX, &mass_matrix[i]);
             else
                 MatCopy(*( data_->ls_dt[i]->get_matrix() ), mass_matrix[i], DIFFERENT_NONZERO_PATTERN);
         }
     }
 
     // assemble stiffness matrix
-    if (stiffness_matrix[0] == NULL
-            || data_->subset(FieldFlag::in_main_matrix).changed()
-            || data_->flow_flux.changed())
+    if (stiffness_changed)
     {
-        // new fluxes can change the location of Neumann boundary,
-        // thus stiffness matrix must be reassembled
         for (unsigned int i=0; i<Model::n_substances(); i++)
         {
+            if (!data_->assemble_matrix(i)) continue;
             data_->ls[i]->start_add_assembly();
             data_->ls[i]->mat_zero_entries();
         }
@@ -519,8 +626,13 @@ void TransportDG<Model>::update_solution()
         END_TIMER("assemble_stiffness");
         for (unsigned int i=0; i<Model::n_substances(); i++)
         {
+            if (!data_->assemble_matrix(i))
+            {
+                // penalty parameters are used also in the boundary condition terms of the right hand side
+                data_->gamma[i] = data_->gamma[ data_->operator_owner[i] ];
+                continue;
+            }
         	data_->ls[i]->finish_assembly();
-
             if (stiffness_matrix[i] == NULL)
                 MatConvert(*( data_->ls[i]->get_matrix() ), MATSAME, MAT_INITIAL_MATRIX, &stiffness_matrix[i]);
             else
@@ -528,6 +640,8 @@ void TransportDG<Model>::update_solution()
         }
     }
 
+    if (find_groups) find_operator_groups();
+
     // assemble right hand side (due to sources and boundary conditions)
     if (rhs[0] == NULL
             || data_->subset(FieldFlag::in_rhs).changed()
@@ -569,26 +683,38 @@ void TransportDG<Model>::update_solution()
     *
     *   A^k = A + 1/dt M.
     *
+    * Higher order schemes (BDF2, ESDIRK) use the same matrices A, M and f, see solve_bdf() and solve_esdirk().
+    * Substances of a group with shared operator are solved with the matrix and preconditioner of the group owner.
     */
-    Mat m;
     START_TIMER("solve");
+    // BDF2 needs mass vector from the last but one time instant
+    bool use_bdf2 = (time_scheme_ == bdf2 && mass_vec_prev[0] != nullptr);
+    double time_error = 0;
     for (unsigned int i=0; i<Model::n_substances(); i++)
     {
-        MatConvert(stiffness_matrix[i], MATSAME, MAT_INITIAL_MATRIX, &m);
-        MatAXPY(m, 1./Model::time_->dt(), mass_matrix[i], SUBSET_NONZERO_PATTERN);
-        data_->ls[i]->set_matrix(m, DIFFERENT_NONZERO_PATTERN);
-        Vec w;
-        VecDuplicate(rhs[i], &w);
-        VecWAXPY(w, 1./Model::time_->dt(), mass_vec[i], rhs[i]);
-        data_->ls[i]->set_rhs(w);
-
-        VecDestroy(&w);
-        chkerr(MatDestroy(&m));
+        if (time_scheme_ == esdirk)
+            time_error = std::max(time_error, solve_esdirk(i));
+        else
+            solve_bdf(i, use_bdf2);
 
-        data_->ls[i]->solve();
+        if (time_scheme_ == bdf2)
+        {
+            if (mass_vec_prev[i] == nullptr) VecDuplicate(mass_vec[i], &mass_vec_prev[i]);
+            VecCopy(mass_vec[i], mass_vec_prev[i]);
+        }
 
         // update mass_vec due to possible changes in mass matrix
-        MatMult(*(data_->ls_dt[i]->get_matrix()), data_->ls[i]->get_solution(), mass_vec[i]);
+        MatMult(*(data_->ls_dt[ data_->operator_owner[i] ]->get_matrix()), data_->ls[i]->get_solution(), mass_vec[i]);
+    }
+
+    if (time_scheme_ == esdirk && time_error_tol_ > 0)
+    {
+        // local error of the second order solution is O(dt^3)
+        double factor = (time_error > 0) ? 0.9 * std::pow(time_error, -1./3.) : 5.0;
+        factor = std::min(5.0, std::max(0.2, factor));
+        if (time_error > 1)
+            LogOut().fmt("DG time error estimate {} exceeds tolerance, time step is reduced.\n", time_error);
+        Model::time_->set_upper_constraint(Model::time_->dt() * factor, "DG transport time error estimate.");
     }
     END_TIMER("solve");
 
@@ -598,6 +724,115 @@ void TransportDG<Model>::update_solution()
 }
 
 
+template<class Model>
+void TransportDG<Model>::set_system_matrix(unsigned int sbi, double mass_coef)
+{
+    ASSERT_DBG(data_->assemble_matrix(sbi));
+    Mat m;
+    MatConvert(stiffness_matrix[sbi], MATSAME, MAT_INITIAL_MATRIX, &m);
+    MatAXPY(m, mass_coef, mass_matrix[sbi], SUBSET_NONZERO_PATTERN);
+    data_->ls[sbi]->set_matrix(m, DIFFERENT_NONZERO_PATTERN);
+    chkerr(MatDestroy(&m));
+}
+
+
+template<class Model>
+void TransportDG<Model>::solve_system(unsigned int sbi)
+{
+    unsigned int owner = data_->operator_owner[sbi];
+    if (owner == sbi)
+        data_->ls[sbi]->solve();
+    else
+        ( (LinSys_PETSC *)data_->ls[sbi] )->solve_with_operator( *(LinSys_PETSC *)data_->ls[owner] );
+}
+
+
+template<class Model>
+void TransportDG<Model>::solve_bdf(unsigned int sbi, bool use_bdf2)
+{
+    double omega = use_bdf2 ? Model::time_->dt() / Model::time_->last_dt() : 1.0;
+    time_integrator_.bdf_step(Model::time_->dt(), omega, rhs[sbi], mass_vec[sbi], use_bdf2 ? mass_vec_prev[sbi] : nullptr,
+            [this, sbi](double mass_coef) { if (data_->assemble_matrix(sbi)) set_system_matrix(sbi, mass_coef); },
+            [this, sbi](Vec system_rhs) { data_->ls[sbi]->set_rhs(system_rhs); solve_system(sbi); });
+}
+
+
+template<class Model>
+double TransportDG<Model>::solve_esdirk(unsigned int sbi)
+{
+    return time_integrator_.esdirk_step(Model::time_->dt(), stiffness_matrix[ data_->operator_owner[sbi] ], rhs[sbi],
+            mass_vec[sbi], data_->ls[sbi]->get_solution(), time_error_tol_,
+            [this, sbi](double mass_coef) { if (data_->assemble_matrix(sbi)) set_system_matrix(sbi, mass_coef); },
+            [this, sbi](Vec system_rhs) { data_->ls[sbi]->set_rhs(system_rhs); solve_system(sbi); });
+}
+
+
+template<class Model>
+std::vector<LongIdx> TransportDG<Model>::element_interior_dofs() const
+{
+    // local indices of interior DOFs for every dimension, basis of the order 0 is constant
+    std::vector<unsigned int> elm_interior[4];
+    if (data_->dg_order > 0)
+    {
+        MixedPtr<FE_P_disc> fe(data_->dg_order);
+        auto fill = [&elm_interior](unsigned int dim, const arma::vec &coords, unsigned int i_dof) {
+            if (coords.min() > 1e-12) elm_interior[dim].push_back(i_dof);
+        };
+        for (unsigned int i=0; i<fe[1_d]->n_dofs(); i++) fill(1, fe[1_d]->dof(i).coords, i);
+        for (unsigned int i=0; i<fe[2_d]->n_dofs(); i++) fill(2, fe[2_d]->dof(i).coords, i);
+        for (unsigned int i=0; i<fe[3_d]->n_dofs(); i++) fill(3, fe[3_d]->dof(i).coords, i);
+    }
+
+    // interior DOFs of every element are consecutive, so they form diagonal blocks of the eliminated matrix
+    std::vector<LongIdx> interior_dofs, dof_indices(data_->dh_->max_elem_dofs());
+    for (auto cell : data_->dh_->own_range())
+    {
+        cell.get_dof_indices(dof_indices);
+        for (unsigned int i : elm_interior[cell.dim()])
+            interior_dofs.push_back(dof_indices[i]);
+    }
+    return interior_dofs;
+}
+
+
+template<class Model>
+void TransportDG<Model>::find_operator_groups()
+{
+    START_TIMER("find_operator_groups");
+    unsigned int n_groups = 0;
+    for (unsigned int i=0; i<Model::n_substances(); i++)
+    {
+        data_->operator_owner[i] = i;
+        for (unsigned int j=0; j<i; j++)
+        {
+            if (! data_->assemble_matrix(j)) continue;
+            PetscBool equal_stiffness, equal_mass;
+            chkerr(MatEqual(stiffness_matrix[j], stiffness_matrix[i], &equal_stiffness));
+            if (! equal_stiffness) continue;
+            chkerr(MatEqual(mass_matrix[j], mass_matrix[i], &equal_mass));
+            if (equal_mass)
+            {
+                data_->operator_owner[i] = j;
+                break;
+            }
+        }
+
+        if (data_->assemble_matrix(i))
+            n_groups++;
+        else
+        {
+            // matrices of the owner are used instead, the own ones are neither allocated nor assembled
+            chkerr(MatDestroy(&stiffness_matrix[i]));
+            chkerr(MatDestroy(&mass_matrix[i]));
+            ( (LinSys_PETSC *)data_->ls[i] )->release_matrix();
+            ( (LinSys_PETSC *)data_->ls_dt[i] )->release_matrix();
+        }
+    }
+    operator_groups_found_ = true;
+    MessageOut().fmt("{} substances share {} transport operators.\n", Model::n_substances(), n_groups);
+}
+
+
 template<class Model>
 void TransportDG<Model>::calculate_concentration_matrix()
 {
@@ -649,6 +884,48 @@ void TransportDG<Model>::output_data()
 }
 
 
+template<class Model>
+void TransportDG<Model>::save_state(CheckpointData &data)
+{
+    Model::save_state(data);
+    for (unsigned int sbi=0; sbi<Model::n_substances(); ++sbi)
+    {
+        std::string name = Model::substances()[sbi].name();
+        EquationBase::save_vec(data, "solution_" + name, output_vec[sbi].petsc_vec());
+        EquationBase::save_vec(data, "mass_vec_" + name, mass_vec[sbi]);
+        if (mass_vec_prev[sbi] != nullptr)
+            EquationBase::save_vec(data, "mass_vec_prev_" + name, mass_vec_prev[sbi]);
+    }
+    data.save("ret_sources_prev", ret_sources_prev);
+    Model::output_stream()->save_state(data);
+}
+
+
+template<class Model>
+void TransportDG<Model>::restore_state(CheckpointData &data)
+{
+    Model::restore_state(data);
+    for (unsigned int sbi=0; sbi<Model::n_substances(); ++sbi)
+    {
+        std::string name = Model::substances()[sbi].name();
+        EquationBase::restore_vec(data, "solution_" + name, output_vec[sbi].petsc_vec());
+        // mass matrix of the checkpoint time applied to the solution, needed by the first step after restart
+        if (mass_vec[sbi] == nullptr) VecDuplicate(data_->ls[sbi]->get_solution(), &mass_vec[sbi]);
+        EquationBase::restore_vec(data, "mass_vec_" + name, mass_vec[sbi]);
+        // history of the BDF2 scheme
+        if (data.contains("mass_vec_prev_" + name))
+        {
+            if (mass_vec_prev[sbi] == nullptr) VecDuplicate(data_->ls[sbi]->get_solution(), &mass_vec_prev[sbi]);
+            EquationBase::restore_vec(data, "mass_vec_prev_" + name, mass_vec_prev[sbi]);
+        }
+        output_vec[sbi].local_to_ghost_begin();
+        output_vec[sbi].local_to_ghost_end();
+    }
+    data.load("ret_sources_prev", ret_sources_prev);
+    Model::output_stream()->restore_state(data);
+}
+
+
 template<class Model>
 void TransportDG<Model>::calculate_cumulative_balance()
 {
@@ -725,7 +1002,7 @@ void TransportDG<Model>::update_after_reactions(bool solution_changed)
     }
     // update mass_vec for the case that mass matrix changes in next time step
     for (unsigned int sbi=0; sbi<Model::n_substances(); ++sbi)
-        MatMult(*(data_->ls_dt[sbi]->get_matrix()), data_->ls[sbi]->get_solution(), mass_vec[sbi]);
+        MatMult(*(data_->ls_dt[ data_->operator_owner[sbi] ]->get_matrix()), data_->ls[sbi]->get_solution(), mass_vec[sbi]);
 }
 
 template<class Model>
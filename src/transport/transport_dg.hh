@@ -46,6 +46,7 @@
 #include "mpi.h"                               // for MPI_Comm_rank
 #include "petscmat.h"                          // for Mat, MatDestroy
 #include "petscvec.h"                          // for Vec, VecDestroy, VecSc...
+#include "transport/dg_time_integrator.hh"    // for DGTimeIntegrator
 #include "transport/concentration_model.hh"    // for ConcentrationTransport...
 #include "transport/heat_model.hh"             // for HeatTransferModel, Hea...
 #include "tools/mixed.hh"
@@ -190,8 +191,20 @@ public:
     	/// Polynomial order of finite elements.
     	unsigned int dg_order;
 
+    	/**
+    	 * Owner of the operator (stiffness and mass matrix) of every substance. Substances with identical
+    	 * matrices form a group, only the owner (the first substance of the group) assembles the matrices,
+    	 * matrices of the other substances are released until the groups are searched again.
+    	 */
+    	std::vector<unsigned int> operator_owner;
+
     	// @}
 
+		/// Return true if matrices of substance @p sbi are assembled, i.e. the substance owns its operator.
+		inline bool assemble_matrix(unsigned int sbi) const {
+			return operator_owner[sbi] == sbi;
+		}
+
 
         /// Auxiliary vectors for calculation of sources in balance due to retardation (e.g. sorption).
     	std::vector<Vec> ret_vec;
@@ -240,6 +253,17 @@ public:
 		symmetric = 1
 	};
 
+	enum TimeScheme {
+		// Implicit Euler method
+		implicit_euler = 0,
+
+		// Two step backward differentiation formula with variable step
+		bdf2 = 1,
+
+		// Three stage ESDIRK method TR-BDF2 with embedded third order error estimate
+		esdirk = 2
+	};
+
     /**
      * @brief Constructor.
      * @param init_mesh         computational mesh
@@ -257,6 +281,11 @@ public:
      */
     static const Input::Type::Selection & get_dg_variant_selection_input_type();
 
+    /**
+     * @brief Input type for the time integration scheme selection.
+     */
+    static const Input::Type::Selection & get_time_scheme_selection_input_type();
+
     /**
      * @brief Initialize solution in the zero time.
      */
@@ -275,6 +304,9 @@ public:
 	 */
 	void output_data();
 
+	void save_state(CheckpointData &data) override;
+	void restore_state(CheckpointData &data) override;
+
 	/**
 	 * @brief Destructor.
 	 */
@@ -339,6 +371,48 @@ private:
 	 */
 	void set_initial_condition();
 
+	/**
+	 * @brief Find groups of substances with identical stiffness and mass matrices.
+	 *
+	 * Called after assembly of matrices of all substances. Only the first substance of every group
+	 * keeps its matrix copies, the others are solved with operator of this group owner.
+	 */
+	void find_operator_groups();
+
+	/**
+	 * @brief Global indices of own DOFs interior to elements.
+	 *
+	 * These are the Lagrange nodes inside the element (dg_order 2 and 3 on lines, 3 on triangles).
+	 * Their basis functions do not vanish on element sides and the face terms of the interior penalty
+	 * method couple them to DOFs of neighbouring elements. However, they are coupled to each other
+	 * only within the element, i.e. the interior-interior block of the matrix is block diagonal
+	 * by elements, which is what static condensation needs.
+	 */
+	std::vector<LongIdx> element_interior_dofs() const;
+
+	/**
+	 * @brief Set matrix A + @p mass_coef M of the linear system of substance @p sbi.
+	 *
+	 * Has to be called only for substances owning their operator.
+	 */
+	void set_system_matrix(unsigned int sbi, double mass_coef);
+
+	/// Solve linear system of substance @p sbi, substances of a group use the operator of the group owner.
+	void solve_system(unsigned int sbi);
+
+	/**
+	 * @brief Perform one step of the implicit Euler method (or of the BDF2 method if @p use_bdf2 is true)
+	 * for substance @p sbi.
+	 */
+	void solve_bdf(unsigned int sbi, bool use_bdf2);
+
+	/**
+	 * @brief Perform one step of the ESDIRK method TR-BDF2 for substance @p sbi, see DGTimeIntegrator::esdirk_step.
+	 *
+	 * Returns ratio of the estimated error and the time error tolerance (zero if not estimated).
+	 */
+	double solve_esdirk(unsigned int sbi);
+
     
     
     void output_region_statistics();
@@ -369,6 +443,12 @@ private:
 	
 	/// Mass from previous time instant (necessary when coefficients of mass matrix change in time).
 	std::vector<Vec> mass_vec;
+
+	/// Mass from the last but one time instant (used by the BDF2 scheme).
+	std::vector<Vec> mass_vec_prev;
+
+	/// Steps of the time integration schemes, keeps auxiliary vectors of the ESDIRK stages.
+	DGTimeIntegrator time_integrator_;
     
 	/// Element averages of solution (the array is passed to reactions in operator splitting).
 	double **solution_elem_;
@@ -411,6 +491,21 @@ private:
     /// Indicates whether matrices have been preallocated.
     bool allocation_done;
 
+    /// Substances with identical matrices share the operator (set by input key 'share_operator').
+    bool share_operators_;
+
+    /// Indicates whether groups of substances sharing the operator have been found.
+    bool operator_groups_found_;
+
+    /// DOFs interior to elements are eliminated by the Schur complement (input key 'static_condensation').
+    bool static_condensation_;
+
+    /// Time integration scheme.
+    TimeScheme time_scheme_;
+
+    /// Relative tolerance of the local time error of the ESDIRK scheme, zero if the error is not estimated.
+    double time_error_tol_;
+
     // @}
 
 };
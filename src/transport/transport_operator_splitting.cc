@@ -21,6 +21,7 @@
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
+#include "system/checkpoint_data.hh"
 
 #include "transport/transport_operator_splitting.hh"
 #include <petscmat.h>
@@ -260,6 +261,37 @@ void TransportOperatorSplitting::output_data(){
 }
 
 
+void TransportOperatorSplitting::save_state(CheckpointData &data)
+{
+    EquationBase::save_state(data);
+    {
+        CheckpointData::Scope scope(data, "convection");
+        convection->save_state(data);
+    }
+    if (reaction) {
+        CheckpointData::Scope scope(data, "reaction");
+        reaction->save_state(data);
+    }
+}
+
+
+
+void TransportOperatorSplitting::restore_state(CheckpointData &data)
+{
+    EquationBase::restore_state(data);
+    {
+        CheckpointData::Scope scope(data, "convection");
+        convection->restore_state(data);
+    }
+    convection->calculate_concentration_matrix();
+    if (reaction) {
+        CheckpointData::Scope scope(data, "reaction");
+        reaction->restore_state(data);
+    }
+}
+
+
+
 void TransportOperatorSplitting::zero_time_step()
 {
     //DebugOut() << "tos ZERO TIME STEP.\n";
@@ -234,6 +234,9 @@ public:
     void compute_internal_step();
     void output_data() override;
 
+    void save_state(CheckpointData &data) override;
+    void restore_state(CheckpointData &data) override;
+
    
 
 private:
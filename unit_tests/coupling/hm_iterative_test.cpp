@@ -0,0 +1,145 @@
+/*
+ * hm_iterative_test.cpp
+ *
+ * Parameters of the fixed-stress coupling evaluated once per time step (once per region where constant)
+ * are compared with the direct evaluation of the fields on every element.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+
+#include "coupling/hm_iterative.hh"
+#include "fields/field_set.hh"
+#include "fields/field_fe.hh"
+#include "fem/fe_p.hh"
+#include "fem/dh_cell_accessor.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+#include "input/input_type.hh"
+#include "input/accessors.hh"
+#include "input/reader_to_storage.hh"
+#include "system/sys_profiler.hh"
+
+
+// alpha is constant on regions except the 2D one, young modulus is variable on the 3D front region until time 1
+const string hm_parameters_input = R"YAML(
+data:
+  - region: ALL
+    time: 0.0
+    alpha: 0.6
+    young_modulus: 1e9
+    poisson_ratio: 0.25
+  - region: 3D front
+    time: 0.0
+    young_modulus: !FieldFormula
+      value: 1e9*(1+x*x+y)
+  - region: 2D XY diagonal
+    time: 0.0
+    alpha: !FieldFormula
+      value: 0.5+x
+  - region: ALL
+    time: 1.0
+    alpha: 0.7
+    young_modulus: 3e9
+)YAML";
+
+
+class HMCouplingParametersTest : public testing::Test {
+public:
+    class EqData : public FieldSet {
+    public:
+        EqData() {
+            *this += alpha.name("alpha").units(UnitSI::dimensionless());
+            *this += young_modulus.name("young_modulus").units(UnitSI::Pa());
+            *this += poisson_ratio.name("poisson_ratio").units(UnitSI::dimensionless());
+        }
+
+        Field<3, FieldValue<3>::Scalar> alpha;
+        Field<3, FieldValue<3>::Scalar> young_modulus;
+        Field<3, FieldValue<3>::Scalar> poisson_ratio;
+    };
+
+    HMCouplingParametersTest()
+    : tg_(0.0, 1.0)
+    {
+        FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+        Profiler::instance();
+        mesh_ = mesh_full_constructor("{mesh_file=\"mesh/simplest_cube.msh\"}");
+        dh_ = create_field_fe<3, FieldValue<3>::Scalar>(*mesh_, MixedPtr<FE_P_disc>(0))->get_dofhandler();
+
+        Input::Type::Record rec_type = Input::Type::Record("HMParametersTest", "")
+            .declare_key("data", Input::Type::Array(
+                    Input::Type::Record("HMParametersTest_Data", FieldCommon::field_descriptor_record_description("HMParametersTest_Data"))
+                    .copy_keys( EqData().make_field_descriptor_type("HMParametersTest") )
+                    .declare_key("alpha", FieldAlgorithmBase< 3, FieldValue<3>::Scalar >::get_input_type_instance(), "")
+                    .declare_key("young_modulus", FieldAlgorithmBase< 3, FieldValue<3>::Scalar >::get_input_type_instance(), "")
+                    .declare_key("poisson_ratio", FieldAlgorithmBase< 3, FieldValue<3>::Scalar >::get_input_type_instance(), "")
+                    .close()
+                    ), Input::Type::Default::obligatory(), "")
+            .close();
+        Input::ReaderToStorage reader(hm_parameters_input, rec_type, Input::FileFormat::format_YAML);
+        input_list_ = reader.get_root_interface<Input::Record>().val<Input::Array>("data");
+
+        data_.set_mesh(*mesh_);
+        data_.set_input_list(input_list_, tg_);
+        data_.set_time(tg_.step(), LimitSide::right);
+    }
+
+    ~HMCouplingParametersTest() {
+        delete mesh_;
+    }
+
+    /// Compare parameters on all local elements with values of the fields.
+    void check_parameters() {
+        ASSERT_EQ(dh_->local_size(), params_.alpha().size());
+        for (auto cell : dh_->local_range()) {
+            auto elm = cell.elm();
+            double alpha = data_.alpha.value(elm.centre(), elm);
+            double coef = HMCouplingParameters::fixed_stress_coef(alpha, data_.young_modulus.value(elm.centre(), elm),
+                    data_.poisson_ratio.value(elm.centre(), elm), elm.dim());
+            EXPECT_DOUBLE_EQ(alpha, params_.alpha()[cell.local_idx()]);
+            EXPECT_DOUBLE_EQ(coef, params_.coef()[cell.local_idx()]);
+        }
+    }
+
+    bool update() {
+        return params_.update(tg_.step(), data_.alpha, data_.young_modulus, data_.poisson_ratio, dh_);
+    }
+
+    Mesh *mesh_;
+    std::shared_ptr<DOFHandlerMultiDim> dh_;
+    TimeGovernor tg_;
+    Input::Array input_list_;
+    EqData data_;
+    HMCouplingParameters params_;
+};
+
+
+TEST_F(HMCouplingParametersTest, update) {
+    const RegionDB &region_db = mesh_->region_db();
+    EXPECT_TRUE(data_.alpha.is_constant(region_db.find_label("3D back")));
+    EXPECT_FALSE(data_.young_modulus.is_constant(region_db.find_label("3D front")));
+    EXPECT_FALSE(data_.alpha.is_constant(region_db.find_label("2D XY diagonal")));
+
+    EXPECT_TRUE(update());
+    check_parameters();
+
+    // parameters are evaluated once per time step
+    EXPECT_TRUE(params_.is_current(tg_.step()));
+    EXPECT_FALSE(update());
+
+    // all parameters are constant on all regions in the next step
+    tg_.next_time();
+    data_.set_time(tg_.step(), LimitSide::right);
+    EXPECT_FALSE(params_.is_current(tg_.step()));
+    EXPECT_TRUE(update());
+    check_parameters();
+    for (double alpha : params_.alpha()) EXPECT_DOUBLE_EQ(0.7, alpha);
+
+    // e.g. after restart
+    params_.invalidate();
+    EXPECT_TRUE(update());
+    check_parameters();
+}
@@ -0,0 +1,59 @@
+/*
+ * iteration_acceleration_test.cpp
+ */
+
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <cmath>
+#include <vector>
+
+#include "coupling/iteration_acceleration.hh"
+
+
+/**
+ * Number of iterations of linear fixed point problem x = B x + c with tridiagonal B,
+ * diagonal entries of alternating sign and spectral radius close to one.
+ */
+unsigned int n_iterations(IterationAcceleration::Method method, unsigned int depth) {
+    const unsigned int n = 20;
+    std::vector<double> x(n, 0.0), g(n), weights(n, 1.0);
+    IterationAcceleration acc(method, depth, 1.0, MPI_COMM_SELF);
+
+    for (unsigned int it=1; it<1000; ++it) {
+        double res2 = 0;
+        for (unsigned int i=0; i<n; ++i) {
+            g[i] = 0.95 * (1.0 - 0.02*i) * ((i%2) ? -1.0 : 1.0) * x[i] + 1.0;
+            if (i > 0) g[i] += 0.01*x[i-1];
+            if (i+1 < n) g[i] += 0.01*x[i+1];
+            res2 += (g[i]-x[i])*(g[i]-x[i]);
+        }
+        if (std::sqrt(res2) < 1e-10) return it;
+        acc.update(x, g, weights);
+        x = g;
+    }
+    return 1000;
+}
+
+
+TEST(IterationAcceleration, linear_problem) {
+    unsigned int n_plain = n_iterations(IterationAcceleration::none, 5);
+    EXPECT_GT(n_plain, 400);
+    EXPECT_LT(n_iterations(IterationAcceleration::aitken, 5), n_plain/3);
+    EXPECT_LT(n_iterations(IterationAcceleration::anderson, 5), n_plain/3);
+    // with full history Anderson acts as GMRES
+    EXPECT_LE(n_iterations(IterationAcceleration::anderson, 20), 30);
+}
+
+
+TEST(IterationAcceleration, residual_part) {
+    // residual is given only by the first entry, the second one follows the same combination
+    IterationAcceleration acc(IterationAcceleration::anderson, 3, 1.0, MPI_COMM_SELF);
+    std::vector<double> x = {0.0, 0.0}, g(2), weights = {1.0};
+    for (unsigned int it=0; it<5; ++it) {
+        g = { 0.5*x[0] + 1.0, x[0] };
+        acc.update(x, g, weights);
+        x = g;
+    }
+    EXPECT_NEAR(2.0, x[0], 1e-10);
+    EXPECT_NEAR(2.0, x[1], 1e-10);
+}
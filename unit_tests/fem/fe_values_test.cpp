@@ -101,6 +101,30 @@ TEST(FeValues, test_all) {
 }
 
 
+TEST(FeValues, shared_reference_data) {
+    QGauss quad( 2, 2 );
+    unsigned int n_shared = FEValues<3>::n_shared_fe_data();
+    {
+        FE_P_disc<2> fe_a(1), fe_b(1), fe_c(2);
+        FEValues<3> fv_a(quad, fe_a, update_values);
+        EXPECT_EQ( n_shared+1, FEValues<3>::n_shared_fe_data() );
+
+        // equal element on equal quadrature reuses the data
+        FEValues<3> fv_b(quad, fe_b, update_values | update_gradients);
+        EXPECT_EQ( n_shared+1, FEValues<3>::n_shared_fe_data() );
+
+        FEValues<3> fv_c(quad, fe_c, update_values);
+        EXPECT_EQ( n_shared+2, FEValues<3>::n_shared_fe_data() );
+
+        QGauss side_quad( 1, 2 );
+        FEValues<3> fv_side(side_quad, fe_a, update_values);
+        EXPECT_EQ( n_shared + 2 + RefElement<2>::n_sides * RefElement<2>::n_side_permutations,
+                   FEValues<3>::n_shared_fe_data() );
+    }
+    EXPECT_EQ( n_shared, FEValues<3>::n_shared_fe_data() );
+}
+
+
 class TestElementMapping {
 public:
     TestElementMapping(std::vector<string> nodes_str)
@@ -222,3 +222,93 @@ TEST_F(FieldEvalConstantTest, evaluate) {
     }
 
 }
+
+
+TEST_F(FieldEvalConstantTest, repeated_update) {
+    string eq_data_input = R"YAML(
+    data:
+      - region: ALL
+        time: 0.0
+        scalar_field: 0.5
+        vector_field: [1, 2, 3]
+        tensor_field: [0.1, 0.2, 0.3, 0.4, 0.5, 0.6]
+      - region: ALL
+        time: 1.0
+        scalar_field: 2.5
+    )YAML";
+	this->read_input(eq_data_input);
+
+    auto update_and_check = [this](double expected) {
+        data_->elm_cache_map_.start_elements_update();
+        data_->computed_dh_cell_ = DHCellAccessor(dh_.get(), 3);
+        data_->elm_cache_map_.add(data_->computed_dh_cell_);
+        for (DHCellSide side : data_->computed_dh_cell_.side_range())
+            for(DHCellSide el_ngh_side : side.edge_sides())
+                data_->elm_cache_map_.add(el_ngh_side);
+        data_->update_cache();
+
+        DHCellAccessor cache_cell = this->data_->elm_cache_map_(data_->computed_dh_cell_);
+        for(BulkPoint q_point: data_->mass_eval->points(cache_cell, &data_->elm_cache_map_)) {
+            EXPECT_EQ(expected, data_->scalar_field(q_point));
+            EXPECT_ARMA_EQ(arma::vec3("1 2 3"), data_->vector_field(q_point));
+        }
+    };
+
+    // same cache content, value is updated only after change of time
+    update_and_check(0.5);
+    unsigned int cache_version = data_->elm_cache_map_.cache_version();
+    update_and_check(0.5);
+    EXPECT_EQ(cache_version, data_->elm_cache_map_.cache_version());
+
+    TimeGovernor tg(1.0, 1.0);
+    data_->set_time(tg.step(), LimitSide::right);
+    update_and_check(2.5);
+    update_and_check(2.5);
+}
+
+
+TEST_F(FieldEvalConstantTest, two_cache_maps) {
+    string eq_data_input = R"YAML(
+    data:
+      - region: 3D left
+        time: 0.0
+        scalar_field: 0.5
+        vector_field: [1, 2, 3]
+        tensor_field: [0.1, 0.2, 0.3, 0.4, 0.5, 0.6]
+      - region: 3D right
+        time: 0.0
+        scalar_field: 1.5
+        vector_field: [4, 5, 6]
+        tensor_field: [2.1, 2.2, 2.3, 2.4, 2.5, 2.6]
+    )YAML";
+	this->read_input(eq_data_input);
+
+    ElementCacheMap other_cache_map;
+    other_cache_map.init(data_->eval_points_);
+
+    // Both maps store single element at the same position of the value cache of the field.
+    auto update_and_check = [this](ElementCacheMap &cache_map, unsigned int cell_idx, double expected) {
+        DHCellAccessor dh_cell(dh_.get(), cell_idx);
+        cache_map.start_elements_update();
+        cache_map.add(dh_cell);
+        cache_map.prepare_elements_to_update();
+        unsigned int subset_index = data_->mass_eval->get_subset_idx();
+        cache_map.mark_used_eval_points( dh_cell, subset_index, data_->eval_points_->subset_size(dh_cell.dim(), subset_index) );
+        cache_map.create_elements_points_map();
+        data_->cache_update(cache_map);
+        cache_map.finish_elements_update();
+
+        DHCellAccessor cache_cell = cache_map(dh_cell);
+        for(BulkPoint q_point: data_->mass_eval->points(cache_cell, &cache_map))
+            EXPECT_EQ(expected, data_->scalar_field(q_point));
+    };
+
+    // Content of the maps doesn't change, but each of them overwrites the cache written by the other one.
+    for (unsigned int i=0; i<2; ++i) {
+        update_and_check(data_->elm_cache_map_, 0, 0.5);
+        update_and_check(other_cache_map, 9, 1.5);
+    }
+    unsigned int cache_version = data_->elm_cache_map_.cache_version();
+    update_and_check(data_->elm_cache_map_, 0, 0.5);
+    EXPECT_EQ(cache_version, data_->elm_cache_map_.cache_version());
+}
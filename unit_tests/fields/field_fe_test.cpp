@@ -23,6 +23,7 @@
 #include "fem/dofhandler.hh"
 #include "fem/fe_p.hh"
 #include "quadrature/quadrature.hh"
+#include "quadrature/quadrature_lib.hh"
 #include "fem/mapping_p1.hh"
 #include "fem/fe_values.hh"
 #include "fem/fe_rt.hh"
@@ -30,8 +31,10 @@
 #include "system/sys_profiler.hh"
 
 #include "mesh/mesh.h"
+#include "mesh/ref_element.hh"
 #include "io/msh_gmshreader.h"
 #include "io/reader_cache.hh"
+#include "io/interpolation_operator.hh"
 #include "tools/mixed.hh"
 
 
@@ -686,3 +689,73 @@ TEST_F(FieldFENewTest, gauss_1d_2d_elements_small_vector) {
     }
 
 } // */
+
+
+TEST_F(FieldFENewTest, gauss_cached_operator) {
+    // Source data are P0 values 1 + 0.1*x + t in barycenters of the source elements. Reference values are computed
+    // without the interpolation operator: Gauss quadrature on target elements and brute force search of source elements.
+    std::shared_ptr<Mesh> source_mesh = ReaderCache::get_mesh( FilePath("fields/interpolate_boundary_data.msh", FilePath::input_file) );
+    auto expected_value = [&source_mesh](ElementAccessor<3> elm, double time) {
+        EXPECT_EQ(2, elm.dim());
+        QGauss quad(2, 4);
+        auto map = MappingP1<2,3>::element_map(elm);
+        double value = 0.0;
+        for (unsigned int i=0; i<quad.size(); ++i) {
+            arma::vec3 q_point = MappingP1<2,3>::project_unit_to_real(RefElement<2>::local_to_bary(quad.point<2>(i)), map);
+            double sum = 0.0;
+            unsigned int n_source = 0;
+            for (auto source_elm : source_mesh->elements_range())
+                if (MappingP1<3,3>::contains_point(q_point, source_elm)) {
+                    sum += 1.0 + 0.1*source_elm.centre()[0] + time;
+                    n_source++;
+                }
+            value += 2.0 * quad.weight(i) * sum / n_source;
+        }
+        return value;
+    };
+
+    // first field creates the operator, second field reads same frames through operator stored in ReaderCache
+    ScalarField field, cached_field;
+    field.init_from_input(rec.val<Input::Record>("interp_scalar_gauss"), init_data("interp_scalar_gauss"));
+    field.set_mesh(mesh, true);
+    cached_field.init_from_input(rec.val<Input::Record>("interp_scalar_gauss"), init_data("interp_scalar_gauss"));
+    cached_field.set_mesh(mesh, true);
+    for (unsigned int j=0; j<2; j++) {
+    	field.set_time(test_time[j]);
+    	cached_field.set_time(test_time[j]);
+    	for (unsigned int i=9; i<13; ++i) {
+    		ElementAccessor<3> elm = mesh->element_accessor(i);
+    		double expected = expected_value(elm, test_time[j]);
+    		EXPECT_NEAR( expected, field.value(elm.centre(), elm), 1e-12 );
+    		EXPECT_NEAR( expected, cached_field.value(elm.centre(), elm), 1e-12 );
+    	}
+    }
+}
+
+
+TEST(InterpolationOperator, row_values) {
+    InterpolationOperator interp;
+    interp.new_row(3);
+    interp.add(0, 0.25);
+    interp.add(2, 0.5);
+    interp.add(0, 0.25);
+    interp.new_row(5);
+    interp.add(1, 2.0);
+    interp.drop_row();
+    interp.new_row(7);
+    interp.add(1, 3.0);
+    interp.scale_row(1.0/3.0);
+    EXPECT_EQ(2, interp.n_rows());
+    EXPECT_EQ(3, interp.n_nonzeros());
+    EXPECT_EQ(7, interp.target_elm(1));
+
+    // two components per source element
+    std::vector<double> source = {1.0, 10.0, 2.0, 20.0, 3.0, 30.0};
+    std::vector<double> values(2);
+    interp.row_values(0, source, 2, values);
+    EXPECT_DOUBLE_EQ(2.0, values[0]);
+    EXPECT_DOUBLE_EQ(20.0, values[1]);
+    interp.row_values(1, source, 2, values);
+    EXPECT_DOUBLE_EQ(2.0, values[0]);
+    EXPECT_DOUBLE_EQ(20.0, values[1]);
+}
@@ -26,6 +26,7 @@
 #include "input/input_type.hh"
 #include "input/accessors.hh"
 #include "input/reader_to_storage.hh"
+#include "system/armor.hh"
 
 using namespace std;
 
@@ -49,6 +50,16 @@ def func_circle(r,phi,n):
     return ( r * math.cos(phi), r * math.sin(phi), 1 )
 )CODE";
 
+string python_vectorized_function = R"CODE(
+import numpy as np
+
+def func_xyz(p):
+    return p[:,0] * p[:,1] * p[:,2]
+
+def func_circle(p):
+    return np.stack( (p[:,0] * np.cos(p[:,1]), p[:,0] * np.sin(p[:,1]), np.ones(p.shape[0])), axis=1 )
+)CODE";
+
 string python_call_object_err = R"CODE(
 import math
 
@@ -205,6 +216,43 @@ TEST(FieldPython, read_from_input) {
 
 }
 
+TEST(FieldPython, vectorized) {
+    double pi = 4.0 * atan(1);
+    ElementAccessor<3> elm;
+
+    Armor::array point_list(3, 1);
+    point_list.reinit(2);
+    point_list.append(Armor::vec<3>({1.0, pi / 2.0, 1.0}));
+    point_list.append(Armor::vec<3>({sqrt(2.0), 3.0 * pi / 4.0, pi / 2.0}));
+
+    FieldPython<3, FieldValue<3>::VectorFixed > vec_func;
+    vec_func.set_python_field_from_string(python_vectorized_function, "func_circle", true);
+    std::vector<arma::vec3> vec_values(2);
+    vec_func.value_list(point_list, elm, vec_values);
+    EXPECT_NEAR( 0, vec_values[0][0], 1e-14);
+    EXPECT_DOUBLE_EQ( 1, vec_values[0][1]);
+    EXPECT_DOUBLE_EQ( 1, vec_values[0][2]);
+    EXPECT_DOUBLE_EQ( -1, vec_values[1][0]);
+    EXPECT_DOUBLE_EQ( 1, vec_values[1][1]);
+    EXPECT_DOUBLE_EQ( 1, vec_values[1][2]);
+
+    // same values as per point function
+    FieldPython<3, FieldValue<3>::VectorFixed > point_func;
+    point_func.set_python_field_from_string(python_function, "func_circle");
+    for (unsigned int i=0; i<2; ++i) {
+        arma::vec3 result = point_func.value(point_list.vec<3>(i), elm);
+        EXPECT_LT( arma::norm(result - vec_values[i], "inf"), 1e-14 );
+    }
+
+    FieldPython<3, FieldValue<3>::Scalar> scalar_func;
+    scalar_func.set_python_field_from_string(python_vectorized_function, "func_xyz", true);
+    std::vector<double> scalar_values(2);
+    scalar_func.value_list(point_list, elm, scalar_values);
+    EXPECT_DOUBLE_EQ( pi / 2.0, scalar_values[0]);
+    EXPECT_DOUBLE_EQ( sqrt(2.0) * 3.0 * pi * pi / 8.0, scalar_values[1]);
+}
+
+
 TEST(FieldPython, python_exception) {
     FieldPython<3, FieldValue<3>::Scalar> scalar_func;
 	EXPECT_THROW_WHAT( { scalar_func.set_python_field_from_string(python_function, "func_xxx"); }, PythonLoader::ExcPythonError,
@@ -177,3 +177,28 @@ TEST_F(FieldValueCacheTest, element_cache_map) {
     dh_cell1 = (*this)(dh_cell1);
     EXPECT_EQ(dh_cell1.element_cache_index(), 1);
 }
+
+
+TEST_F(FieldValueCacheTest, cache_version) {
+    auto update_cache = [this](std::vector<unsigned int> cells, unsigned int n_points) {
+        this->start_elements_update();
+        for (auto i_cell : cells) this->add( DHCellAccessor(dh_.get(), i_cell) );
+        this->prepare_elements_to_update();
+        for (auto i_cell : cells)
+            this->mark_used_eval_points( DHCellAccessor(dh_.get(), i_cell), bulk_eval->get_subset_idx(), n_points);
+        this->create_elements_points_map();
+        this->finish_elements_update();
+        return this->cache_version();
+    };
+
+    unsigned int version = update_cache({1, 2}, 4);
+    EXPECT_EQ(update_cache({1, 2}, 4), version);   // same content
+    EXPECT_NE(update_cache({1, 3}, 4), version);   // other elements
+    version = this->cache_version();
+    EXPECT_NE(update_cache({1, 3}, 2), version);   // other points
+
+    // versions are unique among instances
+    ElementCacheMap other_map;
+    other_map.init(eval_points);
+    EXPECT_NE(other_map.cache_version(), this->cache_version());
+}
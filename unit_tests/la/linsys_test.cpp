@@ -12,7 +12,12 @@
 
 #include "flow_gtest_mpi.hh"
 #include "la/linsys.hh"
+#include "la/linsys_PETSC.hh"
+#include "la/sparsity_pattern.hh"
+#include "la/distribution.hh"
+#include "system/sys_profiler.hh"
 #include <armadillo>
+#include <sstream>
 #include "mpi.h"
 
 
@@ -170,3 +175,462 @@ TEST_F(SetValues, dirichlet) {
         this->add( {0,3}, {4,5,} );
     }     
 };
+
+
+
+TEST(PcReusePolicy, reuse_steps) {
+    PcReusePolicy policy(2, 2.0);
+
+    // no preconditioner yet
+    EXPECT_TRUE( policy.rebuild_needed(false) );
+    policy.solved(true, true, 10);
+
+    // unchanged matrix never forces the rebuild
+    EXPECT_FALSE( policy.rebuild_needed(false) );
+    EXPECT_FALSE( policy.rebuild_needed(true) );
+    policy.solved(false, true, 12);
+    EXPECT_FALSE( policy.rebuild_needed(true) );
+
+    // solves with unchanged matrix are not counted
+    policy.solved(false, false, 12);
+    policy.solved(false, false, 13);
+    EXPECT_EQ( 1, policy.n_reused() );
+    EXPECT_FALSE( policy.rebuild_needed(true) );
+
+    policy.solved(false, true, 15);
+    EXPECT_EQ( 2, policy.n_reused() );
+    EXPECT_TRUE( policy.rebuild_needed(true) );
+    EXPECT_FALSE( policy.rebuild_needed(false) );
+
+    // growth of the iteration count
+    policy.solved(true, true, 10);
+    policy.solved(false, false, 21);
+    EXPECT_TRUE( policy.rebuild_needed(false) );
+
+    policy.solved(true, true, 10);
+    policy.invalidate();
+    EXPECT_TRUE( policy.rebuild_needed(false) );
+
+    // default policy rebuilds for every changed matrix
+    PcReusePolicy dflt_policy;
+    dflt_policy.solved(true, true, 5);
+    EXPECT_TRUE( dflt_policy.rebuild_needed(true) );
+}
+
+
+TEST(LinSysPetsc, shared_sparsity_pattern) {
+    Distribution ds(4, PETSC_COMM_WORLD);
+    LinSys_PETSC ls1(&ds), ls2(&ds);
+    ls2.share_sparsity_pattern(ls1);
+
+    ls1.start_allocation();
+    ls2.start_allocation();
+    std::vector<int> rows = { (int)ds.begin(), (int)ds.begin()+1 };
+    std::vector<double> vals = { 1.0, 2.0, 3.0, 4.0 };
+    ls1.mat_set_values(2, rows.data(), 2, rows.data(), vals.data());
+    ls2.mat_set_values(2, rows.data(), 2, rows.data(), vals.data());
+
+    // owner of the pattern has to be preallocated first
+    ls1.start_add_assembly();
+    ls2.start_add_assembly();
+    EXPECT_EQ( ls1.get_sparsity_pattern(), ls2.get_sparsity_pattern() );
+    EXPECT_TRUE( ls1.get_sparsity_pattern()->is_complete() );
+    EXPECT_EQ( 2, ls1.get_sparsity_pattern()->on_nz()[0] );
+    EXPECT_EQ( 0, ls1.get_sparsity_pattern()->on_nz()[2] );
+    EXPECT_EQ( 0, ls1.get_sparsity_pattern()->off_nz()[0] );
+
+    ls1.mat_set_values(2, rows.data(), 2, rows.data(), vals.data());
+    ls2.mat_set_values(2, rows.data(), 2, rows.data(), vals.data());
+    ls1.finish_assembly();
+    ls2.finish_assembly();
+
+    PetscBool equal;
+    MatEqual(*ls1.get_matrix(), *ls2.get_matrix(), &equal);
+    EXPECT_TRUE( equal );
+}
+
+
+TEST(LinSysPetsc, sparsity_pattern_from_connectivity) {
+    Distribution ds(4, PETSC_COMM_WORLD);
+    const LongIdx first = ds.begin(), next = ds.end() % ds.size();
+    auto pattern = std::make_shared<SparsityPattern>(ds.lsize());
+
+    // chain of local rows coupled to the first row of the next process, repeated entries are counted once
+    for (LongIdx i=first; i<first+3; i++) {
+        std::vector<LongIdx> dofs = { i, i+1 };
+        pattern->add_entries(ds, 2, dofs.data(), 2, dofs.data());
+        pattern->add_entries(ds, 2, dofs.data(), 2, dofs.data());
+    }
+    std::vector<LongIdx> dofs = { first+3, next };
+    pattern->add_entries(ds, 2, dofs.data(), 2, dofs.data());
+    pattern->assemble(ds);
+
+    EXPECT_TRUE( pattern->is_complete() );
+    // first row gets the coupling from the previous process
+    bool single = (ds.np() == 1);
+    EXPECT_EQ( single ? 3 : 2, pattern->on_nz()[0] );
+    EXPECT_EQ( single ? 0 : 1, pattern->off_nz()[0] );
+    EXPECT_EQ( 3, pattern->on_nz()[1] );
+    EXPECT_EQ( single ? 3 : 2, pattern->on_nz()[3] );
+    EXPECT_EQ( single ? 0 : 1, pattern->off_nz()[3] );
+
+    // system preallocated by the pattern skips the counting pass
+    LinSys_PETSC ls(&ds);
+    ls.set_sparsity_pattern(pattern);
+    ls.start_allocation();
+    ls.start_add_assembly();
+    std::vector<double> vals = { 1.0, -1.0, -1.0, 1.0 };
+    for (LongIdx i=first; i<first+3; i++) {
+        std::vector<LongIdx> dofs = { i, i+1 };
+        ls.mat_set_values(2, dofs.data(), 2, dofs.data(), vals.data());
+    }
+    ls.mat_set_values(2, dofs.data(), 2, dofs.data(), vals.data());
+    ls.finish_assembly();
+    EXPECT_EQ( pattern, ls.get_sparsity_pattern() );
+}
+
+/// Assemble 1D Laplace with Dirichlet ends and unit right hand side.
+void assemble_laplace(LinSys_PETSC &ls, const Distribution &ds)
+{
+    for (unsigned int pass=0; pass<2; pass++) {
+        if (pass == 0) ls.start_allocation();
+        else ls.start_add_assembly();
+        for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+            int row = i;
+            std::vector<int> cols = { row };
+            std::vector<double> vals = { 2.0 };
+            if (i > 0) { cols.push_back(row-1); vals.push_back(-1.0); }
+            if (i < ds.size()-1) { cols.push_back(row+1); vals.push_back(-1.0); }
+            ls.mat_set_values(1, &row, cols.size(), cols.data(), vals.data());
+            double rhs_val = 1.0;
+            ls.rhs_set_values(1, &row, &rhs_val);
+        }
+    }
+    ls.finish_assembly();
+}
+
+class LinSysRefinementTest : public LinSys_PETSC {
+public:
+    LinSysRefinementTest(Distribution *ds, double inner_r_tol)
+    : LinSys_PETSC(ds, "-ksp_type cg -pc_type jacobi")
+    {
+        refinement_r_tol_ = inner_r_tol;
+        set_tolerances(1e-10, 1e-14, 1000);
+    }
+};
+
+
+TEST(LinSysPetsc, iterative_refinement) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSysRefinementTest ls(&ds, 1e-2);
+    ls.set_solution();
+    ls.set_positive_definite();
+
+    assemble_laplace(ls, ds);
+
+    LinSys::SolveInfo si = ls.solve();
+    EXPECT_GT(si.converged_reason, 0);
+    double rhs_norm;
+    VecNorm(*ls.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_LT(ls.compute_residual(), 1e-9 * rhs_norm);
+}
+
+
+class LinSysReductionsTest : public LinSys_PETSC {
+public:
+    LinSysReductionsTest(Distribution *ds)
+    : LinSys_PETSC(ds, "-ksp_type cg -pc_type jacobi")
+    {
+        log_reductions_ = true;
+        setup_reduction_log();
+        set_tolerances(1e-10, 1e-14, 1000);
+    }
+};
+
+
+TEST(LinSysPetsc, log_reductions) {
+    Profiler::instance();
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+
+    // the second system does not install the log handlers again
+    for (unsigned int i=0; i<2; i++) {
+        LinSysReductionsTest ls(&ds);
+        ls.set_solution();
+        ls.set_positive_definite();
+        assemble_laplace(ls, ds);
+        LinSys::SolveInfo si = ls.solve();
+        EXPECT_GT(si.converged_reason, 0);
+        EXPECT_GT(si.n_iterations, 1);
+    }
+
+#ifdef FLOW123D_DEBUG_PROFILER
+    std::stringstream profiler_output;
+    Profiler::instance()->output(PETSC_COMM_WORLD, profiler_output);
+    EXPECT_NE(profiler_output.str().find("PETSC global reductions"), std::string::npos);
+#endif
+}
+
+
+TEST(LinSysPetsc, solve_with_operator) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSys_PETSC ls1(&ds, "-ksp_type cg -pc_type jacobi"), ls2(&ds);
+    ls1.set_tolerances(1e-10, 1e-14, 1000);
+    ls1.set_solution();
+    ls2.set_solution();
+    ls2.share_sparsity_pattern(ls1);
+
+    // the same 1D Laplace, different right hand sides
+    for (unsigned int pass=0; pass<2; pass++) {
+        for (LinSys_PETSC *ls : {&ls1, &ls2}) {
+            if (pass == 0) ls->start_allocation();
+            else ls->start_add_assembly();
+        }
+        for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+            int row = i;
+            std::vector<int> cols = { row };
+            std::vector<double> vals = { 2.0 };
+            if (i > 0) { cols.push_back(row-1); vals.push_back(-1.0); }
+            if (i < ds.size()-1) { cols.push_back(row+1); vals.push_back(-1.0); }
+            double rhs1 = 1.0, rhs2 = i;
+            ls1.mat_set_values(1, &row, cols.size(), cols.data(), vals.data());
+            ls1.rhs_set_values(1, &row, &rhs1);
+            ls2.mat_set_values(1, &row, cols.size(), cols.data(), vals.data());
+            ls2.rhs_set_values(1, &row, &rhs2);
+        }
+    }
+    ls1.finish_assembly();
+    ls2.finish_assembly();
+
+    EXPECT_GT(ls1.solve().converged_reason, 0);
+    // matrix of ls2 is assembled only to check the residual
+    LinSys::SolveInfo si = ls2.solve_with_operator(ls1);
+    EXPECT_GT(si.converged_reason, 0);
+    double rhs_norm;
+    VecNorm(*ls2.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_LT(ls2.compute_residual(), 1e-8 * rhs_norm);
+}
+
+
+TEST(LinSysPetsc, release_matrix) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSys_PETSC ls1(&ds, "-ksp_type cg -pc_type jacobi"), ls2(&ds);
+    ls1.set_tolerances(1e-10, 1e-14, 1000);
+    ls1.set_solution();
+    ls2.set_solution();
+    ls2.share_sparsity_pattern(ls1);
+    assemble_laplace(ls1, ds);
+    assemble_laplace(ls2, ds);
+    EXPECT_GT(ls1.solve().converged_reason, 0);
+
+    // right hand side of the system without matrix is assembled and solved by the operator of ls1
+    ls2.release_matrix();
+    EXPECT_EQ(nullptr, *ls2.get_matrix());
+    ls2.start_add_assembly();
+    ls2.rhs_zero_entries();
+    for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+        int row = i;
+        double rhs_val = 2.0;
+        ls2.rhs_set_values(1, &row, &rhs_val);
+    }
+    ls2.finish_assembly();
+    EXPECT_GT(ls2.solve_with_operator(ls1).converged_reason, 0);
+    double solution_norm_1, solution_norm_2;
+    VecNorm(ls1.get_solution(), NORM_2, &solution_norm_1);
+    VecNorm(ls2.get_solution(), NORM_2, &solution_norm_2);
+    EXPECT_NEAR(2.0 * solution_norm_1, solution_norm_2, 1e-6 * solution_norm_2);
+
+    // the matrix is created again with the shared pattern, the solution is twice the solution for the unit rhs
+    ls2.rhs_zero_entries();
+    assemble_laplace(ls2, ds);
+    EXPECT_NE(nullptr, *ls2.get_matrix());
+    double rhs_norm;
+    VecNorm(*ls2.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_NEAR(rhs_norm, ls2.compute_residual(), 1e-6 * rhs_norm);
+}
+
+
+TEST(LinSysPetsc, shared_operator_refinement) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSysRefinementTest ls1(&ds, 1e-2), ls2(&ds, 1e-2);
+    ls1.set_solution();
+    ls2.set_solution();
+    ls1.set_positive_definite();
+    ls2.share_sparsity_pattern(ls1);
+    assemble_laplace(ls1, ds);
+    assemble_laplace(ls2, ds);
+    EXPECT_GT(ls1.solve().converged_reason, 0);
+
+    // KSP of ls1 has single precision operator and relaxed tolerance, the shared solve has to be refined
+    ls2.release_matrix();
+    ls2.start_add_assembly();
+    ls2.rhs_zero_entries();
+    for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+        int row = i;
+        double rhs_val = 2.0 + 0.1*i;
+        ls2.rhs_set_values(1, &row, &rhs_val);
+    }
+    ls2.finish_assembly();
+    EXPECT_GT(ls2.solve_with_operator(ls1).converged_reason, 0);
+
+    // residual of the second system with the full precision matrix of the first one
+    Vec residual;
+    double rhs_norm, residual_norm;
+    VecDuplicate(*ls2.get_rhs(), &residual);
+    MatMult(*ls1.get_matrix(), ls2.get_solution(), residual);
+    VecAXPY(residual, -1.0, *ls2.get_rhs());
+    VecNorm(residual, NORM_2, &residual_norm);
+    VecNorm(*ls2.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_LT(residual_norm, 1e-9 * rhs_norm);
+    VecDestroy(&residual);
+}
+
+
+class LinSysDirectTest : public LinSys_PETSC {
+public:
+    LinSysDirectTest(Distribution *ds)
+    : LinSys_PETSC(ds, "-ksp_type cg -pc_type jacobi")
+    {}
+
+    /// Return true if the KSP and the preconditioner of the solved system are of given types.
+    bool has_types(KSPType ksp_type, PCType pc_type)
+    {
+        PC pc;
+        PetscBool same_ksp, same_pc;
+        KSPGetPC(system, &pc);
+        PetscObjectTypeCompare((PetscObject)system, ksp_type, &same_ksp);
+        PetscObjectTypeCompare((PetscObject)pc, pc_type, &same_pc);
+        return same_ksp && same_pc;
+    }
+};
+
+
+/// Direct solver is not used in parallel without MUMPS.
+bool direct_solver_available(const Distribution &ds)
+{
+#ifdef PETSC_HAVE_MUMPS
+    return true;
+#else
+    return ds.np() == 1;
+#endif
+}
+
+
+TEST(LinSysPetsc, direct_solver) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSysDirectTest ls(&ds);
+    ls.set_tolerances(1e-10, 1e-14, 1000);
+    ls.set_solution();
+    ls.set_positive_definite();
+    ls.set_direct_solver();
+
+    // 1D Laplace, the second solve has changed right hand side only and reuses the factorization
+    for (unsigned int pass=0; pass<3; pass++) {
+        if (pass == 0) ls.start_allocation();
+        else ls.start_add_assembly();
+        if (pass == 2) ls.rhs_zero_entries();
+        for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+            int row = i;
+            std::vector<int> cols = { row };
+            std::vector<double> vals = { 2.0 };
+            if (i > 0) { cols.push_back(row-1); vals.push_back(-1.0); }
+            if (i < ds.size()-1) { cols.push_back(row+1); vals.push_back(-1.0); }
+            if (pass < 2) ls.mat_set_values(1, &row, cols.size(), cols.data(), vals.data());
+            double rhs_val = (pass < 2) ? 1.0 : i;
+            ls.rhs_set_values(1, &row, &rhs_val);
+        }
+        if (pass == 0) continue;
+        ls.finish_assembly();
+        if (pass == 2) ls.set_matrix_changed(false);
+
+        LinSys::SolveInfo si = ls.solve();
+        EXPECT_GT(si.converged_reason, 0);
+        double rhs_norm;
+        VecNorm(*ls.get_rhs(), NORM_2, &rhs_norm);
+        EXPECT_LT(ls.compute_residual(), 1e-8 * rhs_norm);
+        // Cholesky factorization of the positive definite system
+        if (direct_solver_available(ds)) EXPECT_TRUE(ls.has_types(KSPPREONLY, PCCHOLESKY));
+        else EXPECT_TRUE(ls.has_types(KSPCG, PCJACOBI));
+    }
+}
+
+
+TEST(LinSysPetsc, direct_solver_lu) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSysDirectTest ls(&ds);
+    ls.set_tolerances(1e-10, 1e-14, 1000);
+    ls.set_solution();
+    ls.set_direct_solver();
+    assemble_laplace(ls, ds);
+
+    EXPECT_GT(ls.solve().converged_reason, 0);
+    double rhs_norm;
+    VecNorm(*ls.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_LT(ls.compute_residual(), 1e-8 * rhs_norm);
+    // system is not marked as positive definite
+    if (direct_solver_available(ds)) EXPECT_TRUE(ls.has_types(KSPPREONLY, PCLU));
+}
+
+
+TEST(LinSysPetsc, near_null_space) {
+    const unsigned int lsize = 20;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    LinSys_PETSC ls(&ds, "-ksp_type cg -pc_type gamg");
+    ls.set_tolerances(1e-10, 1e-14, 1000);
+    ls.set_solution();
+    ls.set_positive_definite();
+    ls.set_block_size(2);
+
+    // two interleaved components, constants of both are the near null space, their sum is dropped
+    std::vector<Vec> basis(3);
+    for (unsigned int k=0; k<3; k++) {
+        VecCreateMPI(PETSC_COMM_WORLD, lsize, PETSC_DECIDE, &basis[k]);
+        for (unsigned int i=ds.begin(); i<ds.end(); i++)
+            VecSetValue(basis[k], i, (k == 2 || i%2 == k) ? 1.0 : 0.0, INSERT_VALUES);
+        VecAssemblyBegin(basis[k]);
+        VecAssemblyEnd(basis[k]);
+    }
+    ls.set_near_null_space(basis);
+    for (Vec &v : basis) VecDestroy(&v);
+
+    // 1D Laplace for every component
+    for (unsigned int pass=0; pass<2; pass++) {
+        if (pass == 0) ls.start_allocation();
+        else ls.start_add_assembly();
+        for (unsigned int i=ds.begin(); i<ds.end(); i++) {
+            int row = i;
+            std::vector<int> cols = { row };
+            std::vector<double> vals = { 2.0 };
+            if (i > 1) { cols.push_back(row-2); vals.push_back(-1.0); }
+            if (i < ds.size()-2) { cols.push_back(row+2); vals.push_back(-1.0); }
+            ls.mat_set_values(1, &row, cols.size(), cols.data(), vals.data());
+            double rhs_val = 1.0 + i%2;
+            ls.rhs_set_values(1, &row, &rhs_val);
+        }
+    }
+    ls.finish_assembly();
+
+    PetscInt block_size;
+    MatGetBlockSize(*ls.get_matrix(), &block_size);
+    EXPECT_EQ(2, block_size);
+    MatNullSpace nsp;
+    MatGetNearNullSpace(*ls.get_matrix(), &nsp);
+    ASSERT_NE(nullptr, nsp);
+    PetscBool has_const;
+    PetscInt n_vecs;
+    const Vec *vecs;
+    MatNullSpaceGetVecs(nsp, &has_const, &n_vecs, &vecs);
+    EXPECT_EQ(2, n_vecs);
+
+    LinSys::SolveInfo si = ls.solve();
+    EXPECT_GT(si.converged_reason, 0);
+    double rhs_norm;
+    VecNorm(*ls.get_rhs(), NORM_2, &rhs_norm);
+    EXPECT_LT(ls.compute_residual(), 1e-8 * rhs_norm);
+}
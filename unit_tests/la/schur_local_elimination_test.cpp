@@ -0,0 +1,235 @@
+/*
+ * schur_local_elimination_test.cpp
+ *
+ * Compare formation of the Schur complement by PETSc matrix products
+ * and by the local elimination of diagonal blocks.
+ */
+
+#define TEST_USE_PETSC
+
+#include "flow_gtest_mpi.hh"
+
+#include "la/distribution.hh"
+#include "la/schur.hh"
+#include "la/linsys_PETSC.hh"
+#include "system/sys_profiler.hh"
+
+#include <petscmat.h>
+#include <vector>
+
+
+/**
+ * Saddle point system with structure of the mixed-hybrid Darcy flow:
+ * each 'element' has block of @p block_size velocity dofs (block A),
+ * one pressure dof and one edge dof shared with the next element (block B).
+ */
+class SchurLocalTest : public SchurComplement {
+public:
+    SchurLocalTest(Distribution *ds, IS ia, unsigned int n_elements, unsigned int block_size)
+    : SchurComplement(ds, ia), n_el_(n_elements), bs_(block_size), asym_(1.0)
+    {}
+
+    static Distribution *make_distribution(unsigned int n_elements, unsigned int block_size)
+    { return new Distribution(n_elements * (block_size + 2), PETSC_COMM_WORLD); }
+
+    void fill(double factor) {
+        int rank, np;
+        MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+        MPI_Comm_size(PETSC_COMM_WORLD, &np);
+        const int rank_size = n_el_ * (bs_ + 2);
+        const int begin = rank * rank_size;
+        const int a_end = begin + n_el_ * bs_;
+
+        for (unsigned int el=0; el<n_el_; el++) {
+            int press = a_end + el;
+            int edge = a_end + n_el_ + el;
+            int next_edge = edge + 1;
+            if (el == n_el_-1) next_edge = (rank < np-1) ? (begin + rank_size + n_el_ * bs_ + n_el_) : edge;
+
+            std::vector<int> rows(bs_);
+            std::vector<double> a_vals(bs_ * bs_);
+            for (unsigned int i=0; i<bs_; i++) {
+                rows[i] = begin + el * bs_ + i;
+                for (unsigned int j=0; j<bs_; j++)
+                    a_vals[i*bs_ + j] = factor * ( (i==j) ? 4.0 + el % 3 : 1.0 );
+            }
+            mat_set_values(bs_, &rows[0], bs_, &rows[0], &a_vals[0]);
+
+            for (unsigned int i=0; i<bs_; i++) {
+                int cols[2] = { press, (i%2 == 0) ? edge : next_edge };
+                double vals[2] = { -1.0, 1.0 };
+                double t_vals[2] = { asym_ * vals[0], asym_ * vals[1] };
+                mat_set_values(1, &rows[i], 2, cols, vals);
+                mat_set_values(2, cols, 1, &rows[i], t_vals);
+            }
+            double c_val = 0.5 * factor;
+            mat_set_values(1, &press, 1, &press, &c_val);
+            mat_set_values(1, &edge, 1, &edge, &c_val);
+
+            double rhs_val = 1.0;
+            rhs_set_values(1, &press, &rhs_val);
+        }
+    }
+
+    void assemble(double factor) {
+        start_add_assembly();
+        mat_zero_entries();
+        rhs_zero_entries();
+        fill(factor);
+        finish_assembly();
+        set_matrix_changed();
+    }
+
+    using SchurComplement::form_schur;
+
+    unsigned int n_el_, bs_;
+    double asym_;      ///< Factor of the B' block, the system is nonsymmetric if not 1.
+};
+
+
+SchurLocalTest *make_schur(Distribution *ds, unsigned int n_el, unsigned int bs, bool local, double asym = 1.0) {
+    IS is;
+    ISCreateStride(PETSC_COMM_WORLD, n_el * bs, ds->begin(), 1, &is);
+    SchurLocalTest *schur = new SchurLocalTest(ds, is, n_el, bs);
+    schur->asym_ = asym;
+    schur->set_local_elimination(local);
+    schur->set_solution();
+    if (asym == 1.0) schur->set_positive_definite();
+    schur->start_allocation();
+    schur->fill(1.0);
+    schur->start_add_assembly();
+    schur->fill(1.0);
+    schur->finish_assembly();
+
+    LinSys_PETSC *compl_ls = new LinSys_PETSC( schur->make_complement_distribution() );
+    compl_ls->set_tolerances(1e-12, 1e-12, 1000);
+    schur->set_complement(compl_ls);
+    return schur;
+}
+
+
+double matrix_difference(const Mat *a, const Mat *b) {
+    Mat diff;
+    double norm;
+    MatDuplicate(*a, MAT_COPY_VALUES, &diff);
+    MatAXPY(diff, -1.0, *b, DIFFERENT_NONZERO_PATTERN);
+    MatNorm(diff, NORM_FROBENIUS, &norm);
+    MatDestroy(&diff);
+    return norm;
+}
+
+
+TEST(SchurLocalElimination, compare_with_petsc) {
+    Profiler::instance();
+    const unsigned int n_el = 20;
+
+    // symmetric system uses rows of B, nonsymmetric one the cached transposition of B'
+    for (double asym : {1.0, 0.5})
+    for (unsigned int bs=2; bs<=5; bs++) {
+        Distribution *ds_petsc = SchurLocalTest::make_distribution(n_el, bs);
+        Distribution *ds_local = SchurLocalTest::make_distribution(n_el, bs);
+        SchurLocalTest *schur_petsc = make_schur(ds_petsc, n_el, bs, false, asym);
+        SchurLocalTest *schur_local = make_schur(ds_local, n_el, bs, true, asym);
+
+        // first formation creates patterns by PETSc in both cases
+        schur_petsc->solve();
+        schur_local->solve();
+
+        // further formations use local elimination with the cached block patterns
+        for (double factor : {2.0, 3.0}) {
+            schur_petsc->assemble(factor);
+            schur_local->assemble(factor);
+            schur_petsc->solve();
+            schur_local->solve();
+
+            EXPECT_NEAR(0.0, matrix_difference(schur_petsc->get_system()->get_matrix(), schur_local->get_system()->get_matrix()), 1e-12);
+
+            Vec sol_diff;
+            double norm;
+            VecDuplicate(schur_petsc->get_solution(), &sol_diff);
+            VecWAXPY(sol_diff, -1.0, schur_petsc->get_solution(), schur_local->get_solution());
+            VecNorm(sol_diff, NORM_2, &norm);
+            EXPECT_NEAR(0.0, norm, 1e-8);
+            VecDestroy(&sol_diff);
+        }
+
+        delete schur_petsc;
+        delete schur_local;
+        delete ds_petsc;
+        delete ds_local;
+    }
+}
+
+
+TEST(SchurLocalElimination, nonsymmetric_reallocation) {
+    Profiler::instance();
+    const unsigned int n_el = 20, bs = 3;
+
+    Distribution *ds = SchurLocalTest::make_distribution(n_el, bs);
+    IS is;
+    ISCreateStride(PETSC_COMM_WORLD, n_el * bs, ds->begin(), 1, &is);
+    SchurLocalTest *schur = new SchurLocalTest(ds, is, n_el, bs);
+    schur->asym_ = 0.5;
+    schur->set_solution();
+    LinSys_PETSC *compl_ls = new LinSys_PETSC( schur->make_complement_distribution(), "-ksp_type gmres -pc_type jacobi" );
+    compl_ls->set_tolerances(1e-12, 1e-14, 1000);
+    schur->set_complement(compl_ls);
+
+    // the second allocation forms the complement anew
+    for (double factor : {1.0, 2.0}) {
+        schur->start_allocation();
+        schur->fill(factor);
+        schur->start_add_assembly();
+        schur->fill(factor);
+        schur->finish_assembly();
+
+        EXPECT_GT(schur->solve().converged_reason, 0);
+        double rhs_norm;
+        VecNorm(*schur->get_rhs(), NORM_2, &rhs_norm);
+        EXPECT_LT(schur->compute_residual(), 1e-8 * rhs_norm);
+    }
+
+    delete schur;
+    delete ds;
+}
+
+
+#ifdef FLOW123D_RUN_UNIT_BENCHMARKS
+
+TEST(SchurLocalElimination, benchmark) {
+    Profiler::instance();
+    const unsigned int n_el = 100000, n_loops = 20;
+
+    // block sizes of 2D and 3D elements
+    for (unsigned int bs=3; bs<=4; bs++) {
+        Distribution *ds_petsc = SchurLocalTest::make_distribution(n_el, bs);
+        Distribution *ds_local = SchurLocalTest::make_distribution(n_el, bs);
+        SchurLocalTest *schur_petsc = make_schur(ds_petsc, n_el, bs, false);
+        SchurLocalTest *schur_local = make_schur(ds_local, n_el, bs, true);
+        schur_petsc->form_schur();
+        schur_local->form_schur();
+
+        {
+            START_TIMER("form_schur_petsc");
+            for (unsigned int i=0; i<n_loops; i++) {
+                schur_petsc->set_matrix_changed();
+                schur_petsc->form_schur();
+            }
+        }
+        {
+            START_TIMER("form_schur_local");
+            for (unsigned int i=0; i<n_loops; i++) {
+                schur_local->set_matrix_changed();
+                schur_local->form_schur();
+            }
+        }
+
+        delete schur_petsc;
+        delete schur_local;
+        delete ds_petsc;
+        delete ds_local;
+    }
+    Profiler::instance()->output(PETSC_COMM_WORLD, cout);
+}
+
+#endif // FLOW123D_RUN_UNIT_BENCHMARKS
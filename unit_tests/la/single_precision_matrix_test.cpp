@@ -0,0 +1,95 @@
+/*
+ * single_precision_matrix_test.cpp
+ *
+ * Compare product of the single precision copy of a matrix with the product of the original matrix,
+ * including the off-diagonal block and the diagonal scaling.
+ */
+
+#define TEST_USE_PETSC
+
+#include "flow_gtest_mpi.hh"
+
+#include "la/single_precision_matrix.hh"
+#include "system/system.hh"
+
+#include <petscmat.h>
+#include <vector>
+
+
+/// 1D Laplace with values not representable in single precision, the rows are split evenly between processes.
+Mat make_laplace(PetscInt lsize)
+{
+    int np;
+    MPI_Comm_size(PETSC_COMM_WORLD, &np);
+    const PetscInt size = lsize * np;
+
+    Mat mat;
+    chkerr(MatCreateAIJ(PETSC_COMM_WORLD, lsize, lsize, PETSC_DETERMINE, PETSC_DETERMINE, 3, NULL, 2, NULL, &mat));
+    PetscInt begin, end;
+    chkerr(MatGetOwnershipRange(mat, &begin, &end));
+    for (PetscInt row=begin; row<end; row++) {
+        std::vector<PetscInt> cols = { row };
+        std::vector<PetscScalar> vals = { 2.0 + 1.0 / (row + 3) };
+        if (row > 0) { cols.push_back(row-1); vals.push_back(-1.0 / 3); }
+        if (row < size-1) { cols.push_back(row+1); vals.push_back(-1.0 / 7); }
+        chkerr(MatSetValues(mat, 1, &row, cols.size(), cols.data(), vals.data(), INSERT_VALUES));
+    }
+    chkerr(MatAssemblyBegin(mat, MAT_FINAL_ASSEMBLY));
+    chkerr(MatAssemblyEnd(mat, MAT_FINAL_ASSEMBLY));
+    return mat;
+}
+
+
+/// Return max norm of y_1 - y_2 relative to the max norm of y_1.
+double relative_difference(Vec y1, Vec y2)
+{
+    Vec diff;
+    double norm, diff_norm;
+    chkerr(VecDuplicate(y1, &diff));
+    chkerr(VecWAXPY(diff, -1.0, y2, y1));
+    chkerr(VecNorm(y1, NORM_INFINITY, &norm));
+    chkerr(VecNorm(diff, NORM_INFINITY, &diff_norm));
+    chkerr(VecDestroy(&diff));
+    return diff_norm / norm;
+}
+
+
+TEST(SinglePrecisionMatrix, mult) {
+    Mat mat = make_laplace(10);
+    Mat single = SinglePrecisionMatrix::create(mat);
+
+    Vec x, y, y_single, l, r;
+    chkerr(MatCreateVecs(mat, &x, &y));
+    chkerr(VecDuplicate(y, &y_single));
+    chkerr(VecDuplicate(x, &l));
+    chkerr(VecDuplicate(x, &r));
+    PetscInt begin, end;
+    chkerr(VecGetOwnershipRange(x, &begin, &end));
+    for (PetscInt i=begin; i<end; i++) {
+        // nonsymmetric scaling, different values of the neighbours on other processes
+        chkerr(VecSetValue(x, i, 1.0 + 0.1 * i, INSERT_VALUES));
+        chkerr(VecSetValue(l, i, 1.0 + 0.01 * i, INSERT_VALUES));
+        chkerr(VecSetValue(r, i, 2.0 - 0.01 * i, INSERT_VALUES));
+    }
+    for (Vec v : {x, l, r}) {
+        chkerr(VecAssemblyBegin(v));
+        chkerr(VecAssemblyEnd(v));
+    }
+
+    chkerr(MatMult(mat, x, y));
+    chkerr(MatMult(single, x, y_single));
+    double diff = relative_difference(y, y_single);
+    EXPECT_LT(diff, 1e-6);
+    // the copy is really rounded
+    EXPECT_GT(diff, 1e-12);
+
+    chkerr(MatDiagonalScale(mat, l, r));
+    chkerr(MatDiagonalScale(single, l, r));
+    chkerr(MatMult(mat, x, y));
+    chkerr(MatMult(single, x, y_single));
+    EXPECT_LT(relative_difference(y, y_single), 1e-6);
+
+    for (Vec *v : {&x, &y, &y_single, &l, &r}) chkerr(VecDestroy(v));
+    chkerr(MatDestroy(&single));
+    chkerr(MatDestroy(&mat));
+}
@@ -0,0 +1,71 @@
+/*
+ * elasticity_test.cpp
+ *
+ * Rigid body modes of the elasticity are interpolated by the displacement FE field
+ * and compared with exact translations and rotations.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+#include <vector>
+
+#include "mechanics/elasticity.hh"
+#include "fields/field_fe.hh"
+#include "fem/dh_cell_accessor.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+#include "tools/time_governor.hh"
+#include "system/sys_profiler.hh"
+#include "system/system.hh"
+
+
+TEST(Elasticity, rigid_body_modes) {
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+    Profiler::instance();
+    Mesh *mesh = mesh_full_constructor("{mesh_file=\"mesh/cube_2x1.msh\"}");
+    Mechanics::FEObjects feo(mesh, 1);
+    const unsigned int n_own = feo.dh()->distr()->lsize();
+
+    std::vector<Vec> modes;
+    bool interleaved = Elasticity::rigid_body_modes(feo, modes);
+    ASSERT_EQ(6, modes.size());
+    if (interleaved) EXPECT_EQ(0, n_own % 3);
+
+    TimeGovernor tg(0.0, 1.0);
+    for (unsigned int m=0; m<6; m++) {
+        // displacement field given by the mode
+        auto field = create_field_fe<3, FieldValue<3>::VectorFixed>(feo.dh());
+        VectorMPI vec = field->get_data_vec();
+        const PetscScalar *array;
+        chkerr(VecGetArrayRead(modes[m], &array));
+        for (unsigned int i=0; i<n_own; i++) vec[i] = array[i];
+        chkerr(VecRestoreArrayRead(modes[m], &array));
+        vec.local_to_ghost_begin();
+        vec.local_to_ghost_end();
+        field->set_time(tg.step());
+
+        arma::vec3 axis = arma::zeros<arma::vec>(3);
+        axis(m%3) = 1;
+        for (auto cell : feo.dh()->own_range()) {
+            auto elm = cell.elm();
+            arma::vec3 centre = elm.centre();
+            arma::vec3 u_centre = field->value(centre, elm);
+            if (m < 3) {
+                // translation
+                EXPECT_LT(arma::norm(u_centre - axis), 1e-12);
+            } else {
+                // rotation around the axis, independent of the centre of rotation
+                for (unsigned int n=0; n<elm->n_nodes(); n++) {
+                    arma::vec3 node = *elm.node(n);
+                    arma::vec3 u_node = field->value(node, elm);
+                    EXPECT_LT(arma::norm(u_centre - u_node - arma::cross(axis, centre - node)), 1e-12);
+                }
+            }
+        }
+    }
+
+    for (Vec &v : modes) chkerr(VecDestroy(&v));
+    delete mesh;
+}
@@ -56,3 +56,53 @@ TEST(GMSHReader, read_mesh_from_file) {
 
     delete mesh;
 }
+
+
+TEST(GMSHReader, read_binary_and_v41_formats) {
+    Profiler::instance();
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+
+    // reference mesh in ASCII 2.2 format
+	std::string ref_in_string = "{mesh_file=\"mesh/simplest_cube.msh\"}";
+	Mesh * ref_mesh = mesh_constructor(ref_in_string);
+    auto ref_reader = reader_constructor(ref_in_string);
+    ref_reader->read_physical_names(ref_mesh);
+    ref_reader->read_raw_mesh(ref_mesh);
+
+    for (std::string file : {"mesh/simplest_cube_22_bin.msh", "mesh/simplest_cube_41.msh", "mesh/simplest_cube_41_bin.msh"}) {
+        SCOPED_TRACE(file);
+        std::string mesh_in_string = "{mesh_file=\"" + file + "\"}";
+        Mesh * mesh = mesh_constructor(mesh_in_string);
+        auto reader = reader_constructor(mesh_in_string);
+        reader->read_physical_names(mesh);
+        reader->read_raw_mesh(mesh);
+
+        EXPECT_EQ(ref_mesh->n_nodes(), mesh->n_nodes());
+        EXPECT_EQ(ref_mesh->n_elements(), mesh->n_elements());
+        EXPECT_EQ(ref_mesh->n_elements(true), mesh->n_elements(true));
+        for (unsigned int i=0; i<mesh->n_elements(); ++i) {
+            EXPECT_EQ(ref_mesh->element_accessor(i).region().id(), mesh->element_accessor(i).region().id());
+            EXPECT_EQ(ref_mesh->element_accessor(i).dim(), mesh->element_accessor(i).dim());
+            for (unsigned int i_node=0; i_node<mesh->element_accessor(i)->n_nodes(); ++i_node)
+                EXPECT_EQ( ref_mesh->find_node_id(ref_mesh->element_accessor(i)->node_idx(i_node)),
+                           mesh->find_node_id(mesh->element_accessor(i)->node_idx(i_node)) );
+        }
+
+        // ElementData sections of two time frames, read directly from indexed positions
+        mesh->setup_topology();
+        reader->check_compatible_mesh(*mesh);
+        for (double time : {1.0, 0.0, 0.5}) {
+            BaseMeshReader::HeaderQuery header_params("scalar", time, OutputTime::DiscreteSpace::ELEM_DATA);
+            reader->find_header(header_params);
+            typename ElementDataCache<double>::ComponentDataPtr data = reader->get_element_data<double>(9, 1, false, 0);
+            std::vector<double> &vec = *( data.get() );
+            ASSERT_EQ(9, vec.size());
+            double time_shift = (time < 1.0) ? 0.0 : 1.0;
+            for (unsigned int i=0; i<vec.size(); ++i) EXPECT_DOUBLE_EQ( time_shift + 0.1*(i+1), vec[i] );
+        }
+
+        delete mesh;
+    }
+
+    delete ref_mesh;
+}
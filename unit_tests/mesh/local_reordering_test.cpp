@@ -0,0 +1,106 @@
+/*
+ * local_reordering_test.cpp
+ */
+
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest.hh>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <numeric>
+
+#include "mesh/local_reordering.hh"
+
+
+/// Graph of the regular grid nx x ny with shuffled numbering of vertices.
+LocalReordering::Graph shuffled_grid(unsigned int nx, unsigned int ny, std::vector<unsigned int> &vertex_4_grid) {
+    unsigned int n = nx*ny;
+    vertex_4_grid.resize(n);
+    for (unsigned int i=0; i<n; ++i) vertex_4_grid[i] = (37*i) % n;
+
+    std::vector< std::vector<unsigned int> > rows(n);
+    for (unsigned int i=0; i<nx; ++i)
+        for (unsigned int j=0; j<ny; ++j) {
+            unsigned int v = vertex_4_grid[i*ny+j];
+            if (i+1 < nx) {
+                unsigned int w = vertex_4_grid[(i+1)*ny+j];
+                rows[v].push_back(w);
+                rows[w].push_back(v);
+            }
+            if (j+1 < ny) {
+                unsigned int w = vertex_4_grid[i*ny+j+1];
+                rows[v].push_back(w);
+                rows[w].push_back(v);
+            }
+        }
+
+    LocalReordering::Graph graph;
+    graph.offsets.push_back(0);
+    for (auto &row : rows) {
+        graph.adj.insert(graph.adj.end(), row.begin(), row.end());
+        graph.offsets.push_back(graph.adj.size());
+    }
+    return graph;
+}
+
+
+bool is_permutation(const std::vector<unsigned int> &order, unsigned int n) {
+    std::vector<unsigned int> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<unsigned int> identity(n);
+    std::iota(identity.begin(), identity.end(), 0);
+    return sorted == identity;
+}
+
+
+TEST(LocalReordering, reverse_cuthill_mckee) {
+    std::vector<unsigned int> vertex_4_grid;
+    LocalReordering::Graph graph = shuffled_grid(20, 20, vertex_4_grid);
+    std::vector<unsigned int> identity(graph.size());
+    std::iota(identity.begin(), identity.end(), 0);
+
+    std::vector<unsigned int> order = LocalReordering::reverse_cuthill_mckee(graph);
+    EXPECT_TRUE( is_permutation(order, graph.size()) );
+
+    // bandwidth of RCM ordering of the grid is given by the length of its diagonal
+    EXPECT_LE( LocalReordering::bandwidth(graph, order), 21u );
+    EXPECT_GT( LocalReordering::bandwidth(graph, identity), 100u );
+    EXPECT_LT( LocalReordering::cache_misses(graph, order, 8, 8), LocalReordering::cache_misses(graph, identity, 8, 8) );
+
+    // unconnected components
+    LocalReordering::Graph two_vertices;
+    two_vertices.offsets = {0, 0, 0};
+    EXPECT_TRUE( is_permutation(LocalReordering::reverse_cuthill_mckee(two_vertices), 2) );
+}
+
+
+TEST(LocalReordering, hilbert) {
+    // consecutive cells of the curve are neighbours
+    std::vector< std::array<unsigned int, 3> > cell_4_index(512);
+    for (unsigned int x=0; x<8; ++x)
+        for (unsigned int y=0; y<8; ++y)
+            for (unsigned int z=0; z<8; ++z) {
+                unsigned int coords[3] = {x, y, z};
+                unsigned long long index = LocalReordering::hilbert_index(coords, 3);
+                ASSERT_LT(index, 512u);
+                cell_4_index[index] = {x, y, z};
+            }
+    for (unsigned int i=1; i<512; ++i) {
+        int dist = 0;
+        for (unsigned int d=0; d<3; ++d) dist += std::abs( (int)cell_4_index[i][d] - (int)cell_4_index[i-1][d] );
+        EXPECT_EQ(1, dist);
+    }
+
+    // ordering of points of shuffled grid
+    std::vector<unsigned int> vertex_4_grid;
+    LocalReordering::Graph graph = shuffled_grid(16, 16, vertex_4_grid);
+    std::vector<arma::vec3> points(graph.size());
+    for (unsigned int i=0; i<16; ++i)
+        for (unsigned int j=0; j<16; ++j)
+            points[ vertex_4_grid[i*16+j] ] = arma::vec3({ (double)i, (double)j, 0.0 });
+    std::vector<unsigned int> order = LocalReordering::hilbert(points);
+    EXPECT_TRUE( is_permutation(order, graph.size()) );
+    std::vector<unsigned int> identity(graph.size());
+    std::iota(identity.begin(), identity.end(), 0);
+    EXPECT_LT( LocalReordering::cache_misses(graph, order, 8, 8), LocalReordering::cache_misses(graph, identity, 8, 8) );
+}
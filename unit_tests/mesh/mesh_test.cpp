@@ -17,6 +17,7 @@
 #include <vector>
 #include "mesh/accessors.hh"
 #include "mesh/partitioning.hh"
+#include "mesh/neighbours.h"
 #include "input/reader_to_storage.hh"
 #include "system/sys_profiler.hh"
 
@@ -89,6 +90,56 @@ TEST(MeshTopology, make_neighbours_and_edges) {
 }
 
 
+TEST(MeshTopology, compact_arrays) {
+	FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+    Profiler::instance();
+
+    Mesh * mesh = mesh_full_constructor("{mesh_file=\"mesh/simplest_cube.msh\"}");
+    const MeshTopology &topology = mesh->topology();
+
+    EXPECT_TRUE( topology.is_built() );
+    EXPECT_EQ( mesh->n_elements() + mesh->n_elements(true), topology.n_elements() );
+    EXPECT_EQ( mesh->n_edges(), topology.n_edges() );
+    EXPECT_EQ( mesh->n_vb_neighbours(), topology.n_vb_neighbours() );
+    EXPECT_GT( topology.memory_size(), 0u );
+
+    // arrays match data of elements
+    for (auto ele : mesh->elements_range()) {
+        ASSERT_EQ( ele->n_nodes(), topology.elem_n_nodes(ele.idx()) );
+        for (unsigned int i=0; i<ele->n_nodes(); ++i) {
+            EXPECT_EQ( ele->node_idx(i), topology.elem_node(ele.idx(), i) );
+            EXPECT_EQ( ele->node_idx(i), ele.node(i).idx() );
+        }
+        for (unsigned int s=0; s<ele->n_sides(); ++s) {
+            unsigned int side = topology.elem_side(ele.idx(), s);
+            EXPECT_EQ( ele.idx(), topology.side_element(side) );
+            EXPECT_EQ( s, topology.side_local_idx(side) );
+            EXPECT_EQ( ele->edge_idx(s), topology.side_edge(side) );
+            EXPECT_EQ( ele->edge_idx(s), ele.side(s)->edge_idx() );
+            unsigned int bc_idx = (ele->boundary_idx_ == nullptr) ? Mesh::undef_idx : ele->boundary_idx_[s];
+            EXPECT_EQ( bc_idx, ele.side(s)->cond_idx() );
+        }
+        for (unsigned int i=0; i<ele->n_neighs_vb(); ++i) {
+            SideIter side = ele.neigh_vb_side(i);
+            EXPECT_EQ( ele->neigh_vb[i]->side()->elem_idx(), side->elem_idx() );
+            EXPECT_EQ( ele->neigh_vb[i]->side()->side_idx(), side->side_idx() );
+        }
+    }
+
+    // every side of edge points back to the edge
+    unsigned int n_edge_sides = 0;
+    for (auto edg : mesh->edge_range()) {
+        for (unsigned int i=0; i<edg.n_sides(); ++i) {
+            EXPECT_EQ( edg.idx(), edg.side(i)->edge_idx() );
+            n_edge_sides++;
+        }
+    }
+    EXPECT_EQ( mesh->n_sides(), n_edge_sides );
+
+    delete mesh;
+}
+
+
 const string mesh_input = R"YAML(
 mesh_file: "mesh/simplest_cube.msh"
 regions:
@@ -69,3 +69,51 @@ TEST(Partitioning, all) {
 
     delete mesh;
 }
+
+
+const string mesh_reorder_input = R"JSON(
+{
+  mesh_file="mesh/simplest_cube.msh",
+  partitioning={
+    tool="METIS",
+    graph_type="any_neighboring",
+    reordering="rcm",
+    locality_report=true
+  }
+}
+)JSON";
+
+
+TEST(Partitioning, reordering) {
+    Profiler::instance();
+
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+
+    Mesh * mesh = mesh_full_constructor(mesh_reorder_input);
+    EXPECT_TRUE( mesh->get_part()->reorders_elements() );
+
+    // local elements and global rows are consistent after reordering
+    Distribution * el_ds = mesh->get_el_ds();
+    std::vector<bool> found(mesh->n_elements(), false);
+    for(unsigned int i=0; i < el_ds->lsize(); i++) {
+        LongIdx el = mesh->get_el_4_loc()[i];
+        EXPECT_EQ( i+el_ds->begin(), mesh->get_row_4_el()[el] );
+        EXPECT_FALSE( found[el] );
+        found[el] = true;
+    }
+
+    // every global row is used once
+    std::vector<unsigned int> n_rows(mesh->n_elements(), 0);
+    for(unsigned int el=0; el < mesh->n_elements(); el++) n_rows[ mesh->get_row_4_el()[el] ]++;
+    for(unsigned int row=0; row < mesh->n_elements(); row++) EXPECT_EQ( 1, n_rows[row] );
+
+    // local nodes are numbered uniquely
+    std::vector<bool> node_found(mesh->n_nodes(), false);
+    for(unsigned int i=0; i < mesh->n_local_nodes(); i++) {
+        LongIdx node = mesh->get_node_4_loc()[i];
+        EXPECT_FALSE( node_found[node] );
+        node_found[node] = true;
+    }
+
+    delete mesh;
+}
@@ -17,6 +17,7 @@
 
 #include "mesh/mesh.h"
 #include "io/msh_pvdreader.hh"
+#include "io/reader_cache.hh"
 
 
 class PvdMeshReaderTest : public PvdMeshReader {
@@ -90,3 +91,53 @@ TEST(PVDReader, get_element_data) {
         }
     }
 }
+
+
+TEST(PVDReader, repeated_time_frames) {
+    Profiler::instance();
+
+    // has to introduce some flag for passing absolute path to 'test_units' in source tree
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+    FilePath mesh_file("mesh/pvd-test.pvd", FilePath::input_file);
+    ReaderCache::set_data_cache_size(ReaderCache::default_data_cache_size);
+    ElementDataLRU &data_lru = ReaderCache::data_lru();
+
+    PvdMeshReaderTest reader(mesh_file);
+    {
+        std::string mesh_in_string = "{mesh_file=\"fields/simplest_cube_3d.msh\"}";
+        auto gmsh_reader = reader_constructor( mesh_in_string );
+        Mesh * source_mesh = mesh_constructor( mesh_in_string );
+        gmsh_reader->read_physical_names(source_mesh);
+        gmsh_reader->read_raw_mesh(source_mesh);
+        source_mesh->setup_topology();
+        source_mesh->check_and_finish();
+        reader.check_compatible_mesh(*source_mesh);
+        delete source_mesh;
+    }
+
+    // time frames are read forward (prepared by readahead) and then again from decoded data cache
+    std::vector<unsigned int> frames = {0, 1, 2, 0, 2, 1};
+    unsigned int n_hits = data_lru.n_hits();
+    for (unsigned int i : frames) {
+    	BaseMeshReader::HeaderQuery header_params("scalar_field", i*0.1, OutputTime::DiscreteSpace::ELEM_DATA);
+    	reader.find_header(header_params);
+        typename ElementDataCache<double>::ComponentDataPtr scalar_data = reader.get_element_data<double>(6, 1, false, 0);
+        std::vector<double> &vec = *( scalar_data.get() );
+        EXPECT_EQ(6, vec.size());
+        for (unsigned int j=0; j<vec.size(); j++) {
+        	EXPECT_DOUBLE_EQ( (i+j+1)*0.5, vec[j] );
+        }
+    }
+    EXPECT_EQ(n_hits+3, data_lru.n_hits());
+
+    // switch off the cache, data are read from file again
+    ReaderCache::set_data_cache_size(0);
+    EXPECT_EQ(0, data_lru.n_items());
+    {
+    	BaseMeshReader::HeaderQuery header_params("scalar_field", 0.0, OutputTime::DiscreteSpace::ELEM_DATA);
+    	reader.find_header(header_params);
+    	std::vector<double> &vec = *( reader.get_element_data<double>(6, 1, false, 0).get() );
+    	EXPECT_DOUBLE_EQ( 0.5, vec[0] );
+    }
+    ReaderCache::set_data_cache_size(ReaderCache::default_data_cache_size);
+}
@@ -42,6 +42,17 @@ public:
 		return data_format_;
 	}
 
+	/// Returns number of tables of compressed blocks.
+	unsigned int n_block_tables() {
+		return block_tables_.size();
+	}
+
+	/// Returns size of decoded binary data of given field in bytes.
+	std::size_t decoded_data_size(const std::string &field_name) {
+		std::streamoff data_pos = header_table_.find(field_name)->second.position.file_position_;
+		return this->decode_binary_data(data_pos)->size();
+	}
+
 	void read_nodes(Mesh* mesh)
 	{
 		HeaderQuery header_params("Points", 0.0, OutputTime::DiscreteSpace::MESH_DEFINITION);
@@ -249,6 +260,13 @@ TEST(VtkReaderTest, read_compressed_vtu) {
     	EXPECT_EQ( 6, data_attr.n_entities );
     }
 
+    {
+    	// tables of compressed blocks are created during opening of file
+    	EXPECT_EQ( 7, reader->n_block_tables() );
+    	EXPECT_EQ( 6*3*sizeof(double), reader->decoded_data_size("vector_field") );
+    	EXPECT_EQ( 6*9*sizeof(double), reader->decoded_data_size("tensor_field") );
+    }
+
     //delete mesh;
 }
 
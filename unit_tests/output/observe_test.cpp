@@ -26,6 +26,7 @@
 #include "system/armadillo_tools.hh"
 #include "../arma_expect.hh"
 #include <fstream>
+#include <cstring>
 
 
 
@@ -108,8 +109,9 @@ public:
 
 class TestObserve : public Observe {
 public:
-    TestObserve(Mesh &mesh, Input::Array in_array)
-    : Observe("test_eq", mesh, in_array, 6, "s")
+    TestObserve(Mesh &mesh, Input::Array in_array, std::string name = "test_eq", ObserveFormat format = ObserveFormat::yaml,
+            bool use_cache = false)
+    : Observe(name, mesh, in_array, 6, "s", format, use_cache)
     {
         for(auto &point: this->points_) my_points.push_back(TestObservePoint(point));
     }
@@ -284,3 +286,94 @@ TEST(Observe, all) {
         EXPECT_EQ(str_obs_file_ref.str(), str_obs_file.str());
 }
 
+
+TEST(Observe, binary) {
+    Profiler::instance();
+    armadillo_setup();
+    EqData field_set;
+
+    auto output_type = Input::Type::Record("Output", "")
+        .declare_key("observe_points", Input::Type::Array(ObservePoint::get_input_type()), Input::Type::Default::obligatory(), "")
+        .declare_key("input_fields", Input::Type::Array(
+                EqData()
+                .make_field_descriptor_type("SomeEquation")
+                .close() ), Input::Type::Default::obligatory(), "")
+        .close();
+    auto in_rec = Input::ReaderToStorage(test_input, output_type, Input::FileFormat::format_JSON)
+        .get_root_interface<Input::Record>();
+
+    FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/mesh/simplest_cube.msh", FilePath::input_file);
+    Mesh *mesh = mesh_full_constructor("{mesh_file=\"" + (string)mesh_file + "\", global_snap_radius=1.0 }");
+
+    unsigned int n_points;
+    std::vector<double> scalar_values;
+    {
+    std::shared_ptr<TestObserve> obs = std::make_shared<TestObserve>(*mesh, in_rec.val<Input::Array>("observe_points"),
+            "test_bin", Observe::ObserveFormat::binary);
+    n_points = obs->points().size();
+
+    TimeGovernor tg(0.0, 1.0);
+    field_set.set_mesh(*mesh);
+    field_set.set_input_list( in_rec.val<Input::Array>("input_fields"), tg );
+    for (unsigned int i_time=0; i_time<2; ++i_time) {
+        field_set.set_time(tg.step(), LimitSide::right);
+        field_set.scalar_field.observe_output(obs);
+        field_set.enum_field.observe_output(obs);
+        field_set.vector_field.observe_output(obs);
+        field_set.tensor_field.observe_output(obs);
+        obs->output_time_frame( true );
+        tg.next_time();
+    }
+    }
+    if (mesh->get_el_ds()->myp()!=0) return;
+
+    // closed observe file 'test_bin_observe.bin'
+    std::ifstream obs_file("test_bin_observe.bin", std::ios::binary);
+    std::string line;
+    bool fields_found = false;
+    while (std::getline(obs_file, line) && line != "binary_data:")
+        if (line == "fields:") fields_found = true;
+    EXPECT_TRUE(fields_found);
+    ASSERT_EQ("binary_data:", line);
+
+    // fields are ordered by name: enum (uint32), scalar, tensor, vector (float64)
+    unsigned int record_size = sizeof(double) + n_points * (sizeof(unsigned int) + (1 + 9 + 3) * sizeof(double));
+    std::vector<char> record(record_size);
+    for (unsigned int i_time=0; i_time<2; ++i_time) {
+        obs_file.read(&(record[0]), record_size);
+        ASSERT_TRUE(obs_file.good());
+        double time;
+        std::memcpy(&time, &(record[0]), sizeof(double));
+        EXPECT_DOUBLE_EQ(double(i_time), time);
+    }
+    obs_file.read(&(record[0]), 1);
+    EXPECT_TRUE(obs_file.eof());
+}
+
+
+TEST(Observe, points_cache) {
+    Profiler::instance();
+    armadillo_setup();
+
+    auto output_type = Input::Type::Record("Output", "")
+        .declare_key("observe_points", Input::Type::Array(ObservePoint::get_input_type()), Input::Type::Default::obligatory(), "")
+        .declare_key("input_fields", Input::Type::Array(
+                EqData()
+                .make_field_descriptor_type("SomeEquation")
+                .close() ), Input::Type::Default::obligatory(), "")
+        .close();
+    auto in_rec = Input::ReaderToStorage(test_input, output_type, Input::FileFormat::format_JSON)
+        .get_root_interface<Input::Record>();
+
+    FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/mesh/simplest_cube.msh", FilePath::input_file);
+    Mesh *mesh = mesh_full_constructor("{mesh_file=\"" + (string)mesh_file + "\", global_snap_radius=1.0 }");
+    std::remove("test_cache_observe_points.cache");
+
+    // first run writes cache file, second run reads it
+    for (unsigned int i_run=0; i_run<2; ++i_run) {
+        TestObserve obs(*mesh, in_rec.val<Input::Array>("observe_points"), "test_cache", Observe::ObserveFormat::yaml, true);
+        obs.check_points_input();
+        obs.check_observe_points();
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+}
@@ -236,3 +236,35 @@ TEST(ReaderCache, repeat_call) {
         delete mesh;
     }
 }
+
+
+TEST(ReaderCache, data_lru) {
+	ElementDataLRU lru(100);
+	auto key = [](unsigned int reader_id, double time) {
+		return ElementDataLRU::Key(reader_id, "field", time, 1, 10, false, "double");
+	};
+
+	lru.put(key(0, 0.0), std::make_shared< ElementDataCache<double> >("field", 0.0, 1, 5), 40);
+	lru.put(key(0, 1.0), std::make_shared< ElementDataCache<double> >("field", 1.0, 1, 5), 40);
+	EXPECT_EQ(2, lru.n_items());
+	EXPECT_EQ(80, lru.size());
+
+	// time 0.0 is most recently used, time 1.0 is evicted
+	EXPECT_NE(nullptr, lru.get(key(0, 0.0)));
+	lru.put(key(0, 2.0), std::make_shared< ElementDataCache<double> >("field", 2.0, 1, 5), 40);
+	EXPECT_EQ(2, lru.n_items());
+	EXPECT_EQ(nullptr, lru.get(key(0, 1.0)));
+	EXPECT_NE(nullptr, lru.get(key(0, 0.0)));
+	EXPECT_NE(nullptr, lru.get(key(0, 2.0)));
+	EXPECT_EQ(nullptr, lru.get(key(1, 2.0)));
+	EXPECT_EQ(3, lru.n_hits());
+	EXPECT_EQ(2, lru.n_misses());
+
+	// data over budget are not stored
+	lru.put(key(0, 3.0), std::make_shared< ElementDataCache<double> >("field", 3.0, 1, 50), 400);
+	EXPECT_EQ(nullptr, lru.get(key(0, 3.0)));
+
+	lru.set_capacity(50);
+	EXPECT_EQ(1, lru.n_items());
+	EXPECT_NE(nullptr, lru.get(key(0, 2.0)));
+}
@@ -0,0 +1,91 @@
+/*
+ * checkpoint_data_test.cpp
+ */
+
+#define FEAL_OVERRIDE_ASSERTS
+
+#include <flow_gtest.hh>
+#include <cstdio>
+#include <fstream>
+#include "system/checkpoint_data.hh"
+
+
+TEST(CheckpointData, scopes) {
+    CheckpointData data;
+    data.save("value", 1.5);
+    {
+        CheckpointData::Scope scope(data, "flow");
+        data.save("value", 2.5);
+        {
+            CheckpointData::Scope inner(data, "time");
+            data.save("index", 7u);
+        }
+        EXPECT_FALSE( data.contains("index") );
+        EXPECT_TRUE( data.contains("value") );
+    }
+    EXPECT_EQ(3, data.n_records());
+
+    double value;
+    data.load("value", value);
+    EXPECT_DOUBLE_EQ(1.5, value);
+    data.push_scope("flow");
+    data.load("value", value);
+    EXPECT_DOUBLE_EQ(2.5, value);
+    data.pop_scope();
+}
+
+
+TEST(CheckpointData, file_roundtrip) {
+    std::vector<double> vec = {1.0, -2.0, 3.5};
+    double array[4] = {0.5, 1.5, 2.5, 3.5};
+    {
+        CheckpointData data;
+        data.save("flag", true);
+        data.save("vec", vec);
+        data.save("empty", std::vector<unsigned int>());
+        data.save("name", std::string("solute"));
+        data.save_array("array", array, 4);
+        data.write("checkpoint_data_test.bin");
+    }
+
+    CheckpointData data;
+    data.read("checkpoint_data_test.bin");
+    EXPECT_EQ(5, data.n_records());
+
+    bool flag = false;
+    std::vector<double> vec_in;
+    std::vector<unsigned int> empty_in(3);
+    std::string name;
+    double array_in[4];
+    data.load("flag", flag);
+    data.load("vec", vec_in);
+    data.load("empty", empty_in);
+    data.load("name", name);
+    data.load_array("array", array_in, 4);
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(vec, vec_in);
+    EXPECT_EQ(0, empty_in.size());
+    EXPECT_EQ("solute", name);
+    for (unsigned int i=0; i<4; ++i) EXPECT_DOUBLE_EQ(array[i], array_in[i]);
+    std::remove("checkpoint_data_test.bin");
+}
+
+
+TEST(CheckpointData, errors) {
+    CheckpointData data;
+    double array[3] = {1.0, 2.0, 3.0};
+    data.save_array("array", array, 3);
+
+    // different local size (e.g. different partitioning)
+    double array_in[4];
+    EXPECT_THROW( data.load_array("array", array_in, 4), CheckpointData::ExcRecordSize );
+    EXPECT_THROW( data.load_array("missing", array_in, 4), CheckpointData::ExcMissingRecord );
+
+    {
+        std::ofstream out("checkpoint_data_wrong.bin");
+        out << "not a checkpoint file";
+    }
+    EXPECT_THROW( data.read("checkpoint_data_wrong.bin"), CheckpointData::ExcCheckpointFormat );
+    EXPECT_THROW( data.read("checkpoint_data_none.bin"), CheckpointData::ExcCheckpointFile );
+    std::remove("checkpoint_data_wrong.bin");
+}
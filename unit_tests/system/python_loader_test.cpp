@@ -120,6 +120,26 @@ TEST(PythonLoader, traceback_error) {
 }
 
 
+/**
+ * References held by PyObjectRef are released when the error of a python call is thrown.
+ */
+TEST(PythonLoader, object_ref_released_on_error) {
+    PyObject * module = PythonLoader::load_module_from_string("func_xyz", produce_error);
+    PyObject * func = PyObject_GetAttrString(module, "func_xyz");
+    PyObject * value = PyFloat_FromDouble(0.5);
+    Py_ssize_t refcount = Py_REFCNT(value);
+
+    EXPECT_THROW( {
+        Py_INCREF(value);
+        PyObjectRef ref(value);
+        PyObjectRef result( PyObject_CallFunction(func, NULL) );
+        PythonLoader::check_error();
+    }, PythonLoader::ExcPythonError);
+    EXPECT_EQ(refcount, Py_REFCNT(value));
+    Py_DECREF(value);
+}
+
+
 // only test embedded python if we actually copied out Python
 // this tests only checks if embedded python is loading modules from correct
 // location. This cannot be tested if python was not copied out.
@@ -15,6 +15,7 @@
 #include "tools/time_governor.hh"
 #include "tools/time_marks.hh"
 #include "tools/unit_converter.hh"
+#include "system/checkpoint_data.hh"
 
 
 
@@ -678,3 +679,42 @@ TEST(TimeGovernor, dt_limits_table) {
 	    EXPECT_EQ(str_ref_file.str(), str_out_file.str());
     }
 }
+
+
+TEST(TimeGovernor, save_restore_state) {
+    TimeGovernor::marks().reinit();
+    string tg_in="{time = { start_time = 0.0, end_time = 100.0, max_dt = 10.0 } }";
+    CheckpointData data;
+    double saved_t, saved_dt, saved_last_dt;
+    {
+        TimeGovernor tg( read_input(tg_in) );
+        tg.marks().add(TimeMark(15, tg.equation_fixed_mark_type()));
+        tg.set_upper_constraint(4, "Constraint of the first step.");
+        tg.next_time();
+        tg.next_time();
+        tg.set_upper_constraint(2.5, "Constraint of the third step.");
+        tg.next_time();
+        EXPECT_EQ(3, tg.step().index());
+        saved_t = tg.t();
+        saved_dt = tg.dt();
+        saved_last_dt = tg.last_dt();
+        tg.save_state(data);
+        tg.marks().save_state(data);
+    }
+
+    // same setup, restore state and continue
+    TimeGovernor::marks().reinit();
+    TimeGovernor tg( read_input(tg_in) );
+    tg.marks().restore_state(data);
+    tg.restore_state(data);
+    EXPECT_EQ(3, tg.step().index());
+    EXPECT_DOUBLE_EQ(saved_t, tg.t());
+    EXPECT_DOUBLE_EQ(saved_dt, tg.dt());
+    EXPECT_DOUBLE_EQ(saved_last_dt, tg.last_dt());
+
+    // fixed mark added before the checkpoint is reached after restart
+    tg.next_time();
+    tg.next_time();
+    while (tg.t() < 15 - TimeGovernor::time_step_precision) tg.next_time();
+    EXPECT_DOUBLE_EQ(15, tg.t());
+}
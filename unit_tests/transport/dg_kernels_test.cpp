@@ -0,0 +1,180 @@
+/*
+ * dg_kernels_test.cpp
+ *
+ * Compare local matrices of the DG transport computed by dense contractions
+ * of shape function tables with the generic loops.
+ */
+
+#define FEAL_OVERRIDE_ASSERTS
+
+#include <flow_gtest.hh>
+#include <cmath>
+#include <vector>
+#include "armadillo"
+#include "system/sys_profiler.hh"
+#include "quadrature/quadrature_lib.hh"
+#include "fem/fe_p.hh"
+#include "fem/fe_values.hh"
+#include "mesh/mesh.h"
+#include "mesh/elements.h"
+#include "mesh/accessors.hh"
+#include "transport/assembly_dg_kernels.hh"
+
+
+/// Tetrahedron with shape tables of the discontinuous P1 or P2 element and random coefficients.
+class DGKernelsTest {
+public:
+    DGKernelsTest(unsigned int order)
+    : fe_(order), quad_(3, 2*order)
+    {
+        mesh_.init_node_vector(4);
+        mesh_.add_node(0, arma::vec3("0.1 0 0"));
+        mesh_.add_node(1, arma::vec3("2 0.3 0"));
+        mesh_.add_node(2, arma::vec3("0.5 1.5 0.2"));
+        mesh_.add_node(3, arma::vec3("0.4 0.6 1.8"));
+        std::vector<unsigned int> node_ids = {0, 1, 2, 3};
+        mesh_.init_element_vector(1);
+        mesh_.add_element(1, 3, 1, 0, node_ids);
+
+        FEValues<3> fv(quad_, fe_, update_values | update_gradients | update_JxW_values);
+        fv.reinit(mesh_.element_accessor(0));
+        tables.fill(fv, order <= 1);
+
+        arma::arma_rng::set_seed(order);
+        for (unsigned int k=0; k<quad_.size(); k++) {
+            arma::mat33 B(arma::fill::randu);
+            K.push_back(B.t()*B + arma::eye(3,3));
+            a.push_back(arma::vec3(arma::fill::randn));
+            sigma.push_back(arma::as_scalar(arma::randu(1)));
+        }
+    }
+
+    /// Shape tables of a side with random values, gradients and weights.
+    static DGKernels::ShapeTables random_side(unsigned int n_dofs, unsigned int n_points, bool const_grads) {
+        DGKernels::ShapeTables t;
+        t.const_grads = const_grads;
+        t.values.randu(n_dofs, n_points);
+        t.grads.resize(const_grads ? 1 : n_points);
+        for (arma::mat &g : t.grads) g.randn(n_dofs, 3);
+        t.JxW.randu(n_points);
+        return t;
+    }
+
+    Mesh mesh_;
+    FE_P_disc<3> fe_;
+    QGauss quad_;
+
+    DGKernels::ShapeTables tables;
+    std::vector<arma::mat33> K;
+    std::vector<arma::vec3> a;
+    std::vector<double> sigma;
+};
+
+
+double relative_difference(const arma::mat &A, const arma::mat &B) {
+    return arma::norm(A - B, "fro") / arma::norm(B, "fro");
+}
+
+
+TEST(DGKernels, volume_matrix) {
+    for (unsigned int order=1; order<=2; order++) {
+        DGKernelsTest test(order);
+        arma::mat A, A_generic;
+        DGKernels::volume_matrix(test.tables, test.K, test.a, test.sigma, A);
+        DGKernels::volume_matrix_generic(test.tables, test.K, test.a, test.sigma, A_generic);
+        EXPECT_EQ(test.fe_.n_dofs(), A.n_rows);
+        EXPECT_LT(relative_difference(A, A_generic), 1e-13);
+
+        // P1 gradients are constant, evaluation with gradients at every point gives the same matrix
+        if (order == 1) {
+            DGKernels::ShapeTables full = test.tables;
+            full.const_grads = false;
+            full.grads.assign(test.quad_.size(), test.tables.grads[0]);
+            DGKernels::volume_matrix(full, test.K, test.a, test.sigma, A_generic);
+            EXPECT_LT(relative_difference(A, A_generic), 1e-13);
+        }
+    }
+}
+
+
+TEST(DGKernels, edge_matrix) {
+    const unsigned int n_points = 6;
+    std::vector<arma::mat33> K(n_points, arma::mat33("2 0.5 0; 0.5 1 0; 0 0 3"));
+    arma::vec3 normal("0.6 0 0.8");
+
+    for (unsigned int n_dofs : {4, 10}) {
+        DGKernels::ShapeTables t1 = DGKernelsTest::random_side(n_dofs, n_points, n_dofs == 4);
+        DGKernels::ShapeTables t2 = DGKernelsTest::random_side(n_dofs, n_points, n_dofs == 4);
+        arma::mat W1, W2, A, A_generic;
+        DGKernels::normal_derivatives(t1, K, normal, 0.3, W1);
+        DGKernels::normal_derivatives(t2, K, normal, 0.7, W2);
+        EXPECT_NEAR(0.3 * arma::dot(K[0] * t1.grad(2).row(1).t(), normal), W1(1,2), 1e-14);
+
+        for (double variant : {-1.0, 0.0, 1.0}) {
+            DGKernels::edge_matrix(t1, W1, 1, t2, W2, -1, t1.JxW, -0.4, 2.5, variant, A);
+            DGKernels::edge_matrix_generic(t1, W1, 1, t2, W2, -1, t1.JxW, -0.4, 2.5, variant, A_generic);
+            EXPECT_LT(relative_difference(A, A_generic), 1e-13);
+
+            DGKernels::edge_matrix(t2, W2, -1, t2, W2, -1, t1.JxW, 0.4, 2.5, variant, A);
+            DGKernels::edge_matrix_generic(t2, W2, -1, t2, W2, -1, t1.JxW, 0.4, 2.5, variant, A_generic);
+            EXPECT_LT(relative_difference(A, A_generic), 1e-13);
+        }
+    }
+}
+
+
+#ifdef FLOW123D_RUN_UNIT_BENCHMARKS
+
+TEST(DGKernels, benchmark) {
+    Profiler::instance();
+    // number of elements of a medium 3D transport mesh
+    const unsigned int n_elements = 200000;
+
+    for (unsigned int order=1; order<=2; order++) {
+        DGKernelsTest test(order);
+        arma::mat A;
+        double sum = 0;
+        {
+            START_TIMER("volume_matrix_generic");
+            for (unsigned int i=0; i<n_elements; i++) {
+                DGKernels::volume_matrix_generic(test.tables, test.K, test.a, test.sigma, A);
+                sum += A(0,0);
+            }
+        }
+        {
+            START_TIMER("volume_matrix");
+            for (unsigned int i=0; i<n_elements; i++) {
+                DGKernels::volume_matrix(test.tables, test.K, test.a, test.sigma, A);
+                sum -= A(0,0);
+            }
+        }
+
+        // sides of a tetrahedron with quadrature of the triangle
+        unsigned int n_dofs = test.fe_.n_dofs();
+        QGauss side_quad(2, 2*order);
+        DGKernels::ShapeTables t1 = DGKernelsTest::random_side(n_dofs, side_quad.size(), order <= 1);
+        DGKernels::ShapeTables t2 = DGKernelsTest::random_side(n_dofs, side_quad.size(), order <= 1);
+        std::vector<arma::mat33> K(side_quad.size(), test.K[0]);
+        arma::mat W1, W2;
+        DGKernels::normal_derivatives(t1, K, arma::vec3("0 0 1"), 0.5, W1);
+        DGKernels::normal_derivatives(t2, K, arma::vec3("0 0 1"), 0.5, W2);
+        {
+            START_TIMER("edge_matrix_generic");
+            for (unsigned int i=0; i<2*n_elements; i++) {
+                DGKernels::edge_matrix_generic(t1, W1, 1, t2, W2, -1, t1.JxW, 0.4, 2.5, -1, A);
+                sum += A(0,0);
+            }
+        }
+        {
+            START_TIMER("edge_matrix");
+            for (unsigned int i=0; i<2*n_elements; i++) {
+                DGKernels::edge_matrix(t1, W1, 1, t2, W2, -1, t1.JxW, 0.4, 2.5, -1, A);
+                sum -= A(0,0);
+            }
+        }
+        EXPECT_LT(fabs(sum), 1e-6 * n_elements);
+    }
+    Profiler::instance()->output(cout);
+}
+
+#endif // FLOW123D_RUN_UNIT_BENCHMARKS
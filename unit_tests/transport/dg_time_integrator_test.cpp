@@ -0,0 +1,176 @@
+/*
+ * dg_time_integrator_test.cpp
+ *
+ * Time schemes of the DG transport on the diagonal system M u' = f - A u with known solution
+ * u(t) = f/a + (u_0 - f/a) exp(-a t/m) in every component.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+
+#include <flow_gtest_mpi.hh>
+#include <cmath>
+#include <vector>
+
+#include "transport/dg_time_integrator.hh"
+#include "system/system.hh"
+
+
+class DGTimeIntegratorTest : public testing::Test {
+public:
+    static const PetscInt lsize = 3;
+    static constexpr double u0 = 1.0;
+
+    DGTimeIntegratorTest()
+    {
+        chkerr(VecCreateMPI(PETSC_COMM_WORLD, lsize, PETSC_DETERMINE, &mass_));
+        for (Vec *v : {&stiffness_diag_, &rhs_, &solution_, &mass_vec_, &mass_vec_prev_, &system_diag_})
+            chkerr(VecDuplicate(mass_, v));
+        chkerr(MatCreateAIJ(PETSC_COMM_WORLD, lsize, lsize, PETSC_DETERMINE, PETSC_DETERMINE, 1, NULL, 0, NULL, &stiffness_));
+
+        PetscInt begin, end;
+        chkerr(VecGetOwnershipRange(mass_, &begin, &end));
+        for (PetscInt i=begin; i<end; i++) {
+            chkerr(VecSetValue(mass_, i, 1.0 + 0.5*i, INSERT_VALUES));
+            chkerr(VecSetValue(stiffness_diag_, i, 1.0 + i, INSERT_VALUES));
+            chkerr(VecSetValue(rhs_, i, 0.3, INSERT_VALUES));
+        }
+        for (Vec v : {mass_, stiffness_diag_, rhs_}) {
+            chkerr(VecAssemblyBegin(v));
+            chkerr(VecAssemblyEnd(v));
+        }
+        chkerr(MatDiagonalSet(stiffness_, stiffness_diag_, INSERT_VALUES));
+    }
+
+    ~DGTimeIntegratorTest()
+    {
+        for (Vec *v : {&mass_, &stiffness_diag_, &rhs_, &solution_, &mass_vec_, &mass_vec_prev_, &system_diag_})
+            chkerr(VecDestroy(v));
+        chkerr(MatDestroy(&stiffness_));
+    }
+
+    /// Set diagonal of the system matrix to mass_coef M + A.
+    DGTimeIntegrator::SetMatrix set_matrix()
+    {
+        return [this](double mass_coef) {
+            chkerr(VecWAXPY(system_diag_, mass_coef, mass_, stiffness_diag_));
+        };
+    }
+
+    /// Solve the diagonal system.
+    DGTimeIntegrator::Solve solve()
+    {
+        return [this](Vec system_rhs) {
+            chkerr(VecPointwiseDivide(solution_, system_rhs, system_diag_));
+        };
+    }
+
+    /// Set @p u to the exact solution at time @p t.
+    void exact_solution(double t, Vec u)
+    {
+        const PetscScalar *m, *a, *f;
+        PetscScalar *u_array;
+        chkerr(VecGetArrayRead(mass_, &m));
+        chkerr(VecGetArrayRead(stiffness_diag_, &a));
+        chkerr(VecGetArrayRead(rhs_, &f));
+        chkerr(VecGetArray(u, &u_array));
+        for (PetscInt i=0; i<lsize; i++)
+            u_array[i] = f[i]/a[i] + (u0 - f[i]/a[i]) * std::exp(-a[i]*t/m[i]);
+        chkerr(VecRestoreArray(u, &u_array));
+        chkerr(VecRestoreArrayRead(rhs_, &f));
+        chkerr(VecRestoreArrayRead(stiffness_diag_, &a));
+        chkerr(VecRestoreArrayRead(mass_, &m));
+    }
+
+    /// Max norm of the difference of @p solution_ and the exact solution at time @p t.
+    double error(double t)
+    {
+        Vec exact;
+        double error_norm;
+        chkerr(VecDuplicate(solution_, &exact));
+        exact_solution(t, exact);
+        chkerr(VecAXPY(exact, -1.0, solution_));
+        chkerr(VecNorm(exact, NORM_INFINITY, &error_norm));
+        chkerr(VecDestroy(&exact));
+        return error_norm;
+    }
+
+    /**
+     * Error at time 1 of the integration by @p n_steps steps. If @p variable_step is true, the steps alternate
+     * between 0.8 and 1.2 times the mean step.
+     */
+    double integrate(bool esdirk, unsigned int n_steps, bool variable_step)
+    {
+        DGTimeIntegrator integrator;
+        chkerr(VecSet(solution_, u0));
+        double t = 0, dt_prev = 0;
+        for (unsigned int k=0; k<n_steps; k++) {
+            double dt = (1.0 / n_steps) * ( variable_step ? ((k%2) ? 1.2 : 0.8) : 1.0 );
+            chkerr(VecPointwiseMult(mass_vec_, mass_, solution_));
+            if (esdirk)
+                integrator.esdirk_step(dt, stiffness_, rhs_, mass_vec_, solution_, 0.0, set_matrix(), solve());
+            else
+                integrator.bdf_step(dt, (k > 0) ? dt/dt_prev : 1.0, rhs_, mass_vec_, (k > 0) ? mass_vec_prev_ : nullptr,
+                        set_matrix(), solve());
+            chkerr(VecCopy(mass_vec_, mass_vec_prev_));
+            t += dt;
+            dt_prev = dt;
+        }
+        return error(t);
+    }
+
+    /// Estimate of the local error and the true local error of one TR-BDF2 step of length @p dt from the exact solution.
+    void esdirk_local_error(double dt, double &estimate, double &local_error)
+    {
+        const double t0 = 0.2, tol = 1e-3;
+        DGTimeIntegrator integrator;
+        exact_solution(t0, solution_);
+        double old_norm, new_norm;
+        chkerr(VecNorm(solution_, NORM_INFINITY, &old_norm));
+        chkerr(VecPointwiseMult(mass_vec_, mass_, solution_));
+        double ratio = integrator.esdirk_step(dt, stiffness_, rhs_, mass_vec_, solution_, tol, set_matrix(), solve());
+        chkerr(VecNorm(solution_, NORM_INFINITY, &new_norm));
+        estimate = ratio * tol * std::max(old_norm, new_norm);
+        local_error = error(t0 + dt);
+    }
+
+    Vec mass_, stiffness_diag_, rhs_, solution_, mass_vec_, mass_vec_prev_, system_diag_;
+    Mat stiffness_;
+};
+
+
+TEST_F(DGTimeIntegratorTest, bdf2_convergence) {
+    for (bool variable_step : {false, true}) {
+        double error_coarse = integrate(false, 20, variable_step);
+        double error_fine = integrate(false, 40, variable_step);
+        EXPECT_LT(error_coarse, 1e-3);
+        // second order: error is reduced 4 times
+        EXPECT_GT(error_coarse / error_fine, 3.7);
+        EXPECT_LT(error_coarse / error_fine, 4.6);
+    }
+}
+
+
+TEST_F(DGTimeIntegratorTest, esdirk_convergence) {
+    for (bool variable_step : {false, true}) {
+        double error_coarse = integrate(true, 10, variable_step);
+        double error_fine = integrate(true, 20, variable_step);
+        EXPECT_LT(error_coarse, 1e-3);
+        EXPECT_GT(error_coarse / error_fine, 3.7);
+        EXPECT_LT(error_coarse / error_fine, 4.6);
+    }
+}
+
+
+TEST_F(DGTimeIntegratorTest, esdirk_error_estimate) {
+    double estimate_coarse, error_coarse, estimate_fine, error_fine;
+    esdirk_local_error(0.1, estimate_coarse, error_coarse);
+    esdirk_local_error(0.05, estimate_fine, error_fine);
+
+    // embedded solution is of third order, the difference estimates the local error of the second order solution
+    EXPECT_NEAR(1.0, estimate_coarse / error_coarse, 0.1);
+    EXPECT_NEAR(1.0, estimate_fine / error_fine, 0.05);
+    // local error is O(dt^3)
+    EXPECT_GT(estimate_coarse / estimate_fine, 7.0);
+    EXPECT_LT(estimate_coarse / estimate_fine, 9.0);
+}
@@ -0,0 +1,83 @@
+/*
+ * fv_explicit_operator_test.cpp
+ *
+ * Compare the matrix-free FV transport operator with MatMultAdd of the PETSc matrix
+ * assembled from the same entries, including entries of rows owned by other processes.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+
+#include <flow_gtest_mpi.hh>
+#include <vector>
+
+#include "transport/fv_explicit_operator.hh"
+#include "la/distribution.hh"
+#include "system/system.hh"
+
+
+TEST(FVExplicitOperator, apply) {
+    const unsigned int lsize = 6, n_comp = 2;
+    Distribution ds(lsize, PETSC_COMM_WORLD);
+    const LongIdx size = ds.size();
+
+    FVExplicitOperator op(&ds, n_comp);
+    Mat mat;
+    chkerr(MatCreateAIJ(PETSC_COMM_WORLD, lsize, lsize, PETSC_DETERMINE, PETSC_DETERMINE, 3, NULL, 3, NULL, &mat));
+    chkerr(MatSetOption(mat, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+    auto add = [&](LongIdx row, LongIdx col, double value) {
+        op.add(row, col, value);
+        chkerr(MatSetValue(mat, row, col, value, ADD_VALUES));
+    };
+
+    op.start_assembly();
+    for (LongIdx i=ds.begin(); i<(LongIdx)ds.end(); i++) {
+        // fluxes to neighbours, the neighbours at the ends of the local range are ghosts
+        add(i, i, -1.0 - 0.1*i);
+        if (i > 0) add(i, i-1, 0.5 + 0.01*i);
+        if (i+1 < size) add(i, i+1, 0.4);
+    }
+    // row of the next process coupled to an own element (e.g. fracture to its bulk neighbour),
+    // its diagonal entry is summed with the entry added by the owner
+    LongIdx other_row = ds.end() % size;
+    add(other_row, ds.begin(), 0.25);
+    add(other_row, other_row, -0.25);
+    op.finish_assembly();
+    chkerr(MatAssemblyBegin(mat, MAT_FINAL_ASSEMBLY));
+    chkerr(MatAssemblyEnd(mat, MAT_FINAL_ASSEMBLY));
+
+    op.scale(0.1);
+    chkerr(MatScale(mat, 0.1));
+    if (ds.np() > 1) EXPECT_GT(op.n_ghosts(), 0);
+
+    // y_c = A x_c + z as in the matrix transport step, for every component
+    Vec x, y, z;
+    chkerr(MatCreateVecs(mat, &x, &y));
+    chkerr(VecDuplicate(y, &z));
+    std::vector<double> expected(lsize * n_comp), z_val(lsize);
+    for (unsigned int i=0; i<lsize; i++) {
+        LongIdx row = ds.begin() + i;
+        z_val[i] = 1.0 - 0.1*row;
+        for (unsigned int c=0; c<n_comp; c++) op.x()[i*n_comp + c] = 1.0 + 0.01*row*row + c;
+    }
+    chkerr(VecPlaceArray(z, z_val.data()));
+    for (unsigned int c=0; c<n_comp; c++) {
+        double *array;
+        chkerr(VecGetArray(x, &array));
+        for (unsigned int i=0; i<lsize; i++) array[i] = op.x()[i*n_comp + c];
+        chkerr(VecRestoreArray(x, &array));
+        chkerr(MatMultAdd(mat, x, z, y));
+        chkerr(VecGetArray(y, &array));
+        for (unsigned int i=0; i<lsize; i++) expected[i*n_comp + c] = array[i];
+        chkerr(VecRestoreArray(y, &array));
+    }
+    chkerr(VecResetArray(z));
+
+    op.apply();
+    for (unsigned int i=0; i<lsize; i++)
+        for (unsigned int c=0; c<n_comp; c++)
+            EXPECT_NEAR(expected[i*n_comp + c], op.y()[i*n_comp + c] + z_val[i], 1e-13);
+
+    for (Vec *v : {&x, &y, &z}) chkerr(VecDestroy(v));
+    chkerr(MatDestroy(&mat));
+}